@@ -9,47 +9,91 @@
 
 #include "BaseWheeledVehiclePawn.h"
 
+#include "ChaosVehicleWheel.h"
 #include "ChaosWheeledVehicleMovementComponent.h"
 #include "EnhancedInputComponent.h"
 #include "Camera/CameraComponent.h"
+#include "Camera/CameraTypes.h"
+#include "GameFramework/PlayerController.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputActionValue.h"
+#include "SingularisVehicleCameraRig.h"
+#include "SingularisVehicleCameraRigSubsystem.h"
+#include "SingularisVehicleContactSubsystem.h"
+#include "SingularisVehicleControlSubsystem.h"
+#include "SingularisVehicleGroundSubsystem.h"
+#include "SingularisVehicleHibernationSubsystem.h"
+#include "SingularisVehicleLightComponent.h"
+#include "SingularisVehicleMovementComponent.h"
+#include "SingularisVehiclePersistenceSubsystem.h"
+#include "SingularisVehicleResetSubsystem.h"
+#include "SingularisVehicleSignificanceSubsystem.h"
+#include "SingularisVehicleSnapshotSubsystem.h"
+#include "SingularisVehicleWheelVisualSubsystem.h"
+#include "SingularisVehicleSpec.h"
+#include "SingularisVehicleStats.h"
+#include "SingularisVehicleTelemetry.h"
+#include "Engine/AssetManager.h"
 
 #define LOCTEXT_NAMESPACE "BaseWheeledVehiclePawn"
 
 DEFINE_LOG_CATEGORY(LogBaseWheeledVehiclePawn);
 
-ABaseWheeledVehiclePawn::ABaseWheeledVehiclePawn()
+DECLARE_CYCLE_STAT(TEXT("Pawn Tick"), STAT_SingularisVehicle_PawnTick, STATGROUP_SingularisVehicle);
+DECLARE_CYCLE_STAT(TEXT("Pawn Input"), STAT_SingularisVehicle_PawnInput, STATGROUP_SingularisVehicle);
+DECLARE_CYCLE_STAT(TEXT("Pawn Reset"), STAT_SingularisVehicle_PawnReset, STATGROUP_SingularisVehicle);
+DECLARE_CYCLE_STAT(TEXT("Telemetry"), STAT_SingularisVehicle_Telemetry, STATGROUP_SingularisVehicle);
+
+namespace SingularisVehiclePawn
+{
+	static bool bForceServerLean = false;
+	static FAutoConsoleVariableRef CVarForceServerLean(
+		TEXT("SingularisVehicle.ForceServerLean"),
+		bForceServerLean,
+		TEXT("非专用服务器上也按服务器精简配置运行载具：销毁自带相机、不触发刹车灯事件、不更新灯光与骨骼动画。只影响之后 BeginPlay 的载具，用于在客户端构建中估算服务器开销。"));
+}
+
+const FName ABaseWheeledVehiclePawn::FrontSpringArmName(TEXT("Front Spring Arm"));
+const FName ABaseWheeledVehiclePawn::FrontCameraName(TEXT("Front Camera"));
+const FName ABaseWheeledVehiclePawn::BackSpringArmName(TEXT("Back Spring Arm"));
+const FName ABaseWheeledVehiclePawn::BackCameraName(TEXT("Back Camera"));
+
+ABaseWheeledVehiclePawn::ABaseWheeledVehiclePawn(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<USingularisVehicleMovementComponent>(VehicleMovementComponentName))
 {
+	// 专用服务器构建不创建相机，相关指针保持为空
+#if SINGULARISVEHICLE_WITH_COSMETICS
 	// 构造前置摄像头和弹簧臂
-	FrontSpringArm = CreateDefaultSubobject<USpringArmComponent>(TEXT("Front Spring Arm"));
-	FrontSpringArm->SetupAttachment(GetMesh());
-	FrontSpringArm->TargetArmLength = 0.0f;
-	FrontSpringArm->bDoCollisionTest = false;
-	FrontSpringArm->bEnableCameraRotationLag = true;
-	FrontSpringArm->CameraRotationLagSpeed = 15.0f;
-	FrontSpringArm->SetRelativeLocation(FVector(30.0f, 0.0f, 120.0f));
-
-	FrontCamera = CreateDefaultSubobject<UCameraComponent>(TEXT("Front Camera"));
-	FrontCamera->SetupAttachment(FrontSpringArm);
-	FrontCamera->bAutoActivate = false;
+	FrontSpringArm = CreateOptionalDefaultSubobject<USpringArmComponent>(FrontSpringArmName);
+	if (FrontSpringArm)
+	{
+		FrontSpringArm->SetupAttachment(GetMesh());
+		ASingularisVehicleCameraRig::ConfigureFrontSpringArm(FrontSpringArm);
+
+		FrontCamera = CreateOptionalDefaultSubobject<UCameraComponent>(FrontCameraName);
+		if (FrontCamera)
+		{
+			FrontCamera->SetupAttachment(FrontSpringArm);
+			FrontCamera->bAutoActivate = false;
+		}
+	}
 
 	// 构造后置摄像头和弹簧臂
-	BackSpringArm = CreateDefaultSubobject<USpringArmComponent>(TEXT("Back Spring Arm"));
-	BackSpringArm->SetupAttachment(GetMesh());
-	BackSpringArm->TargetArmLength = 650.0f;
-	BackSpringArm->SocketOffset.Z = 150.0f;
-	BackSpringArm->bDoCollisionTest = false;
-	BackSpringArm->bInheritPitch = false;
-	BackSpringArm->bInheritRoll = false;
-	BackSpringArm->bEnableCameraRotationLag = true;
-	BackSpringArm->CameraRotationLagSpeed = 2.0f;
-	BackSpringArm->CameraLagMaxDistance = 50.0f;
-
-	BackCamera = CreateDefaultSubobject<UCameraComponent>(TEXT("Back Camera"));
-	BackCamera->SetupAttachment(BackSpringArm);
+	BackSpringArm = CreateOptionalDefaultSubobject<USpringArmComponent>(BackSpringArmName);
+	if (BackSpringArm)
+	{
+		BackSpringArm->SetupAttachment(GetMesh());
+		ASingularisVehicleCameraRig::ConfigureBackSpringArm(BackSpringArm);
+
+		BackCamera = CreateOptionalDefaultSubobject<UCameraComponent>(BackCameraName);
+		if (BackCamera)
+		{
+			BackCamera->SetupAttachment(BackSpringArm);
+		}
+	}
+#endif
 
 	// 配置载具网格
 	GetMesh()->SetSimulatePhysics(true);
@@ -57,6 +101,7 @@ ABaseWheeledVehiclePawn::ABaseWheeledVehiclePawn()
 
 	// 获取 Chaos 车辆移动组件
 	ChaosVehicleMovement = CastChecked<UChaosWheeledVehicleMovementComponent>(GetVehicleMovement());
+	SingularisVehicleMovement = Cast<USingularisVehicleMovementComponent>(ChaosVehicleMovement);
 
 	// 设置车轮基本参数
 	SetVehicleMovementParameters();
@@ -78,7 +123,6 @@ void ABaseWheeledVehiclePawn::SetupPlayerInputComponent(UInputComponent* Compone
 
 		// 制动 
 		EnhancedInputComponent->BindAction(BrakeAction, ETriggerEvent::Triggered, this, &ABaseWheeledVehiclePawn::Brake);
-		EnhancedInputComponent->BindAction(BrakeAction, ETriggerEvent::Started, this, &ABaseWheeledVehiclePawn::StartBrake);
 		EnhancedInputComponent->BindAction(BrakeAction, ETriggerEvent::Completed, this, &ABaseWheeledVehiclePawn::StopBrake);
 
 		// 手刹 
@@ -105,15 +149,140 @@ void ABaseWheeledVehiclePawn::SetupPlayerInputComponent(UInputComponent* Compone
 	}
 }
 
+void ABaseWheeledVehiclePawn::NotifyControllerChanged()
+{
+	Super::NotifyControllerChanged();
+
+	// 占有发生在 BeginPlay 之前时由 BeginPlay 处理
+	if (!HasActorBegunPlay())
+	{
+		return;
+	}
+
+	if (bUseSharedCameraRig)
+	{
+		if (IsLocallyControlled() && IsPlayerControlled())
+		{
+			AcquireCameraRig();
+		}
+		else
+		{
+			ReleaseCameraRig();
+		}
+	}
+
+	UpdateCameraRigTickEnabled();
+
+	if (USingularisVehicleControlSubsystem* Control = GetWorld()->GetSubsystem<USingularisVehicleControlSubsystem>())
+	{
+		Control->RefreshControlSource(this);
+	}
+}
+
+void ABaseWheeledVehiclePawn::PreRegisterAllComponents()
+{
+	Super::PreRegisterAllComponents();
+
+	// 规格已在内存中时赶在物理状态创建前写入，避免重建 Chaos 载具模拟
+	const UWorld* World = GetWorld();
+	if (World && World->IsGameWorld() && !AppliedVehicleSpec)
+	{
+		if (const USingularisVehicleSpec* Spec = VehicleSpec.Get())
+		{
+			ApplyVehicleSpec(Spec);
+		}
+	}
+}
+
+void ABaseWheeledVehiclePawn::BeginPlay()
+{
+	Super::BeginPlay();
+
+#if SINGULARISVEHICLE_TELEMETRY
+	SingularisVehicleTelemetry::TraceVehicleSpawn(*this);
+#endif
+
+	// 规格尚未加载时异步加载，不阻塞游戏线程
+	if (!AppliedVehicleSpec && !VehicleSpec.IsNull())
+	{
+		VehicleSpecLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+			VehicleSpec.ToSoftObjectPath(),
+			FStreamableDelegate::CreateUObject(this, &ABaseWheeledVehiclePawn::OnVehicleSpecLoaded));
+	}
+
+	// 使用共享相机组时销毁自带的相机，只在被玩家控制时借用；服务器精简配置下同样销毁，且不借用
+	const bool bRunCosmetics = ShouldRunCosmetics();
+	if (bUseSharedCameraRig || !bRunCosmetics)
+	{
+		for (USceneComponent* CameraComponent : TArray<USceneComponent*>{FrontCamera, BackCamera, FrontSpringArm, BackSpringArm})
+		{
+			if (CameraComponent)
+			{
+				CameraComponent->DestroyComponent();
+			}
+		}
+
+		FrontCamera = nullptr;
+		BackCamera = nullptr;
+		FrontSpringArm = nullptr;
+		BackSpringArm = nullptr;
+
+		if (bUseSharedCameraRig && IsLocallyControlled() && IsPlayerControlled())
+		{
+			AcquireCameraRig();
+		}
+	}
+
+	UpdateCameraRigTickEnabled();
+
+	// 没有人观看，骨骼动画从不更新；重要度层级变化时同样保持
+	if (!bRunCosmetics)
+	{
+		GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+	}
+
+	RegisterWithSubsystems();
+}
+
+void ABaseWheeledVehiclePawn::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (VehicleSpecLoadHandle.IsValid())
+	{
+		VehicleSpecLoadHandle->CancelHandle();
+		VehicleSpecLoadHandle.Reset();
+	}
+
+	ReleaseCameraRig();
+
+	UnregisterFromSubsystems();
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ABaseWheeledVehiclePawn::Tick(const float Delta)
 {
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_PawnTick);
+
 	Super::Tick(Delta);
 
 	// 如果车辆在空中，添加一些角度阻尼
 	// 角度阻尼（Angular Damping）：是指物体在旋转时受到的阻力，它会减缓物体的旋转速度
 	// 此处的作用是让车辆在空中不会无限旋转，而是会逐渐减速
-	const bool bMovingOnGround = ChaosVehicleMovement->IsMovingOnGround();
-	GetMesh()->SetAngularDamping(bMovingOnGround ? 0.0f : 3.0f);
+	// 异步输入模式下由物理线程模拟在每个物理步中施加
+	if (!SingularisVehicleMovement || !SingularisVehicleMovement->IsUsingAsyncPhysicsInput())
+	{
+		const bool bMovingOnGround = ChaosVehicleMovement->IsMovingOnGround();
+		const float AirborneAngularDamping = SingularisVehicleMovement ? SingularisVehicleMovement->AirborneAngularDamping : 3.0f;
+		GetMesh()->SetAngularDamping(bMovingOnGround ? 0.0f : AirborneAngularDamping);
+	}
+
+#if SINGULARISVEHICLE_TELEMETRY
+	if (SingularisVehicleTelemetry::IsEnabled())
+	{
+		SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_Telemetry);
+		SingularisVehicleTelemetry::RecordVehicleState(*this);
+	}
+#endif
 
 	/*// 将相机的偏航角重新对准正面
 	// 偏航角（Yaw） ：是物体在三维空间中绕垂直轴（通常是 Y 轴）旋转的角度
@@ -123,80 +292,207 @@ void ABaseWheeledVehiclePawn::Tick(const float Delta)
 	BackSpringArm->SetRelativeRotation(FRotator(0.0f, CameraYaw, 0.0f));*/
 }
 
+void ABaseWheeledVehiclePawn::CalcCamera(const float DeltaTime, FMinimalViewInfo& OutResult)
+{
+	// 共享相机组的摄像头不属于本 Actor，无法被默认的查找逻辑找到
+	if (SharedCameraRig.IsValid())
+	{
+		if (UCameraComponent* ActiveCamera = bFrontCameraActive ? FrontCamera : BackCamera)
+		{
+			ActiveCamera->GetCameraView(DeltaTime, OutResult);
+			return;
+		}
+	}
+
+	Super::CalcCamera(DeltaTime, OutResult);
+}
+
+bool ABaseWheeledVehiclePawn::ShouldRunCosmetics() const
+{
+#if SINGULARISVEHICLE_WITH_COSMETICS
+	return !SingularisVehiclePawn::bForceServerLean && !IsNetMode(NM_DedicatedServer);
+#else
+	return false;
+#endif
+}
+
+void ABaseWheeledVehiclePawn::AcquireCameraRig()
+{
+	if (!bUseSharedCameraRig || SharedCameraRig.IsValid() || !ShouldRunCosmetics())
+	{
+		return;
+	}
+
+	USingularisVehicleCameraRigSubsystem* CameraRigs = GetWorld()->GetSubsystem<USingularisVehicleCameraRigSubsystem>();
+	ASingularisVehicleCameraRig* Rig = CameraRigs ? CameraRigs->AcquireRig(GetController<APlayerController>(), this) : nullptr;
+	if (!Rig)
+	{
+		return;
+	}
+
+	SharedCameraRig = Rig;
+	FrontSpringArm = Rig->GetFrontSpringArm();
+	FrontCamera = Rig->GetFrontCamera();
+	BackSpringArm = Rig->GetBackSpringArm();
+	BackCamera = Rig->GetBackCamera();
+
+	ActivateCurrentCamera();
+}
+
+void ABaseWheeledVehiclePawn::ReleaseCameraRig()
+{
+	if (!SharedCameraRig.IsValid())
+	{
+		return;
+	}
+
+	SharedCameraRig.Reset();
+	FrontSpringArm = nullptr;
+	FrontCamera = nullptr;
+	BackSpringArm = nullptr;
+	BackCamera = nullptr;
+
+	if (USingularisVehicleCameraRigSubsystem* CameraRigs = GetWorld()->GetSubsystem<USingularisVehicleCameraRigSubsystem>())
+	{
+		CameraRigs->ReleaseRig(this);
+	}
+}
+
 // ReSharper disable once CppMemberFunctionMayBeConst
 void ABaseWheeledVehiclePawn::Steering(const FInputActionValue& Value)
 {
-	// 获取转向的输入幅度并给车辆运动组件
-	const float SteeringValue = Value.Get<float>();
-	ChaosVehicleMovement->SetSteeringInput(SteeringValue);
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_PawnInput);
+
+	// 获取转向的输入幅度写入控制帧
+	FVehicleControlFrame Frame = GetControlFrame();
+	Frame.Steering = Value.Get<float>();
+	SubmitControlFrame(Frame);
 }
 
 // ReSharper disable once CppMemberFunctionMayBeConst
 void ABaseWheeledVehiclePawn::Throttle(const FInputActionValue& Value)
 {
-	// 获取油门的输入幅度并给车辆运动组件
-	const float ThrottleValue = Value.Get<float>();
-	ChaosVehicleMovement->SetThrottleInput(ThrottleValue);
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_PawnInput);
+
+	// 获取油门的输入幅度写入控制帧
+	FVehicleControlFrame Frame = GetControlFrame();
+	Frame.Throttle = Value.Get<float>();
+	SubmitControlFrame(Frame);
 }
 
 // ReSharper disable once CppMemberFunctionMayBeConst
 void ABaseWheeledVehiclePawn::Brake(const FInputActionValue& Value)
 {
-	// 获取刹车的输入幅度并给车辆运动组件
-	const float BreakValue = Value.Get<float>();
-	ChaosVehicleMovement->SetBrakeInput(BreakValue);
-}
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_PawnInput);
 
-void ABaseWheeledVehiclePawn::StartBrake([[maybe_unused]] const FInputActionValue& Value)
-{
-	// 制动输入时启动刹车灯
-	BrakeLights(true);
+	// 获取刹车的输入幅度写入控制帧，刹车灯随控制帧切换
+	FVehicleControlFrame Frame = GetControlFrame();
+	Frame.Brake = Value.Get<float>();
+	SubmitControlFrame(Frame);
 }
 
 void ABaseWheeledVehiclePawn::StopBrake([[maybe_unused]] const FInputActionValue& Value)
 {
-	// 关闭刹车灯
-	BrakeLights(false);
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_PawnInput);
+
 	// 将制动输入重置为零
-	ChaosVehicleMovement->SetBrakeInput(0.0f);
+	FVehicleControlFrame Frame = GetControlFrame();
+	Frame.Brake = 0.0f;
+	SubmitControlFrame(Frame);
 }
 
 void ABaseWheeledVehiclePawn::StartHandbrake([[maybe_unused]] const FInputActionValue& Value)
 {
-	// 启动手刹
-	ChaosVehicleMovement->SetHandbrakeInput(true);
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_PawnInput);
 
-	// 打开刹车灯
-	BrakeLights(true);
+	// 启动手刹
+	FVehicleControlFrame Frame = GetControlFrame();
+	Frame.bHandbrake = true;
+	SubmitControlFrame(Frame);
 }
 
 void ABaseWheeledVehiclePawn::StopHandbrake([[maybe_unused]] const FInputActionValue& Value)
 {
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_PawnInput);
+
 	// 关闭手刹
-	ChaosVehicleMovement->SetHandbrakeInput(false);
+	FVehicleControlFrame Frame = GetControlFrame();
+	Frame.bHandbrake = false;
+	SubmitControlFrame(Frame);
+}
+
+void ABaseWheeledVehiclePawn::SetBrakeLights(const bool bActive, const bool bNotifyBlueprint)
+{
+	if (bBrakeLightsActive == bActive)
+	{
+		return;
+	}
+
+	bBrakeLightsActive = bActive;
+
+#if SINGULARISVEHICLE_WITH_COSMETICS
+	if (bNotifyBlueprint && ShouldRunCosmetics())
+	{
+		BrakeLights(bActive);
+	}
+#endif
+}
 
-	// 关闭刹车灯
-	BrakeLights(false);
+void ABaseWheeledVehiclePawn::SetInputBrakeLights(const bool bActive)
+{
+	// 灯光组件从运动组件推导状态，避免每次踩刹车都进入蓝图虚拟机
+	if (!LightComponent)
+	{
+		SetBrakeLights(bActive);
+	}
 }
 
 // ReSharper disable once CppMemberFunctionMayBeConst
 void ABaseWheeledVehiclePawn::LookAround(const FInputActionValue& Value)
 {
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_PawnInput);
+
 	// 获取环顾的输入幅度并给后置弹簧臂添加本地旋转
 	const float LookValue = Value.Get<float>();
-	BackSpringArm->AddLocalRotation(FRotator(0.0f, LookValue, 0.0f));
+	if (BackSpringArm)
+	{
+		BackSpringArm->AddLocalRotation(FRotator(0.0f, LookValue, 0.0f));
+	}
+
+	UpdateNetCameraState();
 }
 
 void ABaseWheeledVehiclePawn::ToggleCamera([[maybe_unused]] const FInputActionValue& Value)
 {
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_PawnInput);
+
 	// 切换摄像头
 	bFrontCameraActive = !bFrontCameraActive;
-	FrontCamera->SetActive(bFrontCameraActive);
-	BackCamera->SetActive(!bFrontCameraActive);
+	ActivateCurrentCamera();
+	UpdateNetCameraState();
 }
 
 
 void ABaseWheeledVehiclePawn::ResetVehicle([[maybe_unused]] const FInputActionValue& Value)
+{
+	RequestSafeReset();
+}
+
+void ABaseWheeledVehiclePawn::RequestSafeReset()
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_PawnReset);
+
+	if (USingularisVehicleResetSubsystem* Reset = GetWorld()->GetSubsystem<USingularisVehicleResetSubsystem>())
+	{
+		Reset->RequestReset(this);
+	}
+	else
+	{
+		ResetInPlace();
+	}
+}
+
+void ABaseWheeledVehiclePawn::ResetInPlace()
 {
 	// 重置到当前略高的位置
 	const FVector ResetLocation = GetActorLocation() + FVector(0.0f, 0.0f, 50.0f);
@@ -206,13 +502,465 @@ void ABaseWheeledVehiclePawn::ResetVehicle([[maybe_unused]] const FInputActionVa
 	ResetRotation.Pitch = 0.0f;
 	ResetRotation.Roll = 0.0f;
 
+	TeleportVehicle(FTransform(ResetRotation, ResetLocation, FVector::OneVector));
+}
+
+void ABaseWheeledVehiclePawn::ApplyVehicleSpec(const USingularisVehicleSpec* Spec)
+{
+	if (!Spec)
+	{
+		return;
+	}
+
+	Spec->ApplyTo(*ChaosVehicleMovement);
+	AppliedVehicleSpec = Spec;
+
+	// 物理状态已经存在时，新的参数需要重建 Chaos 载具模拟才能生效
+	if (ChaosVehicleMovement->IsPhysicsStateCreated())
+	{
+		ChaosVehicleMovement->RecreatePhysicsState();
+	}
+}
+
+void ABaseWheeledVehiclePawn::OnVehicleSpecLoaded()
+{
+	VehicleSpecLoadHandle.Reset();
+	ApplyVehicleSpec(VehicleSpec.Get());
+}
+
+void ABaseWheeledVehiclePawn::TeleportVehicle(const FTransform& NewTransform)
+{
 	// 将演员传送到重置点并重置物理状态
-	SetActorTransform(FTransform(ResetRotation, ResetLocation, FVector::OneVector), false, nullptr, ETeleportType::TeleportPhysics);
+	SetActorTransform(NewTransform, false, nullptr, ETeleportType::TeleportPhysics);
 
 	GetMesh()->SetPhysicsAngularVelocityInDegrees(FVector::ZeroVector);
 	GetMesh()->SetPhysicsLinearVelocity(FVector::ZeroVector);
+}
+
+void ABaseWheeledVehiclePawn::SubmitControlFrame(const FVehicleControlFrame& Frame)
+{
+	USingularisVehicleControlSubsystem* Control = GetWorld()->GetSubsystem<USingularisVehicleControlSubsystem>();
+	if (!Control || !Control->SubmitControlFrame(this, Frame))
+	{
+		ApplyControlFrame(Frame, &LocalControlFrame);
+		LocalControlFrame = Frame;
+	}
+}
+
+FVehicleControlFrame ABaseWheeledVehiclePawn::GetControlFrame() const
+{
+	const USingularisVehicleControlSubsystem* Control = GetWorld()->GetSubsystem<USingularisVehicleControlSubsystem>();
+	const FVehicleControlFrame* Frame = Control ? Control->FindControlFrame(this) : nullptr;
+	return Frame ? *Frame : LocalControlFrame;
+}
+
+void ABaseWheeledVehiclePawn::SetControlInputs(const float ThrottleValue, const float BrakeValue, const float SteeringValue, const bool bHandbrake)
+{
+	FVehicleControlFrame Frame;
+	Frame.Throttle = ThrottleValue;
+	Frame.Brake = BrakeValue;
+	Frame.Steering = SteeringValue;
+	Frame.bHandbrake = bHandbrake;
+	SubmitControlFrame(Frame);
+}
+
+void ABaseWheeledVehiclePawn::ApplyControlFrame(const FVehicleControlFrame& Frame, const FVehicleControlFrame* Previous)
+{
+	// 只写入发生变化的通道
+	const EVehicleControlChannels Channels = Frame.GetChangedChannels(Previous);
+	if (SingularisVehicleMovement)
+	{
+		// 异步输入模式下一次送出一个采样，没有变化时不送出
+		SingularisVehicleMovement->QueueControlInputs(Frame.Throttle, Frame.Brake, Frame.Steering, Frame.bHandbrake, Channels);
+	}
+	else
+	{
+		if (EnumHasAnyFlags(Channels, EVehicleControlChannels::Throttle))
+		{
+			ChaosVehicleMovement->SetThrottleInput(Frame.Throttle);
+		}
+		if (EnumHasAnyFlags(Channels, EVehicleControlChannels::Brake))
+		{
+			ChaosVehicleMovement->SetBrakeInput(Frame.Brake);
+		}
+		if (EnumHasAnyFlags(Channels, EVehicleControlChannels::Steering))
+		{
+			ChaosVehicleMovement->SetSteeringInput(Frame.Steering);
+		}
+		if (EnumHasAnyFlags(Channels, EVehicleControlChannels::Handbrake))
+		{
+			ChaosVehicleMovement->SetHandbrakeInput(Frame.bHandbrake);
+		}
+	}
+
+	if (!Previous || Frame.WantsBrakeLights() != Previous->WantsBrakeLights())
+	{
+		SetInputBrakeLights(Frame.WantsBrakeLights());
+	}
+}
+
+void ABaseWheeledVehiclePawn::ResetVehicleState()
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_PawnReset);
+
+	// 清除输入，不等待本帧的批处理
+	if (USingularisVehicleControlSubsystem* Control = GetWorld()->GetSubsystem<USingularisVehicleControlSubsystem>())
+	{
+		Control->ResetControlFrame(this);
+	}
+	LocalControlFrame = FVehicleControlFrame();
+	SetSteeringInput(0.0f);
+	SetThrottleInput(0.0f);
+	SetBrakeInput(0.0f);
+	SetHandbrakeInput(false);
+
+	// 清除引擎转速、挡位与车轮的转动状态
+	ChaosVehicleMovement->ResetVehicle();
+	ChaosVehicleMovement->StopMovementImmediately();
+
+	// 相机回到默认的后置视角
+	bFrontCameraActive = false;
+	ActivateCurrentCamera();
+	if (BackSpringArm)
+	{
+		BackSpringArm->SetRelativeRotation(FRotator::ZeroRotator);
+	}
+	UpdateNetCameraState();
+
+	if (LightComponent)
+	{
+		LightComponent->SetLightState(false, false, false);
+	}
+	else
+	{
+		SetBrakeLights(false);
+	}
+}
+
+void ABaseWheeledVehiclePawn::OnAcquiredFromPool(const FTransform& SpawnTransform)
+{
+	bPooled = false;
+
+	TeleportVehicle(SpawnTransform);
+	ResetVehicleState();
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+	GetMesh()->SetEnableGravity(true);
+	ChaosVehicleMovement->SetComponentTickEnabled(true);
+	ChaosVehicleMovement->SetSleeping(false);
+
+	if (!Controller && AutoPossessAI != EAutoPossessAI::Disabled)
+	{
+		SpawnDefaultController();
+	}
+
+	RegisterWithSubsystems();
+}
+
+void ABaseWheeledVehiclePawn::OnReleasedToPool(const FVector& ParkingLocation)
+{
+	UnregisterFromSubsystems();
+
+	DetachFromControllerPendingDestroy();
+	ResetVehicleState();
+
+	// 停放在池位置并冻结：物理体保持存在但休眠，避免重新创建物理与 Chaos 载具模拟
+	TeleportVehicle(FTransform(ParkingLocation));
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+	GetMesh()->SetEnableGravity(false);
+	ChaosVehicleMovement->SetComponentTickEnabled(false);
+	ChaosVehicleMovement->SetSleeping(true);
+
+	bPooled = true;
+}
+
+void ABaseWheeledVehiclePawn::RegisterWithSubsystems()
+{
+	// 注册到重要度子系统，由其统一调度更新频率
+	if (USingularisVehicleSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<USingularisVehicleSignificanceSubsystem>())
+	{
+		Significance->RegisterVehicle(this);
+	}
+
+	// 注册到重置子系统，开始记录安全位置
+	if (USingularisVehicleResetSubsystem* Reset = GetWorld()->GetSubsystem<USingularisVehicleResetSubsystem>())
+	{
+		Reset->RegisterVehicle(this);
+	}
+
+	if (USingularisVehicleControlSubsystem* Control = GetWorld()->GetSubsystem<USingularisVehicleControlSubsystem>())
+	{
+		Control->RegisterVehicle(this);
+	}
+
+	if (USingularisVehicleHibernationSubsystem* Hibernation = GetWorld()->GetSubsystem<USingularisVehicleHibernationSubsystem>())
+	{
+		Hibernation->RegisterVehicle(this);
+	}
+
+	if (USingularisVehicleSnapshotSubsystem* Snapshots = GetWorld()->GetSubsystem<USingularisVehicleSnapshotSubsystem>())
+	{
+		Snapshots->RegisterVehicle(this);
+	}
+
+	if (USingularisVehicleWheelVisualSubsystem* WheelVisuals = GetWorld()->GetSubsystem<USingularisVehicleWheelVisualSubsystem>())
+	{
+		WheelVisuals->RegisterVehicle(this);
+	}
+
+	if (USingularisVehicleGroundSubsystem* Ground = GetWorld()->GetSubsystem<USingularisVehicleGroundSubsystem>())
+	{
+		Ground->RegisterVehicle(this);
+	}
+
+	if (USingularisVehicleContactSubsystem* Contacts = GetWorld()->GetSubsystem<USingularisVehicleContactSubsystem>())
+	{
+		Contacts->RegisterVehicle(this);
+	}
+
+	if (USingularisVehiclePersistenceSubsystem* Persistence = GetWorld()->GetSubsystem<USingularisVehiclePersistenceSubsystem>())
+	{
+		Persistence->RegisterVehicle(this);
+	}
+}
+
+void ABaseWheeledVehiclePawn::UnregisterFromSubsystems()
+{
+	if (USingularisVehicleSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<USingularisVehicleSignificanceSubsystem>())
+	{
+		Significance->UnregisterVehicle(this);
+	}
+
+	if (USingularisVehicleResetSubsystem* Reset = GetWorld()->GetSubsystem<USingularisVehicleResetSubsystem>())
+	{
+		Reset->UnregisterVehicle(this);
+	}
+
+	if (USingularisVehicleControlSubsystem* Control = GetWorld()->GetSubsystem<USingularisVehicleControlSubsystem>())
+	{
+		Control->UnregisterVehicle(this);
+	}
+
+	if (USingularisVehicleHibernationSubsystem* Hibernation = GetWorld()->GetSubsystem<USingularisVehicleHibernationSubsystem>())
+	{
+		Hibernation->UnregisterVehicle(this);
+	}
+
+	if (USingularisVehicleSnapshotSubsystem* Snapshots = GetWorld()->GetSubsystem<USingularisVehicleSnapshotSubsystem>())
+	{
+		Snapshots->UnregisterVehicle(this);
+	}
+
+	if (USingularisVehicleWheelVisualSubsystem* WheelVisuals = GetWorld()->GetSubsystem<USingularisVehicleWheelVisualSubsystem>())
+	{
+		WheelVisuals->UnregisterVehicle(this);
+	}
+
+	if (USingularisVehicleGroundSubsystem* Ground = GetWorld()->GetSubsystem<USingularisVehicleGroundSubsystem>())
+	{
+		Ground->UnregisterVehicle(this);
+	}
+
+	if (USingularisVehicleContactSubsystem* Contacts = GetWorld()->GetSubsystem<USingularisVehicleContactSubsystem>())
+	{
+		Contacts->UnregisterVehicle(this);
+	}
+
+	if (USingularisVehiclePersistenceSubsystem* Persistence = GetWorld()->GetSubsystem<USingularisVehiclePersistenceSubsystem>())
+	{
+		Persistence->UnregisterVehicle(this);
+	}
+}
 
-	UE_LOG(LogBaseWheeledVehiclePawn, Error, TEXT("Reset Vehicle"));
+void ABaseWheeledVehiclePawn::SavePersistentState(FSingularisPersistedVehicle& OutRecord) const
+{
+	OutRecord.Location = GetActorLocation();
+	OutRecord.Rotation = FQuat4f(GetActorQuat());
+	OutRecord.LinearVelocity = FVector3f(GetMesh()->GetPhysicsLinearVelocity());
+	OutRecord.AngularVelocity = FVector3f(GetMesh()->GetPhysicsAngularVelocityInDegrees());
+	OutRecord.Gear = static_cast<int8>(ChaosVehicleMovement->GetCurrentGear());
+	OutRecord.bHandbrake = GetControlFrame().bHandbrake;
+	OutRecord.bFrontCameraActive = bFrontCameraActive;
+}
+
+void ABaseWheeledVehiclePawn::RestorePersistentState(const FSingularisPersistedVehicle& Record)
+{
+	// 对象池取出时已清除速度，这里写回记录的车身速度
+	const FVector LinearVelocity(Record.LinearVelocity);
+	GetMesh()->SetPhysicsLinearVelocity(LinearVelocity);
+	GetMesh()->SetPhysicsAngularVelocityInDegrees(FVector(Record.AngularVelocity));
+
+	if (SingularisVehicleMovement)
+	{
+		SingularisVehicleMovement->RestoreDriveState(Record.Gear, LinearVelocity | GetActorForwardVector());
+	}
+	else
+	{
+		ChaosVehicleMovement->SetTargetGear(Record.Gear, true);
+	}
+
+	if (Record.bHandbrake)
+	{
+		FVehicleControlFrame Frame;
+		Frame.bHandbrake = true;
+		SubmitControlFrame(Frame);
+	}
+
+	bFrontCameraActive = Record.bFrontCameraActive;
+	ActivateCurrentCamera();
+	UpdateNetCameraState();
+}
+
+void ABaseWheeledVehiclePawn::ApplySignificanceTier(const EVehicleSignificanceTier NewTier)
+{
+	if (NewTier == SignificanceTier)
+	{
+		return;
+	}
+
+	const EVehicleSignificanceTier OldTier = SignificanceTier;
+	SignificanceTier = NewTier;
+
+	// 离开冻结层级时唤醒物理并恢复 Tick
+	if (OldTier == EVehicleSignificanceTier::Frozen)
+	{
+		SetActorTickEnabled(true);
+		ChaosVehicleMovement->SetComponentTickEnabled(true);
+		ChaosVehicleMovement->SetSleeping(false);
+	}
+
+	// Actor Tick 频率
+	switch (NewTier)
+	{
+	case EVehicleSignificanceTier::Full:
+		SetActorTickInterval(0.0f);
+		break;
+	case EVehicleSignificanceTier::Reduced:
+		SetActorTickInterval(ReducedTickInterval);
+		break;
+	case EVehicleSignificanceTier::LowDetail:
+		SetActorTickInterval(LowDetailTickInterval);
+		break;
+	case EVehicleSignificanceTier::Frozen:
+		SetActorTickEnabled(false);
+		ChaosVehicleMovement->SetComponentTickEnabled(false);
+		ChaosVehicleMovement->SetSleeping(true);
+		break;
+	default:
+		break;
+	}
+
+	UpdateCameraRigTickEnabled();
+
+	// 骨骼动画只在可见时更新
+	GetMesh()->VisibilityBasedAnimTickOption = NewTier == EVehicleSignificanceTier::Full && ShouldRunCosmetics()
+		                                           ? EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones
+		                                           : EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+
+	// LowDetail 及以上层级将车轮检测简化为射线，恢复时使用车轮类的默认设置
+	// 注意：Chaos 的物理子步数为项目级设置，无法按载具调整，因此以车轮检测精度作为降级手段
+	const bool bSimplifyWheels = NewTier >= EVehicleSignificanceTier::LowDetail;
+	for (UChaosVehicleWheel* Wheel : ChaosVehicleMovement->Wheels)
+	{
+		if (Wheel)
+		{
+			const UChaosVehicleWheel* WheelDefaults = Wheel->GetClass()->GetDefaultObject<UChaosVehicleWheel>();
+			Wheel->SweepShape = bSimplifyWheels ? ESweepShape::Raycast : WheelDefaults->SweepShape;
+			Wheel->SweepType = bSimplifyWheels ? ESweepType::SimpleSweep : WheelDefaults->SweepType;
+		}
+	}
+}
+
+void ABaseWheeledVehiclePawn::UpdateCameraRigTickEnabled() const
+{
+	// 共享相机组由子系统管理，附加期间始终更新
+	if (SharedCameraRig.IsValid())
+	{
+		return;
+	}
+
+	// AI 控制或停放的载具没有人会透过它们观察，远处载具同理
+	const bool bCameraRigTick = IsLocallyControlled() && IsPlayerControlled() && SignificanceTier == EVehicleSignificanceTier::Full;
+	for (USpringArmComponent* SpringArm : {FrontSpringArm, BackSpringArm})
+	{
+		if (SpringArm)
+		{
+			SpringArm->SetComponentTickEnabled(bCameraRigTick);
+		}
+	}
+}
+
+void ABaseWheeledVehiclePawn::ActivateCurrentCamera() const
+{
+	if (FrontCamera)
+	{
+		FrontCamera->SetActive(bFrontCameraActive);
+	}
+
+	if (BackCamera)
+	{
+		BackCamera->SetActive(!bFrontCameraActive);
+	}
+}
+
+void ABaseWheeledVehiclePawn::SetThrottleInput(const float Throttle) const
+{
+	if (SingularisVehicleMovement)
+	{
+		SingularisVehicleMovement->QueueThrottleInput(Throttle);
+	}
+	else
+	{
+		ChaosVehicleMovement->SetThrottleInput(Throttle);
+	}
+}
+
+void ABaseWheeledVehiclePawn::SetBrakeInput(const float Brake) const
+{
+	if (SingularisVehicleMovement)
+	{
+		SingularisVehicleMovement->QueueBrakeInput(Brake);
+	}
+	else
+	{
+		ChaosVehicleMovement->SetBrakeInput(Brake);
+	}
+}
+
+void ABaseWheeledVehiclePawn::SetSteeringInput(const float Steering) const
+{
+	if (SingularisVehicleMovement)
+	{
+		SingularisVehicleMovement->QueueSteeringInput(Steering);
+	}
+	else
+	{
+		ChaosVehicleMovement->SetSteeringInput(Steering);
+	}
+}
+
+void ABaseWheeledVehiclePawn::SetHandbrakeInput(const bool bHandbrake) const
+{
+	if (SingularisVehicleMovement)
+	{
+		SingularisVehicleMovement->QueueHandbrakeInput(bHandbrake);
+	}
+	else
+	{
+		ChaosVehicleMovement->SetHandbrakeInput(bHandbrake);
+	}
+}
+
+void ABaseWheeledVehiclePawn::UpdateNetCameraState() const
+{
+	if (SingularisVehicleMovement)
+	{
+		SingularisVehicleMovement->SetNetCameraState(bFrontCameraActive, BackSpringArm ? BackSpringArm->GetRelativeRotation().Yaw : 0.0f);
+	}
 }
 
 void ABaseWheeledVehiclePawn::SetVehicleMovementParameters() const
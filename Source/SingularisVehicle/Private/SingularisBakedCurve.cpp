@@ -0,0 +1,81 @@
+/* =====================================================================
+ * SingularisBakedCurve.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisBakedCurve.h"
+
+#include "Curves/RichCurve.h"
+
+void FSingularisBakedCurve::Bake(const FRichCurve& Curve)
+{
+	float CurveMinTime = 0.0f;
+	float CurveMaxTime = 0.0f;
+	Curve.GetTimeRange(CurveMinTime, CurveMaxTime);
+	Bake(Curve, CurveMinTime, CurveMaxTime);
+}
+
+void FSingularisBakedCurve::Bake(const FRichCurve& Curve, const float InMinTime, const float InMaxTime)
+{
+	MinTime = InMinTime;
+	MaxTime = FMath::Max(InMaxTime, InMinTime + UE_KINDA_SMALL_NUMBER);
+
+	const float Step = (MaxTime - MinTime) / static_cast<float>(NumSamples - 1);
+	InvStep = 1.0f / Step;
+
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		Values[Index] = Curve.Eval(MinTime + Step * Index);
+	}
+	Values[NumSamples] = Values[NumSamples - 1];
+
+	bBaked = true;
+}
+
+float FSingularisBakedCurve::ComputeMaxError(const FRichCurve& Curve, const int32 NumTestSamples) const
+{
+	float MaxError = 0.0f;
+	for (int32 Index = 0; Index < NumTestSamples; ++Index)
+	{
+		const float Time = FMath::Lerp(MinTime, MaxTime, static_cast<float>(Index) / static_cast<float>(FMath::Max(NumTestSamples - 1, 1)));
+		MaxError = FMath::Max(MaxError, FMath::Abs(Evaluate(Time) - Curve.Eval(Time)));
+	}
+
+	return MaxError;
+}
+
+void FSingularisBakedCurve::EvaluateBatch(const float* RESTRICT InTimes, float* RESTRICT OutValues, const int32 Num) const
+{
+	const VectorRegister4Float VecMinTime = VectorSetFloat1(MinTime);
+	const VectorRegister4Float VecInvStep = VectorSetFloat1(InvStep);
+	const VectorRegister4Float VecMaxPosition = VectorSetFloat1(static_cast<float>(NumSamples - 1));
+
+	int32 Index = 0;
+	for (; Index + 4 <= Num; Index += 4)
+	{
+		// 4 个一组计算位置、索引与插值系数
+		VectorRegister4Float Position = VectorMultiply(VectorSubtract(VectorLoad(InTimes + Index), VecMinTime), VecInvStep);
+		Position = VectorMin(VectorMax(Position, VectorZeroFloat()), VecMaxPosition);
+
+		const VectorRegister4Float Floor = VectorTruncate(Position);
+		const VectorRegister4Float Alpha = VectorSubtract(Position, Floor);
+
+		alignas(16) int32 Indices[4];
+		VectorIntStore(VectorFloatToInt(Floor), Indices);
+
+		// 表很小，常驻缓存，按索引逐个取值
+		const VectorRegister4Float A = MakeVectorRegister(Values[Indices[0]], Values[Indices[1]], Values[Indices[2]], Values[Indices[3]]);
+		const VectorRegister4Float B = MakeVectorRegister(Values[Indices[0] + 1], Values[Indices[1] + 1], Values[Indices[2] + 1], Values[Indices[3] + 1]);
+
+		VectorStore(VectorMultiplyAdd(VectorSubtract(B, A), Alpha, A), OutValues + Index);
+	}
+
+	for (; Index < Num; ++Index)
+	{
+		OutValues[Index] = Evaluate(InTimes[Index]);
+	}
+}
@@ -0,0 +1,41 @@
+/* =====================================================================
+ * SingularisSurfaceResponse.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisSurfaceResponse.h"
+
+namespace SingularisSurfaceResponse
+{
+	static FSingularisSurfaceResponseTable::FEntry MakeEntry(const FSingularisSurfaceResponse& Response)
+	{
+		FSingularisSurfaceResponseTable::FEntry Entry;
+		Entry.FrictionScale = FMath::Max(Response.FrictionScale, 0.0f);
+		Entry.SlipThreshold = FMath::Max(Response.SlipThreshold, 0.0f);
+		Entry.SkidThreshold = FMath::Max(Response.SkidThreshold, 0.0f);
+		return Entry;
+	}
+}
+
+FSingularisSurfaceResponseTableRef FSingularisSurfaceResponseTable::Bake(const TConstArrayView<FSingularisSurfaceResponse> Responses,
+                                                                        const FSingularisSurfaceResponse& Default)
+{
+	const TSharedRef<FSingularisSurfaceResponseTable, ESPMode::ThreadSafe> Table = MakeShared<FSingularisSurfaceResponseTable, ESPMode::ThreadSafe>();
+
+	const FEntry DefaultEntry = SingularisSurfaceResponse::MakeEntry(Default);
+	for (FEntry& Entry : Table->Entries)
+	{
+		Entry = DefaultEntry;
+	}
+
+	for (const FSingularisSurfaceResponse& Response : Responses)
+	{
+		Table->Entries[Response.SurfaceType.GetValue() & (NumSurfaceTypes - 1)] = SingularisSurfaceResponse::MakeEntry(Response);
+	}
+
+	return Table;
+}
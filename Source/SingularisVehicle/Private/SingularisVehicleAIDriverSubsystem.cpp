@@ -0,0 +1,330 @@
+/* =====================================================================
+ * SingularisVehicleAIDriverSubsystem.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleAIDriverSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "BaseWheeledVehiclePawn.h"
+#include "ChaosWheeledVehicleMovementComponent.h"
+#include "SingularisVehicleStats.h"
+#include "Components/SplineComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("AI Driver Gather"), STAT_SingularisVehicle_AIDriverGather, STATGROUP_SingularisVehicle);
+DECLARE_CYCLE_STAT(TEXT("AI Driver Compute"), STAT_SingularisVehicle_AIDriverCompute, STATGROUP_SingularisVehicle);
+DECLARE_CYCLE_STAT(TEXT("AI Driver Write"), STAT_SingularisVehicle_AIDriverWrite, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI Driven Vehicles"), STAT_SingularisVehicle_AIDriven, STATGROUP_SingularisVehicle);
+
+namespace SingularisVehicleAIDriver
+{
+	static bool bForceSingleThread = false;
+	static FAutoConsoleVariableRef CVarForceSingleThread(
+		TEXT("SingularisVehicle.AIDriver.ForceSingleThread"),
+		bForceSingleThread,
+		TEXT("在游戏线程上串行计算 AI 驾驶，用于比较并行的收益。"));
+
+	static int32 MinBatchSize = 32;
+	static FAutoConsoleVariableRef CVarMinBatchSize(
+		TEXT("SingularisVehicle.AIDriver.MinBatchSize"),
+		MinBatchSize,
+		TEXT("ParallelFor 每个任务至少处理的载具数量。"));
+
+	/** 路径烘焙间距（厘米） */
+	static constexpr float PathSpacing = 200.0f;
+
+	/** 每帧重新投影到路径时的搜索范围（厘米） */
+	static constexpr float ProjectionSearchRadius = 2000.0f;
+}
+
+void USingularisVehicleAIDriverSubsystem::Deinitialize()
+{
+	Paths.Reset();
+	Vehicles.Reset();
+	PathIndices.Reset();
+	SpeedScales.Reset();
+	Distances.Reset();
+	Super::Deinitialize();
+}
+
+bool USingularisVehicleAIDriverSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId USingularisVehicleAIDriverSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USingularisVehicleAIDriverSubsystem, STATGROUP_Tickables);
+}
+
+int32 USingularisVehicleAIDriverSubsystem::RegisterPath(const USplineComponent* Spline, const float SpeedLimit)
+{
+	if (!Spline)
+	{
+		return INDEX_NONE;
+	}
+
+	FSingularisTrafficLane Path = FSingularisTrafficLane::FromSpline(*Spline, SpeedLimit, SingularisVehicleAIDriver::PathSpacing);
+	return Path.IsValid() ? Paths.Add(MoveTemp(Path)) : INDEX_NONE;
+}
+
+int32 USingularisVehicleAIDriverSubsystem::RegisterPathPoints(const TConstArrayView<FVector> Points, const bool bClosedLoop, const float SpeedLimit)
+{
+	FSingularisTrafficLane Path = FSingularisTrafficLane::FromPolyline(Points, bClosedLoop, SpeedLimit, SingularisVehicleAIDriver::PathSpacing);
+	return Path.IsValid() ? Paths.Add(MoveTemp(Path)) : INDEX_NONE;
+}
+
+void USingularisVehicleAIDriverSubsystem::AssignVehicle(ABaseWheeledVehiclePawn* Vehicle, const int32 PathIndex, const float SpeedScale)
+{
+	if (!Vehicle || !Paths.IsValidIndex(PathIndex))
+	{
+		return;
+	}
+
+	int32 Index = Vehicles.IndexOfByKey(Vehicle);
+	if (Index == INDEX_NONE)
+	{
+		Index = Vehicles.Add(Vehicle);
+		PathIndices.AddDefaulted();
+		SpeedScales.AddDefaulted();
+		Distances.AddDefaulted();
+	}
+
+	// 首次投影搜索整条路径
+	const FSingularisTrafficLane& Path = Paths[PathIndex];
+	PathIndices[Index] = PathIndex;
+	SpeedScales[Index] = FMath::Max(SpeedScale, 0.0f);
+	Distances[Index] = Path.FindDistanceClosestTo(Vehicle->GetActorLocation(), Path.Length * 0.5f, Path.Length);
+}
+
+void USingularisVehicleAIDriverSubsystem::ReleaseVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	const int32 Index = Vehicles.IndexOfByKey(Vehicle);
+	if (Index != INDEX_NONE)
+	{
+		Vehicles.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		PathIndices.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		SpeedScales.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		Distances.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	}
+}
+
+void USingularisVehicleAIDriverSubsystem::Tick(const float DeltaTime)
+{
+	DriveVehicles(DeltaTime);
+}
+
+void USingularisVehicleAIDriverSubsystem::DriveVehicles(const float DeltaTime)
+{
+	RemoveInvalidVehicles();
+
+	const int32 NumVehicles = Vehicles.Num();
+	LastTimings = FSingularisAIDriverTimings();
+	SET_DWORD_STAT(STAT_SingularisVehicle_AIDriven, NumVehicles);
+	if (NumVehicles == 0)
+	{
+		return;
+	}
+
+	// 第一步：在游戏线程上把载具状态收集到连续数组
+	double StartTime = FPlatformTime::Seconds();
+	{
+		SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_AIDriverGather);
+
+		Transforms.SetNumUninitialized(NumVehicles, EAllowShrinking::No);
+		ForwardSpeeds.SetNumUninitialized(NumVehicles, EAllowShrinking::No);
+		Active.SetNumUninitialized(NumVehicles, EAllowShrinking::No);
+		Obstacles.SetNumUninitialized(NumVehicles, EAllowShrinking::No);
+		Leaders.SetNumUninitialized(NumVehicles, EAllowShrinking::No);
+		LeaderGaps.SetNumUninitialized(NumVehicles, EAllowShrinking::No);
+		Controls.SetNumUninitialized(NumVehicles, EAllowShrinking::No);
+
+		for (int32 Index = 0; Index < NumVehicles; ++Index)
+		{
+			const ABaseWheeledVehiclePawn* Vehicle = Vehicles[Index].Get();
+			const UChaosWheeledVehicleMovementComponent* Movement = Vehicle->GetChaosVehicleMovement();
+			const bool bObstacle = !Vehicle->IsPooled();
+			const bool bActive = bObstacle && !Vehicle->IsPlayerControlled() && Movement->IsComponentTickEnabled();
+
+			Active[Index] = bActive;
+			Obstacles[Index] = bObstacle;
+			Transforms[Index] = Vehicle->GetActorTransform();
+			ForwardSpeeds[Index] = bActive ? Movement->GetForwardSpeed() : 0.0f;
+			LastTimings.NumDriven += bActive ? 1 : 0;
+		}
+	}
+	LastTimings.GatherSeconds = FPlatformTime::Seconds() - StartTime;
+
+	// 第二步：并行计算，只读写数组
+	StartTime = FPlatformTime::Seconds();
+	{
+		SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_AIDriverCompute);
+
+		const EParallelForFlags Flags = SingularisVehicleAIDriver::bForceSingleThread ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+		const int32 MinBatchSize = FMath::Max(SingularisVehicleAIDriver::MinBatchSize, 1);
+
+		// 并行部分只捕获数组视图与参数副本，不经由 this 访问子系统
+		const TConstArrayView<FSingularisTrafficLane> PathsView = Paths;
+		const TConstArrayView<int32> PathIndicesView = PathIndices;
+		const TConstArrayView<FTransform> TransformsView = Transforms;
+		const TConstArrayView<uint8> ObstaclesView = Obstacles;
+		const TArrayView<float> DistancesView = Distances;
+
+		// 投影到路径，跟车需要所有载具的最新进度
+		ParallelFor(
+			TEXT("SingularisVehicleAIDriver.Project"),
+			NumVehicles,
+			MinBatchSize,
+			[PathsView, PathIndicesView, TransformsView, ObstaclesView, DistancesView](const int32 Index)
+			{
+				if (ObstaclesView[Index])
+				{
+					const FSingularisTrafficLane& Path = PathsView[PathIndicesView[Index]];
+					DistancesView[Index] = Path.FindDistanceClosestTo(TransformsView[Index].GetLocation(),
+					                                                  DistancesView[Index],
+					                                                  SingularisVehicleAIDriver::ProjectionSearchRadius);
+				}
+			},
+			Flags);
+
+		FindLeaders();
+
+		const TConstArrayView<uint8> ActiveView = Active;
+		const TConstArrayView<float> SpeedScalesView = SpeedScales;
+		const TConstArrayView<float> ForwardSpeedsView = ForwardSpeeds;
+		const TConstArrayView<int32> LeadersView = Leaders;
+		const TConstArrayView<float> LeaderGapsView = LeaderGaps;
+		const TArrayView<FVehicleControlFrame> ControlsView = Controls;
+		const FSingularisTrafficDrivingParams Params = DrivingParams;
+		const float MinGap = MinFollowDistance;
+		const float TimeGap = FMath::Max(FollowTimeGap, 0.1f);
+
+		ParallelFor(
+			TEXT("SingularisVehicleAIDriver.Control"),
+			NumVehicles,
+			MinBatchSize,
+			[=](const int32 Index)
+			{
+				if (!ActiveView[Index])
+				{
+					return;
+				}
+
+				const FSingularisTrafficLane& Path = PathsView[PathIndicesView[Index]];
+				const bool bHasLeader = LeadersView[Index] != INDEX_NONE;
+
+				FSingularisTrafficLaneFragment PathState;
+				PathState.LaneIndex = PathIndicesView[Index];
+				PathState.Distance = DistancesView[Index];
+				PathState.TargetSpeed = Path.SpeedLimit * SpeedScalesView[Index];
+
+				// 前车制动：超出最小车距的部分按跟车时距换算为速度上限
+				if (bHasLeader)
+				{
+					const float SafeSpeed = FMath::Max(LeaderGapsView[Index] - MinGap, 0.0f) / TimeGap;
+					PathState.TargetSpeed = FMath::Min(PathState.TargetSpeed, SafeSpeed);
+				}
+
+				FSingularisTrafficControlFragment Control;
+				SingularisVehicleTraffic::ComputeFollowControl(Path, Params, PathState, TransformsView[Index], ForwardSpeedsView[Index], Control);
+
+				// 已经贴近前车时全力制动
+				if (bHasLeader && LeaderGapsView[Index] < MinGap)
+				{
+					Control.Throttle = 0.0f;
+					Control.Brake = 1.0f;
+				}
+
+				FVehicleControlFrame& Frame = ControlsView[Index];
+				Frame.Throttle = Control.Throttle;
+				Frame.Brake = Control.Brake;
+				Frame.Steering = Control.Steering;
+				Frame.bHandbrake = Control.bHandbrake;
+			},
+			Flags);
+	}
+	LastTimings.ComputeSeconds = FPlatformTime::Seconds() - StartTime;
+
+	// 第三步：提交控制帧，由控制子系统在同一次批处理中写入运动组件
+	StartTime = FPlatformTime::Seconds();
+	{
+		SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_AIDriverWrite);
+
+		for (int32 Index = 0; Index < NumVehicles; ++Index)
+		{
+			if (Active[Index])
+			{
+				Vehicles[Index]->SubmitControlFrame(Controls[Index]);
+			}
+		}
+	}
+	LastTimings.WriteSeconds = FPlatformTime::Seconds() - StartTime;
+}
+
+void USingularisVehicleAIDriverSubsystem::RemoveInvalidVehicles()
+{
+	for (int32 Index = Vehicles.Num() - 1; Index >= 0; --Index)
+	{
+		if (!Vehicles[Index].IsValid())
+		{
+			Vehicles.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			PathIndices.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			SpeedScales.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			Distances.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		}
+	}
+}
+
+void USingularisVehicleAIDriverSubsystem::FindLeaders()
+{
+	const int32 NumVehicles = Vehicles.Num();
+
+	SortedIndices.Reset();
+	for (int32 Index = 0; Index < NumVehicles; ++Index)
+	{
+		Leaders[Index] = INDEX_NONE;
+		LeaderGaps[Index] = 0.0f;
+
+		if (Obstacles[Index])
+		{
+			SortedIndices.Add(Index);
+		}
+	}
+
+	SortedIndices.Sort([this](const int32 A, const int32 B)
+	{
+		return PathIndices[A] != PathIndices[B] ? PathIndices[A] < PathIndices[B] : Distances[A] < Distances[B];
+	});
+
+	// 同一路径上进度更大的下一辆即为前车，闭合路径的最后一辆跟随第一辆
+	for (int32 Begin = 0; Begin < SortedIndices.Num();)
+	{
+		const int32 PathIndex = PathIndices[SortedIndices[Begin]];
+		int32 End = Begin + 1;
+		while (End < SortedIndices.Num() && PathIndices[SortedIndices[End]] == PathIndex)
+		{
+			++End;
+		}
+
+		const FSingularisTrafficLane& Path = Paths[PathIndex];
+		for (int32 Sorted = Begin; Sorted < End; ++Sorted)
+		{
+			const bool bLast = Sorted + 1 == End;
+			if (bLast && (!Path.bClosedLoop || End - Begin < 2))
+			{
+				continue;
+			}
+
+			const int32 Follower = SortedIndices[Sorted];
+			const int32 Leader = SortedIndices[bLast ? Begin : Sorted + 1];
+			Leaders[Follower] = Leader;
+			LeaderGaps[Follower] = bLast ? Distances[Leader] + Path.Length - Distances[Follower] : Distances[Leader] - Distances[Follower];
+		}
+
+		Begin = End;
+	}
+}
@@ -0,0 +1,86 @@
+/* =====================================================================
+ * SingularisVehicleCameraRig.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleCameraRig.h"
+
+#include "Camera/CameraComponent.h"
+#include "GameFramework/SpringArmComponent.h"
+
+ASingularisVehicleCameraRig::ASingularisVehicleCameraRig()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+	// 构造前置摄像头和弹簧臂
+	FrontSpringArm = CreateDefaultSubobject<USpringArmComponent>(TEXT("Front Spring Arm"));
+	FrontSpringArm->SetupAttachment(RootComponent);
+	ConfigureFrontSpringArm(FrontSpringArm);
+
+	FrontCamera = CreateDefaultSubobject<UCameraComponent>(TEXT("Front Camera"));
+	FrontCamera->SetupAttachment(FrontSpringArm);
+	FrontCamera->bAutoActivate = false;
+
+	// 构造后置摄像头和弹簧臂
+	BackSpringArm = CreateDefaultSubobject<USpringArmComponent>(TEXT("Back Spring Arm"));
+	BackSpringArm->SetupAttachment(RootComponent);
+	ConfigureBackSpringArm(BackSpringArm);
+
+	BackCamera = CreateDefaultSubobject<UCameraComponent>(TEXT("Back Camera"));
+	BackCamera->SetupAttachment(BackSpringArm);
+
+	// 未附加时不需要任何更新
+	FrontSpringArm->PrimaryComponentTick.bStartWithTickEnabled = false;
+	BackSpringArm->PrimaryComponentTick.bStartWithTickEnabled = false;
+	SetActorHiddenInGame(true);
+}
+
+void ASingularisVehicleCameraRig::AttachToVehicle(USceneComponent* VehicleMesh)
+{
+	AttachToComponent(VehicleMesh, FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+
+	// 重置环顾角度，避免沿用上一辆载具的朝向
+	BackSpringArm->SetRelativeRotation(FRotator::ZeroRotator);
+
+	FrontSpringArm->SetComponentTickEnabled(true);
+	BackSpringArm->SetComponentTickEnabled(true);
+	SetActorHiddenInGame(false);
+}
+
+void ASingularisVehicleCameraRig::DetachFromVehicle()
+{
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+
+	FrontSpringArm->SetComponentTickEnabled(false);
+	BackSpringArm->SetComponentTickEnabled(false);
+	FrontCamera->SetActive(false);
+	BackCamera->SetActive(false);
+	SetActorHiddenInGame(true);
+}
+
+void ASingularisVehicleCameraRig::ConfigureFrontSpringArm(USpringArmComponent* SpringArm)
+{
+	SpringArm->TargetArmLength = 0.0f;
+	SpringArm->bDoCollisionTest = false;
+	SpringArm->bEnableCameraRotationLag = true;
+	SpringArm->CameraRotationLagSpeed = 15.0f;
+	SpringArm->SetRelativeLocation(FVector(30.0f, 0.0f, 120.0f));
+}
+
+void ASingularisVehicleCameraRig::ConfigureBackSpringArm(USpringArmComponent* SpringArm)
+{
+	SpringArm->TargetArmLength = 650.0f;
+	SpringArm->SocketOffset.Z = 150.0f;
+	SpringArm->bDoCollisionTest = false;
+	SpringArm->bInheritPitch = false;
+	SpringArm->bInheritRoll = false;
+	SpringArm->bEnableCameraRotationLag = true;
+	SpringArm->CameraRotationLagSpeed = 2.0f;
+	SpringArm->CameraLagMaxDistance = 50.0f;
+}
@@ -0,0 +1,92 @@
+/* =====================================================================
+ * SingularisVehicleCameraRigSubsystem.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleCameraRigSubsystem.h"
+
+#include "BaseWheeledVehiclePawn.h"
+#include "SingularisVehicleCameraRig.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+void USingularisVehicleCameraRigSubsystem::Deinitialize()
+{
+	Rigs.Reset();
+	Super::Deinitialize();
+}
+
+bool USingularisVehicleCameraRigSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	// 专用服务器没有本地玩家，不需要相机组
+	if (!SINGULARISVEHICLE_WITH_COSMETICS || IsRunningDedicatedServer())
+	{
+		return false;
+	}
+
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+ASingularisVehicleCameraRig* USingularisVehicleCameraRigSubsystem::AcquireRig(const APlayerController* PlayerController, ABaseWheeledVehiclePawn* Vehicle)
+{
+	if (!PlayerController || !Vehicle)
+	{
+		return nullptr;
+	}
+
+	// 清理已失效的玩家控制器
+	Rigs.RemoveAllSwap([](const FRigEntry& Entry)
+	{
+		if (!Entry.PlayerController.IsValid() && Entry.Rig.IsValid())
+		{
+			Entry.Rig->Destroy();
+		}
+		return !Entry.PlayerController.IsValid() || !Entry.Rig.IsValid();
+	});
+
+	FRigEntry* Entry = Rigs.FindByPredicate([PlayerController](const FRigEntry& Candidate) { return Candidate.PlayerController == PlayerController; });
+	if (!Entry)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.Owner = const_cast<APlayerController*>(PlayerController);
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParameters.ObjectFlags |= RF_Transient;
+
+		ASingularisVehicleCameraRig* Rig = GetWorld()->SpawnActor<ASingularisVehicleCameraRig>(Vehicle->GetActorTransform(), SpawnParameters);
+		if (!Rig)
+		{
+			return nullptr;
+		}
+
+		Entry = &Rigs.Add_GetRef({PlayerController, Rig, nullptr});
+	}
+
+	// 相机组只能跟随一辆载具
+	if (ABaseWheeledVehiclePawn* PreviousVehicle = Entry->Vehicle.Get(); PreviousVehicle && PreviousVehicle != Vehicle)
+	{
+		PreviousVehicle->ReleaseCameraRig();
+	}
+
+	Entry->Vehicle = Vehicle;
+	Entry->Rig->AttachToVehicle(Vehicle->GetMesh());
+	return Entry->Rig.Get();
+}
+
+void USingularisVehicleCameraRigSubsystem::ReleaseRig(const ABaseWheeledVehiclePawn* Vehicle)
+{
+	for (FRigEntry& Entry : Rigs)
+	{
+		if (Entry.Vehicle == Vehicle)
+		{
+			Entry.Vehicle.Reset();
+			if (Entry.Rig.IsValid())
+			{
+				Entry.Rig->DetachFromVehicle();
+			}
+		}
+	}
+}
@@ -0,0 +1,306 @@
+/* =====================================================================
+ * SingularisVehicleContactSubsystem.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleContactSubsystem.h"
+
+#include "BaseWheeledVehiclePawn.h"
+#include "EventManager.h"
+#include "EventsData.h"
+#include "PBDRigidsSolver.h"
+#include "SingularisVehicleStats.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+
+DECLARE_CYCLE_STAT(TEXT("Contact Aggregation"), STAT_SingularisVehicle_ContactAggregation, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Raw Contacts"), STAT_SingularisVehicle_RawContacts, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Contacts Reported"), STAT_SingularisVehicle_ContactsReported, STATGROUP_SingularisVehicle);
+
+namespace SingularisVehicleContact
+{
+	static bool bEnable = true;
+	static FAutoConsoleVariableRef CVarEnable(
+		TEXT("SingularisVehicle.Contact.Enable"),
+		bEnable,
+		TEXT("收集并合并登记载具的车身接触。"));
+
+	static float MinImpulse = 20000.0f;
+	static FAutoConsoleVariableRef CVarMinImpulse(
+		TEXT("SingularisVehicle.Contact.MinImpulse"),
+		MinImpulse,
+		TEXT("峰值冲量（千克·厘米/秒）达到该值时才报告接触开始，更轻的擦碰不报告。"));
+
+	static float SustainedInterval = 0.25f;
+	static FAutoConsoleVariableRef CVarSustainedInterval(
+		TEXT("SingularisVehicle.Contact.SustainedInterval"),
+		SustainedInterval,
+		TEXT("持续接触每隔多少秒报告一次。"));
+
+	static float EndDelay = 0.1f;
+	static FAutoConsoleVariableRef CVarEndDelay(
+		TEXT("SingularisVehicle.Contact.EndDelay"),
+		EndDelay,
+		TEXT("多少秒未再接触后报告接触结束，避免刮擦时反复开始与结束。"));
+}
+
+void USingularisVehicleContactSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	FPhysScene* PhysScene = InWorld.GetPhysicsScene();
+	Solver = PhysScene ? PhysScene->GetSolver() : nullptr;
+	if (Solver)
+	{
+		// 求解器为整个场景生成碰撞数据，这里只读取登记载具的部分，车身不需要开启逐次命中事件
+		bSolverGeneratedCollisionData = Solver->GetEventFilters()->IsCollisionEventEnabled();
+		Solver->SetGenerateCollisionData(true);
+		Solver->GetEventManager()->RegisterHandler<Chaos::FCollisionEventData>(Chaos::EEventType::Collision,
+		                                                                     this,
+		                                                                     &USingularisVehicleContactSubsystem::HandleCollisionEvents);
+	}
+}
+
+void USingularisVehicleContactSubsystem::Deinitialize()
+{
+	UnregisterCollisionEvents();
+	ActiveContacts.Reset();
+	Vehicles.Reset();
+	Super::Deinitialize();
+}
+
+bool USingularisVehicleContactSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId USingularisVehicleContactSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USingularisVehicleContactSubsystem, STATGROUP_Tickables);
+}
+
+void USingularisVehicleContactSubsystem::UnregisterCollisionEvents()
+{
+	if (Solver)
+	{
+		Solver->GetEventManager()->UnregisterHandler(Chaos::EEventType::Collision, this);
+		Solver->SetGenerateCollisionData(bSolverGeneratedCollisionData);
+		Solver = nullptr;
+	}
+}
+
+void USingularisVehicleContactSubsystem::RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	if (Vehicle)
+	{
+		Vehicles.AddUnique(Vehicle);
+	}
+}
+
+void USingularisVehicleContactSubsystem::UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	const int32 Index = Vehicles.IndexOfByKey(Vehicle);
+	if (Index != INDEX_NONE)
+	{
+		Vehicles.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	}
+}
+
+void USingularisVehicleContactSubsystem::HandleCollisionEvents(const Chaos::FCollisionEventData& CollisionData)
+{
+	FPhysScene* PhysScene = GetWorld()->GetPhysicsScene();
+	if (!SingularisVehicleContact::bEnable || Vehicles.IsEmpty() || !PhysScene)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_ContactAggregation);
+	const double StartTime = FPlatformTime::Seconds();
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// 物理状态重建后代理会变化，每次按当前的车身代理查找
+	TMap<const IPhysicsProxyBase*, ABaseWheeledVehiclePawn*, TInlineSetAllocator<64>> ProxyToVehicle;
+	for (const TWeakObjectPtr<ABaseWheeledVehiclePawn>& WeakVehicle : Vehicles)
+	{
+		ABaseWheeledVehiclePawn* Vehicle = WeakVehicle.Get();
+		const FBodyInstance* BodyInstance = Vehicle ? Vehicle->GetMesh()->GetBodyInstance() : nullptr;
+		if (BodyInstance && BodyInstance->GetPhysicsActorHandle())
+		{
+			ProxyToVehicle.Add(BodyInstance->GetPhysicsActorHandle(), Vehicle);
+		}
+	}
+
+	const Chaos::FCollisionDataArray& AllCollisions = CollisionData.CollisionData.AllCollisionsArray;
+	const TMap<IPhysicsProxyBase*, TArray<int32>>& ProxyToIndices = CollisionData.PhysicsProxyToCollisionIndices.PhysicsProxyToIndicesMap;
+
+	for (const TPair<const IPhysicsProxyBase*, ABaseWheeledVehiclePawn*>& VehiclePair : ProxyToVehicle)
+	{
+		const TArray<int32>* EncodedIndices = ProxyToIndices.Find(const_cast<IPhysicsProxyBase*>(VehiclePair.Key));
+		if (!EncodedIndices)
+		{
+			continue;
+		}
+
+		ABaseWheeledVehiclePawn* Vehicle = VehiclePair.Value;
+		for (const int32 EncodedIndex : *EncodedIndices)
+		{
+			bool bSwapOrder = false;
+			const int32 CollisionIndex = Chaos::FEventManager::DecodeCollisionIndex(EncodedIndex, bSwapOrder);
+			if (!AllCollisions.IsValidIndex(CollisionIndex))
+			{
+				continue;
+			}
+
+			const Chaos::FCollidingData& Data = AllCollisions[CollisionIndex];
+			IPhysicsProxyBase* OtherProxy = bSwapOrder ? Data.Proxy1 : Data.Proxy2;
+
+			// 两辆登记载具之间的接触在双方的列表中各出现一次，只由地址较小的一方记录
+			ABaseWheeledVehiclePawn* OtherVehicle = ProxyToVehicle.FindRef(OtherProxy);
+			if (OtherVehicle && OtherVehicle < Vehicle)
+			{
+				continue;
+			}
+
+			UPrimitiveComponent* OtherComponent = OtherVehicle ? OtherVehicle->GetMesh() : PhysScene->GetOwningComponent<UPrimitiveComponent>(OtherProxy);
+			if (!OtherComponent)
+			{
+				continue;
+			}
+
+			FActiveContact* Contact = ActiveContacts.Find(FContactKey(Vehicle, OtherComponent));
+			if (!Contact)
+			{
+				Contact = &ActiveContacts.Add(FContactKey(Vehicle, OtherComponent));
+				Contact->Vehicle = Vehicle;
+				Contact->OtherComponent = OtherComponent;
+				Contact->bOtherIsVehicle = OtherVehicle != nullptr;
+				Contact->StartTime = Now;
+
+				const FBodyInstance* OtherBody = OtherComponent->GetBodyInstance();
+				const UPhysicalMaterial* OtherMaterial = OtherBody ? OtherBody->GetSimplePhysicalMaterial() : nullptr;
+				Contact->SurfaceType = OtherMaterial ? OtherMaterial->SurfaceType.GetValue() : SurfaceType_Default;
+			}
+
+			const float Impulse = static_cast<float>(Data.AccumulatedImpulse.Size());
+			if (Contact->NumContacts == 0 || Impulse > Contact->PeakImpulse)
+			{
+				Contact->PeakImpulse = Impulse;
+				Contact->Location = Data.Location;
+				Contact->Normal = bSwapOrder ? -Data.Normal : Data.Normal;
+			}
+			Contact->TotalPeakImpulse = FMath::Max(Contact->TotalPeakImpulse, Impulse);
+			Contact->LastSeenTime = Now;
+			Contact->bSeenThisFrame = true;
+			++Contact->NumContacts;
+			++PendingNumRawContacts;
+		}
+	}
+
+	PendingProcessSeconds += FPlatformTime::Seconds() - StartTime;
+}
+
+void USingularisVehicleContactSubsystem::Tick(const float DeltaTime)
+{
+	FlushContacts();
+}
+
+void USingularisVehicleContactSubsystem::FlushContacts()
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_ContactAggregation);
+	const double StartTime = FPlatformTime::Seconds();
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	Batch.Reset();
+	for (auto It = ActiveContacts.CreateIterator(); It; ++It)
+	{
+		FActiveContact& Contact = It.Value();
+		ABaseWheeledVehiclePawn* Vehicle = Contact.Vehicle.Get();
+		UPrimitiveComponent* OtherComponent = Contact.OtherComponent.Get();
+		if (!Vehicle || !OtherComponent)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		// 未达到阈值的接触不报告开始；持续接触按间隔报告；一段时间未再接触后结束
+		ESingularisVehicleContactPhase Phase;
+		if (Contact.bSeenThisFrame && !Contact.bBegan)
+		{
+			if (Contact.PeakImpulse < SingularisVehicleContact::MinImpulse)
+			{
+				Contact.bSeenThisFrame = false;
+				Contact.NumContacts = 0;
+				continue;
+			}
+			Phase = ESingularisVehicleContactPhase::Began;
+			Contact.bBegan = true;
+		}
+		else if (Contact.bSeenThisFrame && Contact.NumContacts > 0 && Now - Contact.LastReportTime >= SingularisVehicleContact::SustainedInterval)
+		{
+			Phase = ESingularisVehicleContactPhase::Sustained;
+		}
+		else if (!Contact.bSeenThisFrame && Now - Contact.LastSeenTime > SingularisVehicleContact::EndDelay)
+		{
+			if (Contact.bBegan)
+			{
+				FSingularisVehicleContact& Ended = Batch.AddDefaulted_GetRef();
+				Ended.Vehicle = Vehicle;
+				Ended.OtherActor = OtherComponent->GetOwner();
+				Ended.OtherComponent = OtherComponent;
+				Ended.bOtherIsVehicle = Contact.bOtherIsVehicle;
+				Ended.Phase = ESingularisVehicleContactPhase::Ended;
+				Ended.Location = Contact.Location;
+				Ended.Normal = Contact.Normal;
+				Ended.PeakImpulse = Contact.TotalPeakImpulse;
+				Ended.Duration = static_cast<float>(Contact.LastSeenTime - Contact.StartTime);
+				Ended.SurfaceType = Contact.SurfaceType;
+			}
+			It.RemoveCurrent();
+			continue;
+		}
+		else
+		{
+			Contact.bSeenThisFrame = false;
+			continue;
+		}
+
+		FSingularisVehicleContact& Report = Batch.AddDefaulted_GetRef();
+		Report.Vehicle = Vehicle;
+		Report.OtherActor = OtherComponent->GetOwner();
+		Report.OtherComponent = OtherComponent;
+		Report.bOtherIsVehicle = Contact.bOtherIsVehicle;
+		Report.Phase = Phase;
+		Report.Location = Contact.Location;
+		Report.Normal = Contact.Normal;
+		Report.PeakImpulse = Contact.PeakImpulse;
+		Report.Duration = static_cast<float>(Now - Contact.StartTime);
+		Report.NumContacts = Contact.NumContacts;
+		Report.SurfaceType = Contact.SurfaceType;
+
+		Contact.LastReportTime = Now;
+		Contact.PeakImpulse = 0.0f;
+		Contact.NumContacts = 0;
+		Contact.bSeenThisFrame = false;
+	}
+
+	LastNumRawContacts = PendingNumRawContacts;
+	LastNumReported = Batch.Num();
+	LastProcessSeconds = PendingProcessSeconds + (FPlatformTime::Seconds() - StartTime);
+	PendingNumRawContacts = 0;
+	PendingProcessSeconds = 0.0;
+
+	SET_DWORD_STAT(STAT_SingularisVehicle_RawContacts, LastNumRawContacts);
+	SET_DWORD_STAT(STAT_SingularisVehicle_ContactsReported, LastNumReported);
+
+	if (!Batch.IsEmpty())
+	{
+		OnContactBatch.Broadcast(Batch);
+		OnContacts.Broadcast(Batch);
+	}
+}
@@ -0,0 +1,246 @@
+/* =====================================================================
+ * SingularisVehicleControlSubsystem.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleControlSubsystem.h"
+
+#include "BaseWheeledVehiclePawn.h"
+#include "ChaosWheeledVehicleMovementComponent.h"
+#include "SingularisVehicleStats.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("Control Apply"), STAT_SingularisVehicle_ControlApply, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Control Frames"), STAT_SingularisVehicle_ControlFrames, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Control Frames Changed"), STAT_SingularisVehicle_ControlFramesChanged, STATGROUP_SingularisVehicle);
+
+void FSingularisVehicleControlTickFunction::ExecuteTick(const float DeltaTime,
+                                                        ELevelTick TickType,
+                                                        ENamedThreads::Type CurrentThread,
+                                                        const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target)
+	{
+		Target->ApplyControlFrames(DeltaTime);
+	}
+}
+
+FString FSingularisVehicleControlTickFunction::DiagnosticMessage()
+{
+	return TEXT("USingularisVehicleControlSubsystem::ApplyControlFrames");
+}
+
+FName FSingularisVehicleControlTickFunction::DiagnosticContext(bool bDetailed)
+{
+	return TEXT("SingularisVehicleControl");
+}
+
+void USingularisVehicleControlSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	ControlTickFunction.Target = this;
+	ControlTickFunction.TickGroup = TG_PrePhysics;
+	ControlTickFunction.bCanEverTick = true;
+	ControlTickFunction.bStartWithTickEnabled = true;
+	ControlTickFunction.bHighPriority = true;
+	ControlTickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+}
+
+void USingularisVehicleControlSubsystem::Deinitialize()
+{
+	if (ControlTickFunction.IsTickFunctionRegistered())
+	{
+		ControlTickFunction.UnRegisterTickFunction();
+	}
+	ControlTickFunction.Target = nullptr;
+
+	Vehicles.Reset();
+	Sources.Reset();
+	PendingFrames.Reset();
+	AppliedFrames.Reset();
+	PrerequisiteControllers.Reset();
+
+	Super::Deinitialize();
+}
+
+bool USingularisVehicleControlSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USingularisVehicleControlSubsystem::RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	if (!Vehicle || FindSlot(Vehicle) != INDEX_NONE)
+	{
+		return;
+	}
+
+	const int32 Slot = Vehicles.Add(Vehicle);
+	Sources.AddDefaulted();
+	PendingFrames.AddDefaulted();
+	AppliedFrames.AddDefaulted();
+	PrerequisiteControllers.AddDefaulted();
+	Vehicle->SetControlSlot(Slot);
+
+	// 运动组件在批处理之后才读取输入
+	Vehicle->GetChaosVehicleMovement()->PrimaryComponentTick.AddPrerequisite(this, ControlTickFunction);
+
+	RefreshControlSource(Vehicle);
+}
+
+void USingularisVehicleControlSubsystem::UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	const int32 Slot = FindSlot(Vehicle);
+	if (Slot == INDEX_NONE)
+	{
+		return;
+	}
+
+	Vehicle->GetChaosVehicleMovement()->PrimaryComponentTick.RemovePrerequisite(this, ControlTickFunction);
+	SetPrerequisiteController(Slot, nullptr);
+	Vehicle->SetControlSlot(INDEX_NONE);
+	RemoveSlot(Slot);
+}
+
+void USingularisVehicleControlSubsystem::RefreshControlSource(ABaseWheeledVehiclePawn* Vehicle)
+{
+	const int32 Slot = FindSlot(Vehicle);
+	if (Slot == INDEX_NONE)
+	{
+		return;
+	}
+
+	AController* Controller = Vehicle->GetController();
+
+	Sources[Slot] = Cast<ISingularisVehicleControlSource>(Controller);
+
+	// 本地玩家的输入在控制器 Tick 中处理，批处理需要排在其后，否则输入会晚一帧生效
+	APlayerController* PlayerController = Cast<APlayerController>(Controller);
+	SetPrerequisiteController(Slot, PlayerController && PlayerController->IsLocalController() ? PlayerController : nullptr);
+}
+
+void USingularisVehicleControlSubsystem::SetPrerequisiteController(const int32 Slot, APlayerController* PlayerController)
+{
+	APlayerController* PreviousController = PrerequisiteControllers[Slot].Get();
+	if (PreviousController == PlayerController)
+	{
+		return;
+	}
+
+	PrerequisiteControllers[Slot] = PlayerController;
+
+	// 同一个控制器可能仍是其他载具的前置，例如换车时新载具先于旧载具刷新
+	if (PreviousController && !PrerequisiteControllers.Contains(PreviousController))
+	{
+		ControlTickFunction.RemovePrerequisite(PreviousController, PreviousController->PrimaryActorTick);
+	}
+
+	if (PlayerController)
+	{
+		ControlTickFunction.AddPrerequisite(PlayerController, PlayerController->PrimaryActorTick);
+	}
+}
+
+bool USingularisVehicleControlSubsystem::SubmitControlFrame(const ABaseWheeledVehiclePawn* Vehicle, const FVehicleControlFrame& Frame)
+{
+	const int32 Slot = FindSlot(Vehicle);
+	if (Slot == INDEX_NONE)
+	{
+		return false;
+	}
+
+	PendingFrames[Slot] = Frame;
+	return true;
+}
+
+const FVehicleControlFrame* USingularisVehicleControlSubsystem::FindControlFrame(const ABaseWheeledVehiclePawn* Vehicle) const
+{
+	const int32 Slot = FindSlot(Vehicle);
+	return Slot != INDEX_NONE ? &PendingFrames[Slot] : nullptr;
+}
+
+void USingularisVehicleControlSubsystem::ResetControlFrame(const ABaseWheeledVehiclePawn* Vehicle)
+{
+	const int32 Slot = FindSlot(Vehicle);
+	if (Slot != INDEX_NONE)
+	{
+		PendingFrames[Slot] = FVehicleControlFrame();
+		AppliedFrames[Slot] = FVehicleControlFrame();
+	}
+}
+
+void USingularisVehicleControlSubsystem::ApplyControlFrames(const float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_ControlApply);
+
+	// 第一遍：向控制来源索取控制帧
+	for (int32 Slot = 0; Slot < Sources.Num(); ++Slot)
+	{
+		if (ISingularisVehicleControlSource* Source = Sources[Slot].Get())
+		{
+			if (const ABaseWheeledVehiclePawn* Vehicle = Vehicles[Slot].Get())
+			{
+				Source->FillControlFrame(*Vehicle, DeltaTime, PendingFrames[Slot]);
+			}
+		}
+	}
+
+	// 输入平滑、录制等在写入之前统一处理
+	OnPreApplyControlFrames.Broadcast(Vehicles, PendingFrames, DeltaTime);
+
+	// 第二遍：只访问控制帧有变化的载具
+	int32 NumChanged = 0;
+	for (int32 Slot = 0; Slot < PendingFrames.Num(); ++Slot)
+	{
+		const FVehicleControlFrame& Frame = PendingFrames[Slot];
+		if (Frame == AppliedFrames[Slot])
+		{
+			continue;
+		}
+
+		if (ABaseWheeledVehiclePawn* Vehicle = Vehicles[Slot].Get())
+		{
+			Vehicle->ApplyControlFrame(Frame, &AppliedFrames[Slot]);
+			AppliedFrames[Slot] = Frame;
+			++NumChanged;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_SingularisVehicle_ControlFrames, PendingFrames.Num());
+	SET_DWORD_STAT(STAT_SingularisVehicle_ControlFramesChanged, NumChanged);
+}
+
+int32 USingularisVehicleControlSubsystem::FindSlot(const ABaseWheeledVehiclePawn* Vehicle) const
+{
+	if (!Vehicle)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 Slot = Vehicle->GetControlSlot();
+	return Vehicles.IsValidIndex(Slot) && Vehicles[Slot].Get() == Vehicle ? Slot : INDEX_NONE;
+}
+
+void USingularisVehicleControlSubsystem::RemoveSlot(const int32 Slot)
+{
+	Vehicles.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	Sources.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	PendingFrames.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	AppliedFrames.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	PrerequisiteControllers.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+
+	// 被移入空位的载具更新槽位
+	if (Vehicles.IsValidIndex(Slot))
+	{
+		if (ABaseWheeledVehiclePawn* MovedVehicle = Vehicles[Slot].Get())
+		{
+			MovedVehicle->SetControlSlot(Slot);
+		}
+	}
+}
@@ -0,0 +1,271 @@
+/* =====================================================================
+ * SingularisVehicleGroundContact.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleGroundContact.h"
+
+#include "Engine/HitResult.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+namespace SingularisVehicleGroundContact
+{
+	/** 射线方向的竖直分量至少占长度的比例，更倾斜的射线交还场景查询 */
+	static constexpr double MinVerticalFraction = 0.7;
+
+	/** 求交时的夹逼迭代次数与收敛容差（厘米） */
+	static constexpr int32 MaxRefineIterations = 4;
+	static constexpr double RefineTolerance = 0.05;
+}
+
+bool FSingularisGroundTile::Sample(const FVector2D& Location, float& OutHeight, FVector3f& OutNormal, uint8& OutPalette) const
+{
+	if (NumSamples < 2)
+	{
+		return false;
+	}
+
+	const double LocalX = (Location.X - Origin.X) / Spacing;
+	const double LocalY = (Location.Y - Origin.Y) / Spacing;
+	const int32 LastCell = NumSamples - 2;
+	if (LocalX < 0.0 || LocalY < 0.0 || LocalX > LastCell + 1 || LocalY > LastCell + 1)
+	{
+		return false;
+	}
+
+	// 恰好落在远端边界上时归入最后一个单元
+	const int32 CellX = FMath::Min(FMath::FloorToInt32(LocalX), LastCell);
+	const int32 CellY = FMath::Min(FMath::FloorToInt32(LocalY), LastCell);
+	if (!UsableCells[CellY * (NumSamples - 1) + CellX])
+	{
+		return false;
+	}
+
+	const float FracX = static_cast<float>(LocalX - CellX);
+	const float FracY = static_cast<float>(LocalY - CellY);
+
+	const int32 Index00 = CellY * NumSamples + CellX;
+	const float H00 = Heights[Index00];
+	const float H10 = Heights[Index00 + 1];
+	const float H01 = Heights[Index00 + NumSamples];
+	const float H11 = Heights[Index00 + NumSamples + 1];
+
+	OutHeight = FMath::Lerp(FMath::Lerp(H00, H10, FracX), FMath::Lerp(H01, H11, FracX), FracY);
+
+	const float SlopeX = FMath::Lerp(H10 - H00, H11 - H01, FracY) / Spacing;
+	const float SlopeY = FMath::Lerp(H01 - H00, H11 - H10, FracX) / Spacing;
+	OutNormal = FVector3f(-SlopeX, -SlopeY, 1.0f).GetUnsafeNormal();
+
+	// 物理材质取最近的采样点
+	OutPalette = SamplePalette[Index00 + (FracX >= 0.5f ? 1 : 0) + (FracY >= 0.5f ? NumSamples : 0)];
+	return true;
+}
+
+FSingularisGroundContactProvider::FSingularisGroundContactProvider(const float InTileSize)
+	: TileSize(FMath::Max(InTileSize, 100.0f))
+{
+}
+
+bool FSingularisGroundContactProvider::TraceWheels(const TConstArrayView<Chaos::FSuspensionTrace> Traces, const TArrayView<FHitResult> OutHits) const
+{
+	if (OutHits.Num() < Traces.Num())
+	{
+		return false;
+	}
+
+	FReadScopeLock ReadLock(TilesLock);
+	for (int32 WheelIndex = 0; WheelIndex < Traces.Num(); ++WheelIndex)
+	{
+		if (!TraceWheelLocked(Traces[WheelIndex].Start, Traces[WheelIndex].End, OutHits[WheelIndex]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FSingularisGroundContactProvider::SampleLocked(const FVector2D& Location,
+                                                    float& OutHeight,
+                                                    FVector3f& OutNormal,
+                                                    const FSingularisGroundTile*& OutTile,
+                                                    uint8& OutPalette) const
+{
+	const TSharedRef<const FSingularisGroundTile, ESPMode::ThreadSafe>* Tile = Tiles.Find(GetTileKey(Location));
+	if (!Tile || !(*Tile)->Sample(Location, OutHeight, OutNormal, OutPalette))
+	{
+		return false;
+	}
+
+	OutTile = &Tile->Get();
+	return true;
+}
+
+bool FSingularisGroundContactProvider::TraceWheelLocked(const FVector& Start, const FVector& End, FHitResult& OutHit) const
+{
+	using namespace SingularisVehicleGroundContact;
+
+	const FVector Delta = End - Start;
+	const double Length = Delta.Size();
+	if (Length <= UE_KINDA_SMALL_NUMBER || -Delta.Z < MinVerticalFraction * Length)
+	{
+		return false;
+	}
+
+	float Height;
+	FVector3f Normal;
+	const FSingularisGroundTile* Tile;
+	uint8 Palette;
+
+	// 起点已在地面以下时场景查询的结果取决于高度场的朝向，不做近似
+	if (!SampleLocked(FVector2D(Start), Height, Normal, Tile, Palette) || Start.Z < Height)
+	{
+		return false;
+	}
+	double LowT = 0.0;
+	double LowAbove = Start.Z - Height;
+
+	if (!SampleLocked(FVector2D(End), Height, Normal, Tile, Palette))
+	{
+		return false;
+	}
+	double HighT = 1.0;
+	double HighAbove = End.Z - Height;
+
+	OutHit = FHitResult(Start, End);
+	if (HighAbove > 0.0)
+	{
+		// 终点仍在地面以上，没有接触
+		return true;
+	}
+
+	// 射线近似竖直，高度沿射线变化平缓，用试位法在起点与终点之间夹逼交点
+	double HitT = LowAbove / (LowAbove - HighAbove);
+	FVector HitPoint = Start + Delta * HitT;
+	for (int32 Iteration = 0; Iteration < MaxRefineIterations; ++Iteration)
+	{
+		if (!SampleLocked(FVector2D(HitPoint), Height, Normal, Tile, Palette))
+		{
+			return false;
+		}
+
+		const double Above = HitPoint.Z - Height;
+		if (FMath::Abs(Above) <= RefineTolerance)
+		{
+			break;
+		}
+
+		if (Above > 0.0)
+		{
+			LowT = HitT;
+			LowAbove = Above;
+		}
+		else
+		{
+			HighT = HitT;
+			HighAbove = Above;
+		}
+
+		HitT = LowT + (HighT - LowT) * LowAbove / (LowAbove - HighAbove);
+		HitPoint = Start + Delta * HitT;
+	}
+
+	if (!SampleLocked(FVector2D(HitPoint), Height, Normal, Tile, Palette))
+	{
+		return false;
+	}
+
+	OutHit.bBlockingHit = true;
+	OutHit.Time = static_cast<float>(HitT);
+	OutHit.Distance = static_cast<float>(HitT * Length);
+	OutHit.Location = HitPoint;
+	OutHit.ImpactPoint = HitPoint;
+	OutHit.Normal = FVector(Normal);
+	OutHit.ImpactNormal = OutHit.Normal;
+
+	if (Tile->Palette.IsValidIndex(Palette))
+	{
+		const FSingularisGroundTile::FPaletteEntry& Entry = Tile->Palette[Palette];
+		OutHit.Component = Entry.Component;
+		OutHit.PhysMaterial = Entry.PhysMaterial;
+	}
+
+	return true;
+}
+
+void FSingularisGroundContactProvider::SetTile(const FIntPoint& Key, TSharedRef<const FSingularisGroundTile, ESPMode::ThreadSafe> Tile)
+{
+	FWriteScopeLock WriteLock(TilesLock);
+	Tiles.Add(Key, MoveTemp(Tile));
+}
+
+void FSingularisGroundContactProvider::RemoveTile(const FIntPoint& Key)
+{
+	FWriteScopeLock WriteLock(TilesLock);
+	Tiles.Remove(Key);
+}
+
+bool FSingularisGroundContactProvider::HasTile(const FIntPoint& Key) const
+{
+	FReadScopeLock ReadLock(TilesLock);
+	return Tiles.Contains(Key);
+}
+
+int32 FSingularisGroundContactProvider::GetNumTiles() const
+{
+	FReadScopeLock ReadLock(TilesLock);
+	return Tiles.Num();
+}
+
+void FSingularisGroundContactProvider::AddTraceStats(const bool bAnalytic, const int32 NumWheels, const double Seconds)
+{
+	FScopeLock Lock(&StatsLock);
+	if (bAnalytic)
+	{
+		Stats.NumAnalyticWheels += NumWheels;
+		Stats.AnalyticSeconds += Seconds;
+	}
+	else
+	{
+		Stats.NumFallbackWheels += NumWheels;
+		Stats.FallbackSeconds += Seconds;
+	}
+}
+
+void FSingularisGroundContactProvider::AddValidationSample(const FHitResult& SceneHit, const FHitResult& AnalyticHit)
+{
+	FScopeLock Lock(&StatsLock);
+	++Stats.NumCompared;
+
+	if (SceneHit.bBlockingHit != AnalyticHit.bBlockingHit)
+	{
+		++Stats.NumHitMismatches;
+		return;
+	}
+
+	if (SceneHit.bBlockingHit)
+	{
+		const double HeightError = FMath::Abs(SceneHit.ImpactPoint.Z - AnalyticHit.ImpactPoint.Z);
+		const double CosAngle = FMath::Clamp(SceneHit.ImpactNormal | AnalyticHit.ImpactNormal, -1.0, 1.0);
+		++Stats.NumBothHit;
+		Stats.SumHeightError += HeightError;
+		Stats.MaxHeightError = FMath::Max(Stats.MaxHeightError, HeightError);
+		Stats.MaxNormalErrorDegrees = FMath::Max(Stats.MaxNormalErrorDegrees, FMath::RadiansToDegrees(FMath::Acos(CosAngle)));
+	}
+}
+
+FSingularisGroundContactStats FSingularisGroundContactProvider::GetStats() const
+{
+	FScopeLock Lock(&StatsLock);
+	return Stats;
+}
+
+void FSingularisGroundContactProvider::ResetStats()
+{
+	FScopeLock Lock(&StatsLock);
+	Stats = FSingularisGroundContactStats();
+}
@@ -0,0 +1,493 @@
+/* =====================================================================
+ * SingularisVehicleGroundSubsystem.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleGroundSubsystem.h"
+
+#include "BaseWheeledVehiclePawn.h"
+#include "LandscapeHeightfieldCollisionComponent.h"
+#include "SingularisVehicleMovementComponent.h"
+#include "SingularisVehicleStats.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+DEFINE_LOG_CATEGORY(LogSingularisVehicleGround);
+
+DECLARE_CYCLE_STAT(TEXT("Ground Tile Build"), STAT_SingularisVehicle_GroundTileBuild, STATGROUP_SingularisVehicle);
+DECLARE_CYCLE_STAT(TEXT("Ground Obstructions"), STAT_SingularisVehicle_GroundObstructions, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ground Obstructed Vehicles"), STAT_SingularisVehicle_GroundObstructedVehicles, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ground Tiles Cached"), STAT_SingularisVehicle_GroundTiles, STATGROUP_SingularisVehicle);
+
+namespace SingularisVehicleGround
+{
+	static bool bEnable = true;
+	static FAutoConsoleVariableRef CVarEnable(
+		TEXT("SingularisVehicle.Ground.Enable"),
+		bEnable,
+		TEXT("开启了 bUseHeightfieldContact 的载具由缓存的高度场求车轮接触；关闭后全部使用场景查询。"));
+
+	static bool bValidate = false;
+	static FAutoConsoleVariableRef CVarValidate(
+		TEXT("SingularisVehicle.Ground.Validate"),
+		bValidate,
+		TEXT("仍以场景查询驱动模拟，同时计算高度场接触并统计两者的偏差。"));
+
+	static float TileSize = 6400.0f;
+	static FAutoConsoleVariableRef CVarTileSize(
+		TEXT("SingularisVehicle.Ground.TileSize"),
+		TileSize,
+		TEXT("高度场块的边长（厘米），只在世界创建时读取。"));
+
+	static float SampleSpacing = 100.0f;
+	static FAutoConsoleVariableRef CVarSampleSpacing(
+		TEXT("SingularisVehicle.Ground.SampleSpacing"),
+		SampleSpacing,
+		TEXT("高度场块的采样间距（厘米），与地形的网格间距一致时误差最小。"));
+
+	static float Margin = 100.0f;
+	static FAutoConsoleVariableRef CVarMargin(
+		TEXT("SingularisVehicle.Ground.Margin"),
+		Margin,
+		TEXT("其他静态碰撞体周围多大范围（厘米）内的网格单元回退到场景查询。"));
+
+	static float Clearance = 500.0f;
+	static FAutoConsoleVariableRef CVarClearance(
+		TEXT("SingularisVehicle.Ground.Clearance"),
+		Clearance,
+		TEXT("地面以上多高（厘米）内的静态碰撞体会让网格单元回退到场景查询，应大于车轮的悬挂检测长度。"));
+
+	static float DynamicMargin = 200.0f;
+	static FAutoConsoleVariableRef CVarDynamicMargin(
+		TEXT("SingularisVehicle.Ground.DynamicMargin"),
+		DynamicMargin,
+		TEXT("载具包围盒周围多大范围（厘米）内有其他载具、模拟物理的物体或可移动物体时，该车回退到场景查询。"));
+
+	static float Lookahead = 1000.0f;
+	static FAutoConsoleVariableRef CVarLookahead(
+		TEXT("SingularisVehicle.Ground.Lookahead"),
+		Lookahead,
+		TEXT("载具周围多大范围（厘米）内的高度场块需要提前建立。"));
+
+	static float EvictDelay = 10.0f;
+	static FAutoConsoleVariableRef CVarEvictDelay(
+		TEXT("SingularisVehicle.Ground.EvictDelay"),
+		EvictDelay,
+		TEXT("高度场块多久（秒）无载具需要后移除；没有地形的块也按该间隔重建，等待流送加载的地形。"));
+
+	static int32 MaxTileBuildsPerFrame = 1;
+	static FAutoConsoleVariableRef CVarMaxTileBuildsPerFrame(
+		TEXT("SingularisVehicle.Ground.MaxTileBuildsPerFrame"),
+		MaxTileBuildsPerFrame,
+		TEXT("每帧最多建立的高度场块数量，尚未建立的块由场景查询代替。"));
+
+	/** 场景查询中高度场块在竖直方向上的半高（厘米） */
+	static constexpr double QueryHalfHeight = 1.0e6;
+}
+
+void USingularisVehicleGroundSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Provider = MakeShared<FSingularisGroundContactProvider, ESPMode::ThreadSafe>(SingularisVehicleGround::TileSize);
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &USingularisVehicleGroundSubsystem::OnLevelChanged);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &USingularisVehicleGroundSubsystem::OnLevelChanged);
+}
+
+void USingularisVehicleGroundSubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+	// 物理线程模拟可能仍持有提供者，只清空缓存
+	InvalidateAll();
+	Vehicles.Reset();
+	Super::Deinitialize();
+}
+
+bool USingularisVehicleGroundSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId USingularisVehicleGroundSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USingularisVehicleGroundSubsystem, STATGROUP_Tickables);
+}
+
+void USingularisVehicleGroundSubsystem::RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	const USingularisVehicleMovementComponent* Movement = Vehicle ? Vehicle->GetSingularisVehicleMovement() : nullptr;
+	if (!Movement || !Movement->bUseHeightfieldContact)
+	{
+		return;
+	}
+
+	Vehicles.AddUnique(Vehicle);
+}
+
+void USingularisVehicleGroundSubsystem::UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	const int32 Index = Vehicles.IndexOfByKey(Vehicle);
+	if (Index != INDEX_NONE)
+	{
+		Vehicles.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+		// 不再更新的标记保持回退，重新登记后由下一帧的检查恢复
+		if (const USingularisVehicleMovementComponent* Movement = Vehicle ? Vehicle->GetSingularisVehicleMovement() : nullptr)
+		{
+			Movement->GetGroundObstruction()->store(true, std::memory_order_relaxed);
+		}
+	}
+}
+
+void USingularisVehicleGroundSubsystem::Tick(const float DeltaTime)
+{
+	Provider->bEnabled.store(SingularisVehicleGround::bEnable, std::memory_order_relaxed);
+	Provider->bValidate.store(SingularisVehicleGround::bValidate, std::memory_order_relaxed);
+
+	if (SingularisVehicleGround::bEnable)
+	{
+		TArray<FIntPoint> Missing;
+		GatherNeededTiles(Missing);
+
+		const int32 NumBuilds = FMath::Min(Missing.Num(), FMath::Max(SingularisVehicleGround::MaxTileBuildsPerFrame, 0));
+		for (int32 Index = 0; Index < NumBuilds; ++Index)
+		{
+			AddTile(Missing[Index]);
+		}
+
+		UpdateObstructions();
+	}
+
+	EvictTiles();
+	SET_DWORD_STAT(STAT_SingularisVehicle_GroundTiles, TileRecords.Num());
+}
+
+void USingularisVehicleGroundSubsystem::BuildPendingTiles()
+{
+	TArray<FIntPoint> Missing;
+	GatherNeededTiles(Missing);
+
+	for (const FIntPoint& Key : Missing)
+	{
+		AddTile(Key);
+	}
+
+	UpdateObstructions();
+}
+
+void USingularisVehicleGroundSubsystem::InvalidateRegion(const FBox& Region)
+{
+	const FIntPoint MinKey = Provider->GetTileKey(FVector2D(Region.Min));
+	const FIntPoint MaxKey = Provider->GetTileKey(FVector2D(Region.Max));
+
+	for (auto It = TileRecords.CreateIterator(); It; ++It)
+	{
+		const FIntPoint& Key = It.Key();
+		if (Key.X >= MinKey.X && Key.X <= MaxKey.X && Key.Y >= MinKey.Y && Key.Y <= MaxKey.Y)
+		{
+			Provider->RemoveTile(Key);
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void USingularisVehicleGroundSubsystem::InvalidateAll()
+{
+	for (const TPair<FIntPoint, FTileRecord>& Pair : TileRecords)
+	{
+		Provider->RemoveTile(Pair.Key);
+	}
+	TileRecords.Reset();
+}
+
+void USingularisVehicleGroundSubsystem::AddTile(const FIntPoint& Key)
+{
+	const TSharedRef<const FSingularisGroundTile, ESPMode::ThreadSafe> Tile = BuildTile(Key);
+
+	FTileRecord& Record = TileRecords.Add(Key);
+	Record.LastUsedTime = GetWorld()->GetTimeSeconds();
+	Record.BuildTime = Record.LastUsedTime;
+	Record.bEmpty = Tile->NumSamples == 0;
+	Provider->SetTile(Key, Tile);
+}
+
+void USingularisVehicleGroundSubsystem::GatherNeededTiles(TArray<FIntPoint>& OutMissing)
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	const double Lookahead = FMath::Max(SingularisVehicleGround::Lookahead, 0.0f);
+
+	for (int32 Index = Vehicles.Num() - 1; Index >= 0; --Index)
+	{
+		const ABaseWheeledVehiclePawn* Vehicle = Vehicles[Index].Get();
+		if (!Vehicle)
+		{
+			Vehicles.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		if (Vehicle->IsPooled())
+		{
+			continue;
+		}
+
+		const FVector2D Location(Vehicle->GetActorLocation());
+		const FIntPoint MinKey = Provider->GetTileKey(Location - FVector2D(Lookahead));
+		const FIntPoint MaxKey = Provider->GetTileKey(Location + FVector2D(Lookahead));
+		for (int32 KeyY = MinKey.Y; KeyY <= MaxKey.Y; ++KeyY)
+		{
+			for (int32 KeyX = MinKey.X; KeyX <= MaxKey.X; ++KeyX)
+			{
+				const FIntPoint Key(KeyX, KeyY);
+				if (FTileRecord* Record = TileRecords.Find(Key))
+				{
+					Record->LastUsedTime = Now;
+				}
+				else
+				{
+					OutMissing.AddUnique(Key);
+				}
+			}
+		}
+	}
+}
+
+void USingularisVehicleGroundSubsystem::EvictTiles()
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	const double EvictDelay = FMath::Max(SingularisVehicleGround::EvictDelay, 0.0f);
+
+	for (auto It = TileRecords.CreateIterator(); It; ++It)
+	{
+		const FTileRecord& Record = It.Value();
+		if (Now - Record.LastUsedTime > EvictDelay || (Record.bEmpty && Now - Record.BuildTime > EvictDelay))
+		{
+			Provider->RemoveTile(It.Key());
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void USingularisVehicleGroundSubsystem::UpdateObstructions()
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_GroundObstructions);
+
+	// 只查询可能在建立高度场块之后移动或生成的物体类型；静态物体已记录在块中
+	FCollisionObjectQueryParams ObjectParams;
+	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+	ObjectParams.AddObjectTypesToQuery(ECC_Pawn);
+	ObjectParams.AddObjectTypesToQuery(ECC_PhysicsBody);
+	ObjectParams.AddObjectTypesToQuery(ECC_Vehicle);
+	ObjectParams.AddObjectTypesToQuery(ECC_Destructible);
+
+	const double DynamicMargin = FMath::Max(SingularisVehicleGround::DynamicMargin, 0.0f);
+	int32 NumObstructed = 0;
+	for (const TWeakObjectPtr<ABaseWheeledVehiclePawn>& VehiclePtr : Vehicles)
+	{
+		const ABaseWheeledVehiclePawn* Vehicle = VehiclePtr.Get();
+		const USingularisVehicleMovementComponent* Movement = Vehicle ? Vehicle->GetSingularisVehicleMovement() : nullptr;
+		if (!Movement || Vehicle->IsPooled() || !Vehicle->GetRootComponent())
+		{
+			continue;
+		}
+
+		// 包围盒由车身网格给出，已包含车轮；车身自身的组件不参与检测
+		const FBox Bounds = Vehicle->GetRootComponent()->Bounds.GetBox().ExpandBy(DynamicMargin);
+		const bool bObstructed = GetWorld()->OverlapAnyTestByObjectType(Bounds.GetCenter(),
+		                                                                FQuat::Identity,
+		                                                                ObjectParams,
+		                                                                FCollisionShape::MakeBox(Bounds.GetExtent()),
+		                                                                FCollisionQueryParams(SCENE_QUERY_STAT(SingularisVehicleGroundObstruction), false, Vehicle));
+		Movement->GetGroundObstruction()->store(bObstructed, std::memory_order_relaxed);
+		NumObstructed += bObstructed ? 1 : 0;
+	}
+
+	SET_DWORD_STAT(STAT_SingularisVehicle_GroundObstructedVehicles, NumObstructed);
+}
+
+void USingularisVehicleGroundSubsystem::OnLevelChanged(ULevel* Level, UWorld* World)
+{
+	if (World == GetWorld())
+	{
+		InvalidateAll();
+	}
+}
+
+TSharedRef<const FSingularisGroundTile, ESPMode::ThreadSafe> USingularisVehicleGroundSubsystem::BuildTile(const FIntPoint& Key) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_GroundTileBuild);
+
+	const TSharedRef<FSingularisGroundTile, ESPMode::ThreadSafe> Tile = MakeShared<FSingularisGroundTile, ESPMode::ThreadSafe>();
+
+	const double TileSize = Provider->GetTileSize();
+	const double Margin = FMath::Max(SingularisVehicleGround::Margin, 0.0f);
+	const double Clearance = FMath::Max(SingularisVehicleGround::Clearance, 0.0f);
+	const FVector2D Origin = FVector2D(Key) * TileSize;
+
+	// 找出块内的地形碰撞与其他静态碰撞体；其他载具与模拟物理的物体不进入缓存，由 UpdateObstructions 每帧检查
+	TArray<FOverlapResult> Overlaps;
+	FCollisionObjectQueryParams ObjectParams;
+	ObjectParams.AddObjectTypesToQuery(ECC_WorldStatic);
+	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+	const FVector2D Center = Origin + FVector2D(TileSize * 0.5);
+	const FVector HalfExtent(TileSize * 0.5 + Margin, TileSize * 0.5 + Margin, SingularisVehicleGround::QueryHalfHeight);
+	GetWorld()->OverlapMultiByObjectType(Overlaps,
+	                                     FVector(Center, 0.0),
+	                                     FQuat::Identity,
+	                                     ObjectParams,
+	                                     FCollisionShape::MakeBox(HalfExtent),
+	                                     FCollisionQueryParams(SCENE_QUERY_STAT(SingularisVehicleGroundTile), false));
+
+	TArray<UPrimitiveComponent*, TInlineAllocator<8>> Heightfields;
+	TArray<FBox> Obstructions;
+	FBox HeightfieldBounds(ForceInit);
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		UPrimitiveComponent* Component = Overlap.GetComponent();
+		if (!Component)
+		{
+			continue;
+		}
+
+		if (Component->IsA<ULandscapeHeightfieldCollisionComponent>())
+		{
+			if (!Heightfields.Contains(Component))
+			{
+				Heightfields.Add(Component);
+				HeightfieldBounds += Component->Bounds.GetBox();
+			}
+		}
+		else if (!Component->IsSimulatingPhysics() && !Cast<APawn>(Component->GetOwner()))
+		{
+			Obstructions.Add(Component->Bounds.GetBox());
+		}
+	}
+
+	if (Heightfields.IsEmpty())
+	{
+		return Tile;
+	}
+
+	const int32 NumCells = FMath::Max(FMath::RoundToInt32(TileSize / FMath::Max(SingularisVehicleGround::SampleSpacing, 1.0f)), 1);
+	const int32 NumSamples = NumCells + 1;
+	Tile->Origin = Origin;
+	Tile->Spacing = static_cast<float>(TileSize / NumCells);
+	Tile->NumSamples = NumSamples;
+	Tile->Heights.SetNumZeroed(NumSamples * NumSamples);
+	Tile->SamplePalette.Init(FSingularisGroundTile::InvalidPalette, NumSamples * NumSamples);
+
+	// 逐点对地形碰撞做组件射线检测，重叠的地形取最高的命中
+	FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(SingularisVehicleGroundSample), false);
+	TraceParams.bReturnPhysicalMaterial = true;
+	const double TraceTop = HeightfieldBounds.Max.Z + 100.0;
+	const double TraceBottom = HeightfieldBounds.Min.Z - 100.0;
+
+	for (int32 SampleY = 0; SampleY < NumSamples; ++SampleY)
+	{
+		for (int32 SampleX = 0; SampleX < NumSamples; ++SampleX)
+		{
+			const FVector2D Location = Origin + FVector2D(SampleX, SampleY) * Tile->Spacing;
+			const int32 SampleIndex = SampleY * NumSamples + SampleX;
+
+			for (UPrimitiveComponent* Heightfield : Heightfields)
+			{
+				const FBox& Bounds = Heightfield->Bounds.GetBox();
+				if (Location.X < Bounds.Min.X - 1.0 || Location.X > Bounds.Max.X + 1.0 || Location.Y < Bounds.Min.Y - 1.0 || Location.Y > Bounds.Max.Y + 1.0)
+				{
+					continue;
+				}
+
+				FHitResult Hit;
+				if (!Heightfield->LineTraceComponent(Hit, FVector(Location, TraceTop), FVector(Location, TraceBottom), TraceParams))
+				{
+					continue;
+				}
+
+				uint8& Palette = Tile->SamplePalette[SampleIndex];
+				if (Palette != FSingularisGroundTile::InvalidPalette && Hit.ImpactPoint.Z <= Tile->Heights[SampleIndex])
+				{
+					continue;
+				}
+
+				int32 PaletteIndex = Tile->Palette.IndexOfByPredicate([&Hit, Heightfield](const FSingularisGroundTile::FPaletteEntry& Entry)
+				{
+					return Entry.Component == Heightfield && Entry.PhysMaterial == Hit.PhysMaterial;
+				});
+				if (PaletteIndex == INDEX_NONE && Tile->Palette.Num() < FSingularisGroundTile::InvalidPalette)
+				{
+					PaletteIndex = Tile->Palette.Add({Heightfield, Hit.PhysMaterial});
+				}
+
+				if (PaletteIndex != INDEX_NONE)
+				{
+					Tile->Heights[SampleIndex] = static_cast<float>(Hit.ImpactPoint.Z);
+					Palette = static_cast<uint8>(PaletteIndex);
+				}
+			}
+		}
+	}
+
+	// 四个角都落在高度场上的单元可以直接采样，除非地面附近有其他静态碰撞体
+	TArray<float> CellMinHeights;
+	TArray<float> CellMaxHeights;
+	CellMinHeights.SetNumUninitialized(NumCells * NumCells);
+	CellMaxHeights.SetNumUninitialized(NumCells * NumCells);
+	Tile->UsableCells.Init(false, NumCells * NumCells);
+
+	for (int32 CellY = 0; CellY < NumCells; ++CellY)
+	{
+		for (int32 CellX = 0; CellX < NumCells; ++CellX)
+		{
+			const int32 CellIndex = CellY * NumCells + CellX;
+			const int32 Corners[4] = {
+				CellY * NumSamples + CellX,
+				CellY * NumSamples + CellX + 1,
+				(CellY + 1) * NumSamples + CellX,
+				(CellY + 1) * NumSamples + CellX + 1
+			};
+
+			bool bValid = true;
+			float MinHeight = TNumericLimits<float>::Max();
+			float MaxHeight = TNumericLimits<float>::Lowest();
+			for (const int32 Corner : Corners)
+			{
+				bValid &= Tile->SamplePalette[Corner] != FSingularisGroundTile::InvalidPalette;
+				MinHeight = FMath::Min(MinHeight, Tile->Heights[Corner]);
+				MaxHeight = FMath::Max(MaxHeight, Tile->Heights[Corner]);
+			}
+
+			Tile->UsableCells[CellIndex] = bValid;
+			CellMinHeights[CellIndex] = MinHeight;
+			CellMaxHeights[CellIndex] = MaxHeight;
+		}
+	}
+
+	for (const FBox& Obstruction : Obstructions)
+	{
+		const int32 MinCellX = FMath::Max(FMath::FloorToInt32((Obstruction.Min.X - Margin - Origin.X) / Tile->Spacing), 0);
+		const int32 MinCellY = FMath::Max(FMath::FloorToInt32((Obstruction.Min.Y - Margin - Origin.Y) / Tile->Spacing), 0);
+		const int32 MaxCellX = FMath::Min(FMath::FloorToInt32((Obstruction.Max.X + Margin - Origin.X) / Tile->Spacing), NumCells - 1);
+		const int32 MaxCellY = FMath::Min(FMath::FloorToInt32((Obstruction.Max.Y + Margin - Origin.Y) / Tile->Spacing), NumCells - 1);
+
+		for (int32 CellY = MinCellY; CellY <= MaxCellY; ++CellY)
+		{
+			for (int32 CellX = MinCellX; CellX <= MaxCellX; ++CellX)
+			{
+				const int32 CellIndex = CellY * NumCells + CellX;
+				if (Obstruction.Min.Z < CellMaxHeights[CellIndex] + Clearance && Obstruction.Max.Z > CellMinHeights[CellIndex] - Margin)
+				{
+					Tile->UsableCells[CellIndex] = false;
+				}
+			}
+		}
+	}
+
+	return Tile;
+}
@@ -0,0 +1,509 @@
+/* =====================================================================
+ * SingularisVehicleHibernationSubsystem.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleHibernationSubsystem.h"
+
+#include "BaseWheeledVehiclePawn.h"
+#include "SingularisVehiclePoolSubsystem.h"
+#include "SingularisVehicleStats.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+DEFINE_LOG_CATEGORY(LogSingularisVehicleHibernation);
+
+DECLARE_CYCLE_STAT(TEXT("Hibernation Update"), STAT_SingularisVehicle_HibernationUpdate, STATGROUP_SingularisVehicle);
+DECLARE_CYCLE_STAT(TEXT("Hibernate Vehicle"), STAT_SingularisVehicle_Hibernate, STATGROUP_SingularisVehicle);
+DECLARE_CYCLE_STAT(TEXT("Wake Vehicle"), STAT_SingularisVehicle_Wake, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hibernated Vehicles"), STAT_SingularisVehicle_Hibernated, STATGROUP_SingularisVehicle);
+
+namespace SingularisVehicleHibernation
+{
+	static float RestDelay = 60.0f;
+	static FAutoConsoleVariableRef CVarRestDelay(
+		TEXT("SingularisVehicle.Hibernation.RestDelay"),
+		RestDelay,
+		TEXT("载具连续静止超过该时间（秒）后休眠，小于等于零时不自动休眠。"));
+
+	static float RestSpeed = 10.0f;
+	static FAutoConsoleVariableRef CVarRestSpeed(
+		TEXT("SingularisVehicle.Hibernation.RestSpeed"),
+		RestSpeed,
+		TEXT("低于该速度（厘米/秒）视为静止。"));
+
+	static float WakeRadius = 5000.0f;
+	static FAutoConsoleVariableRef CVarWakeRadius(
+		TEXT("SingularisVehicle.Hibernation.WakeRadius"),
+		WakeRadius,
+		TEXT("观察者该距离（厘米）内的休眠载具被唤醒。"));
+
+	static float HibernateRadius = 7000.0f;
+	static FAutoConsoleVariableRef CVarHibernateRadius(
+		TEXT("SingularisVehicle.Hibernation.HibernateRadius"),
+		HibernateRadius,
+		TEXT("只有离所有观察者超过该距离（厘米）的载具才会休眠，应大于 WakeRadius 以免反复切换。"));
+
+	static float CheckInterval = 0.25f;
+	static FAutoConsoleVariableRef CVarCheckInterval(
+		TEXT("SingularisVehicle.Hibernation.CheckInterval"),
+		CheckInterval,
+		TEXT("检查静止时间与观察者距离的间隔（秒）。"));
+
+	static int32 MaxTransitionsPerFrame = 4;
+	static FAutoConsoleVariableRef CVarMaxTransitionsPerFrame(
+		TEXT("SingularisVehicle.Hibernation.MaxTransitionsPerFrame"),
+		MaxTransitionsPerFrame,
+		TEXT("每次检查最多的自动休眠与唤醒次数，超出的部分留到下一次；撞击与脚本唤醒不受限制。"));
+
+	static int32 MaxPooledPerClass = 8;
+	static FAutoConsoleVariableRef CVarMaxPooledPerClass(
+		TEXT("SingularisVehicle.Hibernation.MaxPooledPerClass"),
+		MaxPooledPerClass,
+		TEXT("休眠的载具归还对象池，直到池中同类闲置载具达到该数量，之后直接销毁。"));
+}
+
+void USingularisVehicleHibernationSubsystem::Deinitialize()
+{
+	// 世界销毁时组件与载具随之释放，这里只丢弃引用
+	Records.Empty();
+	AwakeVehicles.Empty();
+	PendingWakes.Empty();
+	Models.Empty();
+	InstanceHost = nullptr;
+
+	Super::Deinitialize();
+}
+
+bool USingularisVehicleHibernationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId USingularisVehicleHibernationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USingularisVehicleHibernationSubsystem, STATGROUP_Tickables);
+}
+
+void USingularisVehicleHibernationSubsystem::RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	if (Vehicle && !AwakeVehicles.Contains(Vehicle))
+	{
+		AwakeVehicles.Add(Vehicle, {Vehicle, 0.0f});
+	}
+}
+
+void USingularisVehicleHibernationSubsystem::UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	AwakeVehicles.Remove(Vehicle);
+}
+
+int32 USingularisVehicleHibernationSubsystem::FindOrAddModel(const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass)
+{
+	for (int32 ModelIndex = 0; ModelIndex < Models.Num(); ++ModelIndex)
+	{
+		if (Models[ModelIndex].VehicleClass == VehicleClass)
+		{
+			return ModelIndex;
+		}
+	}
+
+	const ABaseWheeledVehiclePawn* DefaultVehicle = VehicleClass ? VehicleClass->GetDefaultObject<ABaseWheeledVehiclePawn>() : nullptr;
+	if (!DefaultVehicle || !DefaultVehicle->GetHibernationMesh())
+	{
+		return INDEX_NONE;
+	}
+
+	if (!ensure(Models.Num() <= MAX_uint16))
+	{
+		return INDEX_NONE;
+	}
+
+	if (!InstanceHost)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParameters.ObjectFlags |= RF_Transient;
+		InstanceHost = GetWorld()->SpawnActor<AActor>(SpawnParameters);
+		if (!InstanceHost)
+		{
+			return INDEX_NONE;
+		}
+
+		USceneComponent* Root = NewObject<USceneComponent>(InstanceHost, TEXT("Root"));
+		InstanceHost->SetRootComponent(Root);
+		Root->RegisterComponent();
+	}
+
+	// 实例沿用载具车身的碰撞设置，其他载具与角色照常与休眠的车辆碰撞
+	UInstancedStaticMeshComponent* Instances = NewObject<UInstancedStaticMeshComponent>(InstanceHost);
+	Instances->SetStaticMesh(DefaultVehicle->GetHibernationMesh());
+	Instances->SetCollisionProfileName(DefaultVehicle->GetMesh()->GetCollisionProfileName());
+	Instances->SetNotifyRigidBodyCollision(true);
+	Instances->SetRemoveSwap();
+	Instances->SetCanEverAffectNavigation(false);
+	Instances->SetupAttachment(InstanceHost->GetRootComponent());
+	Instances->OnComponentHit.AddDynamic(this, &USingularisVehicleHibernationSubsystem::OnInstancesHit);
+	Instances->RegisterComponent();
+
+	FSingularisHibernationModel& Model = Models.AddDefaulted_GetRef();
+	Model.VehicleClass = VehicleClass;
+	Model.Instances = Instances;
+	return Models.Num() - 1;
+}
+
+int32 USingularisVehicleHibernationSubsystem::AddRecord(const int32 ModelIndex, const FTransform& Transform, const bool bHandbrake)
+{
+	FSingularisHibernationModel& Model = Models[ModelIndex];
+
+	FHibernatedVehicle Record;
+	Record.Location = Transform.GetLocation();
+	Record.Rotation = FQuat4f(Transform.GetRotation());
+	Record.ModelIndex = static_cast<uint16>(ModelIndex);
+	Record.bHandbrake = bHandbrake;
+	Record.InstanceIndex = Model.Instances->AddInstance(FTransform(Transform.GetRotation(), Transform.GetLocation()), true);
+
+	const int32 Handle = Records.Add(Record);
+	check(Record.InstanceIndex == Model.InstanceRecords.Num());
+	Model.InstanceRecords.Add(Handle);
+	return Handle;
+}
+
+void USingularisVehicleHibernationSubsystem::RemoveRecord(const int32 Handle)
+{
+	const FHibernatedVehicle Record = Records[Handle];
+	Records.RemoveAt(Handle);
+
+	// 组件以交换方式删除实例，这里同步移动映射
+	FSingularisHibernationModel& Model = Models[Record.ModelIndex];
+	Model.Instances->RemoveInstance(Record.InstanceIndex);
+	Model.InstanceRecords.RemoveAtSwap(Record.InstanceIndex, 1, EAllowShrinking::No);
+	if (Model.InstanceRecords.IsValidIndex(Record.InstanceIndex))
+	{
+		Records[Model.InstanceRecords[Record.InstanceIndex]].InstanceIndex = Record.InstanceIndex;
+	}
+}
+
+int32 USingularisVehicleHibernationSubsystem::HibernateVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_Hibernate);
+
+	if (!IsValid(Vehicle) || Vehicle->IsPooled())
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 ModelIndex = FindOrAddModel(Vehicle->GetClass());
+	if (ModelIndex == INDEX_NONE)
+	{
+		UE_LOG(LogSingularisVehicleHibernation, Verbose, TEXT("载具类 '%s' 没有设置 HibernationMesh，无法休眠"), *GetNameSafe(Vehicle->GetClass()));
+		return INDEX_NONE;
+	}
+
+	const int32 Handle = AddRecord(ModelIndex, Vehicle->GetActorTransform(), Vehicle->GetControlFrame().bHandbrake);
+	AwakeVehicles.Remove(Vehicle);
+
+	// 池中闲置的同类载具足够唤醒时使用，多余的直接销毁
+	USingularisVehiclePoolSubsystem* Pool = GetWorld()->GetSubsystem<USingularisVehiclePoolSubsystem>();
+	if (Pool && Pool->GetNumAvailable(Vehicle->GetClass()) < SingularisVehicleHibernation::MaxPooledPerClass)
+	{
+		Pool->ReleaseVehicle(Vehicle);
+	}
+	else
+	{
+		Vehicle->Destroy();
+	}
+
+	return Handle;
+}
+
+void USingularisVehicleHibernationSubsystem::AddParkedVehicles(const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass,
+                                                               const TArray<FTransform>& Transforms,
+                                                               TArray<int32>& OutHandles)
+{
+	OutHandles.Reset(Transforms.Num());
+
+	const int32 ModelIndex = FindOrAddModel(VehicleClass);
+	if (ModelIndex == INDEX_NONE)
+	{
+		UE_LOG(LogSingularisVehicleHibernation, Warning, TEXT("载具类 '%s' 没有设置 HibernationMesh，无法放置停放车辆"), *GetNameSafe(VehicleClass));
+		return;
+	}
+
+	// 一次性添加全部实例，只重建一次渲染与物理状态
+	FSingularisHibernationModel& Model = Models[ModelIndex];
+	const int32 FirstInstance = Model.InstanceRecords.Num();
+	Model.Instances->AddInstances(Transforms, false, true);
+
+	for (int32 Index = 0; Index < Transforms.Num(); ++Index)
+	{
+		FHibernatedVehicle Record;
+		Record.Location = Transforms[Index].GetLocation();
+		Record.Rotation = FQuat4f(Transforms[Index].GetRotation());
+		Record.ModelIndex = static_cast<uint16>(ModelIndex);
+		Record.bHandbrake = true;
+		Record.InstanceIndex = FirstInstance + Index;
+
+		const int32 Handle = Records.Add(Record);
+		Model.InstanceRecords.Add(Handle);
+		OutHandles.Add(Handle);
+	}
+}
+
+ABaseWheeledVehiclePawn* USingularisVehicleHibernationSubsystem::WakeVehicle(const int32 Handle)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_Wake);
+
+	if (!Records.IsValidIndex(Handle))
+	{
+		return nullptr;
+	}
+
+	USingularisVehiclePoolSubsystem* Pool = GetWorld()->GetSubsystem<USingularisVehiclePoolSubsystem>();
+	if (!Pool)
+	{
+		return nullptr;
+	}
+
+	const FHibernatedVehicle Record = Records[Handle];
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = Models[Record.ModelIndex].VehicleClass;
+
+	// 先删除实例，载具放回原处时不与自己的实例重叠
+	RemoveRecord(Handle);
+
+	ABaseWheeledVehiclePawn* Vehicle = Pool->AcquireVehicle(VehicleClass, FTransform(FQuat(Record.Rotation), Record.Location));
+	if (!Vehicle)
+	{
+		UE_LOG(LogSingularisVehicleHibernation, Warning, TEXT("无法取出载具 '%s'，休眠记录已丢弃"), *GetNameSafe(VehicleClass));
+		return nullptr;
+	}
+
+	if (Record.bHandbrake)
+	{
+		FVehicleControlFrame Frame;
+		Frame.bHandbrake = true;
+		Vehicle->SubmitControlFrame(Frame);
+	}
+
+	return Vehicle;
+}
+
+int32 USingularisVehicleHibernationSubsystem::WakeVehiclesInRadius(const FVector& Location, const float Radius)
+{
+	const double RadiusSquared = FMath::Square(Radius);
+
+	TArray<int32> Handles;
+	for (auto It = Records.CreateConstIterator(); It; ++It)
+	{
+		if (FVector::DistSquared(It->Location, Location) <= RadiusSquared)
+		{
+			Handles.Add(It.GetIndex());
+		}
+	}
+
+	for (const int32 Handle : Handles)
+	{
+		WakeVehicle(Handle);
+	}
+	return Handles.Num();
+}
+
+void USingularisVehicleHibernationSubsystem::ClearHibernatedVehicles()
+{
+	for (FSingularisHibernationModel& Model : Models)
+	{
+		if (Model.Instances)
+		{
+			Model.Instances->ClearInstances();
+		}
+		Model.InstanceRecords.Reset();
+	}
+
+	Records.Empty();
+	PendingWakes.Reset();
+}
+
+bool USingularisVehicleHibernationSubsystem::GetHibernatedTransform(const int32 Handle, FTransform& OutTransform) const
+{
+	if (!Records.IsValidIndex(Handle))
+	{
+		return false;
+	}
+
+	OutTransform = FTransform(FQuat(Records[Handle].Rotation), Records[Handle].Location);
+	return true;
+}
+
+void USingularisVehicleHibernationSubsystem::Tick(const float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_HibernationUpdate);
+
+	// 撞击在物理回调中排队，这里统一唤醒
+	if (!PendingWakes.IsEmpty())
+	{
+		for (const int32 Handle : PendingWakes)
+		{
+			WakeVehicle(Handle);
+		}
+		PendingWakes.Reset();
+	}
+
+	TimeUntilCheck -= DeltaTime;
+	if (TimeUntilCheck > 0.0f)
+	{
+		return;
+	}
+
+	const float ElapsedTime = SingularisVehicleHibernation::CheckInterval - TimeUntilCheck;
+	TimeUntilCheck = SingularisVehicleHibernation::CheckInterval;
+
+	GatherViewerLocations();
+	WakeNearViewers();
+	UpdateRestingVehicles(ElapsedTime);
+
+	SET_DWORD_STAT(STAT_SingularisVehicle_Hibernated, Records.Num());
+}
+
+void USingularisVehicleHibernationSubsystem::GatherViewerLocations()
+{
+	ViewerLocations.Reset();
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewerLocations.Add(ViewLocation);
+		}
+	}
+}
+
+double USingularisVehicleHibernationSubsystem::GetMinViewerDistanceSquared(const FVector& Location) const
+{
+	double MinDistanceSquared = TNumericLimits<double>::Max();
+	for (const FVector& ViewerLocation : ViewerLocations)
+	{
+		MinDistanceSquared = FMath::Min(MinDistanceSquared, FVector::DistSquared(ViewerLocation, Location));
+	}
+	return MinDistanceSquared;
+}
+
+void USingularisVehicleHibernationSubsystem::WakeNearViewers()
+{
+	if (ViewerLocations.IsEmpty() || Records.IsEmpty())
+	{
+		return;
+	}
+
+	// 记录只有位置，逐条比较足够快；每次检查最多唤醒有限数量，其余留到下一次
+	const double WakeRadiusSquared = FMath::Square(SingularisVehicleHibernation::WakeRadius);
+	TArray<int32, TInlineAllocator<16>> Handles;
+	for (auto It = Records.CreateConstIterator(); It && Handles.Num() < SingularisVehicleHibernation::MaxTransitionsPerFrame; ++It)
+	{
+		if (GetMinViewerDistanceSquared(It->Location) < WakeRadiusSquared)
+		{
+			Handles.Add(It.GetIndex());
+		}
+	}
+
+	for (const int32 Handle : Handles)
+	{
+		WakeVehicle(Handle);
+	}
+}
+
+void USingularisVehicleHibernationSubsystem::UpdateRestingVehicles(const float ElapsedTime)
+{
+	if (SingularisVehicleHibernation::RestDelay <= 0.0f)
+	{
+		return;
+	}
+
+	const float RestSpeedSquared = FMath::Square(SingularisVehicleHibernation::RestSpeed);
+	const double HibernateRadiusSquared = FMath::Square(SingularisVehicleHibernation::HibernateRadius);
+
+	HibernateCandidates.Reset();
+	for (auto It = AwakeVehicles.CreateIterator(); It; ++It)
+	{
+		FAwakeVehicle& Entry = It.Value();
+		ABaseWheeledVehiclePawn* Vehicle = Entry.Vehicle.Get();
+		if (!Vehicle)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		// 只有静止且没有驾驶者要求行驶或制动的载具才累计时间，等红灯的 AI 与玩家驾驶的载具不会休眠
+		const FVehicleControlFrame Frame = Vehicle->GetControlFrame();
+		const bool bResting = Vehicle->AllowsHibernation()
+			&& !Vehicle->IsPlayerControlled()
+			&& FMath::IsNearlyZero(Frame.Throttle)
+			&& FMath::IsNearlyZero(Frame.Brake)
+			&& Vehicle->GetVelocity().SizeSquared() < RestSpeedSquared;
+
+		Entry.RestTime = bResting ? Entry.RestTime + ElapsedTime : 0.0f;
+		if (Entry.RestTime >= SingularisVehicleHibernation::RestDelay
+			&& HibernateCandidates.Num() < SingularisVehicleHibernation::MaxTransitionsPerFrame
+			&& GetMinViewerDistanceSquared(Vehicle->GetActorLocation()) > HibernateRadiusSquared)
+		{
+			HibernateCandidates.Add(Vehicle);
+		}
+	}
+
+	// 休眠会注销载具，遍历结束后再处理
+	for (ABaseWheeledVehiclePawn* Vehicle : HibernateCandidates)
+	{
+		if (HibernateVehicle(Vehicle) == INDEX_NONE)
+		{
+			// 无法休眠的载具不再反复尝试
+			AwakeVehicles.Remove(Vehicle);
+		}
+	}
+	HibernateCandidates.Reset();
+}
+
+void USingularisVehicleHibernationSubsystem::OnInstancesHit(UPrimitiveComponent* HitComponent,
+                                                            AActor* OtherActor,
+                                                            UPrimitiveComponent* OtherComp,
+                                                            FVector NormalImpulse,
+                                                            const FHitResult& Hit)
+{
+	const FSingularisHibernationModel* Model = Models.FindByPredicate([HitComponent](const FSingularisHibernationModel& Candidate)
+	{
+		return Candidate.Instances == HitComponent;
+	});
+	if (!Model || Model->InstanceRecords.IsEmpty())
+	{
+		return;
+	}
+
+	// 碰撞结果以本组件为视角，MyItem 是被撞实例的序号，直接映射到休眠记录
+	if (Model->InstanceRecords.IsValidIndex(Hit.MyItem))
+	{
+		PendingWakes.AddUnique(Model->InstanceRecords[Hit.MyItem]);
+		return;
+	}
+
+	// 没有实例序号时取离撞击点最近的实例
+	int32 ClosestHandle = INDEX_NONE;
+	double ClosestDistanceSquared = TNumericLimits<double>::Max();
+	for (const int32 Handle : Model->InstanceRecords)
+	{
+		const double DistanceSquared = FVector::DistSquared(Records[Handle].Location, Hit.ImpactPoint);
+		if (DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestDistanceSquared = DistanceSquared;
+			ClosestHandle = Handle;
+		}
+	}
+
+	PendingWakes.AddUnique(ClosestHandle);
+}
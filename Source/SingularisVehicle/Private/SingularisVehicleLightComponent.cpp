@@ -0,0 +1,125 @@
+/* =====================================================================
+ * SingularisVehicleLightComponent.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleLightComponent.h"
+
+#include "BaseWheeledVehiclePawn.h"
+#include "ChaosWheeledVehicleMovementComponent.h"
+#include "SingularisVehicleStats.h"
+#include "Components/SkeletalMeshComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Light Update"), STAT_SingularisVehicle_LightUpdate, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Light Changes"), STAT_SingularisVehicle_LightChanges, STATGROUP_SingularisVehicle);
+
+USingularisVehicleLightComponent::USingularisVehicleLightComponent()
+{
+	// 在物理之后读取本帧处理过的输入与挡位
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+}
+
+void USingularisVehicleLightComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Vehicle = Cast<ABaseWheeledVehiclePawn>(GetOwner());
+	if (!Vehicle.IsValid())
+	{
+		UE_LOG(LogBaseWheeledVehiclePawn, Warning, TEXT("'%s' 的灯光组件只能挂在 ABaseWheeledVehiclePawn 上"), *GetNameSafe(GetOwner()));
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	// 服务器上没有人看得到灯光，不登记到载具，刹车灯状态由载具自己记录
+	if (!Vehicle->ShouldRunCosmetics())
+	{
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	Vehicle->SetLightComponent(this);
+}
+
+void USingularisVehicleLightComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (ABaseWheeledVehiclePawn* Pawn = Vehicle.Get())
+	{
+		Pawn->SetLightComponent(nullptr);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void USingularisVehicleLightComponent::TickComponent(const float DeltaTime, const ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	UpdateFromMovement();
+}
+
+bool USingularisVehicleLightComponent::UpdateFromMovement()
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_LightUpdate);
+
+	const ABaseWheeledVehiclePawn* Pawn = Vehicle.Get();
+	const UChaosWheeledVehicleMovementComponent* Movement = Pawn ? Pawn->GetChaosVehicleMovement().Get() : nullptr;
+	if (!Movement || !Movement->IsComponentTickEnabled())
+	{
+		return false;
+	}
+
+	// 倒挡时 Chaos 把制动输入当作倒车油门，此时真正的制动来自油门输入
+	const bool bReverse = Movement->GetCurrentGear() < 0;
+	const bool bHandbrake = Movement->GetHandbrakeInput();
+	const float BrakeInput = bReverse ? Movement->GetThrottleInput() : Movement->GetBrakeInput();
+	const bool bBrake = BrakeInput > BrakeInputThreshold || bHandbrake;
+
+	if (bBrake == bBrakeLightsOn && bReverse == bReverseLightsOn && bHandbrake == bHandbrakeOn)
+	{
+		return false;
+	}
+
+	SetLightState(bBrake, bReverse, bHandbrake);
+	return true;
+}
+
+void USingularisVehicleLightComponent::SetLightState(const bool bBrake, const bool bReverse, const bool bHandbrake)
+{
+	bHandbrakeOn = bHandbrake;
+
+	if (bBrake != bBrakeLightsOn)
+	{
+		bBrakeLightsOn = bBrake;
+		WriteLightValue(BrakeLightDataIndex, bBrake);
+		INC_DWORD_STAT(STAT_SingularisVehicle_LightChanges);
+
+		if (ABaseWheeledVehiclePawn* Pawn = Vehicle.Get())
+		{
+			Pawn->SetBrakeLights(bBrake, bFireBlueprintEvent);
+		}
+	}
+
+	if (bReverse != bReverseLightsOn)
+	{
+		bReverseLightsOn = bReverse;
+		WriteLightValue(ReverseLightDataIndex, bReverse);
+		INC_DWORD_STAT(STAT_SingularisVehicle_LightChanges);
+	}
+}
+
+void USingularisVehicleLightComponent::WriteLightValue(const int32 DataIndex, const bool bOn) const
+{
+	const ABaseWheeledVehiclePawn* Pawn = Vehicle.Get();
+	if (DataIndex < 0 || !Pawn)
+	{
+		return;
+	}
+
+	Pawn->GetMesh()->SetCustomPrimitiveDataFloat(DataIndex, bOn ? 1.0f : 0.0f);
+}
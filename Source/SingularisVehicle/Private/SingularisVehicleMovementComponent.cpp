@@ -0,0 +1,480 @@
+/* =====================================================================
+ * SingularisVehicleMovementComponent.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleMovementComponent.h"
+
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+#include "SingularisVehicleGroundSubsystem.h"
+#include "SingularisVehicleSpec.h"
+#include "SingularisVehicleStats.h"
+#include "SingularisVehicleTypes.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSingularisVehicleMovement, Log, All);
+
+DECLARE_CYCLE_STAT(TEXT("Surface Events"), STAT_SingularisVehicle_SurfaceEvents, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Net Control Frames Sent"), STAT_SingularisVehicle_NetControlFramesSent, STATGROUP_SingularisVehicle);
+
+namespace SingularisVehicleNet
+{
+	static bool bCompactReplication = true;
+	static FAutoConsoleVariableRef CVarCompactReplication(
+		TEXT("SingularisVehicle.Net.CompactReplication"),
+		bCompactReplication,
+		TEXT("联网时是否使用紧凑复制。关闭后回到 Actor 移动复制与 Chaos 自带的输入复制，用于对比带宽。只影响之后开始的载具。"));
+
+	/** 外推复制状态的最长时间（秒） */
+	static constexpr float MaxExtrapolationTime = 0.25f;
+
+	/** 正在使用紧凑复制的载具数量 */
+	static int32 NumCompactVehicles = 0;
+
+	static uint64 LastReportControlBits = 0;
+	static uint64 LastReportStateBits = 0;
+	static double LastReportTime = 0.0;
+
+	static FAutoConsoleCommand ReportCommand(
+		TEXT("SingularisVehicle.Net.Report"),
+		TEXT("输出自上次调用以来紧凑复制的平均带宽（字节/秒/辆）。与默认路径对比时关闭 SingularisVehicle.Net.CompactReplication 并查看 stat net。"),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			const double Now = FPlatformTime::Seconds();
+			const uint64 ControlBits = ControlBitsSent.load();
+			const uint64 StateBits = StateBitsSent.load();
+
+			if (LastReportTime > 0.0)
+			{
+				const double Seconds = FMath::Max(Now - LastReportTime, UE_DOUBLE_SMALL_NUMBER);
+				const double NumVehicles = FMath::Max(NumCompactVehicles, 1);
+				UE_LOG(LogSingularisVehicleMovement,
+				       Display,
+				       TEXT("%d 辆载具，%.1f 秒：控制帧 %.1f 字节/秒/辆，状态 %.1f 字节/秒/辆"),
+				       NumCompactVehicles,
+				       Seconds,
+				       (ControlBits - LastReportControlBits) / 8.0 / Seconds / NumVehicles,
+				       (StateBits - LastReportStateBits) / 8.0 / Seconds / NumVehicles);
+			}
+			else
+			{
+				UE_LOG(LogSingularisVehicleMovement, Display, TEXT("开始统计，再次调用以输出结果"));
+			}
+
+			LastReportControlBits = ControlBits;
+			LastReportStateBits = StateBits;
+			LastReportTime = Now;
+		}));
+}
+
+void USingularisVehicleMovementComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// Chaos 复制的输入状态改为按实例在 PreReplication 中开关
+	RESET_REPLIFETIME_CONDITION(USingularisVehicleMovementComponent, ReplicatedState, COND_Custom);
+
+	// 拥有者也需要服务器的车身状态来纠正偏差，传动状态只有模拟代理需要
+	DOREPLIFETIME(USingularisVehicleMovementComponent, NetMotion);
+	DOREPLIFETIME_CONDITION(USingularisVehicleMovementComponent, NetDrive, COND_SimulatedOnly);
+}
+
+int32 USingularisVehicleMovementComponent::GetFunctionCallspace(UFunction* Function, FFrame* Stack)
+{
+	// 紧凑复制下由 ServerSendControlFrame 代替 Chaos 每帧发送的可靠 RPC
+	static const FName ServerUpdateStateName(TEXT("ServerUpdateState"));
+	if (bCompactReplicationActive && Function->GetFName() == ServerUpdateStateName)
+	{
+		return FunctionCallspace::Absorbed;
+	}
+
+	return Super::GetFunctionCallspace(Function, Stack);
+}
+
+void USingularisVehicleMovementComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	bCompactReplicationActive = bUseCompactReplication && SingularisVehicleNet::bCompactReplication && GetNetMode() != NM_Standalone;
+	if (!bCompactReplicationActive)
+	{
+		return;
+	}
+
+	++SingularisVehicleNet::NumCompactVehicles;
+
+	// 车身状态由 NetMotion 复制
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		GetOwner()->SetReplicateMovement(false);
+	}
+}
+
+void USingularisVehicleMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bCompactReplicationActive)
+	{
+		--SingularisVehicleNet::NumCompactVehicles;
+		bCompactReplicationActive = false;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void USingularisVehicleMovementComponent::TickComponent(const float DeltaTime, const ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+#if SINGULARISVEHICLE_WITH_COSMETICS
+	if (SurfaceResponseTable.IsValid() && OnWheelSurfaceChanged.IsBound())
+	{
+		UpdateSurfaceEvents();
+	}
+#endif
+
+	if (!bCompactReplicationActive)
+	{
+		return;
+	}
+
+	switch (GetOwnerRole())
+	{
+	case ROLE_Authority:
+		UpdateNetState();
+		break;
+	case ROLE_AutonomousProxy:
+		SendControlFrame(DeltaTime);
+		SmoothTowardsNetMotion(DeltaTime);
+		break;
+	case ROLE_SimulatedProxy:
+		SmoothTowardsNetMotion(DeltaTime);
+		break;
+	default:
+		break;
+	}
+}
+
+void USingularisVehicleMovementComponent::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	DOREPLIFETIME_ACTIVE_OVERRIDE(USingularisVehicleMovementComponent, ReplicatedState, !bCompactReplicationActive);
+}
+
+TUniquePtr<Chaos::FSimpleWheeledVehicle> USingularisVehicleMovementComponent::CreatePhysicsVehicle()
+{
+	TUniquePtr<Chaos::FSimpleWheeledVehicle> PhysicsVehicle = Super::CreatePhysicsVehicle();
+
+	// 每次创建物理载具都换一个新队列，旧模拟中尚未消费的采样随旧队列一起丢弃
+	InputQueue.Reset();
+	if (bUseAsyncPhysicsInput)
+	{
+		InputQueue = MakeShared<FSingularisVehicleInputQueue, ESPMode::ThreadSafe>();
+
+		if (!UPhysicsSettings::Get()->bTickPhysicsAsync)
+		{
+			UE_LOG(LogSingularisVehicleMovement,
+			       Warning,
+			       TEXT("'%s' 开启了异步输入，但项目未开启 Tick Physics Async，物理步长仍随帧率变化"),
+			       *GetPathNameSafe(this));
+		}
+	}
+
+	DriveRestoreQueue = MakeShared<FSingularisVehicleDriveRestoreQueue, ESPMode::ThreadSafe>();
+
+	FSingularisVehicleSimulationConfig Config;
+	Config.InputQueue = InputQueue;
+	Config.DriveRestoreQueue = DriveRestoreQueue;
+	Config.SnapshotBuffer = SnapshotBuffer;
+	Config.SurfaceResponses = SurfaceResponseTable;
+
+	// 规格烘焙的转向查找表由模拟直接求值，Chaos 的转向曲线保持原样
+	if (const FSingularisBakedCurve* SteeringCurve = VehicleSpec ? VehicleSpec->FindSimulationSteeringCurve(*this) : nullptr)
+	{
+		Config.SteeringCurve = *SteeringCurve;
+	}
+
+	if (bUseHeightfieldContact && GetWorld())
+	{
+		if (const USingularisVehicleGroundSubsystem* Ground = GetWorld()->GetSubsystem<USingularisVehicleGroundSubsystem>())
+		{
+			Config.GroundContact = Ground->GetContactProvider();
+			Config.GroundObstruction = GroundObstruction;
+		}
+	}
+
+	Config.ThrottleInputRate = ThrottleInputRate;
+	Config.BrakeInputRate = BrakeInputRate;
+	Config.SteeringInputRate = SteeringInputRate;
+	Config.HandbrakeInputRate = HandbrakeInputRate;
+	Config.bReverseAsBrake = bReverseAsBrake;
+	Config.AirborneAngularDamping = bUseAsyncPhysicsInput ? AirborneAngularDamping : 0.0f;
+
+	// 新模拟的快照序号从头开始，路面状态重新广播
+	FMemory::Memset(BroadcastWheelSurfaces, 0xFF);
+	BroadcastSlipMask = 0;
+	BroadcastSkidMask = 0;
+	SurfaceEventStepIndex = 0;
+
+	// 替换父类创建的模拟，此时物理载具尚未交给模拟
+	VehicleSimulationPT = MakeUnique<FSingularisVehicleSimulation>(Config);
+
+	// 延续重建前仍在保持的输入
+	if (InputQueue.IsValid())
+	{
+		EnqueueInputSample();
+	}
+
+	return PhysicsVehicle;
+}
+
+void USingularisVehicleMovementComponent::UpdateSurfaceEvents()
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_SurfaceEvents);
+
+	const FSingularisVehicleSnapshot Snapshot = SnapshotBuffer->Read();
+	if (Snapshot.StepIndex == SurfaceEventStepIndex)
+	{
+		return;
+	}
+	SurfaceEventStepIndex = Snapshot.StepIndex;
+
+	// 先记录全部状态再广播，回调中重建物理状态也不会打乱比较
+	uint8 ChangedMask = 0;
+	for (int32 WheelIndex = 0; WheelIndex < Snapshot.NumWheels; ++WheelIndex)
+	{
+		const uint8 WheelBit = static_cast<uint8>(1u << WheelIndex);
+		if (Snapshot.WheelSurface[WheelIndex] != BroadcastWheelSurfaces[WheelIndex]
+			|| ((Snapshot.WheelSlipMask ^ BroadcastSlipMask) & WheelBit)
+			|| ((Snapshot.WheelSkidMask ^ BroadcastSkidMask) & WheelBit))
+		{
+			ChangedMask |= WheelBit;
+			BroadcastWheelSurfaces[WheelIndex] = Snapshot.WheelSurface[WheelIndex];
+		}
+	}
+	BroadcastSlipMask = Snapshot.WheelSlipMask;
+	BroadcastSkidMask = Snapshot.WheelSkidMask;
+
+	for (int32 WheelIndex = 0; ChangedMask != 0; ++WheelIndex, ChangedMask >>= 1)
+	{
+		if (ChangedMask & 1u)
+		{
+			OnWheelSurfaceChanged.Broadcast(WheelIndex,
+			                                static_cast<EPhysicalSurface>(Snapshot.WheelSurface[WheelIndex]),
+			                                (Snapshot.WheelSlipMask & (1u << WheelIndex)) != 0,
+			                                (Snapshot.WheelSkidMask & (1u << WheelIndex)) != 0);
+		}
+	}
+}
+
+void USingularisVehicleMovementComponent::QueueThrottleInput(const float Throttle)
+{
+	SetThrottleInput(Throttle);
+	LatestInputs.Throttle = Throttle;
+	EnqueueInputSample();
+}
+
+void USingularisVehicleMovementComponent::QueueBrakeInput(const float Brake)
+{
+	SetBrakeInput(Brake);
+	LatestInputs.Brake = Brake;
+	EnqueueInputSample();
+}
+
+void USingularisVehicleMovementComponent::QueueSteeringInput(const float Steering)
+{
+	SetSteeringInput(Steering);
+	LatestInputs.Steering = Steering;
+	EnqueueInputSample();
+}
+
+void USingularisVehicleMovementComponent::QueueHandbrakeInput(const bool bHandbrake)
+{
+	SetHandbrakeInput(bHandbrake);
+	LatestInputs.Handbrake = bHandbrake ? 1.0f : 0.0f;
+	EnqueueInputSample();
+}
+
+void USingularisVehicleMovementComponent::QueueControlInputs(const float Throttle,
+                                                            const float Brake,
+                                                            const float Steering,
+                                                            const bool bHandbrake,
+                                                            const EVehicleControlChannels Channels)
+{
+	if (Channels == EVehicleControlChannels::None)
+	{
+		return;
+	}
+
+	if (EnumHasAnyFlags(Channels, EVehicleControlChannels::Throttle))
+	{
+		SetThrottleInput(Throttle);
+		LatestInputs.Throttle = Throttle;
+	}
+	if (EnumHasAnyFlags(Channels, EVehicleControlChannels::Brake))
+	{
+		SetBrakeInput(Brake);
+		LatestInputs.Brake = Brake;
+	}
+	if (EnumHasAnyFlags(Channels, EVehicleControlChannels::Steering))
+	{
+		SetSteeringInput(Steering);
+		LatestInputs.Steering = Steering;
+	}
+	if (EnumHasAnyFlags(Channels, EVehicleControlChannels::Handbrake))
+	{
+		SetHandbrakeInput(bHandbrake);
+		LatestInputs.Handbrake = bHandbrake ? 1.0f : 0.0f;
+	}
+	EnqueueInputSample();
+}
+
+void USingularisVehicleMovementComponent::SetNetCameraState(const bool bFrontCameraActive, const float LookYaw)
+{
+	PendingControl.SetCameraState(bFrontCameraActive, LookYaw);
+}
+
+void USingularisVehicleMovementComponent::RestoreDriveState(const int32 Gear, const float ForwardSpeed)
+{
+	SetTargetGear(Gear, true);
+
+	if (DriveRestoreQueue.IsValid())
+	{
+		DriveRestoreQueue->Enqueue(FSingularisVehicleDriveRestore{ForwardSpeed});
+	}
+}
+
+void USingularisVehicleMovementComponent::EnqueueInputSample()
+{
+	if (!InputQueue.IsValid())
+	{
+		return;
+	}
+
+	LatestInputs.Timestamp = FPlatformTime::Seconds();
+	InputQueue->Enqueue(LatestInputs);
+}
+
+void USingularisVehicleMovementComponent::ServerSendControlFrame_Implementation(const FSingularisVehicleNetControl& Frame)
+{
+	// 丢弃乱序到达的旧帧，序号按回绕比较
+	if (bHasReceivedControl && static_cast<int8>(Frame.Sequence - ReceivedControl.Sequence) <= 0)
+	{
+		return;
+	}
+
+	ReceivedControl = Frame;
+	bHasReceivedControl = true;
+
+	ApplyRemoteInputs(Frame.GetSteering(), Frame.GetThrottle(), Frame.GetBrake(), Frame.bHandbrake, Frame.TargetGear);
+}
+
+void USingularisVehicleMovementComponent::OnRep_NetMotion()
+{
+	NetMotionReceiveTime = GetWorld()->GetTimeSeconds();
+	bHasNetMotion = true;
+}
+
+void USingularisVehicleMovementComponent::OnRep_NetDrive()
+{
+	ApplyRemoteInputs(NetDrive.GetSteering(), NetDrive.GetThrottle(), NetDrive.GetBrake(), NetDrive.bHandbrake, NetDrive.Gear);
+}
+
+void USingularisVehicleMovementComponent::ApplyRemoteInputs(const float Steering, float Throttle, float Brake, const bool bHandbrake, const int32 Gear)
+{
+	ReplicatedState.SteeringInput = Steering;
+	ReplicatedState.ThrottleInput = Throttle;
+	ReplicatedState.BrakeInput = Brake;
+	ReplicatedState.HandbrakeInput = bHandbrake ? 1.0f : 0.0f;
+	ReplicatedState.TargetGear = Gear;
+
+	if (InputQueue.IsValid())
+	{
+		// 复制的是倒挡互换后的值，物理线程模拟会按挡位再互换一次，这里先换回原始输入
+		if (bReverseAsBrake && Gear < 0)
+		{
+			Swap(Throttle, Brake);
+		}
+
+		LatestInputs.Steering = Steering;
+		LatestInputs.Throttle = Throttle;
+		LatestInputs.Brake = Brake;
+		LatestInputs.Handbrake = bHandbrake ? 1.0f : 0.0f;
+		EnqueueInputSample();
+	}
+}
+
+void USingularisVehicleMovementComponent::SendControlFrame(const float DeltaTime)
+{
+	// 与 Chaos 的 ServerUpdateState 一样发送经过插值与倒挡处理后的输入
+	PendingControl.SetInputs(SteeringInput, ThrottleInput, BrakeInput, HandbrakeInput > 0.5f, GetTargetGear());
+	TimeSinceControlSent += DeltaTime;
+
+	const bool bChanged = !(PendingControl == LastSentControl);
+	const bool bRateAllows = TimeSinceControlSent >= 1.0f / ControlSendRate;
+	if ((bChanged && bRateAllows) || TimeSinceControlSent >= ControlKeepAliveInterval)
+	{
+		PendingControl.Sequence = LastSentControl.Sequence + 1;
+		ServerSendControlFrame(PendingControl);
+		LastSentControl = PendingControl;
+		TimeSinceControlSent = 0.0f;
+
+		INC_DWORD_STAT(STAT_SingularisVehicle_NetControlFramesSent);
+	}
+}
+
+void USingularisVehicleMovementComponent::UpdateNetState()
+{
+	if (UpdatedPrimitive)
+	{
+		NetMotion.SetFromBody(UpdatedPrimitive->GetComponentTransform(),
+		                      UpdatedPrimitive->GetPhysicsLinearVelocity(),
+		                      UpdatedPrimitive->GetPhysicsAngularVelocityInDegrees());
+	}
+
+	NetDrive.Set(GetEngineRotationSpeed(), GetCurrentGear(), SteeringInput, ThrottleInput, BrakeInput, HandbrakeInput > 0.5f);
+}
+
+void USingularisVehicleMovementComponent::SmoothTowardsNetMotion(const float DeltaTime)
+{
+	if (!bHasNetMotion || !UpdatedPrimitive || !UpdatedPrimitive->IsSimulatingPhysics())
+	{
+		return;
+	}
+
+	const float Age = FMath::Min(static_cast<float>(GetWorld()->GetTimeSeconds() - NetMotionReceiveTime), SingularisVehicleNet::MaxExtrapolationTime);
+	const FVector TargetLocation = NetMotion.Location + NetMotion.LinearVelocity * Age;
+	const FQuat TargetRotation = NetMotion.Rotation.Quaternion();
+
+	const FTransform CurrentTransform = UpdatedPrimitive->GetComponentTransform();
+	const float Error = FVector::Dist(CurrentTransform.GetLocation(), TargetLocation);
+
+	if (Error >= NetSnapDistance)
+	{
+		UpdatedPrimitive->SetWorldLocationAndRotation(TargetLocation, TargetRotation, false, nullptr, ETeleportType::TeleportPhysics);
+		UpdatedPrimitive->SetPhysicsLinearVelocity(NetMotion.LinearVelocity);
+		UpdatedPrimitive->SetPhysicsAngularVelocityInDegrees(NetMotion.AngularVelocity);
+		return;
+	}
+
+	// 拥有者在本地预测，偏差较小时信任本地模拟
+	if (GetOwnerRole() == ROLE_AutonomousProxy && Error < OwnerCorrectionThreshold)
+	{
+		return;
+	}
+
+	const float Alpha = 1.0f - FMath::Exp(-NetSmoothingSpeed * DeltaTime);
+	UpdatedPrimitive->SetWorldLocationAndRotation(FMath::Lerp(CurrentTransform.GetLocation(), TargetLocation, Alpha),
+	                                              FQuat::Slerp(CurrentTransform.GetRotation(), TargetRotation, Alpha),
+	                                              false,
+	                                              nullptr,
+	                                              ETeleportType::TeleportPhysics);
+	UpdatedPrimitive->SetPhysicsLinearVelocity(FMath::Lerp(UpdatedPrimitive->GetPhysicsLinearVelocity(), NetMotion.LinearVelocity, Alpha));
+	UpdatedPrimitive->SetPhysicsAngularVelocityInDegrees(
+		FMath::Lerp(UpdatedPrimitive->GetPhysicsAngularVelocityInDegrees(), NetMotion.AngularVelocity, Alpha));
+}
@@ -0,0 +1,225 @@
+/* =====================================================================
+ * SingularisVehicleNetTypes.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleNetTypes.h"
+
+#include "Engine/NetSerialization.h"
+
+std::atomic<uint64> SingularisVehicleNet::ControlBitsSent{0};
+std::atomic<uint64> SingularisVehicleNet::StateBitsSent{0};
+
+namespace SingularisVehicleNet
+{
+	static int8 QuantizeSigned(const float Value)
+	{
+		return static_cast<int8>(FMath::RoundToInt(FMath::Clamp(Value, -1.0f, 1.0f) * 127.0f));
+	}
+
+	static uint8 QuantizeUnsigned(const float Value)
+	{
+		return static_cast<uint8>(FMath::RoundToInt(FMath::Clamp(Value, 0.0f, 1.0f) * 255.0f));
+	}
+
+	/** 挡位以 4 位表示，范围 -8 到 7 */
+	static int8 ClampGear(const int32 Gear)
+	{
+		return static_cast<int8>(FMath::Clamp(Gear, -8, 7));
+	}
+
+	static void SerializeByte(FArchive& Ar, void* Value)
+	{
+		Ar.SerializeBits(Value, 8);
+	}
+
+	static void SerializeFlag(FArchive& Ar, bool& bValue)
+	{
+		uint8 Bit = bValue ? 1 : 0;
+		Ar.SerializeBits(&Bit, 1);
+		bValue = Bit != 0;
+	}
+
+	static void SerializeGear(FArchive& Ar, int8& Gear)
+	{
+		uint8 Packed = static_cast<uint8>(Gear + 8);
+		Ar.SerializeBits(&Packed, 4);
+		Gear = static_cast<int8>(Packed) - 8;
+	}
+
+	static FVector RoundVector(const FVector& Value)
+	{
+		return FVector(FMath::RoundToDouble(Value.X), FMath::RoundToDouble(Value.Y), FMath::RoundToDouble(Value.Z));
+	}
+
+	static double RoundAxis(const double Angle)
+	{
+		return FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(Angle));
+	}
+}
+
+// ==================== 控制帧 ====================
+
+void FSingularisVehicleNetControl::SetInputs(const float InSteering,
+                                             const float InThrottle,
+                                             const float InBrake,
+                                             const bool bInHandbrake,
+                                             const int32 InTargetGear)
+{
+	Steering = SingularisVehicleNet::QuantizeSigned(InSteering);
+	Throttle = SingularisVehicleNet::QuantizeUnsigned(InThrottle);
+	Brake = SingularisVehicleNet::QuantizeUnsigned(InBrake);
+	bHandbrake = bInHandbrake;
+	TargetGear = SingularisVehicleNet::ClampGear(InTargetGear);
+}
+
+void FSingularisVehicleNetControl::SetCameraState(const bool bInFrontCameraActive, const float InLookYaw)
+{
+	bFrontCameraActive = bInFrontCameraActive;
+	LookYaw = SingularisVehicleNet::QuantizeSigned(FRotator::NormalizeAxis(InLookYaw) / 180.0f);
+}
+
+bool FSingularisVehicleNetControl::operator==(const FSingularisVehicleNetControl& Other) const
+{
+	return Steering == Other.Steering
+		&& Throttle == Other.Throttle
+		&& Brake == Other.Brake
+		&& TargetGear == Other.TargetGear
+		&& bHandbrake == Other.bHandbrake
+		&& bFrontCameraActive == Other.bFrontCameraActive
+		&& LookYaw == Other.LookYaw;
+}
+
+bool FSingularisVehicleNetControl::NetSerialize(FArchive& Ar, [[maybe_unused]] UPackageMap* Map, bool& bOutSuccess)
+{
+	SingularisVehicleNet::SerializeByte(Ar, &Sequence);
+	SingularisVehicleNet::SerializeByte(Ar, &Steering);
+	SingularisVehicleNet::SerializeByte(Ar, &Throttle);
+	SingularisVehicleNet::SerializeByte(Ar, &Brake);
+	SingularisVehicleNet::SerializeGear(Ar, TargetGear);
+	SingularisVehicleNet::SerializeFlag(Ar, bHandbrake);
+	SingularisVehicleNet::SerializeFlag(Ar, bFrontCameraActive);
+
+	// 环顾角多数时间为零，只发一位
+	bool bHasLookYaw = LookYaw != 0;
+	SingularisVehicleNet::SerializeFlag(Ar, bHasLookYaw);
+	if (bHasLookYaw)
+	{
+		SingularisVehicleNet::SerializeByte(Ar, &LookYaw);
+	}
+	else
+	{
+		LookYaw = 0;
+	}
+
+	if (Ar.IsSaving())
+	{
+		SingularisVehicleNet::ControlBitsSent += 4 * 8 + 4 + 3 + (bHasLookYaw ? 8 : 0);
+	}
+
+	bOutSuccess = true;
+	return true;
+}
+
+// ==================== 运动状态 ====================
+
+void FSingularisVehicleNetMotion::SetFromBody(const FTransform& Transform, const FVector& InLinearVelocity, const FVector& InAngularVelocity)
+{
+	const FRotator BodyRotation = Transform.Rotator();
+
+	Location = SingularisVehicleNet::RoundVector(Transform.GetLocation());
+	Rotation = FRotator(SingularisVehicleNet::RoundAxis(BodyRotation.Pitch),
+	                    SingularisVehicleNet::RoundAxis(BodyRotation.Yaw),
+	                    SingularisVehicleNet::RoundAxis(BodyRotation.Roll));
+	LinearVelocity = SingularisVehicleNet::RoundVector(InLinearVelocity);
+	AngularVelocity = SingularisVehicleNet::RoundVector(InAngularVelocity);
+}
+
+bool FSingularisVehicleNetMotion::operator==(const FSingularisVehicleNetMotion& Other) const
+{
+	return Location == Other.Location
+		&& Rotation == Other.Rotation
+		&& LinearVelocity == Other.LinearVelocity
+		&& AngularVelocity == Other.AngularVelocity;
+}
+
+bool FSingularisVehicleNetMotion::NetSerialize(FArchive& Ar, [[maybe_unused]] UPackageMap* Map, bool& bOutSuccess)
+{
+	// 网络写出的归档都是 FBitWriter，据此统计实际写出的位数
+	const bool bCountBits = Ar.IsSaving() && Ar.IsNetArchive();
+	const int64 StartBits = bCountBits ? static_cast<FBitWriter&>(Ar).GetNumBits() : 0;
+
+	bOutSuccess = SerializePackedVector<1, 24>(Location, Ar);
+	Rotation.SerializeCompressedShort(Ar);
+
+	// 静止的载具不发送速度
+	bool bMoving = !LinearVelocity.IsZero() || !AngularVelocity.IsZero();
+	SingularisVehicleNet::SerializeFlag(Ar, bMoving);
+	if (bMoving)
+	{
+		bOutSuccess &= SerializePackedVector<1, 20>(LinearVelocity, Ar);
+		bOutSuccess &= SerializePackedVector<1, 16>(AngularVelocity, Ar);
+	}
+	else
+	{
+		LinearVelocity = FVector::ZeroVector;
+		AngularVelocity = FVector::ZeroVector;
+	}
+
+	if (bCountBits)
+	{
+		SingularisVehicleNet::StateBitsSent += static_cast<FBitWriter&>(Ar).GetNumBits() - StartBits;
+	}
+
+	return true;
+}
+
+// ==================== 传动状态 ====================
+
+void FSingularisVehicleNetDrive::Set(const float InEngineRPM,
+                                     const int32 InGear,
+                                     const float InSteering,
+                                     const float InThrottle,
+                                     const float InBrake,
+                                     const bool bInHandbrake)
+{
+	EngineRPM = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt(InEngineRPM / 10.0f), 0, 2047));
+	Gear = SingularisVehicleNet::ClampGear(InGear);
+	Steering = SingularisVehicleNet::QuantizeSigned(InSteering);
+	Throttle = SingularisVehicleNet::QuantizeUnsigned(InThrottle);
+	Brake = SingularisVehicleNet::QuantizeUnsigned(InBrake);
+	bHandbrake = bInHandbrake;
+}
+
+bool FSingularisVehicleNetDrive::operator==(const FSingularisVehicleNetDrive& Other) const
+{
+	return EngineRPM == Other.EngineRPM
+		&& Gear == Other.Gear
+		&& Steering == Other.Steering
+		&& Throttle == Other.Throttle
+		&& Brake == Other.Brake
+		&& bHandbrake == Other.bHandbrake;
+}
+
+bool FSingularisVehicleNetDrive::NetSerialize(FArchive& Ar, [[maybe_unused]] UPackageMap* Map, bool& bOutSuccess)
+{
+	// 转速 11 位，最高 20470 RPM
+	Ar.SerializeBits(&EngineRPM, 11);
+	SingularisVehicleNet::SerializeGear(Ar, Gear);
+	SingularisVehicleNet::SerializeByte(Ar, &Steering);
+	SingularisVehicleNet::SerializeByte(Ar, &Throttle);
+	SingularisVehicleNet::SerializeByte(Ar, &Brake);
+	SingularisVehicleNet::SerializeFlag(Ar, bHandbrake);
+
+	if (Ar.IsSaving())
+	{
+		SingularisVehicleNet::StateBitsSent += 11 + 4 + 3 * 8 + 1;
+	}
+
+	bOutSuccess = true;
+	return true;
+}
@@ -0,0 +1,444 @@
+/* =====================================================================
+ * SingularisVehiclePersistenceSubsystem.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehiclePersistenceSubsystem.h"
+
+#include "BaseWheeledVehiclePawn.h"
+#include "SingularisVehiclePoolSubsystem.h"
+#include "SingularisVehicleStats.h"
+#include "Engine/Level.h"
+#include "Engine/LevelBounds.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/World.h"
+#include "UObject/Package.h"
+#include "WorldPartition/WorldPartitionLevelStreamingDynamic.h"
+#include "WorldPartition/WorldPartitionRuntimeLevelStreamingCell.h"
+
+DEFINE_LOG_CATEGORY(LogSingularisVehiclePersistence);
+
+DECLARE_CYCLE_STAT(TEXT("Persistence Store"), STAT_SingularisVehicle_PersistenceStore, STATGROUP_SingularisVehicle);
+DECLARE_CYCLE_STAT(TEXT("Persistence Restore"), STAT_SingularisVehicle_PersistenceRestore, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Persisted Vehicles"), STAT_SingularisVehicle_Persisted, STATGROUP_SingularisVehicle);
+
+namespace SingularisVehiclePersistence
+{
+	static bool bEnable = true;
+	static FAutoConsoleVariableRef CVarEnable(
+		TEXT("SingularisVehicle.Persistence.Enable"),
+		bEnable,
+		TEXT("单元卸载时把其中的载具写入紧凑记录，重新加载后按批放回；关闭后不再写入新的记录，已有记录照常放回。"));
+
+	static int32 MaxRestoresPerFrame = 8;
+	static FAutoConsoleVariableRef CVarMaxRestoresPerFrame(
+		TEXT("SingularisVehicle.Persistence.MaxRestoresPerFrame"),
+		MaxRestoresPerFrame,
+		TEXT("每帧最多放回的载具数量，超出的部分留到下一帧。"));
+
+	static float RestoreBudgetMs = 2.0f;
+	static FAutoConsoleVariableRef CVarRestoreBudgetMs(
+		TEXT("SingularisVehicle.Persistence.RestoreBudgetMs"),
+		RestoreBudgetMs,
+		TEXT("每帧放回载具的时间预算（毫秒），超出后留到下一帧；每帧至少放回一辆。"));
+
+	static int32 MaxPooledPerClass = 64;
+	static FAutoConsoleVariableRef CVarMaxPooledPerClass(
+		TEXT("SingularisVehicle.Persistence.MaxPooledPerClass"),
+		MaxPooledPerClass,
+		TEXT("写入记录的载具归还对象池，直到池中同类闲置载具达到该数量，之后直接销毁。"));
+
+	/** 单元的名称，World Partition 单元在重新加载前后保持不变 */
+	static FName GetCellName(const ULevel* Level)
+	{
+		if (const ULevelStreaming* Streaming = ULevelStreaming::FindStreamingLevel(Level))
+		{
+			return Streaming->GetWorldAssetPackageFName();
+		}
+		return Level->GetOutermost()->GetFName();
+	}
+
+	/** 单元的范围：World Partition 单元取网格单元的范围，普通流送关卡取关卡内 Actor 的范围 */
+	static FBox GetCellBounds(const ULevel* Level)
+	{
+		if (const UWorldPartitionLevelStreamingDynamic* CellStreaming = Cast<UWorldPartitionLevelStreamingDynamic>(ULevelStreaming::FindStreamingLevel(Level)))
+		{
+			if (const UWorldPartitionRuntimeLevelStreamingCell* Cell = CellStreaming->GetWorldPartitionRuntimeCell())
+			{
+				return Cell->GetCellBounds();
+			}
+		}
+		return ALevelBounds::CalculateLevelBounds(Level);
+	}
+}
+
+void USingularisVehiclePersistenceSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// 在单元的碰撞与 Actor 移除之前写入记录，载具不会先掉出地面
+	PreLevelRemovedHandle = FWorldDelegates::PreLevelRemovedFromWorld.AddUObject(this, &USingularisVehiclePersistenceSubsystem::OnPreLevelRemoved);
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &USingularisVehiclePersistenceSubsystem::OnLevelAdded);
+}
+
+void USingularisVehiclePersistenceSubsystem::Deinitialize()
+{
+	FWorldDelegates::PreLevelRemovedFromWorld.Remove(PreLevelRemovedHandle);
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+
+	ClearRecords();
+	VehicleClasses.Empty();
+	Vehicles.Empty();
+	Super::Deinitialize();
+}
+
+bool USingularisVehiclePersistenceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId USingularisVehiclePersistenceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USingularisVehiclePersistenceSubsystem, STATGROUP_Tickables);
+}
+
+void USingularisVehiclePersistenceSubsystem::RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	if (Vehicle)
+	{
+		Vehicles.AddUnique(Vehicle);
+		RestoreLevelVehicle(Vehicle);
+	}
+}
+
+void USingularisVehiclePersistenceSubsystem::UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	const int32 Index = Vehicles.IndexOfByKey(Vehicle);
+	if (Index != INDEX_NONE)
+	{
+		Vehicles.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	}
+}
+
+void USingularisVehiclePersistenceSubsystem::Tick(const float DeltaTime)
+{
+	SET_DWORD_STAT(STAT_SingularisVehicle_Persisted, GetNumStored());
+
+	if (RestoringCells.IsEmpty())
+	{
+		LastNumRestored = 0;
+		LastRestoreSeconds = 0.0;
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_PersistenceRestore);
+
+	const double StartTime = FPlatformTime::Seconds();
+	LastNumRestored = RestorePending(FMath::Max(SingularisVehiclePersistence::MaxRestoresPerFrame, 1),
+	                                 StartTime + SingularisVehiclePersistence::RestoreBudgetMs * 0.001);
+	LastRestoreSeconds = FPlatformTime::Seconds() - StartTime;
+}
+
+int32 USingularisVehiclePersistenceSubsystem::StoreVehiclesInRegion(const FName CellName, const FBox& Region)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_PersistenceStore);
+
+	const double StartTime = FPlatformTime::Seconds();
+	UWorld* World = GetWorld();
+
+	// 单元在恢复完成前再次卸载：丢弃已放回的记录，其载具若仍在单元内会在下面重新写入
+	FPersistedCell* Cell = Cells.Find(CellName);
+	if (Cell && Cell->bRestoring)
+	{
+		Cell->Records.RemoveAt(0, Cell->NumRestored, EAllowShrinking::No);
+		Cell->NumRestored = 0;
+		Cell->bRestoring = false;
+		RestoringCells.Remove(CellName);
+	}
+
+	if (!SingularisVehiclePersistence::bEnable || !Region.IsValid)
+	{
+		return 0;
+	}
+
+	// 归还对象池时载具会注销自己，先收集再处理
+	StoreCandidates.Reset();
+	for (const TWeakObjectPtr<ABaseWheeledVehiclePawn>& WeakVehicle : Vehicles)
+	{
+		ABaseWheeledVehiclePawn* Vehicle = WeakVehicle.Get();
+
+		// 只处理属于持久关卡的载具，其他关卡中的载具随各自的关卡卸载
+		if (!IsValid(Vehicle) || Vehicle->IsPooled() || !Vehicle->AllowsPersistence() || Vehicle->IsPlayerControlled() ||
+			Vehicle->GetLevel() != World->PersistentLevel)
+		{
+			continue;
+		}
+
+		if (Region.IsInsideXY(Vehicle->GetActorLocation()))
+		{
+			StoreCandidates.Add(Vehicle);
+		}
+	}
+
+	if (StoreCandidates.IsEmpty())
+	{
+		LastStoreSeconds = FPlatformTime::Seconds() - StartTime;
+		return 0;
+	}
+
+	if (!Cell)
+	{
+		Cell = &Cells.Add(CellName);
+	}
+	Cell->Records.Reserve(Cell->Records.Num() + StoreCandidates.Num());
+
+	USingularisVehiclePoolSubsystem* Pool = World->GetSubsystem<USingularisVehiclePoolSubsystem>();
+
+	int32 NumStored = 0;
+	for (ABaseWheeledVehiclePawn* Vehicle : StoreCandidates)
+	{
+		const int32 ClassIndex = FindOrAddClassIndex(Vehicle->GetClass());
+		if (ClassIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		FSingularisPersistedVehicle& Record = Cell->Records.AddDefaulted_GetRef();
+		Vehicle->SavePersistentState(Record);
+		Record.ClassIndex = static_cast<uint16>(ClassIndex);
+		++NumStored;
+
+		// 池中闲置的同类载具足够放回时使用，多余的直接销毁
+		if (Pool && Pool->GetNumAvailable(Vehicle->GetClass()) < SingularisVehiclePersistence::MaxPooledPerClass)
+		{
+			Pool->ReleaseVehicle(Vehicle);
+		}
+		else
+		{
+			Vehicle->Destroy();
+		}
+	}
+	StoreCandidates.Reset();
+
+	LastStoreSeconds = FPlatformTime::Seconds() - StartTime;
+
+	UE_LOG(LogSingularisVehiclePersistence,
+	       Verbose,
+	       TEXT("单元 '%s' 卸载，写入 %d 辆载具，耗时 %.3f ms"),
+	       *CellName.ToString(),
+	       NumStored,
+	       LastStoreSeconds * 1000.0);
+	return NumStored;
+}
+
+void USingularisVehiclePersistenceSubsystem::RestoreCell(const FName CellName)
+{
+	FPersistedCell* Cell = Cells.Find(CellName);
+	if (!Cell || Cell->bRestoring)
+	{
+		return;
+	}
+
+	Cell->bRestoring = true;
+	RestoringCells.Add(CellName);
+}
+
+void USingularisVehiclePersistenceSubsystem::FlushRestores()
+{
+	RestorePending(MAX_int32, TNumericLimits<double>::Max());
+}
+
+void USingularisVehiclePersistenceSubsystem::ClearRecords()
+{
+	Cells.Empty();
+	RestoringCells.Empty();
+}
+
+int32 USingularisVehiclePersistenceSubsystem::StoreLevelVehicles(const FName CellName, const ULevel* Level)
+{
+	if (!SingularisVehiclePersistence::bEnable)
+	{
+		return 0;
+	}
+
+	FPersistedCell* Cell = nullptr;
+	for (const TWeakObjectPtr<ABaseWheeledVehiclePawn>& WeakVehicle : Vehicles)
+	{
+		const ABaseWheeledVehiclePawn* Vehicle = WeakVehicle.Get();
+		if (!IsValid(Vehicle) || Vehicle->GetLevel() != Level || Vehicle->IsPooled() || !Vehicle->AllowsPersistence() ||
+			Vehicle->IsPlayerControlled())
+		{
+			continue;
+		}
+
+		if (!Cell)
+		{
+			Cell = &Cells.FindOrAdd(CellName);
+		}
+
+		// 同名载具由引擎从单元包中重新创建，记录中的类序号不使用
+		FSingularisPersistedVehicle& Record = Cell->LevelVehicles.FindOrAdd(Vehicle->GetFName());
+		Vehicle->SavePersistentState(Record);
+	}
+
+	return Cell ? Cell->LevelVehicles.Num() : 0;
+}
+
+void USingularisVehiclePersistenceSubsystem::RestoreLevelVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	const ULevel* Level = Vehicle->GetLevel();
+	if (!Level || Level == GetWorld()->PersistentLevel)
+	{
+		return;
+	}
+
+	FPersistedCell* Cell = Cells.Find(SingularisVehiclePersistence::GetCellName(Level));
+	FSingularisPersistedVehicle Record;
+	if (!Cell || !Cell->LevelVehicles.RemoveAndCopyValue(Vehicle->GetFName(), Record))
+	{
+		return;
+	}
+
+	Vehicle->TeleportVehicle(FTransform(FQuat(Record.Rotation), Record.Location));
+	Vehicle->RestorePersistentState(Record);
+}
+
+int32 USingularisVehiclePersistenceSubsystem::GetNumStored() const
+{
+	int32 NumStored = 0;
+	for (const TPair<FName, FPersistedCell>& Pair : Cells)
+	{
+		NumStored += Pair.Value.Records.Num() - Pair.Value.NumRestored;
+	}
+	return NumStored;
+}
+
+int32 USingularisVehiclePersistenceSubsystem::GetNumStoredInCell(const FName CellName) const
+{
+	const FPersistedCell* Cell = Cells.Find(CellName);
+	return Cell ? Cell->Records.Num() - Cell->NumRestored : 0;
+}
+
+ABaseWheeledVehiclePawn* USingularisVehiclePersistenceSubsystem::RestoreRecord(USingularisVehiclePoolSubsystem* Pool,
+                                                                               const FSingularisPersistedVehicle& Record)
+{
+	if (!VehicleClasses.IsValidIndex(Record.ClassIndex) || !VehicleClasses[Record.ClassIndex])
+	{
+		return nullptr;
+	}
+
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = VehicleClasses[Record.ClassIndex];
+	const FTransform Transform(FQuat(Record.Rotation), Record.Location);
+
+	ABaseWheeledVehiclePawn* Vehicle;
+	if (Pool)
+	{
+		Vehicle = Pool->AcquireVehicle(VehicleClass, Transform);
+	}
+	else
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		Vehicle = GetWorld()->SpawnActor<ABaseWheeledVehiclePawn>(VehicleClass, Transform, SpawnParameters);
+	}
+
+	if (!Vehicle)
+	{
+		UE_LOG(LogSingularisVehiclePersistence, Warning, TEXT("无法放回载具 '%s'，记录已丢弃"), *GetNameSafe(VehicleClass));
+		return nullptr;
+	}
+
+	Vehicle->RestorePersistentState(Record);
+	return Vehicle;
+}
+
+int32 USingularisVehiclePersistenceSubsystem::RestorePending(const int32 MaxRestores, const double Deadline)
+{
+	USingularisVehiclePoolSubsystem* Pool = GetWorld()->GetSubsystem<USingularisVehiclePoolSubsystem>();
+
+	int32 NumRestored = 0;
+	while (!RestoringCells.IsEmpty() && NumRestored < MaxRestores)
+	{
+		// 至少放回一辆，预算很小时恢复仍然推进
+		if (NumRestored > 0 && FPlatformTime::Seconds() >= Deadline)
+		{
+			break;
+		}
+
+		FPersistedCell* Cell = Cells.Find(RestoringCells[0]);
+		if (!Cell || Cell->NumRestored >= Cell->Records.Num())
+		{
+			Cells.Remove(RestoringCells[0]);
+			RestoringCells.RemoveAt(0);
+			continue;
+		}
+
+		// 复制一份，放回载具的过程中可能有单元卸载并修改记录数组
+		const FSingularisPersistedVehicle Record = Cell->Records[Cell->NumRestored++];
+		RestoreRecord(Pool, Record);
+		++NumRestored;
+	}
+
+	// 最后一个单元恰好放完时立即移除，不必等到下一帧
+	if (!RestoringCells.IsEmpty())
+	{
+		const FPersistedCell* Cell = Cells.Find(RestoringCells[0]);
+		if (!Cell || Cell->NumRestored >= Cell->Records.Num())
+		{
+			Cells.Remove(RestoringCells[0]);
+			RestoringCells.RemoveAt(0);
+		}
+	}
+
+	return NumRestored;
+}
+
+int32 USingularisVehiclePersistenceSubsystem::FindOrAddClassIndex(UClass* VehicleClass)
+{
+	const int32 Index = VehicleClasses.IndexOfByKey(VehicleClass);
+	if (Index != INDEX_NONE)
+	{
+		return Index;
+	}
+
+	if (VehicleClasses.Num() > MAX_uint16)
+	{
+		UE_LOG(LogSingularisVehiclePersistence, Warning, TEXT("载具类过多，'%s' 无法写入记录"), *GetNameSafe(VehicleClass));
+		return INDEX_NONE;
+	}
+
+	return VehicleClasses.Add(VehicleClass);
+}
+
+void USingularisVehiclePersistenceSubsystem::OnPreLevelRemoved(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld() || !Level || Level == World->PersistentLevel)
+	{
+		return;
+	}
+
+	const FName CellName = SingularisVehiclePersistence::GetCellName(Level);
+	StoreLevelVehicles(CellName, Level);
+	StoreVehiclesInRegion(CellName, SingularisVehiclePersistence::GetCellBounds(Level));
+}
+
+void USingularisVehiclePersistenceSubsystem::OnLevelAdded(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld() || !Level || Level == World->PersistentLevel)
+	{
+		return;
+	}
+
+	// 单元的 Actor 在加入世界时已经 BeginPlay，仍未被认领的状态对应的载具已不在单元包中
+	const FName CellName = SingularisVehiclePersistence::GetCellName(Level);
+	if (FPersistedCell* Cell = Cells.Find(CellName))
+	{
+		Cell->LevelVehicles.Empty();
+	}
+
+	RestoreCell(CellName);
+}
@@ -0,0 +1,186 @@
+/* =====================================================================
+ * SingularisVehiclePlaybackComponent.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehiclePlaybackComponent.h"
+
+#include "BaseWheeledVehiclePawn.h"
+#include "ChaosWheeledVehicleMovementComponent.h"
+#include "SingularisVehicleLightComponent.h"
+#include "SingularisVehicleWheelVisualSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+
+USingularisVehiclePlaybackComponent::USingularisVehiclePlaybackComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
+}
+
+void USingularisVehiclePlaybackComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopPlayback();
+	Reader.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool USingularisVehiclePlaybackComponent::OpenRecording(const FString& FilePath)
+{
+	StopPlayback();
+
+	if (!Reader)
+	{
+		Reader = MakeUnique<FSingularisVehicleRecordingReader>();
+	}
+
+	if (!Reader->Open(FilePath))
+	{
+		return false;
+	}
+
+	CurrentFrame = Reader->GetFrame(0);
+	PlaybackTime = 0.0f;
+	return true;
+}
+
+void USingularisVehiclePlaybackComponent::StartPlayback()
+{
+	ABaseWheeledVehiclePawn* Pawn = Cast<ABaseWheeledVehiclePawn>(GetOwner());
+	if (!Pawn || !Reader || !Reader->IsOpen())
+	{
+		return;
+	}
+
+	if (!bPlaying)
+	{
+		SetVehicleSimulating(Pawn, false);
+	}
+
+	bPlaying = true;
+	PlaybackTime = 0.0f;
+	Reader->Sample(PlaybackTime, CurrentFrame);
+	ApplyCurrentFrame();
+
+	SetComponentTickEnabled(true);
+}
+
+void USingularisVehiclePlaybackComponent::StopPlayback()
+{
+	if (!bPlaying)
+	{
+		return;
+	}
+
+	bPlaying = false;
+	SetComponentTickEnabled(false);
+
+	if (ABaseWheeledVehiclePawn* Pawn = Cast<ABaseWheeledVehiclePawn>(GetOwner()))
+	{
+		SetVehicleSimulating(Pawn, true);
+	}
+}
+
+float USingularisVehiclePlaybackComponent::GetRecordingDuration() const
+{
+	return Reader && Reader->IsOpen() ? Reader->GetDuration() : 0.0f;
+}
+
+void USingularisVehiclePlaybackComponent::TickComponent(const float DeltaTime, const ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!bPlaying)
+	{
+		return;
+	}
+
+	const float Duration = Reader->GetDuration();
+	PlaybackTime += DeltaTime * PlaybackRate;
+	if (PlaybackTime > Duration)
+	{
+		if (!bLoop)
+		{
+			Reader->Sample(Duration, CurrentFrame);
+			ApplyCurrentFrame();
+			StopPlayback();
+			return;
+		}
+
+		PlaybackTime = Duration > 0.0f ? FMath::Fmod(PlaybackTime, Duration) : 0.0f;
+	}
+
+	Reader->Sample(PlaybackTime, CurrentFrame);
+	ApplyCurrentFrame();
+}
+
+void USingularisVehiclePlaybackComponent::SetVehicleSimulating(ABaseWheeledVehiclePawn* Pawn, const bool bSimulate) const
+{
+	USkeletalMeshComponent* Mesh = Pawn->GetMesh();
+	UChaosWheeledVehicleMovementComponent* Movement = Pawn->GetChaosVehicleMovement();
+
+	Pawn->SetActorEnableCollision(bSimulate);
+	Mesh->SetSimulatePhysics(bSimulate);
+	Movement->SetComponentTickEnabled(bSimulate);
+
+	// 回放期间 Chaos 车轮停止更新，车轮骨骼改由录制的车轮状态驱动
+	if (USingularisVehicleWheelVisualSubsystem* WheelVisuals = GetWorld()->GetSubsystem<USingularisVehicleWheelVisualSubsystem>())
+	{
+		if (bSimulate)
+		{
+			WheelVisuals->EndExternalWheelPoses(Pawn);
+		}
+		else
+		{
+			WheelVisuals->BeginExternalWheelPoses(Pawn);
+		}
+	}
+
+	if (bSimulate)
+	{
+		// 从回放结束时的速度接着模拟
+		Movement->ResetVehicle();
+		Mesh->SetPhysicsLinearVelocity(FVector(CurrentFrame.LinearVelocity));
+		if (USingularisVehicleLightComponent* Lights = Pawn->GetLightComponent())
+		{
+			Lights->SetLightState(false, false, false);
+		}
+		else
+		{
+			Pawn->SetBrakeLights(false);
+		}
+	}
+}
+
+void USingularisVehiclePlaybackComponent::ApplyCurrentFrame() const
+{
+	ABaseWheeledVehiclePawn* Pawn = Cast<ABaseWheeledVehiclePawn>(GetOwner());
+	if (!Pawn)
+	{
+		return;
+	}
+
+	Pawn->SetActorLocationAndRotation(FVector(CurrentFrame.Location), FRotator(CurrentFrame.Rotation), false, nullptr, ETeleportType::TeleportPhysics);
+
+	if (USingularisVehicleWheelVisualSubsystem* WheelVisuals = GetWorld()->GetSubsystem<USingularisVehicleWheelVisualSubsystem>())
+	{
+		const int32 NumWheels = FMath::Min<int32>(CurrentFrame.NumWheels, FSingularisVehicleRecordFrame::MaxWheels);
+		WheelVisuals->SetExternalWheelPoses(Pawn, MakeArrayView(CurrentFrame.Wheels, NumWheels));
+	}
+
+	// 运动组件在回放期间停止，灯光组件不会自行更新
+	if (USingularisVehicleLightComponent* Lights = Pawn->GetLightComponent())
+	{
+		Lights->SetLightState(CurrentFrame.AreBrakeLightsOn(), CurrentFrame.Gear < 0, CurrentFrame.IsHandbrakeOn());
+	}
+	else
+	{
+		Pawn->SetBrakeLights(CurrentFrame.AreBrakeLightsOn());
+	}
+}
@@ -0,0 +1,181 @@
+/* =====================================================================
+ * SingularisVehiclePoolSubsystem.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehiclePoolSubsystem.h"
+
+#include "BaseWheeledVehiclePawn.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY(LogSingularisVehiclePool);
+
+void USingularisVehiclePoolSubsystem::Deinitialize()
+{
+	Buckets.Reset();
+	Super::Deinitialize();
+}
+
+bool USingularisVehiclePoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USingularisVehiclePoolSubsystem::Prewarm(const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass, const int32 Count)
+{
+	if (!VehicleClass || Count <= 0)
+	{
+		return;
+	}
+
+	FSingularisVehiclePoolBucket& Bucket = Buckets.FindOrAdd(VehicleClass.Get());
+	Bucket.Available.Reserve(Bucket.Available.Num() + Count);
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		if (ABaseWheeledVehiclePawn* Vehicle = SpawnVehicle(VehicleClass, FTransform(ParkingLocation)))
+		{
+			Vehicle->OnReleasedToPool(ParkingLocation);
+			Bucket.Available.Add(Vehicle);
+		}
+	}
+}
+
+ABaseWheeledVehiclePawn* USingularisVehiclePoolSubsystem::AcquireVehicle(const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass,
+                                                                         const FTransform& SpawnTransform)
+{
+	if (!VehicleClass)
+	{
+		return nullptr;
+	}
+
+	if (FSingularisVehiclePoolBucket* Bucket = Buckets.Find(VehicleClass.Get()))
+	{
+		// 跳过在池中被外部销毁的实例
+		while (!Bucket->Available.IsEmpty())
+		{
+			ABaseWheeledVehiclePawn* Vehicle = Bucket->Available.Pop(EAllowShrinking::No);
+			if (IsValid(Vehicle))
+			{
+				Vehicle->OnAcquiredFromPool(SpawnTransform);
+				return Vehicle;
+			}
+		}
+	}
+
+	UE_LOG(LogSingularisVehiclePool, Verbose, TEXT("池中没有闲置的 '%s'，直接生成新的实例"), *GetNameSafe(VehicleClass));
+	return SpawnVehicle(VehicleClass, SpawnTransform);
+}
+
+void USingularisVehiclePoolSubsystem::ReleaseVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	if (!IsValid(Vehicle) || Vehicle->IsPooled())
+	{
+		return;
+	}
+
+	Vehicle->OnReleasedToPool(ParkingLocation);
+	Buckets.FindOrAdd(Vehicle->GetClass()).Available.Add(Vehicle);
+}
+
+int32 USingularisVehiclePoolSubsystem::GetNumAvailable(const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass) const
+{
+	const FSingularisVehiclePoolBucket* Bucket = Buckets.Find(VehicleClass.Get());
+	return Bucket ? Bucket->Available.Num() : 0;
+}
+
+ABaseWheeledVehiclePawn* USingularisVehiclePoolSubsystem::SpawnVehicle(const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass,
+                                                                       const FTransform& SpawnTransform) const
+{
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return GetWorld()->SpawnActor<ABaseWheeledVehiclePawn>(VehicleClass, SpawnTransform, SpawnParameters);
+}
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ * 对比对象池取出与 SpawnActor 的耗时
+ * 用法：SingularisVehicle.Pool.Benchmark /Game/Vehicles/BP_SportsCar.BP_SportsCar_C [Iterations]
+ */
+static FAutoConsoleCommandWithWorldAndArgs GSingularisVehiclePoolBenchmarkCommand(
+	TEXT("SingularisVehicle.Pool.Benchmark"),
+	TEXT("对比对象池取出与 SpawnActor 在每帧 1、10、100 次生成下的耗时。参数：<载具类路径> [迭代次数]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World || Args.IsEmpty())
+		{
+			UE_LOG(LogSingularisVehiclePool, Warning, TEXT("用法：SingularisVehicle.Pool.Benchmark <载具类路径> [迭代次数]"));
+			return;
+		}
+
+		const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = LoadClass<ABaseWheeledVehiclePawn>(nullptr, *Args[0]);
+		USingularisVehiclePoolSubsystem* Pool = World->GetSubsystem<USingularisVehiclePoolSubsystem>();
+		if (!VehicleClass || !Pool)
+		{
+			UE_LOG(LogSingularisVehiclePool, Warning, TEXT("无法加载载具类 '%s'"), *Args[0]);
+			return;
+		}
+
+		const int32 Iterations = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 5;
+		const FTransform SpawnTransform(FVector(0.0f, 0.0f, 10000.0f));
+
+		TArray<ABaseWheeledVehiclePawn*> Vehicles;
+		for (const int32 SpawnsPerFrame : {1, 10, 100})
+		{
+			double SpawnSeconds = 0.0;
+			double AcquireSeconds = 0.0;
+
+			for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+			{
+				// SpawnActor 路径
+				Vehicles.Reset();
+				double StartTime = FPlatformTime::Seconds();
+				for (int32 Index = 0; Index < SpawnsPerFrame; ++Index)
+				{
+					FActorSpawnParameters SpawnParameters;
+					SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+					Vehicles.Add(World->SpawnActor<ABaseWheeledVehiclePawn>(VehicleClass, SpawnTransform, SpawnParameters));
+				}
+				SpawnSeconds += FPlatformTime::Seconds() - StartTime;
+
+				for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+				{
+					if (Vehicle)
+					{
+						Vehicle->Destroy();
+					}
+				}
+
+				// 对象池路径，预热不计入耗时
+				Pool->Prewarm(VehicleClass, SpawnsPerFrame - Pool->GetNumAvailable(VehicleClass));
+				Vehicles.Reset();
+				StartTime = FPlatformTime::Seconds();
+				for (int32 Index = 0; Index < SpawnsPerFrame; ++Index)
+				{
+					Vehicles.Add(Pool->AcquireVehicle(VehicleClass, SpawnTransform));
+				}
+				AcquireSeconds += FPlatformTime::Seconds() - StartTime;
+
+				for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+				{
+					Pool->ReleaseVehicle(Vehicle);
+				}
+			}
+
+			UE_LOG(LogSingularisVehiclePool,
+			       Display,
+			       TEXT("%3d 次/帧：SpawnActor %.3f ms，对象池 %.3f ms（%d 次迭代平均）"),
+			       SpawnsPerFrame,
+			       SpawnSeconds * 1000.0 / Iterations,
+			       AcquireSeconds * 1000.0 / Iterations,
+			       Iterations);
+		}
+	}));
+
+#endif
@@ -0,0 +1,166 @@
+/* =====================================================================
+ * SingularisVehicleRecorderComponent.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleRecorderComponent.h"
+
+#include "BaseWheeledVehiclePawn.h"
+#include "ChaosVehicleWheel.h"
+#include "ChaosWheeledVehicleMovementComponent.h"
+#include "Misc/Paths.h"
+
+USingularisVehicleRecorderComponent::USingularisVehicleRecorderComponent()
+{
+	// 在物理之后采样，记录的是本帧模拟的结果
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+}
+
+void USingularisVehicleRecorderComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Vehicle = Cast<ABaseWheeledVehiclePawn>(GetOwner());
+	if (!Vehicle.IsValid())
+	{
+		UE_LOG(LogBaseWheeledVehiclePawn, Warning, TEXT("'%s' 的录制组件只能挂在 ABaseWheeledVehiclePawn 上"), *GetNameSafe(GetOwner()));
+		return;
+	}
+
+	if (bRecordOnBeginPlay)
+	{
+		StartRecording();
+	}
+}
+
+void USingularisVehicleRecorderComponent::StartRecording()
+{
+	if (!Vehicle.IsValid())
+	{
+		return;
+	}
+
+	// 只在容量变化时重新分配
+	const int32 Capacity = FMath::Max(FMath::CeilToInt(SampleRate * MaxDuration), 1);
+	if (Frames.Num() != Capacity)
+	{
+		Frames.Empty(Capacity);
+		Frames.SetNumUninitialized(Capacity);
+	}
+
+	Head = 0;
+	NumFrames = 0;
+	RecordTime = 0.0f;
+	TimeSinceSample = 1.0f / SampleRate;
+	bRecording = true;
+
+	SetComponentTickEnabled(true);
+}
+
+void USingularisVehicleRecorderComponent::StopRecording()
+{
+	bRecording = false;
+	SetComponentTickEnabled(false);
+}
+
+bool USingularisVehicleRecorderComponent::SaveRecording(const FString& FilePath)
+{
+	if (NumFrames == 0)
+	{
+		return false;
+	}
+
+	// 环形缓冲区展开为时间顺序，交给后台线程写出
+	TArray<FSingularisVehicleRecordFrame> OrderedFrames;
+	OrderedFrames.SetNumUninitialized(NumFrames);
+
+	const int32 Capacity = Frames.Num();
+	const int32 First = (Head - NumFrames + Capacity) % Capacity;
+	const int32 NumBeforeWrap = FMath::Min(NumFrames, Capacity - First);
+	FMemory::Memcpy(OrderedFrames.GetData(), Frames.GetData() + First, NumBeforeWrap * sizeof(FSingularisVehicleRecordFrame));
+	FMemory::Memcpy(OrderedFrames.GetData() + NumBeforeWrap, Frames.GetData(), (NumFrames - NumBeforeWrap) * sizeof(FSingularisVehicleRecordFrame));
+
+	// 覆盖过最早的帧时让时间从零开始
+	const float StartTime = OrderedFrames[0].Time;
+	for (FSingularisVehicleRecordFrame& Frame : OrderedFrames)
+	{
+		Frame.Time -= StartTime;
+	}
+
+	const FString ResolvedPath = FilePath.IsEmpty()
+		                             ? FPaths::ProjectSavedDir() / TEXT("VehicleRecordings") / GetNameSafe(GetOwner()) + TEXT(".svrc")
+		                             : FilePath;
+	SingularisVehicleRecording::SaveAsync(ResolvedPath, SampleRate, MoveTemp(OrderedFrames));
+	return true;
+}
+
+void USingularisVehicleRecorderComponent::TickComponent(const float DeltaTime, const ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!bRecording || !Vehicle.IsValid())
+	{
+		return;
+	}
+
+	RecordTime += DeltaTime;
+	TimeSinceSample += DeltaTime;
+
+	// 帧率低于采样率时每帧只采一次，时间戳保证回放速度正确
+	const float SampleInterval = 1.0f / SampleRate;
+	if (TimeSinceSample < SampleInterval)
+	{
+		return;
+	}
+	TimeSinceSample = FMath::Fmod(TimeSinceSample, SampleInterval);
+
+	CaptureFrame(Frames[Head]);
+	Head = (Head + 1) % Frames.Num();
+	NumFrames = FMath::Min(NumFrames + 1, Frames.Num());
+}
+
+void USingularisVehicleRecorderComponent::CaptureFrame(FSingularisVehicleRecordFrame& OutFrame) const
+{
+	const ABaseWheeledVehiclePawn* Pawn = Vehicle.Get();
+	const UChaosWheeledVehicleMovementComponent* Movement = Pawn->GetChaosVehicleMovement();
+
+	OutFrame.Time = RecordTime;
+	OutFrame.Location = FVector3f(Pawn->GetActorLocation());
+	OutFrame.Rotation = FRotator3f(Pawn->GetActorRotation());
+	OutFrame.LinearVelocity = FVector3f(Pawn->GetVelocity());
+
+	OutFrame.Steering = Movement->GetSteeringInput();
+	OutFrame.Throttle = Movement->GetThrottleInput();
+	OutFrame.Brake = Movement->GetBrakeInput();
+	OutFrame.EngineRPM = Movement->GetEngineRotationSpeed();
+	OutFrame.Gear = static_cast<int8>(Movement->GetCurrentGear());
+
+	OutFrame.Flags = 0;
+	if (Movement->GetHandbrakeInput())
+	{
+		OutFrame.Flags |= FSingularisVehicleRecordFrame::FlagHandbrake;
+	}
+	if (Pawn->AreBrakeLightsActive())
+	{
+		OutFrame.Flags |= FSingularisVehicleRecordFrame::FlagBrakeLights;
+	}
+
+	const int32 NumWheels = FMath::Min(Movement->Wheels.Num(), FSingularisVehicleRecordFrame::MaxWheels);
+	OutFrame.NumWheels = static_cast<uint8>(NumWheels);
+	OutFrame.Reserved = 0;
+	for (int32 WheelIndex = 0; WheelIndex < FSingularisVehicleRecordFrame::MaxWheels; ++WheelIndex)
+	{
+		FSingularisVehicleRecordWheel& OutWheel = OutFrame.Wheels[WheelIndex];
+		const UChaosVehicleWheel* Wheel = WheelIndex < NumWheels ? Movement->Wheels[WheelIndex] : nullptr;
+
+		OutWheel.RotationAngle = Wheel ? Wheel->GetRotationAngle() : 0.0f;
+		OutWheel.SteerAngle = Wheel ? Wheel->GetSteerAngle() : 0.0f;
+		OutWheel.SuspensionOffset = Wheel ? Wheel->GetSuspensionOffset() : 0.0f;
+	}
+}
@@ -0,0 +1,191 @@
+/* =====================================================================
+ * SingularisVehicleRecording.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleRecording.h"
+
+#include "Algo/BinarySearch.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Tasks/Task.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSingularisVehicleRecording, Log, All);
+
+FSingularisVehicleRecordingReader::FSingularisVehicleRecordingReader() = default;
+
+FSingularisVehicleRecordingReader::~FSingularisVehicleRecordingReader()
+{
+	Close();
+}
+
+bool FSingularisVehicleRecordingReader::Open(const FString& FilePath)
+{
+	Close();
+
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+
+	// 优先映射文件，回放只访问当前附近的几帧，由操作系统按需换页
+	MappedHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath));
+	if (MappedHandle.IsValid())
+	{
+		MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+	}
+
+	if (MappedRegion.IsValid())
+	{
+		Data = MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		MappedHandle.Reset();
+		if (!FFileHelper::LoadFileToArray(FallbackData, *FilePath))
+		{
+			UE_LOG(LogSingularisVehicleRecording, Warning, TEXT("无法打开录制文件 '%s'"), *FilePath);
+			return false;
+		}
+
+		Data = FallbackData.GetData();
+		Size = FallbackData.Num();
+	}
+
+	FSingularisVehicleRecordingHeader Header;
+	if (Size < static_cast<int64>(sizeof(Header)))
+	{
+		UE_LOG(LogSingularisVehicleRecording, Warning, TEXT("录制文件 '%s' 不完整"), *FilePath);
+		Close();
+		return false;
+	}
+
+	FMemory::Memcpy(&Header, Data, sizeof(Header));
+	if (!Header.IsValid() || Size < static_cast<int64>(sizeof(Header) + static_cast<int64>(Header.NumFrames) * Header.FrameSize))
+	{
+		UE_LOG(LogSingularisVehicleRecording,
+		       Warning,
+		       TEXT("录制文件 '%s' 的格式或版本不受支持（版本 %u，帧大小 %u）"),
+		       *FilePath,
+		       Header.Version,
+		       Header.FrameSize);
+		Close();
+		return false;
+	}
+
+	Frames = reinterpret_cast<const FSingularisVehicleRecordFrame*>(Data + sizeof(Header));
+	NumFrames = static_cast<int32>(Header.NumFrames);
+	LastFrameIndex = 0;
+
+	if (NumFrames == 0)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void FSingularisVehicleRecordingReader::Close()
+{
+	// 先释放区域再释放句柄
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+	FallbackData.Empty();
+
+	Frames = nullptr;
+	NumFrames = 0;
+	LastFrameIndex = 0;
+}
+
+float FSingularisVehicleRecordingReader::GetDuration() const
+{
+	return NumFrames > 0 ? Frames[NumFrames - 1].Time : 0.0f;
+}
+
+void FSingularisVehicleRecordingReader::Sample(const float Time, FSingularisVehicleRecordFrame& OutFrame) const
+{
+	check(IsOpen());
+
+	if (Time <= Frames[0].Time || NumFrames == 1)
+	{
+		OutFrame = Frames[0];
+		LastFrameIndex = 0;
+		return;
+	}
+
+	if (Time >= Frames[NumFrames - 1].Time)
+	{
+		OutFrame = Frames[NumFrames - 1];
+		LastFrameIndex = NumFrames - 1;
+		return;
+	}
+
+	// 顺序回放时只需从上次的位置向后走几步，跳转时回退到二分查找
+	int32 Index = LastFrameIndex;
+	if (Frames[Index].Time > Time || (Index + 8 < NumFrames && Frames[Index + 8].Time < Time))
+	{
+		Index = Algo::UpperBoundBy(MakeArrayView(Frames, NumFrames), Time, &FSingularisVehicleRecordFrame::Time) - 1;
+	}
+	while (Index + 1 < NumFrames - 1 && Frames[Index + 1].Time <= Time)
+	{
+		++Index;
+	}
+	LastFrameIndex = Index;
+
+	const FSingularisVehicleRecordFrame& A = Frames[Index];
+	const FSingularisVehicleRecordFrame& B = Frames[Index + 1];
+	const float Alpha = (Time - A.Time) / FMath::Max(B.Time - A.Time, UE_KINDA_SMALL_NUMBER);
+
+	// 离散状态取前一帧，连续量插值
+	OutFrame = A;
+	OutFrame.Time = Time;
+	OutFrame.Location = FMath::Lerp(A.Location, B.Location, Alpha);
+	OutFrame.Rotation = FQuat4f::Slerp(A.Rotation.Quaternion(), B.Rotation.Quaternion(), Alpha).Rotator();
+	OutFrame.LinearVelocity = FMath::Lerp(A.LinearVelocity, B.LinearVelocity, Alpha);
+	OutFrame.Steering = FMath::Lerp(A.Steering, B.Steering, Alpha);
+	OutFrame.Throttle = FMath::Lerp(A.Throttle, B.Throttle, Alpha);
+	OutFrame.Brake = FMath::Lerp(A.Brake, B.Brake, Alpha);
+	OutFrame.EngineRPM = FMath::Lerp(A.EngineRPM, B.EngineRPM, Alpha);
+
+	for (int32 WheelIndex = 0; WheelIndex < FMath::Min<int32>(A.NumWheels, FSingularisVehicleRecordFrame::MaxWheels); ++WheelIndex)
+	{
+		const FSingularisVehicleRecordWheel& WheelA = A.Wheels[WheelIndex];
+		const FSingularisVehicleRecordWheel& WheelB = B.Wheels[WheelIndex];
+		FSingularisVehicleRecordWheel& OutWheel = OutFrame.Wheels[WheelIndex];
+
+		OutWheel.RotationAngle = WheelA.RotationAngle + FRotator3f::NormalizeAxis(WheelB.RotationAngle - WheelA.RotationAngle) * Alpha;
+		OutWheel.SteerAngle = FMath::Lerp(WheelA.SteerAngle, WheelB.SteerAngle, Alpha);
+		OutWheel.SuspensionOffset = FMath::Lerp(WheelA.SuspensionOffset, WheelB.SuspensionOffset, Alpha);
+	}
+}
+
+void SingularisVehicleRecording::SaveAsync(const FString& FilePath, const float SampleRate, TArray<FSingularisVehicleRecordFrame>&& Frames)
+{
+	UE::Tasks::Launch(UE_SOURCE_LOCATION,
+	                  [FilePath, SampleRate, Frames = MoveTemp(Frames)]()
+	                  {
+		                  FSingularisVehicleRecordingHeader Header;
+		                  Header.NumFrames = Frames.Num();
+		                  Header.SampleRate = SampleRate;
+
+		                  IFileManager::Get().MakeDirectory(*FPaths::GetPath(FilePath), true);
+		                  const TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+		                  if (!Writer)
+		                  {
+			                  UE_LOG(LogSingularisVehicleRecording, Warning, TEXT("无法写入录制文件 '%s'"), *FilePath);
+			                  return;
+		                  }
+
+		                  Writer->Serialize(&Header, sizeof(Header));
+		                  Writer->Serialize(const_cast<FSingularisVehicleRecordFrame*>(Frames.GetData()), Frames.Num() * sizeof(FSingularisVehicleRecordFrame));
+		                  Writer->Close();
+
+		                  UE_LOG(LogSingularisVehicleRecording, Log, TEXT("已写入 %d 帧到 '%s'"), Frames.Num(), *FilePath);
+	                  });
+}
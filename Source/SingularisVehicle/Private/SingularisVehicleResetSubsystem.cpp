@@ -0,0 +1,313 @@
+/* =====================================================================
+ * SingularisVehicleResetSubsystem.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleResetSubsystem.h"
+
+#include "BaseWheeledVehiclePawn.h"
+#include "ChaosWheeledVehicleMovementComponent.h"
+#include "SingularisVehicleStats.h"
+#include "Engine/World.h"
+
+DEFINE_LOG_CATEGORY(LogSingularisVehicleReset);
+
+DECLARE_CYCLE_STAT(TEXT("Reset Update"), STAT_SingularisVehicle_ResetUpdate, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pending Resets"), STAT_SingularisVehicle_PendingResets, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Reset Queries"), STAT_SingularisVehicle_ResetQueries, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Resets Resolved"), STAT_SingularisVehicle_ResetsResolved, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Resets Fallback"), STAT_SingularisVehicle_ResetsFallback, STATGROUP_SingularisVehicle);
+
+namespace SingularisVehicleReset
+{
+	static float SampleInterval = 0.5f;
+	static FAutoConsoleVariableRef CVarSampleInterval(
+		TEXT("SingularisVehicle.Reset.SampleInterval"),
+		SampleInterval,
+		TEXT("记录安全位置的间隔（秒）。"));
+
+	static float MinSampleDistance = 300.0f;
+	static FAutoConsoleVariableRef CVarMinSampleDistance(
+		TEXT("SingularisVehicle.Reset.MinSampleDistance"),
+		MinSampleDistance,
+		TEXT("与上一个安全位置的距离（厘米）小于该值时不记录，停车时不会冲掉更早的位置。"));
+
+	static float MinUprightDot = 0.8f;
+	static FAutoConsoleVariableRef CVarMinUprightDot(
+		TEXT("SingularisVehicle.Reset.MinUprightDot"),
+		MinUprightDot,
+		TEXT("车身向上方向与世界向上方向的点积不小于该值时才视为姿态正常。"));
+
+	static float Lift = 50.0f;
+	static FAutoConsoleVariableRef CVarLift(
+		TEXT("SingularisVehicle.Reset.Lift"),
+		Lift,
+		TEXT("重置时在安全位置之上抬高的高度（厘米）。"));
+
+	static float GroundProbeDistance = 1000.0f;
+	static FAutoConsoleVariableRef CVarGroundProbeDistance(
+		TEXT("SingularisVehicle.Reset.GroundProbeDistance"),
+		GroundProbeDistance,
+		TEXT("地面射线在安全位置下方检测的距离（厘米）。"));
+
+	static float OverlapSkin = 10.0f;
+	static FAutoConsoleVariableRef CVarOverlapSkin(
+		TEXT("SingularisVehicle.Reset.OverlapSkin"),
+		OverlapSkin,
+		TEXT("重叠检测的包围盒向内收缩的距离（厘米），避免与地面的接触被当作阻挡。"));
+
+	static int32 MaxQueriesPerFrame = 64;
+	static FAutoConsoleVariableRef CVarMaxQueriesPerFrame(
+		TEXT("SingularisVehicle.Reset.MaxQueriesPerFrame"),
+		MaxQueriesPerFrame,
+		TEXT("每帧最多为多少个重置请求发起检测，超出的部分留到下一帧。"));
+
+	/** 所有车轮都着地时才视为在地面上 */
+	static bool IsOnGround(const UChaosWheeledVehicleMovementComponent& Movement)
+	{
+		const int32 NumWheels = Movement.Wheels.Num();
+		if (NumWheels == 0)
+		{
+			return false;
+		}
+
+		for (int32 WheelIndex = 0; WheelIndex < NumWheels; ++WheelIndex)
+		{
+			if (!Movement.GetWheelState(WheelIndex).bInContact)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+void USingularisVehicleResetSubsystem::Deinitialize()
+{
+	Histories.Reset();
+	Requests.Reset();
+	Super::Deinitialize();
+}
+
+bool USingularisVehicleResetSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId USingularisVehicleResetSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USingularisVehicleResetSubsystem, STATGROUP_Tickables);
+}
+
+void USingularisVehicleResetSubsystem::RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	if (!Vehicle || Histories.Contains(Vehicle))
+	{
+		return;
+	}
+
+	FVehicleHistory& History = Histories.Add(Vehicle);
+	History.Vehicle = Vehicle;
+	History.LocalBounds = Vehicle->CalculateComponentsBoundingBoxInLocalSpace();
+
+	// 错开各车的采样时间，避免同一帧集中采样
+	History.NextSampleTime = GetWorld()->GetTimeSeconds() + FMath::FRand() * SingularisVehicleReset::SampleInterval;
+}
+
+void USingularisVehicleResetSubsystem::UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	Histories.Remove(Vehicle);
+	Requests.RemoveAllSwap([Vehicle](const FResetRequest& Request) { return Request.Vehicle == Vehicle; }, EAllowShrinking::No);
+}
+
+void USingularisVehicleResetSubsystem::RequestReset(ABaseWheeledVehiclePawn* Vehicle)
+{
+	if (!Vehicle || Vehicle->IsPooled())
+	{
+		return;
+	}
+
+	if (Requests.ContainsByPredicate([Vehicle](const FResetRequest& Request) { return Request.Vehicle == Vehicle; }))
+	{
+		return;
+	}
+
+	FResetRequest& Request = Requests.AddDefaulted_GetRef();
+	Request.Vehicle = Vehicle;
+}
+
+void USingularisVehicleResetSubsystem::Tick(const float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_ResetUpdate);
+
+	// 第一遍：读取上一帧发起的检测结果，安全则传送，否则退到更早的位置
+	AcceptedBounds.Reset();
+	for (int32 Index = Requests.Num() - 1; Index >= 0; --Index)
+	{
+		FResetRequest& Request = Requests[Index];
+		if (!Request.Vehicle.IsValid() || (Request.bInFlight && ResolveRequest(Request)))
+		{
+			Requests.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		}
+	}
+
+	// 第二遍：为等待中的请求批量发起检测，每帧有上限
+	int32 Budget = FMath::Max(SingularisVehicleReset::MaxQueriesPerFrame, 1);
+	for (int32 Index = Requests.Num() - 1; Index >= 0 && Budget > 0; --Index)
+	{
+		FResetRequest& Request = Requests[Index];
+		if (Request.bInFlight)
+		{
+			continue;
+		}
+
+		if (IssueQueries(Request))
+		{
+			--Budget;
+			INC_DWORD_STAT_BY(STAT_SingularisVehicle_ResetQueries, 2);
+		}
+		else
+		{
+			ApplyFallback(*Request.Vehicle);
+			Requests.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			INC_DWORD_STAT(STAT_SingularisVehicle_ResetsFallback);
+		}
+	}
+
+	SampleHistories(GetWorld()->GetTimeSeconds());
+
+	SET_DWORD_STAT(STAT_SingularisVehicle_PendingResets, Requests.Num());
+}
+
+void USingularisVehicleResetSubsystem::SampleHistories(const double Now)
+{
+	for (auto It = Histories.CreateIterator(); It; ++It)
+	{
+		FVehicleHistory& History = It.Value();
+		if (Now < History.NextSampleTime)
+		{
+			continue;
+		}
+
+		const ABaseWheeledVehiclePawn* Vehicle = History.Vehicle.Get();
+		if (!Vehicle)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		History.NextSampleTime = Now + SingularisVehicleReset::SampleInterval;
+
+		// 冻结或停放的载具车轮状态不再更新，不能作为依据
+		const UChaosWheeledVehicleMovementComponent* Movement = Vehicle->GetChaosVehicleMovement();
+		if (Vehicle->IsPooled() || !Movement->IsComponentTickEnabled() || !SingularisVehicleReset::IsOnGround(*Movement))
+		{
+			continue;
+		}
+
+		const FTransform& Transform = Vehicle->GetActorTransform();
+		if (Transform.GetUnitAxis(EAxis::Z).Z < SingularisVehicleReset::MinUprightDot)
+		{
+			continue;
+		}
+
+		if (History.NumPoses > 0
+			&& FVector::DistSquared(History.GetPose(0).GetLocation(), Transform.GetLocation())
+			< FMath::Square(SingularisVehicleReset::MinSampleDistance))
+		{
+			continue;
+		}
+
+		History.Poses[History.Head] = Transform;
+		History.Head = (History.Head + 1) % HistorySize;
+		History.NumPoses = FMath::Min(History.NumPoses + 1, HistorySize);
+	}
+}
+
+bool USingularisVehicleResetSubsystem::ResolveRequest(FResetRequest& Request)
+{
+	const UWorld* World = GetWorld();
+
+	FTraceDatum GroundDatum;
+	FOverlapDatum OverlapDatum;
+	const bool bGroundReady = World->QueryTraceData(Request.GroundTrace, GroundDatum);
+	const bool bOverlapReady = World->QueryOverlapData(Request.OverlapTrace, OverlapDatum);
+	if (!bGroundReady || !bOverlapReady)
+	{
+		// 结果只保留一帧，句柄失效说明错过了，重新检测同一个位置
+		if (!World->IsTraceHandleValid(Request.GroundTrace, false) || !World->IsTraceHandleValid(Request.OverlapTrace, true))
+		{
+			Request.bInFlight = false;
+		}
+		return false;
+	}
+
+	Request.bInFlight = false;
+
+	const bool bHasGround = GroundDatum.OutHits.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+	const bool bBlocked = OverlapDatum.OutOverlaps.ContainsByPredicate([](const FOverlapResult& Overlap) { return Overlap.bBlockingHit; });
+	// 同一帧发起的重叠检测看不到彼此，需与本帧已传送的载具比较
+	const bool bTaken = AcceptedBounds.ContainsByPredicate([&Request](const FBox& Bounds) { return Bounds.Intersect(Request.CandidateBounds); });
+	if (!bHasGround || bBlocked || bTaken)
+	{
+		++Request.CandidateAge;
+		return false;
+	}
+	AcceptedBounds.Add(Request.CandidateBounds);
+
+	ABaseWheeledVehiclePawn* Vehicle = Request.Vehicle.Get();
+	Vehicle->TeleportVehicle(FTransform(Request.Candidate.GetRotation(),
+	                                    Request.Candidate.GetLocation() + FVector(0.0f, 0.0f, SingularisVehicleReset::Lift)));
+	INC_DWORD_STAT(STAT_SingularisVehicle_ResetsResolved);
+
+	UE_LOG(LogSingularisVehicleReset, Verbose, TEXT("'%s' 重置到第 %d 个安全位置"), *Vehicle->GetName(), Request.CandidateAge);
+	return true;
+}
+
+bool USingularisVehicleResetSubsystem::IssueQueries(FResetRequest& Request)
+{
+	ABaseWheeledVehiclePawn* Vehicle = Request.Vehicle.Get();
+	const FVehicleHistory* History = Histories.Find(Vehicle);
+	if (!History || Request.CandidateAge >= History->NumPoses)
+	{
+		return false;
+	}
+
+	// 只保留偏航角
+	const FTransform& Pose = History->GetPose(Request.CandidateAge);
+	const FQuat Rotation = FRotator(0.0f, Pose.Rotator().Yaw, 0.0f).Quaternion();
+	Request.Candidate = FTransform(Rotation, Pose.GetLocation());
+
+	UWorld* World = GetWorld();
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SingularisVehicleReset), false, Vehicle);
+
+	// 地面射线：安全位置下方是否仍有地面
+	const FVector Location = Pose.GetLocation();
+	Request.GroundTrace = World->AsyncLineTraceByChannel(EAsyncTraceType::Single,
+	                                                     Location + FVector(0.0f, 0.0f, SingularisVehicleReset::Lift),
+	                                                     Location - FVector(0.0f, 0.0f, SingularisVehicleReset::GroundProbeDistance),
+	                                                     GroundTraceChannel,
+	                                                     QueryParams);
+
+	// 重叠检测：抬高后的车身包围盒内是否有其他载具或障碍
+	const FBox& Bounds = History->LocalBounds;
+	const FVector Extent = (Bounds.GetExtent() - FVector(SingularisVehicleReset::OverlapSkin)).ComponentMax(FVector(1.0f));
+	const FVector Center = Location + Rotation.RotateVector(Bounds.GetCenter()) + FVector(0.0f, 0.0f, SingularisVehicleReset::Lift);
+	Request.OverlapTrace = World->AsyncOverlapByChannel(Center, Rotation, OverlapChannel, FCollisionShape::MakeBox(Extent), QueryParams);
+
+	// 只绕 Z 轴旋转，按世界空间包围盒保守判断与其他候选是否重叠
+	Request.CandidateBounds = FBox(-Extent, Extent).TransformBy(FTransform(Rotation, Center));
+
+	Request.bInFlight = true;
+	return true;
+}
+
+void USingularisVehicleResetSubsystem::ApplyFallback(ABaseWheeledVehiclePawn& Vehicle) const
+{
+	UE_LOG(LogSingularisVehicleReset, Verbose, TEXT("'%s' 没有可用的安全位置，原地重置"), *Vehicle.GetName());
+	Vehicle.ResetInPlace();
+}
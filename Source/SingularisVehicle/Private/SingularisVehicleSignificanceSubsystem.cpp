@@ -0,0 +1,232 @@
+/* =====================================================================
+ * SingularisVehicleSignificanceSubsystem.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleSignificanceSubsystem.h"
+
+#include "BaseWheeledVehiclePawn.h"
+#include "SingularisVehicleStats.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("Significance Update"), STAT_SingularisVehicle_SignificanceUpdate, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Vehicles (Full)"), STAT_SingularisVehicle_TierFull, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Vehicles (Reduced)"), STAT_SingularisVehicle_TierReduced, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Vehicles (LowDetail)"), STAT_SingularisVehicle_TierLowDetail, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Vehicles (Frozen)"), STAT_SingularisVehicle_TierFrozen, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tier Changes"), STAT_SingularisVehicle_TierChanges, STATGROUP_SingularisVehicle);
+
+namespace SingularisVehicleSignificance
+{
+	static bool bEnabled = true;
+	static FAutoConsoleVariableRef CVarEnabled(
+		TEXT("SingularisVehicle.Significance.Enable"),
+		bEnabled,
+		TEXT("是否启用载具重要度分级。关闭后所有载具恢复全速更新。"));
+
+	static float ReducedDistance = 5000.0f;
+	static FAutoConsoleVariableRef CVarReducedDistance(
+		TEXT("SingularisVehicle.Significance.ReducedDistance"),
+		ReducedDistance,
+		TEXT("超过该距离（厘米）的载具降低 Tick 频率。"));
+
+	static float LowDetailDistance = 15000.0f;
+	static FAutoConsoleVariableRef CVarLowDetailDistance(
+		TEXT("SingularisVehicle.Significance.LowDetailDistance"),
+		LowDetailDistance,
+		TEXT("超过该距离（厘米）的载具简化车轮检测。"));
+
+	static float FrozenDistance = 30000.0f;
+	static FAutoConsoleVariableRef CVarFrozenDistance(
+		TEXT("SingularisVehicle.Significance.FrozenDistance"),
+		FrozenDistance,
+		TEXT("超过该距离（厘米）的载具冻结物理与 Tick。"));
+
+	static float OffscreenDistanceScale = 2.0f;
+	static FAutoConsoleVariableRef CVarOffscreenDistanceScale(
+		TEXT("SingularisVehicle.Significance.OffscreenDistanceScale"),
+		OffscreenDistanceScale,
+		TEXT("不在屏幕上的载具在打分时距离乘以该系数。"));
+
+	static float Hysteresis = 0.1f;
+	static FAutoConsoleVariableRef CVarHysteresis(
+		TEXT("SingularisVehicle.Significance.Hysteresis"),
+		Hysteresis,
+		TEXT("降级时阈值额外放大的比例，避免载具在阈值附近反复切换层级。"));
+
+	static int32 MaxChangesPerFrame = 32;
+	static FAutoConsoleVariableRef CVarMaxChangesPerFrame(
+		TEXT("SingularisVehicle.Significance.MaxChangesPerFrame"),
+		MaxChangesPerFrame,
+		TEXT("每帧最多应用的层级变更数量，超出的部分留到下一帧。"));
+}
+
+void USingularisVehicleSignificanceSubsystem::Deinitialize()
+{
+	Vehicles.Reset();
+	Super::Deinitialize();
+}
+
+bool USingularisVehicleSignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId USingularisVehicleSignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USingularisVehicleSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void USingularisVehicleSignificanceSubsystem::RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	if (Vehicle && !Vehicles.ContainsByPredicate([Vehicle](const FVehicleEntry& Entry) { return Entry.Vehicle == Vehicle; }))
+	{
+		Vehicles.Add({Vehicle, Vehicle->GetSignificanceTier()});
+		++TierCounts[static_cast<int32>(Vehicle->GetSignificanceTier())];
+	}
+}
+
+void USingularisVehicleSignificanceSubsystem::UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	const int32 Index = Vehicles.IndexOfByPredicate([Vehicle](const FVehicleEntry& Entry) { return Entry.Vehicle == Vehicle; });
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	--TierCounts[static_cast<int32>(Vehicles[Index].Tier)];
+	Vehicles.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	if (Vehicle->GetSignificanceTier() != EVehicleSignificanceTier::Full)
+	{
+		Vehicle->ApplySignificanceTier(EVehicleSignificanceTier::Full);
+	}
+}
+
+int32 USingularisVehicleSignificanceSubsystem::GetNumVehiclesInTier(const EVehicleSignificanceTier Tier) const
+{
+	return Tier < EVehicleSignificanceTier::Num ? TierCounts[static_cast<int32>(Tier)] : 0;
+}
+
+void USingularisVehicleSignificanceSubsystem::Tick(const float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_SignificanceUpdate);
+
+	GatherViewerLocations();
+
+	// 清理已失效的载具
+	for (int32 Index = Vehicles.Num() - 1; Index >= 0; --Index)
+	{
+		if (!Vehicles[Index].Vehicle.IsValid())
+		{
+			--TierCounts[static_cast<int32>(Vehicles[Index].Tier)];
+			Vehicles.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		}
+	}
+
+	// 第一遍：只打分，不修改任何载具
+	PendingChanges.Reset();
+	for (int32 Index = 0; Index < Vehicles.Num(); ++Index)
+	{
+		const ABaseWheeledVehiclePawn* Vehicle = Vehicles[Index].Vehicle.Get();
+		const EVehicleSignificanceTier NewTier = SingularisVehicleSignificance::bEnabled
+			                                         ? EvaluateTier(*Vehicle, Vehicles[Index].Tier)
+			                                         : EVehicleSignificanceTier::Full;
+		if (NewTier != Vehicles[Index].Tier)
+		{
+			PendingChanges.Add({Index, NewTier, NewTier < Vehicles[Index].Tier});
+		}
+	}
+
+	// 第二遍：批量应用层级变更，升级优先于降级，避免玩家附近的载具被限额拖延；同类变更中目标层级越高越优先
+	PendingChanges.Sort([](const FPendingTierChange& A, const FPendingTierChange& B)
+	{
+		if (A.bPromotion != B.bPromotion)
+		{
+			return A.bPromotion;
+		}
+		return A.NewTier < B.NewTier;
+	});
+
+	const int32 NumChanges = FMath::Min(PendingChanges.Num(), FMath::Max(SingularisVehicleSignificance::MaxChangesPerFrame, 1));
+	for (int32 ChangeIndex = 0; ChangeIndex < NumChanges; ++ChangeIndex)
+	{
+		const FPendingTierChange& Change = PendingChanges[ChangeIndex];
+		FVehicleEntry& Entry = Vehicles[Change.EntryIndex];
+
+		--TierCounts[static_cast<int32>(Entry.Tier)];
+		++TierCounts[static_cast<int32>(Change.NewTier)];
+		Entry.Tier = Change.NewTier;
+		Entry.Vehicle->ApplySignificanceTier(Change.NewTier);
+	}
+
+	SET_DWORD_STAT(STAT_SingularisVehicle_TierFull, TierCounts[static_cast<int32>(EVehicleSignificanceTier::Full)]);
+	SET_DWORD_STAT(STAT_SingularisVehicle_TierReduced, TierCounts[static_cast<int32>(EVehicleSignificanceTier::Reduced)]);
+	SET_DWORD_STAT(STAT_SingularisVehicle_TierLowDetail, TierCounts[static_cast<int32>(EVehicleSignificanceTier::LowDetail)]);
+	SET_DWORD_STAT(STAT_SingularisVehicle_TierFrozen, TierCounts[static_cast<int32>(EVehicleSignificanceTier::Frozen)]);
+	SET_DWORD_STAT(STAT_SingularisVehicle_TierChanges, NumChanges);
+}
+
+void USingularisVehicleSignificanceSubsystem::GatherViewerLocations()
+{
+	ViewerLocations.Reset();
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewerLocations.Add(ViewLocation);
+		}
+	}
+}
+
+EVehicleSignificanceTier USingularisVehicleSignificanceSubsystem::EvaluateTier(const ABaseWheeledVehiclePawn& Vehicle,
+                                                                               const EVehicleSignificanceTier CurrentTier) const
+{
+	// 玩家控制的载具以及没有观察者时始终全速
+	if (!Vehicle.AllowsSignificanceThrottling() || Vehicle.IsPlayerControlled() || ViewerLocations.IsEmpty())
+	{
+		return EVehicleSignificanceTier::Full;
+	}
+
+	const FVector VehicleLocation = Vehicle.GetActorLocation();
+	double MinDistanceSquared = TNumericLimits<double>::Max();
+	for (const FVector& ViewerLocation : ViewerLocations)
+	{
+		MinDistanceSquared = FMath::Min(MinDistanceSquared, FVector::DistSquared(ViewerLocation, VehicleLocation));
+	}
+
+	float Distance = FMath::Sqrt(MinDistanceSquared);
+	if (!Vehicle.WasRecentlyRendered(0.25f))
+	{
+		Distance *= SingularisVehicleSignificance::OffscreenDistanceScale;
+	}
+
+	// 阈值按层级由高到低排列，降级（层级数值变大）时放大阈值形成滞后区间
+	const float Thresholds[] = {
+		SingularisVehicleSignificance::ReducedDistance,
+		SingularisVehicleSignificance::LowDetailDistance,
+		SingularisVehicleSignificance::FrozenDistance
+	};
+
+	int32 NewTier = 0;
+	for (int32 ThresholdIndex = 0; ThresholdIndex < UE_ARRAY_COUNT(Thresholds); ++ThresholdIndex)
+	{
+		const bool bDemoting = ThresholdIndex >= static_cast<int32>(CurrentTier);
+		const float Threshold = Thresholds[ThresholdIndex] * (bDemoting ? 1.0f + SingularisVehicleSignificance::Hysteresis : 1.0f);
+		if (Distance > Threshold)
+		{
+			NewTier = ThresholdIndex + 1;
+		}
+	}
+
+	return static_cast<EVehicleSignificanceTier>(NewTier);
+}
@@ -0,0 +1,329 @@
+/* =====================================================================
+ * SingularisVehicleSimulation.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleSimulation.h"
+
+#include "ChaosVehicleWheel.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "SingularisVehicleStats.h"
+#include "VehicleUtility.h"
+
+#include <atomic>
+
+DECLARE_CYCLE_STAT(TEXT("Ground Contact"), STAT_SingularisVehicle_GroundContact, STATGROUP_SingularisVehicle);
+
+namespace SingularisVehicleSimulation
+{
+	/** 物理步耗时统计，载具可能在多个物理线程任务中并行模拟 */
+	static std::atomic<bool> bCollectStepStats{false};
+	static std::atomic<int64> NumSteps{0};
+	static std::atomic<uint64> StepCycles{0};
+}
+
+FSingularisVehicleSimulation::FSingularisVehicleSimulation(const FSingularisVehicleSimulationConfig& InConfig)
+	: Config(InConfig)
+{
+}
+
+void FSingularisVehicleSimulation::ApplyInput(const FControlInputs& ControlInputs, const float DeltaTime)
+{
+	if (!Config.InputQueue.IsValid())
+	{
+		AppliedInputs = ControlInputs;
+		Super::ApplyInput(ControlInputs, DeltaTime);
+		return;
+	}
+
+	// 将两步之间的真实时间按采样时间戳分段，每段以对应的目标推进平滑，保留短促点按的效果
+	const double Now = FPlatformTime::Seconds();
+	if (LastConsumeTime <= 0.0)
+	{
+		LastConsumeTime = Now - DeltaTime;
+	}
+
+	const double Window = FMath::Max(Now - LastConsumeTime, UE_DOUBLE_SMALL_NUMBER);
+	double HeldSince = LastConsumeTime;
+
+	FSingularisVehicleInputSample Sample;
+	while (Config.InputQueue->Dequeue(Sample))
+	{
+		const double HeldFraction = FMath::Clamp((Sample.Timestamp - HeldSince) / Window, 0.0, 1.0);
+		AdvanceInputs(DeltaTime * static_cast<float>(HeldFraction));
+
+		TargetInputs = Sample;
+		HeldSince = FMath::Max(HeldSince, Sample.Timestamp);
+	}
+
+	AdvanceInputs(DeltaTime * static_cast<float>(FMath::Clamp((Now - HeldSince) / Window, 0.0, 1.0)));
+	LastConsumeTime = Now;
+
+	// 挡位选择仍由游戏线程决定，这里只替换输入的幅度
+	FControlInputs ModifiedInputs = ControlInputs;
+	ModifiedInputs.ThrottleInput = SmoothedInputs.Throttle;
+	ModifiedInputs.BrakeInput = SmoothedInputs.Brake;
+	ModifiedInputs.SteeringInput = SmoothedInputs.Steering;
+	ModifiedInputs.HandbrakeInput = SmoothedInputs.Handbrake;
+
+	if (Config.bReverseAsBrake && PVehicle && PVehicle->HasTransmission() && PVehicle->GetTransmission().GetCurrentGear() < 0)
+	{
+		Swap(ModifiedInputs.ThrottleInput, ModifiedInputs.BrakeInput);
+	}
+
+	AppliedInputs = ModifiedInputs;
+	Super::ApplyInput(ModifiedInputs, DeltaTime);
+}
+
+void FSingularisVehicleSimulation::UpdateSimulation(const float DeltaTime, const FChaosVehicleAsyncInput& InputData, Chaos::FRigidBodyHandle_Internal* Handle)
+{
+	const bool bCollectStepStats = SingularisVehicleSimulation::bCollectStepStats.load(std::memory_order_relaxed);
+	const uint64 StartCycles = bCollectStepStats ? FPlatformTime::Cycles64() : 0;
+
+	// 同一步内收到多次恢复请求时只使用最新的一次，在父类推进本步之前写入
+	if (Config.DriveRestoreQueue.IsValid() && PVehicle)
+	{
+		FSingularisVehicleDriveRestore Restore;
+		bool bHasRestore = false;
+		while (Config.DriveRestoreQueue->Dequeue(Restore))
+		{
+			bHasRestore = true;
+		}
+
+		if (bHasRestore)
+		{
+			ApplyDriveRestore(Restore);
+		}
+	}
+
+	Super::UpdateSimulation(DeltaTime, InputData, Handle);
+
+	// 空中时施加与角速度相反的角加速度，效果等同于游戏线程上设置刚体的角度阻尼
+	if (Config.AirborneAngularDamping > 0.0f && VehicleState.bVehicleInAir)
+	{
+		AddTorqueInRadians(-VehicleState.VehicleWorldAngularVelocity * Config.AirborneAngularDamping, true, true);
+	}
+
+	if (Config.SnapshotBuffer.IsValid())
+	{
+		PublishSnapshot(DeltaTime);
+	}
+
+	if (bCollectStepStats)
+	{
+		SingularisVehicleSimulation::StepCycles.fetch_add(FPlatformTime::Cycles64() - StartCycles, std::memory_order_relaxed);
+		SingularisVehicleSimulation::NumSteps.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void FSingularisVehicleSimulation::SetCollectStepStats(const bool bCollect)
+{
+	SingularisVehicleSimulation::bCollectStepStats.store(bCollect);
+}
+
+bool FSingularisVehicleSimulation::ConsumeStepStats(int64& OutNumSteps, double& OutSeconds)
+{
+	OutNumSteps = SingularisVehicleSimulation::NumSteps.exchange(0);
+	OutSeconds = FPlatformTime::ToSeconds64(SingularisVehicleSimulation::StepCycles.exchange(0));
+	return OutNumSteps > 0;
+}
+
+void FSingularisVehicleSimulation::ApplyDriveRestore(const FSingularisVehicleDriveRestore& Restore)
+{
+	for (Chaos::FSimpleWheelSim& Wheel : PVehicle->Wheels)
+	{
+		const float Radius = Wheel.GetEffectiveRadius();
+		if (Radius > UE_KINDA_SMALL_NUMBER)
+		{
+			Wheel.SetAngularVelocity(Restore.ForwardSpeed / Radius);
+		}
+	}
+}
+
+void FSingularisVehicleSimulation::ProcessSteering(const FControlInputs& ControlInputs)
+{
+	if (!Config.SteeringCurve.IsBaked() || !PVehicle || PVehicle->Steering.IsEmpty())
+	{
+		Super::ProcessSteering(ControlInputs);
+		return;
+	}
+
+	// 与父类相同，只是转向比例由查找表求值；整车只求一次，Chaos 对每个转向轮都查找一次曲线
+	Chaos::FSimpleSteeringSim& Steering = PVehicle->GetSteering();
+	const float SpeedScale = Config.SteeringCurve.Evaluate(Chaos::CmSToMPH(VehicleState.ForwardSpeed));
+	const float SteeringInput = ControlInputs.SteeringInput * SpeedScale;
+
+	for (int32 WheelIndex = 0; WheelIndex < PVehicle->Wheels.Num(); ++WheelIndex)
+	{
+		Chaos::FSimpleWheelSim& Wheel = PVehicle->Wheels[WheelIndex];
+		if (Wheel.SteeringEnabled)
+		{
+			const float WheelSide = PVehicle->GetSuspension(WheelIndex).GetLocalRestingPosition().Y;
+			Wheel.SetSteeringAngle(Steering.GetSteeringAngle(SteeringInput, Wheel.MaxSteeringAngle, WheelSide));
+		}
+		else
+		{
+			Wheel.SetSteeringAngle(0.0f);
+		}
+	}
+}
+
+void FSingularisVehicleSimulation::ApplyWheelFrictionForces(const float DeltaTime)
+{
+	// 父类在悬挂阶段按物理材质设置路面摩擦力，这里在摩擦力计算之前叠加路面响应
+	if (Config.SurfaceResponses.IsValid() && PVehicle)
+	{
+		ApplySurfaceResponses();
+	}
+
+	Super::ApplyWheelFrictionForces(DeltaTime);
+}
+
+void FSingularisVehicleSimulation::PerformSuspensionTraces(const TArray<Chaos::FSuspensionTrace>& SuspensionTrace,
+                                                           FCollisionQueryParams& TraceParams,
+                                                           FCollisionResponseContainer& CollisionResponse,
+                                                           TArray<FWheelTraceParams>& WheelTraceParams)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_GroundContact);
+
+	FSingularisGroundContactProvider* Provider = Config.GroundContact.Get();
+	if (!Provider)
+	{
+		Super::PerformSuspensionTraces(SuspensionTrace, TraceParams, CollisionResponse, WheelTraceParams);
+		return;
+	}
+
+	const bool bCollectStats = Provider->bCollectStats.load(std::memory_order_relaxed);
+	const double StartTime = bCollectStats ? FPlatformTime::Seconds() : 0.0;
+
+	// 高度场只能代替射线检测，也不包含动态物体；校验模式下以场景查询的结果驱动模拟，只统计解析结果与之的偏差
+	const bool bEligible = Provider->bEnabled.load(std::memory_order_relaxed)
+		&& !(Config.GroundObstruction.IsValid() && Config.GroundObstruction->load(std::memory_order_relaxed))
+		&& WheelState.TraceResult.Num() >= SuspensionTrace.Num()
+		&& !WheelTraceParams.ContainsByPredicate([](const FWheelTraceParams& Params) { return Params.SweepShape != ESweepShape::Raycast; });
+	const bool bValidate = bEligible && Provider->bValidate.load(std::memory_order_relaxed);
+
+	const bool bAnalytic = bEligible
+		&& !bValidate
+		&& Provider->TraceWheels(SuspensionTrace, MakeArrayView(WheelState.TraceResult.GetData(), SuspensionTrace.Num()));
+	if (!bAnalytic)
+	{
+		Super::PerformSuspensionTraces(SuspensionTrace, TraceParams, CollisionResponse, WheelTraceParams);
+	}
+
+	if (bValidate)
+	{
+		TArray<FHitResult, TInlineAllocator<FSingularisVehicleSnapshot::MaxWheels>> AnalyticHits;
+		AnalyticHits.SetNum(SuspensionTrace.Num());
+		if (Provider->TraceWheels(SuspensionTrace, AnalyticHits))
+		{
+			for (int32 WheelIndex = 0; WheelIndex < SuspensionTrace.Num(); ++WheelIndex)
+			{
+				Provider->AddValidationSample(WheelState.TraceResult[WheelIndex], AnalyticHits[WheelIndex]);
+			}
+		}
+	}
+
+	if (bCollectStats)
+	{
+		Provider->AddTraceStats(bAnalytic, SuspensionTrace.Num(), FPlatformTime::Seconds() - StartTime);
+	}
+}
+
+void FSingularisVehicleSimulation::ApplySurfaceResponses()
+{
+	const FSingularisSurfaceResponseTable& Table = *Config.SurfaceResponses;
+	const int32 NumWheels = FMath::Min(PVehicle->Wheels.Num(), WheelState.TraceResult.Num());
+	for (int32 WheelIndex = 0; WheelIndex < NumWheels; ++WheelIndex)
+	{
+		Chaos::FSimpleWheelSim& Wheel = PVehicle->Wheels[WheelIndex];
+		if (!Wheel.InContact())
+		{
+			continue;
+		}
+
+		const UPhysicalMaterial* Material = WheelState.TraceResult[WheelIndex].PhysMaterial.Get();
+		const uint8 SurfaceType = Material ? static_cast<uint8>(Material->SurfaceType.GetValue()) : static_cast<uint8>(SurfaceType_Default);
+		const float MaterialFriction = Material ? Material->Friction : 1.0f;
+		Wheel.SetSurfaceFriction(MaterialFriction * Table.Get(SurfaceType).FrictionScale);
+
+		if (WheelIndex < FSingularisVehicleSnapshot::MaxWheels)
+		{
+			WheelSurfaces[WheelIndex] = SurfaceType;
+		}
+	}
+}
+
+void FSingularisVehicleSimulation::PublishSnapshot(const float DeltaTime)
+{
+	SimulationTime += DeltaTime;
+
+	FSingularisVehicleSnapshot Snapshot;
+	Snapshot.StepIndex = NextStepIndex++;
+	Snapshot.SimulationTime = static_cast<float>(SimulationTime);
+	Snapshot.ForwardSpeed = VehicleState.ForwardSpeed;
+	Snapshot.bInAir = VehicleState.bVehicleInAir;
+	Snapshot.Throttle = AppliedInputs.ThrottleInput;
+	Snapshot.Brake = AppliedInputs.BrakeInput;
+	Snapshot.Steering = AppliedInputs.SteeringInput;
+	Snapshot.Handbrake = AppliedInputs.HandbrakeInput;
+
+	if (PVehicle)
+	{
+		if (PVehicle->HasEngine())
+		{
+			Snapshot.EngineRPM = PVehicle->GetEngine().GetEngineRPM();
+		}
+
+		if (PVehicle->HasTransmission())
+		{
+			Snapshot.CurrentGear = static_cast<int8>(PVehicle->GetTransmission().GetCurrentGear());
+		}
+
+		const int32 NumWheels = FMath::Min(PVehicle->Wheels.Num(), FSingularisVehicleSnapshot::MaxWheels);
+		Snapshot.NumWheels = static_cast<uint8>(NumWheels);
+		for (int32 WheelIndex = 0; WheelIndex < NumWheels; ++WheelIndex)
+		{
+			const Chaos::FSimpleWheelSim& Wheel = PVehicle->Wheels[WheelIndex];
+			Snapshot.WheelSlip[WheelIndex] = Wheel.GetSlipMagnitude();
+			Snapshot.WheelSlipAngle[WheelIndex] = Wheel.GetSlipAngle();
+			Snapshot.WheelContactMask |= Wheel.InContact() ? static_cast<uint8>(1u << WheelIndex) : 0;
+		}
+
+		if (Config.SurfaceResponses.IsValid())
+		{
+			for (int32 WheelIndex = 0; WheelIndex < NumWheels; ++WheelIndex)
+			{
+				const Chaos::FSimpleWheelSim& Wheel = PVehicle->Wheels[WheelIndex];
+				const FSingularisSurfaceResponseTable::FEntry& Response = Config.SurfaceResponses->Get(WheelSurfaces[WheelIndex]);
+				const uint8 WheelBit = static_cast<uint8>(1u << WheelIndex);
+
+				Snapshot.WheelSurface[WheelIndex] = WheelSurfaces[WheelIndex];
+				if (Wheel.InContact())
+				{
+					Snapshot.WheelSlipMask |= Wheel.GetSlipMagnitude() > Response.SlipThreshold ? WheelBit : 0;
+					Snapshot.WheelSkidMask |= Wheel.GetSkidMagnitude() > Response.SkidThreshold ? WheelBit : 0;
+				}
+			}
+		}
+	}
+
+	Config.SnapshotBuffer->Publish(Snapshot);
+}
+
+void FSingularisVehicleSimulation::AdvanceInputs(const float DeltaTime)
+{
+	if (DeltaTime <= 0.0f)
+	{
+		return;
+	}
+
+	SmoothedInputs.Throttle = Config.ThrottleInputRate.InterpInputValue(DeltaTime, SmoothedInputs.Throttle, TargetInputs.Throttle);
+	SmoothedInputs.Brake = Config.BrakeInputRate.InterpInputValue(DeltaTime, SmoothedInputs.Brake, TargetInputs.Brake);
+	SmoothedInputs.Steering = Config.SteeringInputRate.InterpInputValue(DeltaTime, SmoothedInputs.Steering, TargetInputs.Steering);
+	SmoothedInputs.Handbrake = Config.HandbrakeInputRate.InterpInputValue(DeltaTime, SmoothedInputs.Handbrake, TargetInputs.Handbrake);
+}
@@ -0,0 +1,36 @@
+/* =====================================================================
+ * SingularisVehicleSnapshot.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleSnapshot.h"
+
+#include "HAL/PlatformProcess.h"
+
+FSingularisVehicleSnapshot FSingularisVehicleSnapshotBuffer::Read() const
+{
+	FSingularisVehicleSnapshot Snapshot;
+	for (int32 Attempt = 0; !TryRead(Snapshot); ++Attempt)
+	{
+		// 写入方被抢占时让出时间片，避免一直空转
+		if (Attempt >= 16)
+		{
+			FPlatformProcess::YieldThread();
+		}
+	}
+	return Snapshot;
+}
+
+void FSingularisVehicleSnapshotBuffer::ReadAll(const TConstArrayView<FSingularisVehicleSnapshotBufferRef> Buffers,
+                                               TArray<FSingularisVehicleSnapshot>& OutSnapshots)
+{
+	OutSnapshots.SetNumUninitialized(Buffers.Num(), EAllowShrinking::No);
+	for (int32 Index = 0; Index < Buffers.Num(); ++Index)
+	{
+		OutSnapshots[Index] = Buffers[Index]->Read();
+	}
+}
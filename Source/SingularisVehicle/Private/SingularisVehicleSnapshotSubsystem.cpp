@@ -0,0 +1,71 @@
+/* =====================================================================
+ * SingularisVehicleSnapshotSubsystem.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleSnapshotSubsystem.h"
+
+#include "BaseWheeledVehiclePawn.h"
+#include "SingularisVehicleMovementComponent.h"
+#include "SingularisVehicleStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Read Snapshots"), STAT_SingularisVehicle_ReadSnapshots, STATGROUP_SingularisVehicle);
+
+void USingularisVehicleSnapshotSubsystem::Deinitialize()
+{
+	Vehicles.Reset();
+	Buffers.Reset();
+	Super::Deinitialize();
+}
+
+bool USingularisVehicleSnapshotSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void USingularisVehicleSnapshotSubsystem::RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	const USingularisVehicleMovementComponent* Movement = Vehicle ? Vehicle->GetSingularisVehicleMovement() : nullptr;
+	if (!Movement || Vehicles.Contains(Vehicle))
+	{
+		return;
+	}
+
+	Vehicles.Add(Vehicle);
+	Buffers.Add(Movement->GetSnapshotBuffer());
+}
+
+void USingularisVehicleSnapshotSubsystem::UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	const int32 Index = Vehicles.IndexOfByKey(Vehicle);
+	if (Index != INDEX_NONE)
+	{
+		Vehicles.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		Buffers.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	}
+}
+
+void USingularisVehicleSnapshotSubsystem::ReadSnapshots(TArray<FSingularisVehicleSnapshot>& OutSnapshots, TArray<ABaseWheeledVehiclePawn*>* OutVehicles) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_ReadSnapshots);
+
+	FSingularisVehicleSnapshotBuffer::ReadAll(Buffers, OutSnapshots);
+
+	if (OutVehicles)
+	{
+		OutVehicles->Reset(Vehicles.Num());
+		for (const TWeakObjectPtr<ABaseWheeledVehiclePawn>& Vehicle : Vehicles)
+		{
+			OutVehicles->Add(Vehicle.Get());
+		}
+	}
+}
+
+void USingularisVehicleSnapshotSubsystem::GetSnapshotBuffers(TArray<FSingularisVehicleSnapshotBufferRef>& OutBuffers) const
+{
+	OutBuffers = Buffers;
+}
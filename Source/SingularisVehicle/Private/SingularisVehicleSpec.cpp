@@ -0,0 +1,177 @@
+/* =====================================================================
+ * SingularisVehicleSpec.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleSpec.h"
+
+#include "ChaosVehicleWheel.h"
+#include "SingularisVehicleMovementComponent.h"
+#include "Curves/CurveFloat.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSingularisVehicleSpec, Log, All);
+
+namespace SingularisVehicleSpec
+{
+	/** 查找表相对曲线值域允许的最大误差，超出时提示增加曲线的平滑度或减少关键帧 */
+	static constexpr float MaxRelativeBakeError = 0.01f;
+
+	/** 烘焙一条曲线并检查误差 */
+	static void BakeCurve(const USingularisVehicleSpec& Spec, UCurveFloat* Curve, const float MinTime, const float MaxTime, FSingularisBakedCurve& OutBaked)
+	{
+		OutBaked = FSingularisBakedCurve();
+		if (!Curve)
+		{
+			return;
+		}
+
+		// 曲线可能晚于规格完成 PostLoad
+		Curve->ConditionalPostLoad();
+		OutBaked.Bake(Curve->FloatCurve, MinTime, MaxTime);
+
+		float MinValue = 0.0f;
+		float MaxValue = 0.0f;
+		Curve->FloatCurve.GetValueRange(MinValue, MaxValue);
+		const float ValueRange = FMath::Max(MaxValue - MinValue, UE_KINDA_SMALL_NUMBER);
+
+		if (const float MaxError = OutBaked.ComputeMaxError(Curve->FloatCurve); MaxError > ValueRange * MaxRelativeBakeError)
+		{
+			UE_LOG(LogSingularisVehicleSpec,
+			       Warning,
+			       TEXT("%s：曲线 '%s' 烘焙为 %d 点查找表后最大误差 %.4f，超过值域的 %.0f%%"),
+			       *Spec.GetName(),
+			       *Curve->GetName(),
+			       FSingularisBakedCurve::NumSamples,
+			       MaxError,
+			       MaxRelativeBakeError * 100.0f);
+		}
+	}
+}
+
+const FPrimaryAssetType USingularisVehicleSpec::PrimaryAssetType(TEXT("SingularisVehicleSpec"));
+
+FPrimaryAssetId USingularisVehicleSpec::GetPrimaryAssetId() const
+{
+	return FPrimaryAssetId(PrimaryAssetType, GetFName());
+}
+
+void USingularisVehicleSpec::PostLoad()
+{
+	Super::PostLoad();
+
+	BakeCurves();
+	BakeSurfaceResponses();
+}
+
+#if WITH_EDITOR
+void USingularisVehicleSpec::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	BakeCurves();
+	BakeSurfaceResponses();
+}
+#endif
+
+void USingularisVehicleSpec::BakeCurves()
+{
+	SingularisVehicleSpec::BakeCurve(*this, Engine.TorqueCurve, 0.0f, Engine.MaxRPM, BakedTorqueCurve);
+
+	float SteeringMinTime = 0.0f;
+	float SteeringMaxTime = 0.0f;
+	if (Steering.SteeringCurve)
+	{
+		Steering.SteeringCurve->FloatCurve.GetTimeRange(SteeringMinTime, SteeringMaxTime);
+	}
+	SingularisVehicleSpec::BakeCurve(*this, Steering.SteeringCurve, SteeringMinTime, SteeringMaxTime, BakedSteeringCurve);
+}
+
+void USingularisVehicleSpec::BakeSurfaceResponses()
+{
+	SurfaceResponseTable.Reset();
+	if (!SurfaceResponses.IsEmpty())
+	{
+		SurfaceResponseTable = FSingularisSurfaceResponseTable::Bake(SurfaceResponses, DefaultSurfaceResponse);
+	}
+}
+
+void USingularisVehicleSpec::ApplyTo(UChaosWheeledVehicleMovementComponent& Movement) const
+{
+	// ==================== 底盘设置 ====================
+	Movement.Mass = Chassis.Mass;
+	Movement.ChassisWidth = Chassis.ChassisWidth;
+	Movement.ChassisHeight = Chassis.ChassisHeight;
+	Movement.DragCoefficient = Chassis.DragCoefficient;
+	Movement.DownforceCoefficient = Chassis.DownforceCoefficient;
+
+	// ==================== 车轮设置 ====================
+	if (!Axles.IsEmpty())
+	{
+		Movement.WheelSetups.Reset(Axles.Num() * 2);
+		for (const FSingularisVehicleAxleSpec& Axle : Axles)
+		{
+			for (const FName BoneName : {Axle.LeftBoneName, Axle.RightBoneName})
+			{
+				FChaosWheelSetup& WheelSetup = Movement.WheelSetups.AddDefaulted_GetRef();
+				WheelSetup.WheelClass = Axle.WheelClass;
+				WheelSetup.BoneName = BoneName;
+				WheelSetup.AdditionalOffset = Axle.AdditionalOffset;
+			}
+		}
+	}
+
+	// ==================== 引擎设置 ====================
+	// 曲线只引用资产，清空实例内联的关键帧，使所有实例共用同一份曲线数据
+	if (Engine.TorqueCurve)
+	{
+		Movement.EngineSetup.TorqueCurve.EditorCurveData.Reset();
+		Movement.EngineSetup.TorqueCurve.ExternalCurve = Engine.TorqueCurve;
+	}
+	Movement.EngineSetup.MaxTorque = Engine.MaxTorque;
+	Movement.EngineSetup.MaxRPM = Engine.MaxRPM;
+	Movement.EngineSetup.EngineIdleRPM = Engine.EngineIdleRPM;
+	Movement.EngineSetup.EngineBrakeEffect = Engine.EngineBrakeEffect;
+	Movement.EngineSetup.EngineRevUpMOI = Engine.EngineRevUpMOI;
+	Movement.EngineSetup.EngineRevDownRate = Engine.EngineRevDownRate;
+
+	// ==================== 变速箱设置 ====================
+	Movement.TransmissionSetup.bUseAutomaticGears = Transmission.bUseAutomaticGears;
+	Movement.TransmissionSetup.bUseAutoReverse = Transmission.bUseAutoReverse;
+	Movement.TransmissionSetup.FinalRatio = Transmission.FinalRatio;
+	Movement.TransmissionSetup.ForwardGearRatios = Transmission.ForwardGearRatios;
+	Movement.TransmissionSetup.ReverseGearRatios = Transmission.ReverseGearRatios;
+	Movement.TransmissionSetup.ChangeUpRPM = Transmission.ChangeUpRPM;
+	Movement.TransmissionSetup.ChangeDownRPM = Transmission.ChangeDownRPM;
+	Movement.TransmissionSetup.GearChangeTime = Transmission.GearChangeTime;
+	Movement.TransmissionSetup.TransmissionEfficiency = Transmission.TransmissionEfficiency;
+
+	// ==================== 转向设置 ====================
+	if (Steering.SteeringCurve)
+	{
+		Movement.SteeringSetup.SteeringCurve.EditorCurveData.Reset();
+		Movement.SteeringSetup.SteeringCurve.ExternalCurve = Steering.SteeringCurve;
+	}
+	Movement.SteeringSetup.SteeringType = Steering.SteeringType;
+	Movement.SteeringSetup.AngleRatio = Steering.AngleRatio;
+
+	// ==================== 路面响应与曲线查找表 ====================
+	if (USingularisVehicleMovementComponent* SingularisMovement = Cast<USingularisVehicleMovementComponent>(&Movement))
+	{
+		SingularisMovement->SetSurfaceResponseTable(SurfaceResponseTable);
+		SingularisMovement->SetVehicleSpec(this);
+	}
+}
+
+const FSingularisBakedCurve* USingularisVehicleSpec::FindSimulationSteeringCurve(const UChaosWheeledVehicleMovementComponent& Movement) const
+{
+	if (BakedSteeringCurve.IsBaked() && Movement.SteeringSetup.SteeringCurve.ExternalCurve == Steering.SteeringCurve)
+	{
+		return &BakedSteeringCurve;
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,104 @@
+/* =====================================================================
+ * SingularisVehicleTelemetry.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleTelemetry.h"
+
+#include "BaseWheeledVehiclePawn.h"
+#include "ChaosWheeledVehicleMovementComponent.h"
+
+#if UE_TRACE_ENABLED
+UE_TRACE_CHANNEL_DEFINE(SingularisVehicleChannel);
+
+UE_TRACE_EVENT_BEGIN(SingularisVehicle, VehicleSpawn, NoSync | Important)
+	UE_TRACE_EVENT_FIELD(uint32, VehicleId)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Name)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(SingularisVehicle, VehicleState)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, VehicleId)
+	UE_TRACE_EVENT_FIELD(float, EngineRPM)
+	UE_TRACE_EVENT_FIELD(int32, Gear)
+	UE_TRACE_EVENT_FIELD(float, SpeedKmh)
+	UE_TRACE_EVENT_FIELD(uint8, ContactMask)
+	UE_TRACE_EVENT_FIELD(float[], WheelSlip)
+	UE_TRACE_EVENT_FIELD(float[], SuspensionCompression)
+UE_TRACE_EVENT_END()
+#endif
+
+#if CSV_PROFILER
+CSV_DEFINE_CATEGORY_MODULE(SINGULARISVEHICLE_API, SingularisVehicle, false);
+#endif
+
+namespace SingularisVehicleTelemetry
+{
+	/** 接地状态使用 8 位掩码，更多的车轮不记录 */
+	constexpr int32 MaxTracedWheels = 8;
+}
+
+void SingularisVehicleTelemetry::TraceVehicleSpawn(const ABaseWheeledVehiclePawn& Vehicle)
+{
+#if UE_TRACE_ENABLED
+	const FString Name = Vehicle.GetName();
+	UE_TRACE_LOG(SingularisVehicle, VehicleSpawn, SingularisVehicleChannel, Name.Len() * sizeof(TCHAR))
+		<< VehicleSpawn.VehicleId(Vehicle.GetUniqueID())
+		<< VehicleSpawn.Name(*Name, Name.Len());
+#endif
+}
+
+void SingularisVehicleTelemetry::RecordVehicleState(const ABaseWheeledVehiclePawn& Vehicle)
+{
+	const UChaosWheeledVehicleMovementComponent* Movement = Vehicle.GetChaosVehicleMovement();
+	if (!Movement || !Movement->PhysicsVehicleOutput())
+	{
+		return;
+	}
+
+	const int32 NumWheels = FMath::Min(Movement->GetNumWheels(), MaxTracedWheels);
+	float WheelSlip[MaxTracedWheels];
+	float SuspensionCompression[MaxTracedWheels];
+	uint8 ContactMask = 0;
+	float MaxSlip = 0.0f;
+
+	for (int32 WheelIndex = 0; WheelIndex < NumWheels; ++WheelIndex)
+	{
+		const FWheelStatus& Wheel = Movement->GetWheelState(WheelIndex);
+		WheelSlip[WheelIndex] = Wheel.SlipMagnitude;
+		SuspensionCompression[WheelIndex] = 1.0f - Wheel.NormalizedSuspensionLength;
+		ContactMask |= Wheel.bInContact ? static_cast<uint8>(1 << WheelIndex) : 0;
+		MaxSlip = FMath::Max(MaxSlip, FMath::Abs(Wheel.SlipMagnitude));
+	}
+
+	const float SpeedKmh = FMath::Abs(Movement->GetForwardSpeed()) * 0.036f;
+	const bool bAirborne = NumWheels > 0 && ContactMask == 0;
+
+#if UE_TRACE_ENABLED
+	UE_TRACE_LOG(SingularisVehicle, VehicleState, SingularisVehicleChannel)
+		<< VehicleState.Cycle(FPlatformTime::Cycles64())
+		<< VehicleState.VehicleId(Vehicle.GetUniqueID())
+		<< VehicleState.EngineRPM(Movement->GetEngineRotationSpeed())
+		<< VehicleState.Gear(Movement->GetCurrentGear())
+		<< VehicleState.SpeedKmh(SpeedKmh)
+		<< VehicleState.ContactMask(ContactMask)
+		<< VehicleState.WheelSlip(WheelSlip, NumWheels)
+		<< VehicleState.SuspensionCompression(SuspensionCompression, NumWheels);
+#endif
+
+#if CSV_PROFILER
+	// 每辆车累加一次，CSV 在帧末得到所有载具的汇总
+	CSV_CUSTOM_STAT(SingularisVehicle, ActiveVehicles, 1, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(SingularisVehicle, AirborneVehicles, bAirborne ? 1 : 0, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(SingularisVehicle, MaxSpeedKmh, SpeedKmh, ECsvCustomStatOp::Max);
+	CSV_CUSTOM_STAT(SingularisVehicle, MaxWheelSlip, MaxSlip, ECsvCustomStatOp::Max);
+	CSV_CUSTOM_STAT(SingularisVehicle, MaxEngineRPM, Movement->GetEngineRotationSpeed(), ECsvCustomStatOp::Max);
+#else
+	(void)bAirborne;
+	(void)MaxSlip;
+#endif
+}
@@ -0,0 +1,67 @@
+/* =====================================================================
+ * SingularisVehicleTrafficProcessors.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleTrafficProcessors.h"
+
+#include "MassExecutionContext.h"
+
+USingularisVehicleTrafficMovementProcessor::USingularisVehicleTrafficMovementProcessor()
+	: EntityQuery(*this)
+{
+	bAutoRegisterWithProcessingPhases = false;
+	bRequiresGameThreadExecution = false;
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::All);
+}
+
+void USingularisVehicleTrafficMovementProcessor::SetLanes(const TConstArrayView<FSingularisTrafficLane> InLanes, const FSingularisTrafficDrivingParams& InParams)
+{
+	Lanes = InLanes;
+	DrivingParams = InParams;
+}
+
+void USingularisVehicleTrafficMovementProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FSingularisTrafficTransformFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FSingularisTrafficVelocityFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FSingularisTrafficLaneFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FSingularisTrafficControlFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddTagRequirement<FSingularisTrafficPromotedTag>(EMassFragmentPresence::None);
+}
+
+void USingularisVehicleTrafficMovementProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	// 每个块内的实体互不依赖，按块并行
+	EntityQuery.ParallelForEachEntityChunk(EntityManager,
+	                                       Context,
+	                                       [this](FMassExecutionContext& ChunkContext)
+	                                       {
+		                                       const float DeltaTime = ChunkContext.GetDeltaTimeSeconds();
+		                                       const TArrayView<FSingularisTrafficTransformFragment> Transforms = ChunkContext.GetMutableFragmentView<FSingularisTrafficTransformFragment>();
+		                                       const TArrayView<FSingularisTrafficVelocityFragment> Velocities = ChunkContext.GetMutableFragmentView<FSingularisTrafficVelocityFragment>();
+		                                       const TArrayView<FSingularisTrafficLaneFragment> LaneStates = ChunkContext.GetMutableFragmentView<FSingularisTrafficLaneFragment>();
+		                                       const TArrayView<FSingularisTrafficControlFragment> Controls = ChunkContext.GetMutableFragmentView<FSingularisTrafficControlFragment>();
+
+		                                       for (int32 EntityIndex = 0; EntityIndex < ChunkContext.GetNumEntities(); ++EntityIndex)
+		                                       {
+			                                       FSingularisTrafficLaneFragment& LaneState = LaneStates[EntityIndex];
+			                                       if (!Lanes.IsValidIndex(LaneState.LaneIndex))
+			                                       {
+				                                       continue;
+			                                       }
+
+			                                       SingularisVehicleTraffic::AdvanceKinematic(Lanes[LaneState.LaneIndex],
+			                                                                                  DrivingParams,
+			                                                                                  DeltaTime,
+			                                                                                  LaneState,
+			                                                                                  Transforms[EntityIndex],
+			                                                                                  Velocities[EntityIndex],
+			                                                                                  Controls[EntityIndex]);
+		                                       }
+	                                       });
+}
@@ -0,0 +1,393 @@
+/* =====================================================================
+ * SingularisVehicleTrafficSubsystem.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleTrafficSubsystem.h"
+
+#include "BaseWheeledVehiclePawn.h"
+#include "ChaosWheeledVehicleMovementComponent.h"
+#include "MassEntitySubsystem.h"
+#include "MassExecutionContext.h"
+#include "MassExecutor.h"
+#include "MassProcessingTypes.h"
+#include "SingularisVehiclePoolSubsystem.h"
+#include "SingularisVehicleStats.h"
+#include "SingularisVehicleTrafficProcessors.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/SplineComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Math/RandomStream.h"
+
+DEFINE_LOG_CATEGORY(LogSingularisVehicleTraffic);
+
+DECLARE_CYCLE_STAT(TEXT("Traffic Update"), STAT_SingularisVehicle_TrafficUpdate, STATGROUP_SingularisVehicle);
+DECLARE_CYCLE_STAT(TEXT("Traffic Movement"), STAT_SingularisVehicle_TrafficMovement, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Traffic Entities"), STAT_SingularisVehicle_TrafficEntities, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Traffic Promoted"), STAT_SingularisVehicle_TrafficPromoted, STATGROUP_SingularisVehicle);
+
+namespace SingularisVehicleTraffic
+{
+	static float PromoteRadius = 8000.0f;
+	static FAutoConsoleVariableRef CVarPromoteRadius(
+		TEXT("SingularisVehicle.Traffic.PromoteRadius"),
+		PromoteRadius,
+		TEXT("观察者该距离（厘米）内的交通实体升级为物理载具。"));
+
+	static float DemoteRadius = 10000.0f;
+	static FAutoConsoleVariableRef CVarDemoteRadius(
+		TEXT("SingularisVehicle.Traffic.DemoteRadius"),
+		DemoteRadius,
+		TEXT("物理载具离所有观察者超过该距离（厘米）后降级回交通实体，应大于 PromoteRadius 以免反复切换。"));
+
+	static int32 MaxPromoted = 16;
+	static FAutoConsoleVariableRef CVarMaxPromoted(
+		TEXT("SingularisVehicle.Traffic.MaxPromoted"),
+		MaxPromoted,
+		TEXT("同时存在的物理交通载具上限。"));
+
+	static int32 MaxSwapsPerFrame = 2;
+	static FAutoConsoleVariableRef CVarMaxSwapsPerFrame(
+		TEXT("SingularisVehicle.Traffic.MaxSwapsPerFrame"),
+		MaxSwapsPerFrame,
+		TEXT("每帧最多的升级与降级次数，超出的部分留到下一帧。"));
+
+	/** 车道烘焙间距（厘米） */
+	static constexpr float LaneSpacing = 200.0f;
+
+	/** 物理载具每帧重新投影到车道时的搜索范围（厘米） */
+	static constexpr float ProjectionSearchRadius = 2000.0f;
+}
+
+void USingularisVehicleTrafficSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	UMassEntitySubsystem* MassEntitySubsystem = Collection.InitializeDependency<UMassEntitySubsystem>();
+	EntityManager = &MassEntitySubsystem->GetMutableEntityManager();
+
+	TrafficArchetype = EntityManager->CreateArchetype({
+		FSingularisTrafficTransformFragment::StaticStruct(),
+		FSingularisTrafficVelocityFragment::StaticStruct(),
+		FSingularisTrafficLaneFragment::StaticStruct(),
+		FSingularisTrafficControlFragment::StaticStruct()
+	});
+
+	MovementProcessor = NewObject<USingularisVehicleTrafficMovementProcessor>(this);
+	MovementProcessor->Initialize(*this);
+
+	KinematicQuery.AddRequirement<FSingularisTrafficTransformFragment>(EMassFragmentAccess::ReadOnly);
+	KinematicQuery.AddTagRequirement<FSingularisTrafficPromotedTag>(EMassFragmentPresence::None);
+}
+
+void USingularisVehicleTrafficSubsystem::Deinitialize()
+{
+	// 世界销毁时载具与实体随之释放，这里只丢弃引用
+	Promoted.Reset();
+	Entities.Reset();
+	Lanes.Reset();
+	MovementProcessor = nullptr;
+	EntityManager = nullptr;
+
+	Super::Deinitialize();
+}
+
+bool USingularisVehicleTrafficSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId USingularisVehicleTrafficSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USingularisVehicleTrafficSubsystem, STATGROUP_Tickables);
+}
+
+int32 USingularisVehicleTrafficSubsystem::RegisterLane(const USplineComponent* Spline, const float SpeedLimit)
+{
+	if (!Spline)
+	{
+		return INDEX_NONE;
+	}
+
+	FSingularisTrafficLane Lane = FSingularisTrafficLane::FromSpline(*Spline, SpeedLimit, SingularisVehicleTraffic::LaneSpacing);
+	if (!Lane.IsValid())
+	{
+		UE_LOG(LogSingularisVehicleTraffic, Warning, TEXT("样条 '%s' 太短，无法作为车道"), *GetNameSafe(Spline));
+		return INDEX_NONE;
+	}
+
+	return Lanes.Add(MoveTemp(Lane));
+}
+
+int32 USingularisVehicleTrafficSubsystem::RegisterLanePoints(const TConstArrayView<FVector> Points, const bool bClosedLoop, const float SpeedLimit)
+{
+	FSingularisTrafficLane Lane = FSingularisTrafficLane::FromPolyline(Points, bClosedLoop, SpeedLimit, SingularisVehicleTraffic::LaneSpacing);
+	return Lane.IsValid() ? Lanes.Add(MoveTemp(Lane)) : INDEX_NONE;
+}
+
+void USingularisVehicleTrafficSubsystem::SpawnTraffic(const int32 LaneIndex, const int32 Count, const float SpeedVariance)
+{
+	if (!EntityManager || !Lanes.IsValidIndex(LaneIndex) || Count <= 0)
+	{
+		return;
+	}
+
+	const FSingularisTrafficLane& Lane = Lanes[LaneIndex];
+	const int32 FirstNewEntity = Entities.Num();
+	EntityManager->BatchCreateEntities(TrafficArchetype, Count, Entities);
+
+	FRandomStream Random(LaneIndex * 7919 + FirstNewEntity);
+	const float Spacing = Lane.Length / Count;
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const FMassEntityHandle Entity = Entities[FirstNewEntity + Index];
+
+		FSingularisTrafficLaneFragment& LaneState = EntityManager->GetFragmentDataChecked<FSingularisTrafficLaneFragment>(Entity);
+		LaneState.LaneIndex = LaneIndex;
+		LaneState.Distance = Index * Spacing;
+		LaneState.TargetSpeed = Lane.SpeedLimit * (1.0f + Random.FRandRange(-SpeedVariance, SpeedVariance));
+
+		const FVector Direction = Lane.GetDirectionAtDistance(LaneState.Distance);
+
+		FSingularisTrafficTransformFragment& Transform = EntityManager->GetFragmentDataChecked<FSingularisTrafficTransformFragment>(Entity);
+		Transform.Location = Lane.GetLocationAtDistance(LaneState.Distance);
+		Transform.Rotation = Direction.ToOrientationQuat();
+
+		// 直接以期望速度出生，避免所有车同时从零加速
+		FSingularisTrafficVelocityFragment& Velocity = EntityManager->GetFragmentDataChecked<FSingularisTrafficVelocityFragment>(Entity);
+		Velocity.Speed = LaneState.TargetSpeed;
+		Velocity.Velocity = Direction * Velocity.Speed;
+	}
+}
+
+void USingularisVehicleTrafficSubsystem::ClearTraffic()
+{
+	while (!Promoted.IsEmpty())
+	{
+		DemoteEntity(Promoted.Num() - 1);
+	}
+
+	if (EntityManager && !Entities.IsEmpty())
+	{
+		EntityManager->BatchDestroyEntities(Entities);
+	}
+	Entities.Reset();
+}
+
+void USingularisVehicleTrafficSubsystem::GetEntityTransforms(TArray<FTransform>& OutTransforms)
+{
+	OutTransforms.Reset(Entities.Num());
+	if (!EntityManager)
+	{
+		return;
+	}
+
+	FMassExecutionContext ExecutionContext(*EntityManager);
+	KinematicQuery.ForEachEntityChunk(*EntityManager,
+	                                  ExecutionContext,
+	                                  [&OutTransforms](FMassExecutionContext& Context)
+	                                  {
+		                                  for (const FSingularisTrafficTransformFragment& Transform : Context.GetFragmentView<FSingularisTrafficTransformFragment>())
+		                                  {
+			                                  OutTransforms.Emplace(Transform.Rotation, Transform.Location);
+		                                  }
+	                                  });
+}
+
+void USingularisVehicleTrafficSubsystem::Tick(const float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_TrafficUpdate);
+
+	if (!EntityManager || Entities.IsEmpty())
+	{
+		return;
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_TrafficMovement);
+
+		MovementProcessor->SetLanes(Lanes, DrivingParams);
+		FMassProcessingContext ProcessingContext(*EntityManager, DeltaTime);
+		UE::Mass::Executor::Run(*MovementProcessor, ProcessingContext);
+	}
+
+	GatherViewerLocations();
+	UpdatePromotion();
+	DrivePromotedVehicles();
+
+	SET_DWORD_STAT(STAT_SingularisVehicle_TrafficEntities, Entities.Num());
+	SET_DWORD_STAT(STAT_SingularisVehicle_TrafficPromoted, Promoted.Num());
+}
+
+void USingularisVehicleTrafficSubsystem::GatherViewerLocations()
+{
+	ViewerLocations.Reset();
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewerLocations.Add(ViewLocation);
+		}
+	}
+}
+
+double USingularisVehicleTrafficSubsystem::GetMinViewerDistanceSquared(const FVector& Location) const
+{
+	double MinDistanceSquared = TNumericLimits<double>::Max();
+	for (const FVector& ViewerLocation : ViewerLocations)
+	{
+		MinDistanceSquared = FMath::Min(MinDistanceSquared, FVector::DistSquared(ViewerLocation, Location));
+	}
+	return MinDistanceSquared;
+}
+
+void USingularisVehicleTrafficSubsystem::UpdatePromotion()
+{
+	int32 SwapBudget = SingularisVehicleTraffic::MaxSwapsPerFrame;
+
+	// 先降级，腾出名额
+	const double DemoteRadiusSquared = FMath::Square(SingularisVehicleTraffic::DemoteRadius);
+	for (int32 Index = Promoted.Num() - 1; Index >= 0 && SwapBudget > 0; --Index)
+	{
+		const ABaseWheeledVehiclePawn* Vehicle = Promoted[Index].Vehicle.Get();
+		if (!Vehicle || (!Vehicle->IsPlayerControlled() && GetMinViewerDistanceSquared(Vehicle->GetActorLocation()) > DemoteRadiusSquared))
+		{
+			DemoteEntity(Index);
+			--SwapBudget;
+		}
+	}
+
+	const int32 NumSlots = FMath::Min(SingularisVehicleTraffic::MaxPromoted - Promoted.Num(), SwapBudget);
+	if (!PromotedVehicleClass || ViewerLocations.IsEmpty() || NumSlots <= 0)
+	{
+		return;
+	}
+
+	// 只升级离观察者最近的实体
+	const double PromoteRadiusSquared = FMath::Square(SingularisVehicleTraffic::PromoteRadius);
+	Candidates.Reset();
+
+	FMassExecutionContext ExecutionContext(*EntityManager);
+	KinematicQuery.ForEachEntityChunk(*EntityManager,
+	                                  ExecutionContext,
+	                                  [this, PromoteRadiusSquared](FMassExecutionContext& Context)
+	                                  {
+		                                  const TConstArrayView<FSingularisTrafficTransformFragment> Transforms = Context.GetFragmentView<FSingularisTrafficTransformFragment>();
+		                                  for (int32 EntityIndex = 0; EntityIndex < Context.GetNumEntities(); ++EntityIndex)
+		                                  {
+			                                  const double DistanceSquared = GetMinViewerDistanceSquared(Transforms[EntityIndex].Location);
+			                                  if (DistanceSquared < PromoteRadiusSquared)
+			                                  {
+				                                  Candidates.Add({Context.GetEntity(EntityIndex), DistanceSquared});
+			                                  }
+		                                  }
+	                                  });
+
+	Candidates.Sort([](const FPromotionCandidate& A, const FPromotionCandidate& B) { return A.DistanceSquared < B.DistanceSquared; });
+	for (int32 Index = 0; Index < FMath::Min(NumSlots, Candidates.Num()); ++Index)
+	{
+		if (!PromoteEntity(Candidates[Index].Entity))
+		{
+			break;
+		}
+	}
+}
+
+bool USingularisVehicleTrafficSubsystem::PromoteEntity(const FMassEntityHandle Entity)
+{
+	USingularisVehiclePoolSubsystem* Pool = GetWorld()->GetSubsystem<USingularisVehiclePoolSubsystem>();
+	if (!Pool)
+	{
+		return false;
+	}
+
+	const FSingularisTrafficTransformFragment& Transform = EntityManager->GetFragmentDataChecked<FSingularisTrafficTransformFragment>(Entity);
+	const FSingularisTrafficVelocityFragment& Velocity = EntityManager->GetFragmentDataChecked<FSingularisTrafficVelocityFragment>(Entity);
+	const FSingularisTrafficControlFragment& Control = EntityManager->GetFragmentDataChecked<FSingularisTrafficControlFragment>(Entity);
+
+	ABaseWheeledVehiclePawn* Vehicle = Pool->AcquireVehicle(PromotedVehicleClass, FTransform(Transform.Rotation, Transform.Location));
+	if (!Vehicle)
+	{
+		return false;
+	}
+
+	// 接上实体的速度与输入，切换前后运动连续
+	Vehicle->GetMesh()->SetPhysicsLinearVelocity(Velocity.Velocity);
+	Vehicle->SetControlInputs(Control.Throttle, Control.Brake, Control.Steering, Control.bHandbrake);
+
+	EntityManager->AddTagToEntity(Entity, FSingularisTrafficPromotedTag::StaticStruct());
+	Promoted.Add({Entity, Vehicle});
+	return true;
+}
+
+void USingularisVehicleTrafficSubsystem::DemoteEntity(const int32 PromotedIndex)
+{
+	const FPromotedVehicle Entry = Promoted[PromotedIndex];
+	Promoted.RemoveAtSwap(PromotedIndex, 1, EAllowShrinking::No);
+
+	// 实体状态每帧都从载具同步，这里只需归还载具；载具已被外部销毁时实体从最后一次同步的状态继续
+	if (ABaseWheeledVehiclePawn* Vehicle = Entry.Vehicle.Get())
+	{
+		if (USingularisVehiclePoolSubsystem* Pool = GetWorld()->GetSubsystem<USingularisVehiclePoolSubsystem>())
+		{
+			Pool->ReleaseVehicle(Vehicle);
+		}
+	}
+
+	if (EntityManager && EntityManager->IsEntityValid(Entry.Entity))
+	{
+		EntityManager->RemoveTagFromEntity(Entry.Entity, FSingularisTrafficPromotedTag::StaticStruct());
+	}
+}
+
+void USingularisVehicleTrafficSubsystem::DrivePromotedVehicles()
+{
+	for (const FPromotedVehicle& Entry : Promoted)
+	{
+		ABaseWheeledVehiclePawn* Vehicle = Entry.Vehicle.Get();
+		if (!Vehicle)
+		{
+			continue;
+		}
+
+		FSingularisTrafficLaneFragment& LaneState = EntityManager->GetFragmentDataChecked<FSingularisTrafficLaneFragment>(Entry.Entity);
+		if (!Lanes.IsValidIndex(LaneState.LaneIndex))
+		{
+			continue;
+		}
+
+		const FSingularisTrafficLane& Lane = Lanes[LaneState.LaneIndex];
+		const FTransform VehicleTransform = Vehicle->GetActorTransform();
+		const float ForwardSpeed = Vehicle->GetChaosVehicleMovement()->GetForwardSpeed();
+
+		// 同步实体状态，降级时直接从这里继续
+		LaneState.Distance = Lane.FindDistanceClosestTo(VehicleTransform.GetLocation(), LaneState.Distance, SingularisVehicleTraffic::ProjectionSearchRadius);
+
+		FSingularisTrafficTransformFragment& Transform = EntityManager->GetFragmentDataChecked<FSingularisTrafficTransformFragment>(Entry.Entity);
+		Transform.Location = VehicleTransform.GetLocation();
+		Transform.Rotation = VehicleTransform.GetRotation();
+
+		FSingularisTrafficVelocityFragment& Velocity = EntityManager->GetFragmentDataChecked<FSingularisTrafficVelocityFragment>(Entry.Entity);
+		Velocity.Velocity = Vehicle->GetVelocity();
+		Velocity.Speed = FMath::Max(ForwardSpeed, 0.0f);
+
+		// 玩家接管的载具只同步状态
+		if (Vehicle->IsPlayerControlled())
+		{
+			continue;
+		}
+
+		FSingularisTrafficControlFragment& Control = EntityManager->GetFragmentDataChecked<FSingularisTrafficControlFragment>(Entry.Entity);
+		SingularisVehicleTraffic::ComputeFollowControl(Lane, DrivingParams, LaneState, VehicleTransform, ForwardSpeed, Control);
+		Vehicle->SetControlInputs(Control.Throttle, Control.Brake, Control.Steering, Control.bHandbrake);
+	}
+}
@@ -0,0 +1,208 @@
+/* =====================================================================
+ * SingularisVehicleTrafficTypes.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleTrafficTypes.h"
+
+#include "Components/SplineComponent.h"
+
+namespace SingularisVehicleTraffic
+{
+	/** 物理载具跟随目标速度的时间常数（秒） */
+	static constexpr float SpeedResponseTime = 1.0f;
+
+	/** 由预瞄点在车身坐标系下的方向得到转向输入 */
+	static float ComputeSteering(const FSingularisTrafficLane& Lane,
+	                             const FSingularisTrafficDrivingParams& Params,
+	                             const float Distance,
+	                             const FTransform& VehicleTransform)
+	{
+		const FVector Target = Lane.GetLocationAtDistance(Distance + Params.LookaheadDistance);
+		const FVector LocalTarget = VehicleTransform.InverseTransformPositionNoScale(Target);
+		const float AngleDegrees = FMath::RadiansToDegrees(FMath::Atan2(LocalTarget.Y, LocalTarget.X));
+		return FMath::Clamp(AngleDegrees / Params.MaxSteerAngle, -1.0f, 1.0f);
+	}
+}
+
+FSingularisTrafficLane FSingularisTrafficLane::FromPolyline(const TConstArrayView<FVector> Polyline, const bool bClosedLoop, const float SpeedLimit, const float Spacing)
+{
+	FSingularisTrafficLane Lane;
+	Lane.SpeedLimit = SpeedLimit;
+	Lane.bClosedLoop = bClosedLoop;
+
+	if (Polyline.Num() < 2)
+	{
+		return Lane;
+	}
+
+	// 闭合车道补上回到起点的一段
+	TArray<FVector, TInlineAllocator<64>> Source(Polyline.GetData(), Polyline.Num());
+	if (bClosedLoop)
+	{
+		Source.Add(Polyline[0]);
+	}
+
+	TArray<float, TInlineAllocator<64>> Cumulative;
+	Cumulative.SetNumUninitialized(Source.Num());
+	Cumulative[0] = 0.0f;
+	for (int32 Index = 1; Index < Source.Num(); ++Index)
+	{
+		Cumulative[Index] = Cumulative[Index - 1] + FVector::Dist(Source[Index - 1], Source[Index]);
+	}
+
+	Lane.Length = Cumulative.Last();
+	if (Lane.Length <= UE_KINDA_SMALL_NUMBER)
+	{
+		Lane.Length = 0.0f;
+		return Lane;
+	}
+
+	// 实际间距略小于请求值，使最后一个采样点正好落在终点
+	const int32 NumSegments = FMath::Max(FMath::CeilToInt(Lane.Length / FMath::Max(Spacing, 1.0f)), 1);
+	const float Step = Lane.Length / NumSegments;
+	Lane.InvSpacing = 1.0f / Step;
+	Lane.Points.SetNumUninitialized(NumSegments + 1);
+
+	int32 SourceIndex = 0;
+	for (int32 SampleIndex = 0; SampleIndex <= NumSegments; ++SampleIndex)
+	{
+		const float Distance = FMath::Min(SampleIndex * Step, Lane.Length);
+		while (SourceIndex < Source.Num() - 2 && Cumulative[SourceIndex + 1] < Distance)
+		{
+			++SourceIndex;
+		}
+
+		const float SegmentLength = Cumulative[SourceIndex + 1] - Cumulative[SourceIndex];
+		const float Alpha = SegmentLength > UE_KINDA_SMALL_NUMBER ? (Distance - Cumulative[SourceIndex]) / SegmentLength : 0.0f;
+		Lane.Points[SampleIndex] = FMath::Lerp(Source[SourceIndex], Source[SourceIndex + 1], FMath::Clamp(Alpha, 0.0f, 1.0f));
+	}
+
+	return Lane;
+}
+
+FSingularisTrafficLane FSingularisTrafficLane::FromSpline(const USplineComponent& Spline, const float SpeedLimit, const float Spacing)
+{
+	const float SplineLength = Spline.GetSplineLength();
+	const int32 NumSamples = FMath::Max(FMath::CeilToInt(SplineLength / FMath::Max(Spacing, 1.0f)), 1);
+
+	// 闭合样条的长度已包含回到起点的一段，这里只取到终点之前，由 FromPolyline 补上
+	const bool bClosedLoop = Spline.IsClosedLoop();
+	const int32 LastSample = bClosedLoop ? NumSamples - 1 : NumSamples;
+
+	TArray<FVector> Polyline;
+	Polyline.Reserve(LastSample + 1);
+	for (int32 Index = 0; Index <= LastSample; ++Index)
+	{
+		Polyline.Add(Spline.GetLocationAtDistanceAlongSpline(SplineLength * Index / NumSamples, ESplineCoordinateSpace::World));
+	}
+
+	return FromPolyline(Polyline, bClosedLoop, SpeedLimit, Spacing);
+}
+
+float FSingularisTrafficLane::WrapDistance(const float Distance) const
+{
+	if (bClosedLoop)
+	{
+		const float Wrapped = FMath::Fmod(Distance, Length);
+		return Wrapped < 0.0f ? Wrapped + Length : Wrapped;
+	}
+
+	return FMath::Clamp(Distance, 0.0f, Length);
+}
+
+FVector FSingularisTrafficLane::GetLocationAtDistance(const float Distance) const
+{
+	const float Position = WrapDistance(Distance) * InvSpacing;
+	const int32 Index = FMath::Min(static_cast<int32>(Position), Points.Num() - 2);
+	return FMath::Lerp(Points[Index], Points[Index + 1], Position - Index);
+}
+
+FVector FSingularisTrafficLane::GetDirectionAtDistance(const float Distance) const
+{
+	const int32 Index = FMath::Min(static_cast<int32>(WrapDistance(Distance) * InvSpacing), Points.Num() - 2);
+	return (Points[Index + 1] - Points[Index]).GetSafeNormal();
+}
+
+float FSingularisTrafficLane::FindDistanceClosestTo(const FVector& Location, const float HintDistance, const float SearchRadius) const
+{
+	const int32 NumSegments = Points.Num() - 1;
+	const int32 HintIndex = FMath::Min(static_cast<int32>(WrapDistance(HintDistance) * InvSpacing), NumSegments - 1);
+	const int32 Window = FMath::Min(FMath::CeilToInt(SearchRadius * InvSpacing), NumSegments / 2 + 1);
+
+	float BestDistance = HintDistance;
+	double BestDistanceSquared = TNumericLimits<double>::Max();
+	for (int32 Offset = -Window; Offset <= Window; ++Offset)
+	{
+		int32 Index = HintIndex + Offset;
+		if (bClosedLoop)
+		{
+			Index = (Index % NumSegments + NumSegments) % NumSegments;
+		}
+		else if (Index < 0 || Index >= NumSegments)
+		{
+			continue;
+		}
+
+		const FVector Closest = FMath::ClosestPointOnSegment(Location, Points[Index], Points[Index + 1]);
+		const double DistanceSquared = FVector::DistSquared(Closest, Location);
+		if (DistanceSquared < BestDistanceSquared)
+		{
+			BestDistanceSquared = DistanceSquared;
+			BestDistance = Index / InvSpacing + FVector::Dist(Points[Index], Closest);
+		}
+	}
+
+	return BestDistance;
+}
+
+void SingularisVehicleTraffic::AdvanceKinematic(const FSingularisTrafficLane& Lane,
+                                                const FSingularisTrafficDrivingParams& Params,
+                                                const float DeltaTime,
+                                                FSingularisTrafficLaneFragment& LaneState,
+                                                FSingularisTrafficTransformFragment& Transform,
+                                                FSingularisTrafficVelocityFragment& Velocity,
+                                                FSingularisTrafficControlFragment& Control)
+{
+	// 以加速度上限逼近期望速度
+	const float SpeedError = LaneState.TargetSpeed - Velocity.Speed;
+	const float Acceleration = FMath::Clamp(SpeedError / FMath::Max(DeltaTime, UE_KINDA_SMALL_NUMBER), -Params.MaxDeceleration, Params.MaxAcceleration);
+	Velocity.Speed = FMath::Max(Velocity.Speed + Acceleration * DeltaTime, 0.0f);
+
+	// 开放车道走到终点后回到起点；运动学实体都在远处，跳变不可见
+	float Distance = LaneState.Distance + Velocity.Speed * DeltaTime;
+	if (!Lane.bClosedLoop && Distance >= Lane.Length)
+	{
+		Distance = 0.0f;
+	}
+	LaneState.Distance = Lane.WrapDistance(Distance);
+
+	const FVector Direction = Lane.GetDirectionAtDistance(LaneState.Distance);
+	Transform.Location = Lane.GetLocationAtDistance(LaneState.Distance);
+	Transform.Rotation = Direction.ToOrientationQuat();
+	Velocity.Velocity = Direction * Velocity.Speed;
+
+	Control.Throttle = Acceleration > 0.0f ? Acceleration / Params.MaxAcceleration : 0.0f;
+	Control.Brake = Acceleration < 0.0f ? -Acceleration / Params.MaxDeceleration : 0.0f;
+	Control.Steering = ComputeSteering(Lane, Params, LaneState.Distance, FTransform(Transform.Rotation, Transform.Location));
+	Control.bHandbrake = false;
+}
+
+void SingularisVehicleTraffic::ComputeFollowControl(const FSingularisTrafficLane& Lane,
+                                                    const FSingularisTrafficDrivingParams& Params,
+                                                    const FSingularisTrafficLaneFragment& LaneState,
+                                                    const FTransform& VehicleTransform,
+                                                    const float ForwardSpeed,
+                                                    FSingularisTrafficControlFragment& OutControl)
+{
+	const float DesiredAcceleration = (LaneState.TargetSpeed - ForwardSpeed) / SpeedResponseTime;
+
+	OutControl.Throttle = FMath::Clamp(DesiredAcceleration / Params.MaxAcceleration, 0.0f, 1.0f);
+	OutControl.Brake = FMath::Clamp(-DesiredAcceleration / Params.MaxDeceleration, 0.0f, 1.0f);
+	OutControl.Steering = ComputeSteering(Lane, Params, LaneState.Distance, VehicleTransform);
+	OutControl.bHandbrake = false;
+}
@@ -0,0 +1,335 @@
+/* =====================================================================
+ * SingularisVehicleWheelVisualSubsystem.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleWheelVisualSubsystem.h"
+
+#include "BaseWheeledVehiclePawn.h"
+#include "ChaosVehicleWheel.h"
+#include "ChaosWheeledVehicleMovementComponent.h"
+#include "SingularisVehicleStats.h"
+#include "Animation/AnimInstance.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkinnedAsset.h"
+
+DEFINE_LOG_CATEGORY(LogSingularisVehicleWheelVisual);
+
+DECLARE_CYCLE_STAT(TEXT("Wheel Visual Update"), STAT_SingularisVehicle_WheelVisualUpdate, STATGROUP_SingularisVehicle);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wheel Visuals Updated"), STAT_SingularisVehicle_WheelVisualsUpdated, STATGROUP_SingularisVehicle);
+
+namespace SingularisVehicleWheelVisual
+{
+	static int32 Mode = 1;
+	static FAutoConsoleVariableRef CVarMode(
+		TEXT("SingularisVehicle.WheelVisual.Mode"),
+		Mode,
+		TEXT("0：全部使用动画蓝图；1：开启了 bUseNativeWheelVisuals 的载具直接写入车轮骨骼；2：所有载具都直接写入。只影响之后注册的载具。"));
+
+	static int32 ReducedInterval = 2;
+	static FAutoConsoleVariableRef CVarReducedInterval(
+		TEXT("SingularisVehicle.WheelVisual.ReducedInterval"),
+		ReducedInterval,
+		TEXT("Reduced 层级的载具每隔多少帧更新一次车轮。"));
+
+	static int32 LowDetailInterval = 4;
+	static FAutoConsoleVariableRef CVarLowDetailInterval(
+		TEXT("SingularisVehicle.WheelVisual.LowDetailInterval"),
+		LowDetailInterval,
+		TEXT("LowDetail 层级的载具每隔多少帧更新一次车轮，Frozen 层级不更新。"));
+
+	static bool bUpdateOffscreen = false;
+	static FAutoConsoleVariableRef CVarUpdateOffscreen(
+		TEXT("SingularisVehicle.WheelVisual.UpdateOffscreen"),
+		bUpdateOffscreen,
+		TEXT("不可见的载具也更新车轮，用于无渲染的测试。"));
+
+	/** Returns 层级对应的更新间隔（帧），0 表示不更新 */
+	static int32 GetUpdateInterval(const EVehicleSignificanceTier Tier)
+	{
+		switch (Tier)
+		{
+		case EVehicleSignificanceTier::Full:
+			return 1;
+		case EVehicleSignificanceTier::Reduced:
+			return FMath::Max(ReducedInterval, 1);
+		case EVehicleSignificanceTier::LowDetail:
+			return FMath::Max(LowDetailInterval, 1);
+		default:
+			return 0;
+		}
+	}
+}
+
+void USingularisVehicleWheelVisualSubsystem::Deinitialize()
+{
+	Vehicles.Reset();
+	Super::Deinitialize();
+}
+
+bool USingularisVehicleWheelVisualSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+#if SINGULARISVEHICLE_WITH_COSMETICS
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+#else
+	return false;
+#endif
+}
+
+TStatId USingularisVehicleWheelVisualSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USingularisVehicleWheelVisualSubsystem, STATGROUP_Tickables);
+}
+
+void USingularisVehicleWheelVisualSubsystem::RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	const int32 Mode = SingularisVehicleWheelVisual::Mode;
+	if (!Vehicle || Mode <= 0 || (Mode == 1 && !Vehicle->UsesNativeWheelVisuals()) || !Vehicle->ShouldRunCosmetics())
+	{
+		return;
+	}
+
+	if (FVehicleEntry* Entry = FindEntry(Vehicle))
+	{
+		// 回放期间临时接管的载具改为常驻，结束回放时不再恢复动画蓝图
+		Entry->bTemporary = false;
+		return;
+	}
+
+	if (const FVehicleEntry* Entry = AddVehicle(Vehicle))
+	{
+		UpdateVehicle(*Vehicle, *Entry->Mesh, Entry->Bones, {});
+	}
+}
+
+void USingularisVehicleWheelVisualSubsystem::UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	const int32 Index = Vehicles.IndexOfByPredicate([Vehicle](const FVehicleEntry& Entry) { return Entry.Vehicle == Vehicle; });
+	if (Index != INDEX_NONE)
+	{
+		Vehicles.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	}
+}
+
+bool USingularisVehicleWheelVisualSubsystem::BeginExternalWheelPoses(ABaseWheeledVehiclePawn* Vehicle)
+{
+	if (!Vehicle || !Vehicle->ShouldRunCosmetics())
+	{
+		return false;
+	}
+
+	FVehicleEntry* Entry = FindEntry(Vehicle);
+	if (!Entry)
+	{
+		const TSubclassOf<UAnimInstance> AnimClass = Vehicle->GetMesh() ? Vehicle->GetMesh()->GetAnimClass() : nullptr;
+		Entry = AddVehicle(Vehicle);
+		if (!Entry)
+		{
+			return false;
+		}
+
+		Entry->bTemporary = true;
+		Entry->RestoreAnimClass = AnimClass;
+	}
+
+	Entry->bUseExternalWheels = true;
+	Entry->ExternalWheels.Reset();
+	return true;
+}
+
+void USingularisVehicleWheelVisualSubsystem::SetExternalWheelPoses(const ABaseWheeledVehiclePawn* Vehicle, const TConstArrayView<FSingularisVehicleRecordWheel> Wheels)
+{
+	if (FVehicleEntry* Entry = FindEntry(Vehicle); Entry && Entry->bUseExternalWheels)
+	{
+		Entry->ExternalWheels = Wheels;
+	}
+}
+
+void USingularisVehicleWheelVisualSubsystem::EndExternalWheelPoses(ABaseWheeledVehiclePawn* Vehicle)
+{
+	FVehicleEntry* Entry = FindEntry(Vehicle);
+	if (!Entry)
+	{
+		return;
+	}
+
+	if (Entry->bTemporary)
+	{
+		if (USkeletalMeshComponent* Mesh = Entry->Mesh.Get())
+		{
+			Mesh->bNoSkeletonUpdate = false;
+			Mesh->SetAnimInstanceClass(Entry->RestoreAnimClass);
+		}
+
+		UnregisterVehicle(Vehicle);
+		return;
+	}
+
+	Entry->bUseExternalWheels = false;
+	Entry->ExternalWheels.Reset();
+}
+
+USingularisVehicleWheelVisualSubsystem::FVehicleEntry* USingularisVehicleWheelVisualSubsystem::AddVehicle(ABaseWheeledVehiclePawn* Vehicle)
+{
+	USkeletalMeshComponent* Mesh = Vehicle->GetMesh();
+	if (!Mesh || !Mesh->GetSkinnedAsset())
+	{
+		return nullptr;
+	}
+
+	TArray<FWheelBone> Bones;
+	if (!BuildWheelBones(*Vehicle, *Mesh, Bones))
+	{
+		UE_LOG(LogSingularisVehicleWheelVisual, Warning, TEXT("%s 的骨骼网格中找不到任何车轮骨骼，继续使用动画蓝图"), *Vehicle->GetName());
+		return nullptr;
+	}
+
+	// 清除动画实例并停止骨骼刷新，之后骨骼只由这里写入；其他骨骼保持当前姿势
+	Mesh->SetAnimInstanceClass(nullptr);
+	Mesh->bNoSkeletonUpdate = true;
+
+	FVehicleEntry& Entry = Vehicles.AddDefaulted_GetRef();
+	Entry.Vehicle = Vehicle;
+	Entry.Mesh = Mesh;
+	Entry.Bones = MoveTemp(Bones);
+	Entry.UpdatePhase = NextUpdatePhase++;
+	return &Entry;
+}
+
+USingularisVehicleWheelVisualSubsystem::FVehicleEntry* USingularisVehicleWheelVisualSubsystem::FindEntry(const ABaseWheeledVehiclePawn* Vehicle)
+{
+	return Vehicles.FindByPredicate([Vehicle](const FVehicleEntry& Entry) { return Entry.Vehicle == Vehicle; });
+}
+
+void USingularisVehicleWheelVisualSubsystem::Tick(const float DeltaTime)
+{
+	UpdateWheelVisuals();
+}
+
+void USingularisVehicleWheelVisualSubsystem::UpdateWheelVisuals()
+{
+	SCOPE_CYCLE_COUNTER(STAT_SingularisVehicle_WheelVisualUpdate);
+
+	const double StartTime = FPlatformTime::Seconds();
+	++UpdateCounter;
+
+	int32 NumUpdated = 0;
+	for (int32 Index = Vehicles.Num() - 1; Index >= 0; --Index)
+	{
+		const FVehicleEntry& Entry = Vehicles[Index];
+		const ABaseWheeledVehiclePawn* Vehicle = Entry.Vehicle.Get();
+		USkeletalMeshComponent* Mesh = Entry.Mesh.Get();
+		if (!Vehicle || !Mesh)
+		{
+			Vehicles.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		// 停放、冻结与不可见的载具不更新；降频的载具按帧错位分散到不同帧
+		const int32 Interval = SingularisVehicleWheelVisual::GetUpdateInterval(Vehicle->GetSignificanceTier());
+		if (Vehicle->IsPooled()
+			|| Interval == 0
+			|| (UpdateCounter + Entry.UpdatePhase) % Interval != 0
+			|| (!SingularisVehicleWheelVisual::bUpdateOffscreen && !Mesh->WasRecentlyRendered(0.25f)))
+		{
+			continue;
+		}
+
+		UpdateVehicle(*Vehicle, *Mesh, Entry.Bones, Entry.bUseExternalWheels ? TConstArrayView<FSingularisVehicleRecordWheel>(Entry.ExternalWheels) : TConstArrayView<FSingularisVehicleRecordWheel>());
+		++NumUpdated;
+	}
+
+	LastNumUpdated = NumUpdated;
+	LastUpdateSeconds = FPlatformTime::Seconds() - StartTime;
+	SET_DWORD_STAT(STAT_SingularisVehicle_WheelVisualsUpdated, NumUpdated);
+}
+
+bool USingularisVehicleWheelVisualSubsystem::BuildWheelBones(const ABaseWheeledVehiclePawn& Vehicle,
+                                                            const USkeletalMeshComponent& Mesh,
+                                                            TArray<FWheelBone>& OutBones)
+{
+	const FReferenceSkeleton& RefSkeleton = Mesh.GetSkinnedAsset()->GetRefSkeleton();
+	const TArray<FTransform>& RefBonePose = RefSkeleton.GetRefBonePose();
+
+	// 车轮骨骼到车轮序号的映射
+	TArray<int32> BoneWheelIndices;
+	BoneWheelIndices.Init(INDEX_NONE, RefSkeleton.GetNum());
+
+	bool bFoundWheel = false;
+	const TArray<FChaosWheelSetup>& WheelSetups = Vehicle.GetChaosVehicleMovement()->WheelSetups;
+	for (int32 WheelIndex = 0; WheelIndex < WheelSetups.Num(); ++WheelIndex)
+	{
+		const int32 BoneIndex = RefSkeleton.FindBoneIndex(WheelSetups[WheelIndex].BoneName);
+		if (BoneIndex != INDEX_NONE)
+		{
+			BoneWheelIndices[BoneIndex] = WheelIndex;
+			bFoundWheel = true;
+		}
+	}
+
+	// 参考骨架中父骨骼总在子骨骼之前，一次遍历即可收集车轮骨骼的全部子骨骼
+	TBitArray<> Affected(false, RefSkeleton.GetNum());
+	OutBones.Reset();
+	for (int32 BoneIndex = 0; BoneIndex < RefSkeleton.GetNum(); ++BoneIndex)
+	{
+		const int32 ParentIndex = RefSkeleton.GetParentIndex(BoneIndex);
+		const bool bWheel = BoneWheelIndices[BoneIndex] != INDEX_NONE;
+		if (!bWheel && (ParentIndex == INDEX_NONE || !Affected[ParentIndex]))
+		{
+			continue;
+		}
+
+		Affected[BoneIndex] = true;
+		OutBones.Add({BoneIndex, ParentIndex, BoneWheelIndices[BoneIndex], RefBonePose[BoneIndex]});
+	}
+
+	return bFoundWheel;
+}
+
+void USingularisVehicleWheelVisualSubsystem::UpdateVehicle(const ABaseWheeledVehiclePawn& Vehicle,
+                                                          USkeletalMeshComponent& Mesh,
+                                                          const TConstArrayView<FWheelBone> Bones,
+                                                          const TConstArrayView<FSingularisVehicleRecordWheel> ExternalWheels)
+{
+	const TArray<TObjectPtr<UChaosVehicleWheel>>& Wheels = Vehicle.GetChaosVehicleMovement()->Wheels;
+
+	// 从当前姿势开始，只改写车轮骨骼及其子骨骼
+	TArray<FTransform>& ComponentSpaceTransforms = Mesh.GetEditableComponentSpaceTransforms();
+	ComponentSpaceTransforms = Mesh.GetComponentSpaceTransforms();
+	TArrayView<FTransform> BoneSpaceTransforms = Mesh.GetEditableBoneSpaceTransforms();
+
+	for (const FWheelBone& Bone : Bones)
+	{
+		const FTransform ParentTransform = Bone.ParentIndex != INDEX_NONE ? ComponentSpaceTransforms[Bone.ParentIndex] : FTransform::Identity;
+		FTransform BoneTransform = Bone.RefLocalTransform * ParentTransform;
+
+		// 与 WheelController 动画节点相同：在组件空间中先平移悬挂偏移，再叠加转向与滚动
+		if (ExternalWheels.IsValidIndex(Bone.WheelIndex))
+		{
+			const FSingularisVehicleRecordWheel& Wheel = ExternalWheels[Bone.WheelIndex];
+			BoneTransform.AddToTranslation(FVector(0.0, 0.0, Wheel.SuspensionOffset));
+			const FQuat WheelRotation(FRotator(Wheel.RotationAngle, Wheel.SteerAngle, 0.0f));
+			BoneTransform.SetRotation(WheelRotation * BoneTransform.GetRotation());
+		}
+		else if (const UChaosVehicleWheel* Wheel = ExternalWheels.IsEmpty() && Wheels.IsValidIndex(Bone.WheelIndex) ? Wheels[Bone.WheelIndex].Get() : nullptr)
+		{
+			BoneTransform.AddToTranslation(FVector(0.0, 0.0, Wheel->GetSuspensionOffset()));
+			const FQuat WheelRotation(FRotator(Wheel->GetRotationAngle(), Wheel->GetSteerAngle(), 0.0f));
+			BoneTransform.SetRotation(WheelRotation * BoneTransform.GetRotation());
+		}
+
+		ComponentSpaceTransforms[Bone.BoneIndex] = BoneTransform;
+		if (BoneSpaceTransforms.IsValidIndex(Bone.BoneIndex))
+		{
+			// 物理混合以骨骼空间变换重建没有物理体的骨骼，这里保持一致
+			BoneSpaceTransforms[Bone.BoneIndex] = BoneTransform.GetRelativeTransform(ParentTransform);
+		}
+	}
+
+	Mesh.ApplyEditedComponentSpaceTransforms();
+	Mesh.MarkRenderDynamicDataDirty();
+}
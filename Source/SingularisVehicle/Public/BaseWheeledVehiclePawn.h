@@ -11,13 +11,22 @@
 
 #include "CoreMinimal.h"
 #include "WheeledVehiclePawn.h"
+#include "SingularisVehicleTypes.h"
 #include "BaseWheeledVehiclePawn.generated.h"
 
 class UCameraComponent;
 class USpringArmComponent;
+class ASingularisVehicleCameraRig;
+class USingularisVehicleSpec;
+struct FStreamableHandle;
 class UInputAction;
 class UChaosWheeledVehicleMovementComponent;
+class USingularisVehicleMovementComponent;
+class USingularisVehicleLightComponent;
+class UStaticMesh;
 struct FInputActionValue;
+struct FMinimalViewInfo;
+struct FSingularisPersistedVehicle;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogBaseWheeledVehiclePawn, Log, All);
 
@@ -53,6 +62,9 @@ class SINGULARISVEHICLE_API ABaseWheeledVehiclePawn : public AWheeledVehiclePawn
 	/** 将指针转换为 Chaos 车辆运动组件 */
 	TObjectPtr<UChaosWheeledVehicleMovementComponent> ChaosVehicleMovement;
 
+	/** 插件的运动组件，子类替换了运动组件类时为空 */
+	TObjectPtr<USingularisVehicleMovementComponent> SingularisVehicleMovement;
+
 protected:
 	/** 转向 Action */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input)
@@ -85,17 +97,189 @@ protected:
 	/** 记录哪个摄像头是激活的 */
 	bool bFrontCameraActive = false;
 
+	/** 刹车灯当前是否打开 */
+	bool bBrakeLightsActive = false;
+
+	/** 灯光组件，存在时刹车灯由它根据运动组件推导 */
+	UPROPERTY(Transient)
+	TObjectPtr<USingularisVehicleLightComponent> LightComponent;
+
+	/** 在 USingularisVehicleControlSubsystem 中的槽位，未注册时为 INDEX_NONE */
+	int32 ControlSlot = INDEX_NONE;
+
+	/** 控制子系统不存在时保存最近提交的控制帧 */
+	FVehicleControlFrame LocalControlFrame;
+
+	/**
+	 * 是否使用共享相机组
+	 * 开启后载具不保留自己的弹簧臂与摄像头，仅在被本地玩家控制时从 USingularisVehicleCameraRigSubsystem 借用一套，
+	 * 失去控制时归还；ToggleCamera、LookAround 以及各个相机 Getter 在持有相机组期间照常工作
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Camera)
+	bool bUseSharedCameraRig = false;
+
+	/** 当前借用的共享相机组 */
+	TWeakObjectPtr<ASingularisVehicleCameraRig> SharedCameraRig;
+
+	/**
+	 * 载具规格
+	 * 已加载时在组件注册前直接写入运动组件；未加载时在 BeginPlay 通过 Asset Manager 异步加载，加载完成后写入并重建物理状态
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Vehicle)
+	TSoftObjectPtr<USingularisVehicleSpec> VehicleSpec;
+
+	/** 已写入运动组件的规格，持有引用以保证共享的曲线资产不被回收 */
+	UPROPERTY(Transient)
+	TObjectPtr<const USingularisVehicleSpec> AppliedVehicleSpec;
+
+	/** 规格的异步加载句柄 */
+	TSharedPtr<FStreamableHandle> VehicleSpecLoadHandle;
+
+	/** 是否允许重要度子系统根据距离和可见性降低此载具的更新频率 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Significance)
+	bool bAllowSignificanceThrottling = true;
+
+	/** Reduced 层级下的 Actor Tick 间隔（秒） */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Significance, meta = (ClampMin = "0.0"))
+	float ReducedTickInterval = 0.1f;
+
+	/** LowDetail 层级下的 Actor Tick 间隔（秒） */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Significance, meta = (ClampMin = "0.0"))
+	float LowDetailTickInterval = 0.25f;
+
+	/** 当前的重要度层级 */
+	EVehicleSignificanceTier SignificanceTier = EVehicleSignificanceTier::Full;
+
+	/** 是否正闲置在对象池中 */
+	bool bPooled = false;
+
+	/**
+	 * 休眠时代替载具显示的静态网格，原点须与载具根组件一致
+	 * 为空时载具不会休眠；同类载具的休眠实例由 USingularisVehicleHibernationSubsystem 合并为一个实例化网格
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Hibernation)
+	TObjectPtr<UStaticMesh> HibernationMesh;
+
+	/** 是否允许静止一段时间后自动休眠 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Hibernation)
+	bool bAllowHibernation = true;
+
+	/**
+	 * 所在的 World Partition 单元卸载时，是否由 USingularisVehiclePersistenceSubsystem 写入紧凑记录并归还对象池，
+	 * 单元重新加载后再放回；玩家控制的载具始终不受影响
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Persistence)
+	bool bAllowPersistence = true;
+
+	/**
+	 * 是否不使用动画蓝图，由 USingularisVehicleWheelVisualSubsystem 直接写入车轮骨骼
+	 * 开启后网格上的动画实例在 BeginPlay 时被清除，车轮以外的骨骼动画（如车门、驾驶员）不再播放
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Wheels)
+	bool bUseNativeWheelVisuals = false;
+
 public:
-	ABaseWheeledVehiclePawn();
+	/** 相机相关默认子对象的名称，C++ 子类可通过 FObjectInitializer::DoNotCreateDefaultSubobject 完全去掉自带的相机 */
+	static const FName FrontSpringArmName;
+	static const FName FrontCameraName;
+	static const FName BackSpringArmName;
+	static const FName BackCameraName;
+
+	explicit ABaseWheeledVehiclePawn(const FObjectInitializer& ObjectInitializer);
 
 	// 开始实现 Pawn 接口
 	virtual void SetupPlayerInputComponent(UInputComponent* Component) override;
+	virtual void NotifyControllerChanged() override;
 	// 结束 Pawn 接口
 
 	// 开始 Actor 接口
+	virtual void PreRegisterAllComponents() override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void Tick(float Delta) override;
+	virtual void CalcCamera(float DeltaTime, FMinimalViewInfo& OutResult) override;
 	// 结束 Actor 接口
 
+	/**
+	 * Returns 是否执行纯表现的工作（相机、刹车灯事件、灯光与骨骼动画）
+	 * 专用服务器构建、以专用服务器运行或开启 SingularisVehicle.ForceServerLean 时为 false
+	 */
+	bool ShouldRunCosmetics() const;
+
+	/** 借用共享相机组，仅在 bUseSharedCameraRig 开启且被本地玩家控制时生效 */
+	void AcquireCameraRig();
+
+	/** 归还共享相机组 */
+	void ReleaseCameraRig();
+
+	/**
+	 * 切换重要度层级
+	 * 由 USingularisVehicleSignificanceSubsystem 在每帧的批处理中调用，子类可重写以裁剪更多的工作
+	 */
+	virtual void ApplySignificanceTier(EVehicleSignificanceTier NewTier);
+
+	/**
+	 * 将规格写入运动组件
+	 * 在物理状态创建之后调用时会重建 Chaos 载具模拟
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle")
+	void ApplyVehicleSpec(const USingularisVehicleSpec* Spec);
+
+	/** 将载具传送到指定位置，并清除线速度与角速度 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle")
+	void TeleportVehicle(const FTransform& NewTransform);
+
+	/**
+	 * 请求把载具重置到最近的安全位置
+	 * 由 USingularisVehicleResetSubsystem 批量进行异步检测，下一帧结果返回后才传送；子系统不存在时立即原地重置
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle")
+	void RequestSafeReset();
+
+	/** 在当前位置略微抬高并摆正，只保留偏航角；没有可用的安全位置时使用 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle")
+	void ResetInPlace();
+
+	/**
+	 * 提交控制帧，由 USingularisVehicleControlSubsystem 在本帧的批处理中统一写入运动组件
+	 * 玩家输入回调、AI 与交通等驾驶者都经由此处；子系统不存在时立即写入
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle")
+	void SubmitControlFrame(const FVehicleControlFrame& Frame);
+
+	/** Returns 最近一次提交的控制帧 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle")
+	FVehicleControlFrame GetControlFrame() const;
+
+	/** 一次设置全部控制输入，等同于提交一个控制帧 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle")
+	void SetControlInputs(float ThrottleValue, float BrakeValue, float SteeringValue, bool bHandbrake);
+
+	/**
+	 * 把控制帧写入运动组件并切换刹车灯，由 USingularisVehicleControlSubsystem 调用
+	 * @param Previous 上次写入的控制帧，只写入与之不同的通道；为空时全部写入
+	 */
+	void ApplyControlFrame(const FVehicleControlFrame& Frame, const FVehicleControlFrame* Previous = nullptr);
+
+	/** 清除引擎、变速箱、车轮与输入状态，以及相机朝向，使载具回到刚生成时的状态 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle")
+	virtual void ResetVehicleState();
+
+	/** 从对象池取出时调用，由 USingularisVehiclePoolSubsystem 调用 */
+	virtual void OnAcquiredFromPool(const FTransform& SpawnTransform);
+
+	/** 归还到对象池时调用，由 USingularisVehiclePoolSubsystem 调用 */
+	virtual void OnReleasedToPool(const FVector& ParkingLocation);
+
+	/**
+	 * 把位置、速度、挡位、手刹与摄像头状态写入持久化记录，由 USingularisVehiclePersistenceSubsystem 在所在单元卸载时调用
+	 * 子类可重写以写入 Damage 等自己维护的状态，重写时先调用父类
+	 */
+	virtual void SavePersistentState(FSingularisPersistedVehicle& OutRecord) const;
+
+	/** 从持久化记录恢复状态，由 USingularisVehiclePersistenceSubsystem 在载具从对象池取出并放回原处后调用 */
+	virtual void RestorePersistentState(const FSingularisPersistedVehicle& Record);
+
 protected:
 	/** 处理转向输入 */
 	void Steering(const FInputActionValue& Value);
@@ -106,8 +290,7 @@ protected:
 	/** 处理制动输入 */
 	void Brake(const FInputActionValue& Value);
 
-	/** 处理制动器开始/停止输入 */
-	void StartBrake(const FInputActionValue& Value);
+	/** 处理制动器停止输入 */
 	void StopBrake(const FInputActionValue& Value);
 
 	/** 处理手刹的开始/停止输入 */
@@ -127,6 +310,14 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent, Category="Vehicle")
 	void BrakeLights(bool bBraking);
 
+public:
+	/**
+	 * 设置刹车灯状态，状态变化且 bNotifyBlueprint 时触发 BrakeLights 事件
+	 * 由输入回调、USingularisVehicleLightComponent 与 USingularisVehiclePlaybackComponent 调用
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle")
+	void SetBrakeLights(bool bActive, bool bNotifyBlueprint = true);
+
 public:
 	/** Returns 前置摄像头弹簧臂子对象 */
 	FORCEINLINE USpringArmComponent* GetFrontSpringArm() const { return FrontSpringArm; }
@@ -138,7 +329,62 @@ public:
 	FORCEINLINE UCameraComponent* GetBackCamera() const { return BackCamera; }
 	/** Returns 已转换的 Chaos 车辆运动子对象 */
 	FORCEINLINE const TObjectPtr<UChaosWheeledVehicleMovementComponent>& GetChaosVehicleMovement() const { return ChaosVehicleMovement; }
+	/** Returns 插件的运动组件子对象，子类替换了运动组件类时为空 */
+	FORCEINLINE USingularisVehicleMovementComponent* GetSingularisVehicleMovement() const { return SingularisVehicleMovement; }
+	/** Returns 当前是否拥有可用的相机组（自带的或借用的） */
+	FORCEINLINE bool HasCameraRig() const { return FrontCamera && BackCamera && BackSpringArm; }
+	/** Returns 当前的重要度层级 */
+	FORCEINLINE EVehicleSignificanceTier GetSignificanceTier() const { return SignificanceTier; }
+	/** 登记灯光组件，由 USingularisVehicleLightComponent 在 BeginPlay/EndPlay 时调用 */
+	FORCEINLINE void SetLightComponent(USingularisVehicleLightComponent* InLightComponent) { LightComponent = InLightComponent; }
+	/** Returns 已登记的灯光组件，未挂载时为空 */
+	FORCEINLINE USingularisVehicleLightComponent* GetLightComponent() const { return LightComponent; }
+	/** 记录控制帧槽位，由 USingularisVehicleControlSubsystem 调用 */
+	FORCEINLINE void SetControlSlot(const int32 InControlSlot) { ControlSlot = InControlSlot; }
+	/** Returns 控制帧槽位，未注册时为 INDEX_NONE */
+	FORCEINLINE int32 GetControlSlot() const { return ControlSlot; }
+	/** Returns 刹车灯当前是否打开 */
+	FORCEINLINE bool AreBrakeLightsActive() const { return bBrakeLightsActive; }
+	/** Returns 是否正闲置在对象池中 */
+	FORCEINLINE bool IsPooled() const { return bPooled; }
+	/** Returns 是否允许重要度子系统降低更新频率 */
+	FORCEINLINE bool AllowsSignificanceThrottling() const { return bAllowSignificanceThrottling; }
+	/** Returns 休眠时使用的静态网格 */
+	FORCEINLINE UStaticMesh* GetHibernationMesh() const { return HibernationMesh; }
+	/** Returns 是否允许静止后自动休眠 */
+	FORCEINLINE bool AllowsHibernation() const { return bAllowHibernation && HibernationMesh != nullptr; }
+	/** Returns 所在单元卸载时是否允许写入持久化记录 */
+	FORCEINLINE bool AllowsPersistence() const { return bAllowPersistence; }
+	/** Returns 是否由车轮表现子系统直接写入车轮骨骼 */
+	FORCEINLINE bool UsesNativeWheelVisuals() const { return bUseNativeWheelVisuals; }
 
 private:
 	void SetVehicleMovementParameters() const;
+
+	/** 将控制输入交给运动组件，异步输入模式下同时送往物理线程 */
+	void SetThrottleInput(float Throttle) const;
+	void SetBrakeInput(float Brake) const;
+	void SetSteeringInput(float Steering) const;
+	void SetHandbrakeInput(bool bHandbrake) const;
+
+	/** 随控制帧切换刹车灯；挂有灯光组件时由组件处理 */
+	void SetInputBrakeLights(bool bActive);
+
+	/** 将摄像头状态交给运动组件，随控制帧发送 */
+	void UpdateNetCameraState() const;
+
+	/** 相机组只在本地玩家控制且处于全速层级时更新 */
+	void UpdateCameraRigTickEnabled() const;
+
+	/** 按 bFrontCameraActive 激活对应的摄像头 */
+	void ActivateCurrentCamera() const;
+
+	/** 规格异步加载完成 */
+	void OnVehicleSpecLoaded();
+
+	/** 登记到各载具子系统，BeginPlay 与从对象池取出时调用 */
+	void RegisterWithSubsystems();
+
+	/** 从各载具子系统注销，EndPlay 与归还对象池时调用 */
+	void UnregisterFromSubsystems();
 };
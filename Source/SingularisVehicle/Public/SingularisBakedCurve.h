@@ -0,0 +1,67 @@
+/* =====================================================================
+ * SingularisBakedCurve.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FRichCurve;
+
+/**
+ *  烘焙后的曲线查找表
+ *  将 FRichCurve 按等间距采样为固定大小的表，求值只做一次乘法、截断与线性插值，
+ *  不做关键帧查找，也不按插值模式分支；批量求值使用 SIMD 计算索引与插值系数
+ */
+struct SINGULARISVEHICLE_API FSingularisBakedCurve
+{
+	/** 采样点数量 */
+	static constexpr int32 NumSamples = 128;
+
+	/** 按曲线的时间范围烘焙 */
+	void Bake(const FRichCurve& Curve);
+
+	/** 按指定的时间范围烘焙 */
+	void Bake(const FRichCurve& Curve, float InMinTime, float InMaxTime);
+
+	/** 与原曲线对比，Returns 在范围内密集采样得到的最大绝对误差 */
+	float ComputeMaxError(const FRichCurve& Curve, int32 NumTestSamples = 4096) const;
+
+	/** 批量求值，Num 不要求是 4 的倍数 */
+	void EvaluateBatch(const float* RESTRICT InTimes, float* RESTRICT OutValues, int32 Num) const;
+
+	/** 求值，超出范围时取端点的值 */
+	FORCEINLINE float Evaluate(const float Time) const
+	{
+		const float Position = FMath::Clamp((Time - MinTime) * InvStep, 0.0f, static_cast<float>(NumSamples - 1));
+		const int32 Index = static_cast<int32>(Position);
+		const float Alpha = Position - static_cast<float>(Index);
+
+		// Values 末尾多存一个点，Index 为最后一个采样点时无需判断越界
+		return Values[Index] + (Values[Index + 1] - Values[Index]) * Alpha;
+	}
+
+	/** Returns 是否已经烘焙 */
+	FORCEINLINE bool IsBaked() const { return bBaked; }
+
+	FORCEINLINE float GetMinTime() const { return MinTime; }
+	FORCEINLINE float GetMaxTime() const { return MaxTime; }
+
+	/** Returns 第 Index 个采样点的值 */
+	FORCEINLINE float GetSampleValue(const int32 Index) const { return Values[Index]; }
+
+	/** Returns 第 Index 个采样点的时间 */
+	FORCEINLINE float GetSampleTime(const int32 Index) const { return MinTime + static_cast<float>(Index) / InvStep; }
+
+private:
+	alignas(16) float Values[NumSamples + 1] = {};
+	float MinTime = 0.0f;
+	float MaxTime = 0.0f;
+	float InvStep = 0.0f;
+	bool bBaked = false;
+};
@@ -0,0 +1,75 @@
+/* =====================================================================
+ * SingularisSurfaceResponse.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Chaos/ChaosEngineInterface.h"
+#include "SingularisSurfaceResponse.generated.h"
+
+/**
+ * 车轮在一种路面上的响应
+ */
+USTRUCT(BlueprintType)
+struct FSingularisSurfaceResponse
+{
+	GENERATED_BODY()
+
+	/** 物理材质的表面类型，在项目设置的 Physics - Physical Surface 中命名 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Surface)
+	TEnumAsByte<EPhysicalSurface> SurfaceType = SurfaceType_Default;
+
+	/** 乘在物理材质摩擦力上的系数，冰面等低抓地路面小于 1 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Surface, meta = (ClampMin = "0.0"))
+	float FrictionScale = 1.0f;
+
+	/** 车轮滑移量超过该值（厘米/秒）时视为打滑，用于轮胎声等表现 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Surface, meta = (ClampMin = "0.0"))
+	float SlipThreshold = 20.0f;
+
+	/** 车轮侧滑量超过该值（厘米/秒）时视为侧滑，用于胎痕与烟尘等表现 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Surface, meta = (ClampMin = "0.0"))
+	float SkidThreshold = 20.0f;
+};
+
+/**
+ *  烘焙后的路面响应表
+ *  按表面类型展开为定长数组，物理线程上每个车轮接触只做一次下标访问；
+ *  烘焙后不再修改，由规格、运动组件与物理线程模拟共享
+ */
+struct SINGULARISVEHICLE_API FSingularisSurfaceResponseTable
+{
+	/** 表面类型的数量，SurfaceType_Max 为 2 的幂 */
+	static constexpr int32 NumSurfaceTypes = SurfaceType_Max;
+	static_assert(FMath::IsPowerOfTwo(NumSurfaceTypes), "表面类型的数量须为 2 的幂");
+
+	/** 烘焙后的一项，只保留模拟需要的数值 */
+	struct FEntry
+	{
+		float FrictionScale = 1.0f;
+		float SlipThreshold = 20.0f;
+		float SkidThreshold = 20.0f;
+	};
+
+	/**
+	 * 烘焙表格，未列出的表面类型使用 Default；同一表面类型出现多次时后者生效
+	 * Returns 烘焙结果
+	 */
+	static TSharedRef<const FSingularisSurfaceResponseTable, ESPMode::ThreadSafe> Bake(TConstArrayView<FSingularisSurfaceResponse> Responses,
+	                                                                                  const FSingularisSurfaceResponse& Default);
+
+	/** Returns 表面类型对应的响应 */
+	FORCEINLINE const FEntry& Get(const uint8 SurfaceType) const { return Entries[SurfaceType & (NumSurfaceTypes - 1)]; }
+
+private:
+	FEntry Entries[NumSurfaceTypes];
+};
+
+using FSingularisSurfaceResponseTableRef = TSharedRef<const FSingularisSurfaceResponseTable, ESPMode::ThreadSafe>;
+using FSingularisSurfaceResponseTablePtr = TSharedPtr<const FSingularisSurfaceResponseTable, ESPMode::ThreadSafe>;
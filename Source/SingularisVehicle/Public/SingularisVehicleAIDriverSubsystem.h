@@ -0,0 +1,145 @@
+/* =====================================================================
+ * SingularisVehicleAIDriverSubsystem.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SingularisVehicleTrafficTypes.h"
+#include "SingularisVehicleTypes.h"
+#include "SingularisVehicleAIDriverSubsystem.generated.h"
+
+class ABaseWheeledVehiclePawn;
+class USplineComponent;
+
+/**
+ * 一次驾驶更新各阶段的耗时（秒）
+ */
+struct FSingularisAIDriverTimings
+{
+	/** 在游戏线程上读取载具状态 */
+	double GatherSeconds = 0.0;
+
+	/** 车道投影、跟车与控制计算 */
+	double ComputeSeconds = 0.0;
+
+	/** 提交控制帧 */
+	double WriteSeconds = 0.0;
+
+	/** 本次驾驶的载具数量 */
+	int32 NumDriven = 0;
+};
+
+/**
+ *  AI 驾驶子系统
+ *  沿路径驾驶大量载具：每帧先在游戏线程把载具状态收集到连续数组，再用 ParallelFor 并行完成车道投影、
+ *  预瞄追踪、速度控制与前车制动，并行部分只读写数组，不访问任何 UObject；最后把结果作为控制帧提交，
+ *  由 USingularisVehicleControlSubsystem 在下一次批处理中写入运动组件
+ *
+ *  驾驶算法与交通子系统升级后的物理载具相同（SingularisVehicleTraffic::ComputeFollowControl）
+ *
+ *  跟车只考虑由 AssignVehicle 交给本子系统、且分配在同一路径上的载具：未交给本子系统的载具（如玩家驾驶的载具）、其他路径上的载具
+ *  以及交通子系统的 Mass 实体即使停在路径上也不会被当作前车，需要避让它们时应一并交给本子系统或另行处理
+ */
+UCLASS()
+class SINGULARISVEHICLE_API USingularisVehicleAIDriverSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// 开始 Subsystem 接口
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// 结束 Subsystem 接口
+
+	// 开始 TickableGameObject 接口
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// 结束 TickableGameObject 接口
+
+	/** 驾驶参数 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle|AI")
+	FSingularisTrafficDrivingParams DrivingParams;
+
+	/** 与前车保持的最小车距（厘米，车身中心之间），小于该距离时全力制动 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle|AI", meta = (ClampMin = "0.0"))
+	float MinFollowDistance = 800.0f;
+
+	/** 跟车时距（秒），超出最小车距的部分按该时距换算为速度上限 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle|AI", meta = (ClampMin = "0.1"))
+	float FollowTimeGap = 1.5f;
+
+	/**
+	 * 烘焙样条为路径，Returns 路径序号
+	 * @param SpeedLimit 限速（厘米/秒）
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|AI")
+	int32 RegisterPath(const USplineComponent* Spline, float SpeedLimit = 1400.0f);
+
+	/** 由折线注册路径，Returns 路径序号 */
+	int32 RegisterPathPoints(TConstArrayView<FVector> Points, bool bClosedLoop, float SpeedLimit);
+
+	/**
+	 * 让载具沿路径行驶，已在驾驶的载具改换路径
+	 * @param SpeedScale 期望速度相对限速的比例
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|AI")
+	void AssignVehicle(ABaseWheeledVehiclePawn* Vehicle, int32 PathIndex, float SpeedScale = 1.0f);
+
+	/** 停止驾驶载具，不清除其当前的控制输入 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|AI")
+	void ReleaseVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** Returns 正在驾驶的载具数量 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|AI")
+	int32 GetNumVehicles() const { return Vehicles.Num(); }
+
+	/** 执行一次驾驶更新，由 Tick 调用 */
+	void DriveVehicles(float DeltaTime);
+
+	/** Returns 最近一次驾驶更新的各阶段耗时 */
+	FORCEINLINE const FSingularisAIDriverTimings& GetLastTimings() const { return LastTimings; }
+
+private:
+	/** 清除已失效的载具 */
+	void RemoveInvalidVehicles();
+
+	/** 按路径与进度排序，为每辆车找到同一路径上的前车；只在本子系统驾驶的载具中查找 */
+	void FindLeaders();
+
+	TArray<FSingularisTrafficLane> Paths;
+
+	/** 以下数组一一对应，按载具序号访问；前四项跨帧保留，其余每帧重新填写 */
+	TArray<TWeakObjectPtr<ABaseWheeledVehiclePawn>> Vehicles;
+	TArray<int32> PathIndices;
+	TArray<float> SpeedScales;
+
+	/** 沿路径的进度（厘米），作为下一帧投影的搜索起点 */
+	TArray<float> Distances;
+
+	TArray<FTransform> Transforms;
+	TArray<float> ForwardSpeeds;
+
+	/** 本帧是否驾驶：停放、冻结或被玩家控制的载具跳过 */
+	TArray<uint8> Active;
+
+	/** 本帧是否作为前车参与跟车：除停放的载具外都是，冻结与玩家控制的载具同样需要避让 */
+	TArray<uint8> Obstacles;
+
+	/** 同一路径上的前车序号与车距，没有前车时为 INDEX_NONE */
+	TArray<int32> Leaders;
+	TArray<float> LeaderGaps;
+
+	TArray<FVehicleControlFrame> Controls;
+
+	/** 排序用的临时数组 */
+	TArray<int32> SortedIndices;
+
+	FSingularisAIDriverTimings LastTimings;
+};
@@ -0,0 +1,68 @@
+/* =====================================================================
+ * SingularisVehicleCameraRig.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "SingularisVehicleCameraRig.generated.h"
+
+class UCameraComponent;
+class USpringArmComponent;
+
+/**
+ *  共享相机组
+ *  包含与载具自带相机相同的前/后弹簧臂与摄像头，
+ *  由 USingularisVehicleCameraRigSubsystem 管理，在玩家占有载具时附加到载具上，离开时释放
+ */
+UCLASS(NotPlaceable, Transient)
+class SINGULARISVEHICLE_API ASingularisVehicleCameraRig : public AActor
+{
+	GENERATED_BODY()
+
+	/** 前置摄像头弹簧臂 */
+	UPROPERTY(VisibleAnywhere, Category = Camera)
+	TObjectPtr<USpringArmComponent> FrontSpringArm;
+
+	/** 前置摄像头组件 */
+	UPROPERTY(VisibleAnywhere, Category = Camera)
+	TObjectPtr<UCameraComponent> FrontCamera;
+
+	/** 后置摄像头弹簧臂 */
+	UPROPERTY(VisibleAnywhere, Category = Camera)
+	TObjectPtr<USpringArmComponent> BackSpringArm;
+
+	/** 后置摄像头组件 */
+	UPROPERTY(VisibleAnywhere, Category = Camera)
+	TObjectPtr<UCameraComponent> BackCamera;
+
+public:
+	ASingularisVehicleCameraRig();
+
+	/** 附加到载具网格上，并启用弹簧臂更新 */
+	void AttachToVehicle(USceneComponent* VehicleMesh);
+
+	/** 从载具上分离，停止弹簧臂更新并隐藏 */
+	void DetachFromVehicle();
+
+	/** 按载具默认的前置弹簧臂参数配置 */
+	static void ConfigureFrontSpringArm(USpringArmComponent* SpringArm);
+
+	/** 按载具默认的后置弹簧臂参数配置 */
+	static void ConfigureBackSpringArm(USpringArmComponent* SpringArm);
+
+	/** Returns 前置摄像头弹簧臂子对象 */
+	FORCEINLINE USpringArmComponent* GetFrontSpringArm() const { return FrontSpringArm; }
+	/** Returns 前摄像头子对象 */
+	FORCEINLINE UCameraComponent* GetFrontCamera() const { return FrontCamera; }
+	/** Returns 后置摄像头弹簧臂子对象 */
+	FORCEINLINE USpringArmComponent* GetBackSpringArm() const { return BackSpringArm; }
+	/** Returns 后摄像头子对象 */
+	FORCEINLINE UCameraComponent* GetBackCamera() const { return BackCamera; }
+};
@@ -0,0 +1,51 @@
+/* =====================================================================
+ * SingularisVehicleCameraRigSubsystem.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SingularisVehicleCameraRigSubsystem.generated.h"
+
+class ABaseWheeledVehiclePawn;
+class APlayerController;
+class ASingularisVehicleCameraRig;
+
+/**
+ *  共享相机组子系统
+ *  每个本地玩家控制器只持有一套相机组，随玩家占有的载具移动，
+ *  使 AI 与停放的载具不再携带和更新各自的弹簧臂与摄像头
+ */
+UCLASS()
+class SINGULARISVEHICLE_API USingularisVehicleCameraRigSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// 开始 Subsystem 接口
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// 结束 Subsystem 接口
+
+	/** 为玩家控制器取得相机组并附加到载具上；若相机组仍附加在其他载具上，会先从那辆载具上释放 */
+	ASingularisVehicleCameraRig* AcquireRig(const APlayerController* PlayerController, ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 释放载具当前持有的相机组，相机组保留给同一玩家控制器复用 */
+	void ReleaseRig(const ABaseWheeledVehiclePawn* Vehicle);
+
+private:
+	struct FRigEntry
+	{
+		TWeakObjectPtr<const APlayerController> PlayerController;
+		TWeakObjectPtr<ASingularisVehicleCameraRig> Rig;
+		TWeakObjectPtr<ABaseWheeledVehiclePawn> Vehicle;
+	};
+
+	TArray<FRigEntry> Rigs;
+};
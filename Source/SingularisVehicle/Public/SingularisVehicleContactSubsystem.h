@@ -0,0 +1,208 @@
+/* =====================================================================
+ * SingularisVehicleContactSubsystem.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Chaos/ChaosEngineInterface.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "SingularisVehicleContactSubsystem.generated.h"
+
+class ABaseWheeledVehiclePawn;
+class UPrimitiveComponent;
+
+namespace Chaos
+{
+	class FPBDRigidsSolver;
+	struct FCollisionEventData;
+}
+
+/**
+ * 车身接触的阶段
+ */
+UENUM(BlueprintType)
+enum class ESingularisVehicleContactPhase : uint8
+{
+	/** 接触开始，峰值冲量首次达到阈值 */
+	Began,
+	/** 持续接触（如贴墙刮擦），按间隔报告 */
+	Sustained,
+	/** 接触结束 */
+	Ended
+};
+
+/**
+ * 合并后的一次车身接触：一辆载具与另一辆载具或一个物体之间，自上次报告以来的全部原始接触
+ */
+USTRUCT(BlueprintType)
+struct FSingularisVehicleContact
+{
+	GENERATED_BODY()
+
+	/** 接触的载具；两辆载具之间的接触只报告一次，另一辆为 OtherActor */
+	UPROPERTY(BlueprintReadOnly, Category = Contact)
+	TObjectPtr<ABaseWheeledVehiclePawn> Vehicle;
+
+	UPROPERTY(BlueprintReadOnly, Category = Contact)
+	TObjectPtr<AActor> OtherActor;
+
+	UPROPERTY(BlueprintReadOnly, Category = Contact)
+	TObjectPtr<UPrimitiveComponent> OtherComponent;
+
+	/** 另一方是否为登记的载具 */
+	UPROPERTY(BlueprintReadOnly, Category = Contact)
+	bool bOtherIsVehicle = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = Contact)
+	ESingularisVehicleContactPhase Phase = ESingularisVehicleContactPhase::Began;
+
+	/** 峰值冲量处的接触点 */
+	UPROPERTY(BlueprintReadOnly, Category = Contact)
+	FVector Location = FVector::ZeroVector;
+
+	/** 峰值冲量处的法线，指向 Vehicle 一侧 */
+	UPROPERTY(BlueprintReadOnly, Category = Contact)
+	FVector Normal = FVector::UpVector;
+
+	/** 自上次报告以来的峰值冲量（千克·厘米/秒），Ended 时为整个接触的峰值 */
+	UPROPERTY(BlueprintReadOnly, Category = Contact)
+	float PeakImpulse = 0.0f;
+
+	/** 接触开始至今的时长（秒） */
+	UPROPERTY(BlueprintReadOnly, Category = Contact)
+	float Duration = 0.0f;
+
+	/** 合并的原始接触数量 */
+	UPROPERTY(BlueprintReadOnly, Category = Contact)
+	int32 NumContacts = 0;
+
+	/** 另一方物理材质的表面类型，用于选择刮擦声与火花等表现 */
+	UPROPERTY(BlueprintReadOnly, Category = Contact)
+	TEnumAsByte<EPhysicalSurface> SurfaceType = SurfaceType_Default;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnSingularisVehicleContactBatch, TConstArrayView<FSingularisVehicleContact>);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSingularisVehicleContacts, const TArray<FSingularisVehicleContact>&, Contacts);
+
+/**
+ *  车身接触聚合子系统
+ *  直接订阅 Chaos 求解器的碰撞事件，不需要在车身网格上开启 Simulation Generates Hit Events，
+ *  把登记载具的原始接触按（载具，另一方）合并，每帧最多广播一批：
+ *  接触的峰值冲量达到阈值时报告开始，持续接触按间隔报告一次，一段时间未再接触后报告结束
+ *
+ *  伤害、刮擦声与镜头震动等逻辑应绑定 OnContactBatch 或 OnContacts，而不是车身的 OnComponentHit
+ *
+ *  订阅期间求解器为整个场景生成碰撞数据，不只是登记的载具：每个物理步都会收集场景中全部的碰撞约束，
+ *  物体很多时这部分开销随接触数量增长；世界结束时恢复求解器原来的设置
+ */
+UCLASS()
+class SINGULARISVEHICLE_API USingularisVehicleContactSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// 开始 Subsystem 接口
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// 结束 Subsystem 接口
+
+	// 开始 TickableGameObject 接口
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// 结束 TickableGameObject 接口
+
+	/** 登记载具，由载具 BeginPlay 调用 */
+	void RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 注销载具，由载具 EndPlay 调用；进行中的接触按结束延迟正常结束 */
+	void UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 每帧的接触批次，供 C++ 使用，不复制数组 */
+	FOnSingularisVehicleContactBatch OnContactBatch;
+
+	/** 每帧的接触批次，供蓝图使用 */
+	UPROPERTY(BlueprintAssignable, Category = "Vehicle|Contact")
+	FOnSingularisVehicleContacts OnContacts;
+
+	/** Returns 登记的载具数量 */
+	FORCEINLINE int32 GetNumVehicles() const { return Vehicles.Num(); }
+
+	/** Returns 进行中的接触数量 */
+	FORCEINLINE int32 GetNumActiveContacts() const { return ActiveContacts.Num(); }
+
+	/** Returns 最近一帧合并的原始接触数量 */
+	FORCEINLINE int32 GetLastNumRawContacts() const { return LastNumRawContacts; }
+
+	/** Returns 最近一帧报告的接触数量 */
+	FORCEINLINE int32 GetLastNumReported() const { return LastNumReported; }
+
+	/** Returns 最近一帧收集与报告的耗时（秒），不含订阅者的处理 */
+	FORCEINLINE double GetLastProcessSeconds() const { return LastProcessSeconds; }
+
+private:
+	/** 求解器的碰撞事件，在游戏线程上同步物理结果时调用，异步物理下一帧可能调用多次 */
+	void HandleCollisionEvents(const Chaos::FCollisionEventData& CollisionData);
+
+	/** 更新进行中的接触并广播本帧的批次 */
+	void FlushContacts();
+
+	/** 注销求解器的碰撞事件，恢复求解器原来的碰撞数据设置 */
+	void UnregisterCollisionEvents();
+
+	/** 进行中的一次接触 */
+	struct FActiveContact
+	{
+		TWeakObjectPtr<ABaseWheeledVehiclePawn> Vehicle;
+		TWeakObjectPtr<UPrimitiveComponent> OtherComponent;
+		bool bOtherIsVehicle = false;
+		TEnumAsByte<EPhysicalSurface> SurfaceType = SurfaceType_Default;
+
+		double StartTime = 0.0;
+		double LastSeenTime = 0.0;
+		double LastReportTime = 0.0;
+
+		/** 是否已报告开始 */
+		bool bBegan = false;
+
+		/** 本帧是否收到过原始接触 */
+		bool bSeenThisFrame = false;
+
+		/** 整个接触的峰值冲量 */
+		float TotalPeakImpulse = 0.0f;
+
+		/** 自上次报告以来的累计 */
+		float PeakImpulse = 0.0f;
+		FVector Location = FVector::ZeroVector;
+		FVector Normal = FVector::UpVector;
+		int32 NumContacts = 0;
+	};
+
+	using FContactKey = TPair<TObjectKey<ABaseWheeledVehiclePawn>, TObjectKey<UPrimitiveComponent>>;
+	TMap<FContactKey, FActiveContact> ActiveContacts;
+
+	TArray<TWeakObjectPtr<ABaseWheeledVehiclePawn>> Vehicles;
+
+	/** 本帧的批次，复用内存 */
+	TArray<FSingularisVehicleContact> Batch;
+
+	/** 已订阅碰撞事件的求解器 */
+	Chaos::FPBDRigidsSolver* Solver = nullptr;
+
+	/** 订阅前求解器是否已在生成碰撞数据，注销时恢复 */
+	bool bSolverGeneratedCollisionData = false;
+
+	int32 PendingNumRawContacts = 0;
+	double PendingProcessSeconds = 0.0;
+
+	int32 LastNumRawContacts = 0;
+	int32 LastNumReported = 0;
+	double LastProcessSeconds = 0.0;
+};
@@ -0,0 +1,42 @@
+/* =====================================================================
+ * SingularisVehicleControlSource.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "SingularisVehicleTypes.h"
+#include "SingularisVehicleControlSource.generated.h"
+
+class ABaseWheeledVehiclePawn;
+
+UINTERFACE(MinimalAPI, meta = (CannotImplementInterfaceInBlueprint))
+class USingularisVehicleControlSource : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ *  载具控制来源
+ *  由 AI 控制器等驾驶者实现；控制器占有载具后，USingularisVehicleControlSubsystem 在每帧的批处理中
+ *  依次向各载具的控制来源索取控制帧，驾驶者不需要自己调用运动组件的输入接口
+ */
+class SINGULARISVEHICLE_API ISingularisVehicleControlSource
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * 填写本帧的控制输入
+	 * @param Vehicle 被控制的载具
+	 * @param DeltaTime 帧长（秒）
+	 * @param InOutFrame 传入上一帧提交的控制帧，只需修改变化的通道
+	 */
+	virtual void FillControlFrame(const ABaseWheeledVehiclePawn& Vehicle, float DeltaTime, FVehicleControlFrame& InOutFrame) = 0;
+};
@@ -0,0 +1,131 @@
+/* =====================================================================
+ * SingularisVehicleControlSubsystem.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/WeakInterfacePtr.h"
+#include "SingularisVehicleControlSource.h"
+#include "SingularisVehicleTypes.h"
+#include "SingularisVehicleControlSubsystem.generated.h"
+
+class ABaseWheeledVehiclePawn;
+class APlayerController;
+class USingularisVehicleControlSubsystem;
+
+/**
+ * 控制帧批处理的 Tick 函数
+ * 位于 TG_PrePhysics，在本地玩家控制器处理完输入之后、载具运动组件 Tick 之前执行
+ */
+USTRUCT()
+struct FSingularisVehicleControlTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	USingularisVehicleControlSubsystem* Target = nullptr;
+
+	// 开始 TickFunction 接口
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+	virtual FName DiagnosticContext(bool bDetailed) override;
+	// 结束 TickFunction 接口
+};
+
+template <>
+struct TStructOpsTypeTraits<FSingularisVehicleControlTickFunction> : public TStructOpsTypeTraitsBase2<FSingularisVehicleControlTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * 控制帧写入运动组件之前的回调，可原地修改控制帧（输入平滑）或只读取（录制）
+ * 两个数组一一对应，Vehicles 中的元素可能为空
+ */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnPreApplyControlFrames,
+                                       TConstArrayView<TWeakObjectPtr<ABaseWheeledVehiclePawn>> /* Vehicles */,
+                                       TArrayView<FVehicleControlFrame> /* Frames */,
+                                       float /* DeltaTime */);
+
+/**
+ *  载具控制子系统
+ *  所有载具的控制帧存放在连续数组中；每帧一次批处理：先向实现了 ISingularisVehicleControlSource 的控制器
+ *  索取控制帧，再广播 OnPreApplyControlFrames，最后与上次写入的控制帧逐通道比较，只把变化的通道写入运动组件，
+ *  同时处理刹车灯的切换。未变化的载具不会被访问
+ */
+UCLASS()
+class SINGULARISVEHICLE_API USingularisVehicleControlSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// 开始 Subsystem 接口
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// 结束 Subsystem 接口
+
+	/** 注册载具并分配控制帧，由载具 BeginPlay 调用 */
+	void RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 注销载具并释放控制帧，由载具 EndPlay 调用 */
+	void UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 控制器变化后重新查找控制来源，由载具 NotifyControllerChanged 调用 */
+	void RefreshControlSource(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 提交载具下一次批处理使用的控制帧，Returns 载具是否已注册 */
+	bool SubmitControlFrame(const ABaseWheeledVehiclePawn* Vehicle, const FVehicleControlFrame& Frame);
+
+	/** Returns 载具最近一次提交的控制帧，未注册时返回 nullptr */
+	const FVehicleControlFrame* FindControlFrame(const ABaseWheeledVehiclePawn* Vehicle) const;
+
+	/** 把载具的控制帧与已写入的记录清零，载具自己负责立即清除运动组件的输入 */
+	void ResetControlFrame(const ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 执行一次批处理，由 Tick 函数调用 */
+	void ApplyControlFrames(float DeltaTime);
+
+	/** Returns 已注册的载具数量 */
+	FORCEINLINE int32 GetNumVehicles() const { return Vehicles.Num(); }
+
+	/** 控制帧写入运动组件之前广播 */
+	FOnPreApplyControlFrames OnPreApplyControlFrames;
+
+private:
+	/** 以下数组一一对应，按槽位访问；载具通过 ControlSlot 记住自己的槽位 */
+	TArray<TWeakObjectPtr<ABaseWheeledVehiclePawn>> Vehicles;
+
+	/** 控制器实现的控制来源，没有时为空 */
+	TArray<TWeakInterfacePtr<ISingularisVehicleControlSource>> Sources;
+
+	/** 待写入的控制帧 */
+	TArray<FVehicleControlFrame> PendingFrames;
+
+	/** 上次写入运动组件的控制帧 */
+	TArray<FVehicleControlFrame> AppliedFrames;
+
+	/** 为该载具加为批处理前置的本地玩家控制器，没有时为空 */
+	TArray<TWeakObjectPtr<APlayerController>> PrerequisiteControllers;
+
+	FSingularisVehicleControlTickFunction ControlTickFunction;
+
+	/** Returns 载具的槽位，未注册时返回 INDEX_NONE */
+	int32 FindSlot(const ABaseWheeledVehiclePawn* Vehicle) const;
+
+	/** 释放槽位，最后一个槽位移入空位 */
+	void RemoveSlot(int32 Slot);
+
+	/** 替换槽位的前置玩家控制器；旧控制器不再是任何载具的前置时从批处理的前置中移除 */
+	void SetPrerequisiteController(int32 Slot, APlayerController* PlayerController);
+};
@@ -0,0 +1,167 @@
+/* =====================================================================
+ * SingularisVehicleGroundContact.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+#include "SuspensionSystem.h"
+#include <atomic>
+
+class UPhysicalMaterial;
+class UPrimitiveComponent;
+struct FHitResult;
+
+/**
+ *  缓存的一块高度场
+ *  在游戏线程上对地形碰撞逐点采样得到，按等间距网格保存高度与物理材质，之后不再修改；
+ *  每个网格单元记录是否可以直接采样：四个角都落在高度场上，且附近没有其他静态几何体
+ */
+struct SINGULARISVEHICLE_API FSingularisGroundTile
+{
+	/** 采样点 (0, 0) 的世界 XY 坐标 */
+	FVector2D Origin = FVector2D::ZeroVector;
+
+	/** 采样间距（厘米） */
+	float Spacing = 100.0f;
+
+	/** 每边的采样点数量，为 0 表示该区域没有高度场 */
+	int32 NumSamples = 0;
+
+	/** 以下数组按 Y * NumSamples + X 排列 */
+	TArray<float> Heights;
+
+	/** Palette 中的序号，InvalidPalette 表示该点不在高度场上 */
+	TArray<uint8> SamplePalette;
+
+	/** 每个网格单元是否可以直接采样，按 Y * (NumSamples - 1) + X 排列 */
+	TBitArray<> UsableCells;
+
+	/** 采样点所属的碰撞组件与物理材质，写入命中结果 */
+	struct FPaletteEntry
+	{
+		TWeakObjectPtr<UPrimitiveComponent> Component;
+		TWeakObjectPtr<UPhysicalMaterial> PhysMaterial;
+	};
+	TArray<FPaletteEntry> Palette;
+
+	/** 表示采样点不在高度场上 */
+	static constexpr uint8 InvalidPalette = 0xFF;
+
+	/**
+	 * 在世界 XY 坐标处双线性插值高度，法线取插值曲面的梯度
+	 * Returns 所在网格单元是否可以直接采样，否则输出不变
+	 */
+	bool Sample(const FVector2D& Location, float& OutHeight, FVector3f& OutNormal, uint8& OutPalette) const;
+};
+
+/**
+ * 高度场接触的统计，用于基准测试
+ */
+struct FSingularisGroundContactStats
+{
+	/** 由缓存高度场解析得到接触的车轮次数，以及回退到场景查询的车轮次数 */
+	int64 NumAnalyticWheels = 0;
+	int64 NumFallbackWheels = 0;
+
+	/** 两种方式在悬挂检测上花费的时间（秒） */
+	double AnalyticSeconds = 0.0;
+	double FallbackSeconds = 0.0;
+
+	/** 校验模式下与场景查询对比的车轮次数，以及是否命中不一致的次数 */
+	int64 NumCompared = 0;
+	int64 NumHitMismatches = 0;
+
+	/** 两者都命中的次数，以及此时的高度误差（厘米）与法线夹角误差（度） */
+	int64 NumBothHit = 0;
+	double SumHeightError = 0.0;
+	double MaxHeightError = 0.0;
+	double MaxNormalErrorDegrees = 0.0;
+};
+
+/**
+ *  车轮的高度场接触提供者
+ *  由 USingularisVehicleGroundSubsystem 在游戏线程上缓存载具附近的高度场块，物理线程模拟在悬挂检测时
+ *  一次读锁取得一辆车所有车轮的接触：射线近似竖直且落在可直接采样的单元上时解析求交，否则交还场景查询
+ *
+ *  缓存只反映建立时的静态几何体：其他载具、模拟物理的物体与 Pawn 由子系统每帧逐车检查，附近有这些物体的载具
+ *  通过 FSingularisGroundObstructionRef 回退到场景查询；在地形上放置或移除静态物体后需调用 USingularisVehicleGroundSubsystem::InvalidateRegion
+ */
+class SINGULARISVEHICLE_API FSingularisGroundContactProvider
+{
+public:
+	explicit FSingularisGroundContactProvider(float InTileSize);
+
+	/**
+	 * 为一辆车的所有车轮求接触，可在任意线程调用
+	 * 只要有一个车轮无法解析就返回 false，此时 OutHits 的内容无意义，调用方应对所有车轮执行场景查询
+	 */
+	bool TraceWheels(TConstArrayView<Chaos::FSuspensionTrace> Traces, TArrayView<FHitResult> OutHits) const;
+
+	/** 添加或替换高度场块，只在游戏线程调用 */
+	void SetTile(const FIntPoint& Key, TSharedRef<const FSingularisGroundTile, ESPMode::ThreadSafe> Tile);
+
+	/** 移除高度场块，只在游戏线程调用 */
+	void RemoveTile(const FIntPoint& Key);
+
+	/** Returns 是否已缓存高度场块 */
+	bool HasTile(const FIntPoint& Key) const;
+
+	/** Returns 已缓存的高度场块数量 */
+	int32 GetNumTiles() const;
+
+	/** Returns 世界 XY 坐标所在高度场块的键 */
+	FORCEINLINE FIntPoint GetTileKey(const FVector2D& Location) const
+	{
+		return FIntPoint(FMath::FloorToInt32(Location.X / TileSize), FMath::FloorToInt32(Location.Y / TileSize));
+	}
+
+	FORCEINLINE float GetTileSize() const { return TileSize; }
+
+	/** 开关与模式，由子系统根据控制台变量在游戏线程上设置，物理线程读取 */
+	std::atomic<bool> bEnabled{true};
+	std::atomic<bool> bValidate{false};
+	std::atomic<bool> bCollectStats{false};
+
+	/** 累计一次悬挂检测的统计，只在 bCollectStats 时调用 */
+	void AddTraceStats(bool bAnalytic, int32 NumWheels, double Seconds);
+
+	/** 累计一个车轮的校验结果，只在 bValidate 时调用 */
+	void AddValidationSample(const FHitResult& SceneHit, const FHitResult& AnalyticHit);
+
+	/** Returns 累计的统计 */
+	FSingularisGroundContactStats GetStats() const;
+
+	/** 清零统计 */
+	void ResetStats();
+
+private:
+	/** 在世界 XY 坐标处采样，Returns 是否可以直接采样 */
+	bool SampleLocked(const FVector2D& Location, float& OutHeight, FVector3f& OutNormal, const FSingularisGroundTile*& OutTile, uint8& OutPalette) const;
+
+	/** 在持有读锁时求一个车轮的接触 */
+	bool TraceWheelLocked(const FVector& Start, const FVector& End, FHitResult& OutHit) const;
+
+	const float TileSize;
+
+	mutable FRWLock TilesLock;
+	TMap<FIntPoint, TSharedRef<const FSingularisGroundTile, ESPMode::ThreadSafe>> Tiles;
+
+	mutable FCriticalSection StatsLock;
+	FSingularisGroundContactStats Stats;
+};
+
+using FSingularisGroundContactProviderPtr = TSharedPtr<FSingularisGroundContactProvider, ESPMode::ThreadSafe>;
+
+/**
+ * 一辆载具附近是否有高度场块不包含的动态物体，由地面接触子系统每帧在游戏线程上写入，物理线程模拟读取；
+ * 为 true 时该车的所有车轮使用场景查询
+ */
+using FSingularisGroundObstructionRef = TSharedRef<std::atomic<bool>, ESPMode::ThreadSafe>;
+using FSingularisGroundObstructionPtr = TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe>;
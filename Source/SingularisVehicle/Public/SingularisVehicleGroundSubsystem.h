@@ -0,0 +1,111 @@
+/* =====================================================================
+ * SingularisVehicleGroundSubsystem.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SingularisVehicleGroundContact.h"
+#include "SingularisVehicleGroundSubsystem.generated.h"
+
+class ABaseWheeledVehiclePawn;
+class ULevel;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogSingularisVehicleGround, Log, All);
+
+/**
+ *  地面接触子系统
+ *  为开启了 bUseHeightfieldContact 的载具维护车轮高度场接触的缓存：每帧按载具位置找出需要的高度场块，
+ *  每帧最多建立若干块，长时间无载具经过的块被移除；关卡加载或卸载时清空缓存
+ *
+ *  建立一块时对块内的地形碰撞组件逐点做组件射线检测，同时把块内其他静态碰撞体覆盖的网格单元标记为不可直接采样，
+ *  车轮经过这些单元时回退到场景查询
+ *
+ *  缓存不包含其他载具、模拟物理的物体与 Pawn，也不包含建立之后生成的可移动物体；每帧对每辆登记的载具在其包围盒附近
+ *  做一次动态物体的重叠检测，有命中时该车的车轮回退到场景查询
+ */
+UCLASS()
+class SINGULARISVEHICLE_API USingularisVehicleGroundSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// 开始 Subsystem 接口
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// 结束 Subsystem 接口
+
+	// 开始 TickableGameObject 接口
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// 结束 TickableGameObject 接口
+
+	/** 登记载具，由载具 BeginPlay 调用；只登记开启了 bUseHeightfieldContact 的载具 */
+	void RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 注销载具，由载具 EndPlay 调用 */
+	void UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 移除与区域相交的高度场块，之后按需重建；在地形上放置或移除静态物体后调用 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Ground")
+	void InvalidateRegion(const FBox& Region);
+
+	/** 移除全部高度场块 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Ground")
+	void InvalidateAll();
+
+	/** 立即建立所有登记载具需要的高度场块，不受每帧数量限制，用于测试 */
+	void BuildPendingTiles();
+
+	/** Returns 与物理线程模拟共享的接触提供者 */
+	FORCEINLINE const FSingularisGroundContactProviderPtr& GetContactProvider() const { return Provider; }
+
+	/** Returns 登记的载具数量 */
+	FORCEINLINE int32 GetNumVehicles() const { return Vehicles.Num(); }
+
+private:
+	/** 建立一块高度场，Returns 建立结果 */
+	TSharedRef<const FSingularisGroundTile, ESPMode::ThreadSafe> BuildTile(const FIntPoint& Key) const;
+
+	/** 建立一块高度场并交给接触提供者 */
+	void AddTile(const FIntPoint& Key);
+
+	/** 找出登记载具需要的高度场块，更新使用时间，返回尚未建立的块 */
+	void GatherNeededTiles(TArray<FIntPoint>& OutMissing);
+
+	/** 移除长时间未使用的块，以及到期重试的空块 */
+	void EvictTiles();
+
+	/** 检查每辆登记的载具附近是否有动态物体，写入载具与物理线程模拟共享的标记 */
+	void UpdateObstructions();
+
+	void OnLevelChanged(ULevel* Level, UWorld* World);
+
+	/** 已缓存块的簿记，只在游戏线程上访问 */
+	struct FTileRecord
+	{
+		/** 最近一次有载具需要的时间 */
+		double LastUsedTime = 0.0;
+
+		/** 建立的时间 */
+		double BuildTime = 0.0;
+
+		/** 块内没有任何高度场，按间隔重建以等待流送加载的地形 */
+		bool bEmpty = false;
+	};
+
+	FSingularisGroundContactProviderPtr Provider;
+	TMap<FIntPoint, FTileRecord> TileRecords;
+
+	TArray<TWeakObjectPtr<ABaseWheeledVehiclePawn>> Vehicles;
+
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+};
@@ -0,0 +1,193 @@
+/* =====================================================================
+ * SingularisVehicleHibernationSubsystem.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/SparseArray.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "SingularisVehicleHibernationSubsystem.generated.h"
+
+class ABaseWheeledVehiclePawn;
+class UInstancedStaticMeshComponent;
+class UPrimitiveComponent;
+struct FHitResult;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogSingularisVehicleHibernation, Log, All);
+
+/**
+ * 同一载具类的休眠实例，共用一个实例化静态网格组件
+ */
+USTRUCT()
+struct FSingularisHibernationModel
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass;
+
+	UPROPERTY()
+	TObjectPtr<UInstancedStaticMeshComponent> Instances;
+
+	/** 实例序号到休眠记录句柄的映射，与组件的实例一一对应 */
+	TArray<int32> InstanceRecords;
+};
+
+/**
+ *  载具休眠子系统
+ *  静止超过一段时间、且没有驾驶者要求其行驶的载具被替换为共享实例化静态网格中的一个实例，载具本身归还对象池或销毁，
+ *  只保留位置、朝向与手刹状态；玩家靠近、实例被撞击或脚本请求时，再从对象池取出完整的载具放回原处
+ *
+ *  同一载具类的所有休眠实例只占一次绘制调用，休眠期间没有任何逐车的 Tick 与物理模拟；
+ *  也可以用 AddParkedVehicles 直接放置大量从未生成过载具的停放车辆
+ *
+ *  载具类需设置 HibernationMesh，其原点须与载具根组件一致
+ */
+UCLASS()
+class SINGULARISVEHICLE_API USingularisVehicleHibernationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// 开始 Subsystem 接口
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// 结束 Subsystem 接口
+
+	// 开始 TickableGameObject 接口
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// 结束 TickableGameObject 接口
+
+	/** 注册载具并开始计算静止时间，由载具 BeginPlay 调用 */
+	void RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 注销载具，由载具 EndPlay 调用 */
+	void UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/**
+	 * 立即让载具休眠，不检查静止时间
+	 * Returns 休眠记录句柄，载具类没有 HibernationMesh 时返回 INDEX_NONE 且载具不受影响
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Hibernation")
+	int32 HibernateVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/**
+	 * 直接放置一批休眠的停放车辆，不生成载具
+	 * @param OutHandles 与 Transforms 一一对应的句柄
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Hibernation")
+	void AddParkedVehicles(TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass, const TArray<FTransform>& Transforms, TArray<int32>& OutHandles);
+
+	/**
+	 * 唤醒一辆休眠的载具，从对象池取出完整的载具放回原处
+	 * 唤醒后句柄失效；Returns 唤醒的载具，句柄无效时返回 nullptr
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Hibernation")
+	ABaseWheeledVehiclePawn* WakeVehicle(int32 Handle);
+
+	/** 唤醒一定范围内的所有休眠载具，Returns 唤醒的数量 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Hibernation")
+	int32 WakeVehiclesInRadius(const FVector& Location, float Radius);
+
+	/** 丢弃所有休眠记录与实例，不生成载具 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Hibernation")
+	void ClearHibernatedVehicles();
+
+	/** Returns 句柄对应的休眠位置，句柄无效时返回 false */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Hibernation")
+	bool GetHibernatedTransform(int32 Handle, FTransform& OutTransform) const;
+
+	/** Returns 休眠中的载具数量 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Hibernation")
+	int32 GetNumHibernated() const { return Records.Num(); }
+
+	/** Returns 正在计算静止时间的载具数量 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Hibernation")
+	int32 GetNumAwake() const { return AwakeVehicles.Num(); }
+
+	/** Returns 使用中的实例化网格数量，即休眠载具的绘制调用数 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Hibernation")
+	int32 GetNumModels() const { return Models.Num(); }
+
+private:
+	/** 休眠载具的全部状态 */
+	struct FHibernatedVehicle
+	{
+		FVector Location = FVector::ZeroVector;
+		FQuat4f Rotation = FQuat4f::Identity;
+
+		/** Models 中的序号 */
+		uint16 ModelIndex = 0;
+
+		/** 休眠时是否拉着手刹，唤醒后保持 */
+		bool bHandbrake = false;
+
+		/** 实例化网格中的实例序号 */
+		int32 InstanceIndex = INDEX_NONE;
+	};
+
+	struct FAwakeVehicle
+	{
+		TWeakObjectPtr<ABaseWheeledVehiclePawn> Vehicle;
+
+		/** 连续静止的时间（秒） */
+		float RestTime = 0.0f;
+	};
+
+	/** Returns 载具类对应的模型序号，按需创建实例化网格；载具类没有 HibernationMesh 时返回 INDEX_NONE */
+	int32 FindOrAddModel(TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass);
+
+	/** 添加一条休眠记录及其实例，Returns 句柄 */
+	int32 AddRecord(int32 ModelIndex, const FTransform& Transform, bool bHandbrake);
+
+	/** 删除休眠记录及其实例，最后一个实例移入空位 */
+	void RemoveRecord(int32 Handle);
+
+	/** 收集所有玩家控制器的视点位置 */
+	void GatherViewerLocations();
+
+	/** Returns 到最近观察者的距离平方 */
+	double GetMinViewerDistanceSquared(const FVector& Location) const;
+
+	/** 累计静止时间，让满足条件的载具休眠 */
+	void UpdateRestingVehicles(float ElapsedTime);
+
+	/** 唤醒观察者附近的休眠载具 */
+	void WakeNearViewers();
+
+	/** 实例被撞击时排队唤醒 */
+	UFUNCTION()
+	void OnInstancesHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
+
+	UPROPERTY(Transient)
+	TArray<FSingularisHibernationModel> Models;
+
+	/** 承载实例化网格组件的 Actor */
+	UPROPERTY(Transient)
+	TObjectPtr<AActor> InstanceHost;
+
+	/** 休眠记录，句柄即稀疏数组的序号 */
+	TSparseArray<FHibernatedVehicle> Records;
+
+	TMap<TObjectKey<ABaseWheeledVehiclePawn>, FAwakeVehicle> AwakeVehicles;
+
+	/** 被撞击、等待唤醒的句柄 */
+	TArray<int32> PendingWakes;
+
+	/** 本次检查的观察者位置 */
+	TArray<FVector> ViewerLocations;
+
+	/** 满足休眠条件的载具，复用以避免每次分配 */
+	TArray<ABaseWheeledVehiclePawn*> HibernateCandidates;
+
+	/** 距下一次检查的剩余时间（秒） */
+	float TimeUntilCheck = 0.0f;
+};
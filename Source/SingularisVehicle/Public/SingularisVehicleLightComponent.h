@@ -0,0 +1,87 @@
+/* =====================================================================
+ * SingularisVehicleLightComponent.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SingularisVehicleLightComponent.generated.h"
+
+class ABaseWheeledVehiclePawn;
+
+/**
+ *  载具灯光组件
+ *  每帧从运动组件推导刹车、倒车与手刹状态，只在状态变化时写入车身网格的 Custom Primitive Data，
+ *  所有载具可以共用同一个材质，不需要为每辆车创建动态材质实例
+ *
+ *  挂上此组件后载具不再在输入回调中触发 BrakeLights 事件；需要蓝图响应时打开 bFireBlueprintEvent
+ */
+UCLASS(ClassGroup = (Vehicle), meta = (BlueprintSpawnableComponent))
+class SINGULARISVEHICLE_API USingularisVehicleLightComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	USingularisVehicleLightComponent();
+
+	/** 刹车灯亮度写入的 Custom Primitive Data 序号，小于零时不写 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Lights)
+	int32 BrakeLightDataIndex = 0;
+
+	/** 倒车灯亮度写入的 Custom Primitive Data 序号，小于零时不写 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Lights)
+	int32 ReverseLightDataIndex = 1;
+
+	/** 制动输入超过该值时点亮刹车灯 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Lights, meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float BrakeInputThreshold = 0.05f;
+
+	/** 刹车灯状态变化时是否同时触发载具的 BrakeLights 蓝图事件 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Lights)
+	bool bFireBlueprintEvent = false;
+
+	// 开始 ActorComponent 接口
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	// 结束 ActorComponent 接口
+
+	/**
+	 * 从运动组件推导灯光状态并写入变化
+	 * 运动组件停止 Tick 时（对象池、冻结层级、回放）保持当前状态
+	 * @return 是否有状态变化
+	 */
+	bool UpdateFromMovement();
+
+	/** 直接设置灯光状态，只写入变化；回放等不经过运动组件的驱动方使用 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Lights")
+	void SetLightState(bool bBrake, bool bReverse, bool bHandbrake);
+
+	/** Returns 刹车灯是否点亮（含手刹） */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Lights")
+	bool AreBrakeLightsOn() const { return bBrakeLightsOn; }
+
+	/** Returns 倒车灯是否点亮 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Lights")
+	bool AreReverseLightsOn() const { return bReverseLightsOn; }
+
+	/** Returns 手刹是否拉起 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Lights")
+	bool IsHandbrakeOn() const { return bHandbrakeOn; }
+
+private:
+	/** 写入一个 Custom Primitive Data 值 */
+	void WriteLightValue(int32 DataIndex, bool bOn) const;
+
+	TWeakObjectPtr<ABaseWheeledVehiclePawn> Vehicle;
+
+	bool bBrakeLightsOn = false;
+	bool bReverseLightsOn = false;
+	bool bHandbrakeOn = false;
+};
@@ -0,0 +1,251 @@
+/* =====================================================================
+ * SingularisVehicleMovementComponent.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChaosWheeledVehicleMovementComponent.h"
+#include "SingularisVehicleNetTypes.h"
+#include "SingularisVehicleSimulation.h"
+#include "SingularisVehicleTypes.h"
+#include "SingularisVehicleMovementComponent.generated.h"
+
+class USingularisVehicleSpec;
+
+/** 车轮所在路面或打滑、侧滑状态变化时广播 */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FOnWheelSurfaceChanged,
+                                              int32, WheelIndex,
+                                              TEnumAsByte<EPhysicalSurface>, SurfaceType,
+                                              bool, bSlipping,
+                                              bool, bSkidding);
+
+/**
+ *  插件的轮式载具运动组件
+ *  在 Chaos 轮式载具运动组件的基础上使用 FSingularisVehicleSimulation 作为物理线程模拟
+ *
+ *  开启 bUseAsyncPhysicsInput 后，输入经由 Queue*Input 带时间戳写入无锁队列，由物理步按固定步长消费并平滑，
+ *  空中角度阻尼也改为在物理步中施加；配合项目设置中的 "Tick Physics Async" 使用时操控不随帧率变化
+ *
+ *  开启 bUseCompactReplication 后联网时使用紧凑复制：拥有者客户端以不可靠 RPC 发送量化后的控制帧，只在变化或保活时发送；
+ *  服务器复制量化后的车身运动与传动状态，内容不变时不发送，客户端向服务器状态平滑收敛。
+ *  此时关闭 Actor 的移动复制、Chaos 每帧发送的可靠输入 RPC 与其复制的输入状态
+ */
+UCLASS(ClassGroup = (Physics), meta = (BlueprintSpawnableComponent))
+class SINGULARISVEHICLE_API USingularisVehicleMovementComponent : public UChaosWheeledVehicleMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	/** 是否将控制输入通过无锁队列直接送往物理线程；修改后需要重建物理状态 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = VehicleInput)
+	bool bUseAsyncPhysicsInput = false;
+
+	/** 车辆离地时的角度阻尼，让车辆在空中不会无限旋转，而是会逐渐减速 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = VehicleSetup, meta = (ClampMin = "0.0"))
+	float AirborneAngularDamping = 3.0f;
+
+	/**
+	 * 联网时是否使用紧凑复制，在 BeginPlay 时确定；也可通过 SingularisVehicle.Net.CompactReplication 全局关闭
+	 * 默认关闭：开启后载具不再使用 Actor 的移动复制与 Chaos 的输入复制，依赖这两者的现有项目需要逐个载具类开启
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Replication)
+	bool bUseCompactReplication = false;
+
+	/** 输入变化时拥有者客户端发送控制帧的最高频率（次/秒） */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Replication, meta = (ClampMin = "1.0"))
+	float ControlSendRate = 30.0f;
+
+	/** 输入不变时补发控制帧的间隔（秒），弥补不可靠 RPC 的丢包 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Replication, meta = (ClampMin = "0.02"))
+	float ControlKeepAliveInterval = 0.25f;
+
+	/** 客户端向服务器状态收敛的速度（1/秒） */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Replication, meta = (ClampMin = "0.0"))
+	float NetSmoothingSpeed = 10.0f;
+
+	/** 拥有者客户端与服务器的偏差小于该距离（厘米）时不纠正，保留本地预测的手感 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Replication, meta = (ClampMin = "0.0"))
+	float OwnerCorrectionThreshold = 50.0f;
+
+	/** 偏差超过该距离（厘米）时直接传送 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Replication, meta = (ClampMin = "0.0"))
+	float NetSnapDistance = 1000.0f;
+
+	/**
+	 * 在地形上由缓存的高度场直接求车轮接触，代替悬挂射线的场景查询
+	 * 只对使用 Raycast 悬挂检测的车轮生效，靠近其他静态几何体、其他载具或模拟物理的物体时自动回退；需要在创建物理载具前设置
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = VehicleSetup)
+	bool bUseHeightfieldContact = false;
+
+	/**
+	 * 车轮换到另一种路面或开始、停止打滑与侧滑时广播，用于切换轮胎声、烟尘与胎痕等表现
+	 * 只在状态变化时广播，不逐帧广播；需要载具规格配置了路面响应，且只在有绑定时检查
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "Vehicle|Surface")
+	FOnWheelSurfaceChanged OnWheelSurfaceChanged;
+
+	// 开始 UObject 接口
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual int32 GetFunctionCallspace(UFunction* Function, FFrame* Stack) override;
+	// 结束 UObject 接口
+
+	// 开始 ActorComponent 接口
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+	// 结束 ActorComponent 接口
+
+	/** 设置油门输入；异步输入模式下同时送往物理线程 */
+	void QueueThrottleInput(float Throttle);
+
+	/** 设置制动输入；异步输入模式下同时送往物理线程 */
+	void QueueBrakeInput(float Brake);
+
+	/** 设置转向输入；异步输入模式下同时送往物理线程 */
+	void QueueSteeringInput(float Steering);
+
+	/** 设置手刹输入；异步输入模式下同时送往物理线程 */
+	void QueueHandbrakeInput(bool bHandbrake);
+
+	/**
+	 * 一次设置控制输入，只写入 Channels 中的通道；异步输入模式下只向物理线程送出一个采样
+	 * Channels 为空时不做任何事
+	 */
+	void QueueControlInputs(float Throttle, float Brake, float Steering, bool bHandbrake, EVehicleControlChannels Channels = EVehicleControlChannels::All);
+
+	/** 更新随控制帧发送的摄像头状态，LookYaw 为后置弹簧臂的偏航角（度） */
+	void SetNetCameraState(bool bFrontCameraActive, float LookYaw);
+
+	/**
+	 * 恢复挡位与车轮转速，用于把持久化的载具放回时保持行驶状态；应在设置车身速度之后调用
+	 * 引擎转速不单独恢复，挂挡时下一个物理步由车轮转速经传动系统推出
+	 */
+	void RestoreDriveState(int32 Gear, float ForwardSpeed);
+
+	/** Returns 当前物理载具是否以异步输入模式创建 */
+	FORCEINLINE bool IsUsingAsyncPhysicsInput() const { return InputQueue.IsValid(); }
+
+	/** Returns 是否正在使用紧凑复制 */
+	FORCEINLINE bool IsUsingCompactReplication() const { return bCompactReplicationActive; }
+
+	/** Returns 服务器上最近收到的控制帧，包含拥有者的摄像头状态 */
+	FORCEINLINE const FSingularisVehicleNetControl& GetReceivedControl() const { return ReceivedControl; }
+
+	/** Returns 最近一个物理步发布的状态快照，可在任意线程调用 */
+	FORCEINLINE FSingularisVehicleSnapshot ReadSnapshot() const { return SnapshotBuffer->Read(); }
+
+	/** Returns 快照存储，可交给其他线程长期持有，物理载具重建后仍然有效 */
+	FORCEINLINE FSingularisVehicleSnapshotBufferRef GetSnapshotBuffer() const { return SnapshotBuffer; }
+
+	/** Returns 附近是否有动态物体的标记，由地面接触子系统写入 */
+	FORCEINLINE const FSingularisGroundObstructionRef& GetGroundObstruction() const { return GroundObstruction; }
+
+	/** 设置路面响应表，由 USingularisVehicleSpec::ApplyTo 调用；已创建的物理载具在重建物理状态后才使用新表 */
+	FORCEINLINE void SetSurfaceResponseTable(const FSingularisSurfaceResponseTablePtr& InSurfaceResponseTable) { SurfaceResponseTable = InSurfaceResponseTable; }
+
+	/** Returns 路面响应表，未配置时为空 */
+	FORCEINLINE const FSingularisSurfaceResponseTablePtr& GetSurfaceResponseTable() const { return SurfaceResponseTable; }
+
+	/** 设置写入本组件的规格，由 USingularisVehicleSpec::ApplyTo 调用；创建物理载具时使用其烘焙的转向查找表 */
+	FORCEINLINE void SetVehicleSpec(const USingularisVehicleSpec* InVehicleSpec) { VehicleSpec = InVehicleSpec; }
+
+	/** Returns 模拟代理上复制得到的引擎转速 */
+	FORCEINLINE float GetReplicatedEngineRPM() const { return NetDrive.GetEngineRPM(); }
+
+protected:
+	// 开始 Chaos 载具运动组件接口
+	virtual TUniquePtr<Chaos::FSimpleWheeledVehicle> CreatePhysicsVehicle() override;
+	// 结束 Chaos 载具运动组件接口
+
+private:
+	/** 将最新的输入带上时间戳写入队列 */
+	void EnqueueInputSample();
+
+	/** 拥有者客户端发送控制帧 */
+	UFUNCTION(Server, Unreliable)
+	void ServerSendControlFrame(const FSingularisVehicleNetControl& Frame);
+
+	UFUNCTION()
+	void OnRep_NetMotion();
+
+	UFUNCTION()
+	void OnRep_NetDrive();
+
+	/** 写入远端控制的载具的输入，Chaos 在游戏线程上读取 ReplicatedState，异步输入模式下同时送往物理线程 */
+	void ApplyRemoteInputs(float Steering, float Throttle, float Brake, bool bHandbrake, int32 Gear);
+
+	/** 拥有者客户端在输入变化或需要保活时发送控制帧 */
+	void SendControlFrame(float DeltaTime);
+
+	/** 服务器采样并量化需要复制的状态 */
+	void UpdateNetState();
+
+	/** 客户端向复制得到的车身状态平滑收敛 */
+	void SmoothTowardsNetMotion(float DeltaTime);
+
+	/** 对比最新快照与上次广播的路面状态，只为变化的车轮广播 OnWheelSurfaceChanged */
+	void UpdateSurfaceEvents();
+
+	/** 服务器复制的车身运动状态 */
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_NetMotion)
+	FSingularisVehicleNetMotion NetMotion;
+
+	/** 服务器复制给模拟代理的传动与输入状态 */
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_NetDrive)
+	FSingularisVehicleNetDrive NetDrive;
+
+	/** 客户端待发送与上一次发送的控制帧 */
+	FSingularisVehicleNetControl PendingControl;
+	FSingularisVehicleNetControl LastSentControl;
+
+	/** 服务器上最近收到的控制帧 */
+	FSingularisVehicleNetControl ReceivedControl;
+
+	/** 距上一次发送控制帧的时间 */
+	float TimeSinceControlSent = 0.0f;
+
+	/** 收到车身状态的时间，用于外推 */
+	double NetMotionReceiveTime = 0.0;
+	bool bHasNetMotion = false;
+
+	bool bHasReceivedControl = false;
+	bool bCompactReplicationActive = false;
+
+	/** 与物理线程模拟共享的输入队列 */
+	TSharedPtr<FSingularisVehicleInputQueue, ESPMode::ThreadSafe> InputQueue;
+
+	/** 与物理线程模拟共享的行驶状态恢复队列，随物理载具重建 */
+	TSharedPtr<FSingularisVehicleDriveRestoreQueue, ESPMode::ThreadSafe> DriveRestoreQueue;
+
+	/** 游戏线程上最新的原始输入 */
+	FSingularisVehicleInputSample LatestInputs;
+
+	/** 与物理线程模拟共享的状态快照，组件存在期间不变 */
+	TSharedRef<FSingularisVehicleSnapshotBuffer, ESPMode::ThreadSafe> SnapshotBuffer = MakeShared<FSingularisVehicleSnapshotBuffer, ESPMode::ThreadSafe>();
+
+	/** 与物理线程模拟共享的动态物体标记，组件存在期间不变；地面接触子系统检查之前保持回退 */
+	FSingularisGroundObstructionRef GroundObstruction = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(true);
+
+	/** 与物理线程模拟共享的路面响应表 */
+	FSingularisSurfaceResponseTablePtr SurfaceResponseTable;
+
+	/** 最近写入本组件的规格，提供转向曲线的查找表 */
+	UPROPERTY(Transient)
+	TObjectPtr<const USingularisVehicleSpec> VehicleSpec;
+
+	/** 上次广播时各车轮的路面与打滑、侧滑状态；路面为 0xFF 表示尚未广播，创建物理载具时重置 */
+	uint8 BroadcastWheelSurfaces[FSingularisVehicleSnapshot::MaxWheels] = {};
+	uint8 BroadcastSlipMask = 0;
+	uint8 BroadcastSkidMask = 0;
+
+	/** 上次检查的快照序号 */
+	uint32 SurfaceEventStepIndex = 0;
+};
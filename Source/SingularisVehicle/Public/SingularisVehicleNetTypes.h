@@ -0,0 +1,148 @@
+/* =====================================================================
+ * SingularisVehicleNetTypes.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+#include "SingularisVehicleNetTypes.generated.h"
+
+/**
+ * 客户端发给服务器的控制帧
+ * 转向、油门、制动各量化为 8 位，手刹与摄像头各 1 位，挡位 4 位，环顾角只在非零时发送
+ */
+USTRUCT()
+struct SINGULARISVEHICLE_API FSingularisVehicleNetControl
+{
+	GENERATED_BODY()
+
+	/** 回绕的序号，服务器丢弃乱序到达的旧帧 */
+	uint8 Sequence = 0;
+
+	int8 Steering = 0;
+	uint8 Throttle = 0;
+	uint8 Brake = 0;
+	int8 TargetGear = 0;
+	bool bHandbrake = false;
+
+	/** 摄像头状态 */
+	bool bFrontCameraActive = false;
+	int8 LookYaw = 0;
+
+	/** 由浮点输入量化 */
+	void SetInputs(float InSteering, float InThrottle, float InBrake, bool bInHandbrake, int32 InTargetGear);
+
+	/** 由摄像头状态量化，LookYaw 为后置弹簧臂的偏航角（度） */
+	void SetCameraState(bool bInFrontCameraActive, float InLookYaw);
+
+	FORCEINLINE float GetSteering() const { return Steering / 127.0f; }
+	FORCEINLINE float GetThrottle() const { return Throttle / 255.0f; }
+	FORCEINLINE float GetBrake() const { return Brake / 255.0f; }
+	FORCEINLINE float GetLookYaw() const { return LookYaw * (180.0f / 127.0f); }
+
+	/** 比较时忽略序号 */
+	bool operator==(const FSingularisVehicleNetControl& Other) const;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template <>
+struct TStructOpsTypeTraits<FSingularisVehicleNetControl> : TStructOpsTypeTraitsBase2<FSingularisVehicleNetControl>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+/**
+ * 服务器复制的车身运动状态
+ * 在采样时即量化，内容不变时属性比较相等而不会重新发送；静止时只发送位置与朝向
+ */
+USTRUCT()
+struct SINGULARISVEHICLE_API FSingularisVehicleNetMotion
+{
+	GENERATED_BODY()
+
+	/** 位置，精确到厘米 */
+	FVector Location = FVector::ZeroVector;
+
+	/** 朝向，每个轴 16 位 */
+	FRotator Rotation = FRotator::ZeroRotator;
+
+	/** 线速度（厘米/秒），取整 */
+	FVector LinearVelocity = FVector::ZeroVector;
+
+	/** 角速度（度/秒），取整 */
+	FVector AngularVelocity = FVector::ZeroVector;
+
+	/** 由刚体状态量化 */
+	void SetFromBody(const FTransform& Transform, const FVector& InLinearVelocity, const FVector& InAngularVelocity);
+
+	bool operator==(const FSingularisVehicleNetMotion& Other) const;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template <>
+struct TStructOpsTypeTraits<FSingularisVehicleNetMotion> : TStructOpsTypeTraitsBase2<FSingularisVehicleNetMotion>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true,
+	};
+};
+
+/**
+ * 服务器复制给模拟代理的传动与输入状态，用于车轮转向、引擎音效等表现
+ */
+USTRUCT()
+struct SINGULARISVEHICLE_API FSingularisVehicleNetDrive
+{
+	GENERATED_BODY()
+
+	/** 转速，以 10 RPM 为单位 */
+	uint16 EngineRPM = 0;
+
+	int8 Gear = 0;
+	int8 Steering = 0;
+	uint8 Throttle = 0;
+	uint8 Brake = 0;
+	bool bHandbrake = false;
+
+	/** 由浮点状态量化 */
+	void Set(float InEngineRPM, int32 InGear, float InSteering, float InThrottle, float InBrake, bool bInHandbrake);
+
+	FORCEINLINE float GetEngineRPM() const { return EngineRPM * 10.0f; }
+	FORCEINLINE float GetSteering() const { return Steering / 127.0f; }
+	FORCEINLINE float GetThrottle() const { return Throttle / 255.0f; }
+	FORCEINLINE float GetBrake() const { return Brake / 255.0f; }
+
+	bool operator==(const FSingularisVehicleNetDrive& Other) const;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template <>
+struct TStructOpsTypeTraits<FSingularisVehicleNetDrive> : TStructOpsTypeTraitsBase2<FSingularisVehicleNetDrive>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true,
+	};
+};
+
+namespace SingularisVehicleNet
+{
+	/** 累计写出的位数，供 SingularisVehicle.Net.Report 统计带宽 */
+	SINGULARISVEHICLE_API extern std::atomic<uint64> ControlBitsSent;
+	SINGULARISVEHICLE_API extern std::atomic<uint64> StateBitsSent;
+}
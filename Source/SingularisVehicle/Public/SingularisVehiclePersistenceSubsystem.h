@@ -0,0 +1,188 @@
+/* =====================================================================
+ * SingularisVehiclePersistenceSubsystem.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include <type_traits>
+#include "SingularisVehiclePersistenceSubsystem.generated.h"
+
+class ABaseWheeledVehiclePawn;
+class ULevel;
+class USingularisVehiclePoolSubsystem;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogSingularisVehiclePersistence, Log, All);
+
+/**
+ * 一辆持久化载具的固定布局记录，共 72 字节
+ * 所在单元卸载时由 ABaseWheeledVehiclePawn::SavePersistentState 写入，单元重新加载后据此放回载具
+ */
+struct FSingularisPersistedVehicle
+{
+	FVector Location = FVector::ZeroVector;
+	FQuat4f Rotation = FQuat4f::Identity;
+
+	/** 车身线速度（厘米/秒） */
+	FVector3f LinearVelocity = FVector3f::ZeroVector;
+
+	/** 车身角速度（度/秒） */
+	FVector3f AngularVelocity = FVector3f::ZeroVector;
+
+	/** 由子类维护的损伤值，插件本身不读写 */
+	float Damage = 0.0f;
+
+	/** 载具类在子系统类表中的序号 */
+	uint16 ClassIndex = 0;
+
+	/** 挡位，负数为倒挡，0 为空挡 */
+	int8 Gear = 0;
+
+	/** 两个标志共用一个字节，否则按 FVector 的 8 字节对齐会补齐到 80 字节 */
+	uint8 bHandbrake : 1 = false;
+	uint8 bFrontCameraActive : 1 = false;
+};
+
+static_assert(std::is_trivially_copyable_v<FSingularisPersistedVehicle>, "持久化记录须能按字节复制");
+static_assert(sizeof(FSingularisPersistedVehicle) == 72, "持久化记录的布局发生了变化");
+
+/**
+ *  载具持久化子系统
+ *  World Partition 单元（或普通流送关卡）即将卸载时，把位于单元范围内、属于持久关卡的登记载具写入该单元的紧凑记录，
+ *  载具本身归还对象池或销毁；单元重新加载后，每帧按数量与时间预算从对象池取出一批载具放回原处，并恢复速度、挡位、
+ *  手刹与摄像头状态，避免一次性生成全部载具造成卡顿
+ *
+ *  同一单元的记录连续存放；单元在恢复完成前再次卸载时，尚未放回的记录保留，已放回的载具重新写入
+ *
+ *  保存在单元自身包中的载具随单元由引擎卸载与重新创建：卸载前按 Actor 名称记下其状态，引擎重新创建同名载具时
+ *  在其 BeginPlay 登记时放回记下的位置并恢复状态，单元加载完成后仍未认领的状态被丢弃；玩家控制的载具不会被写入记录
+ */
+UCLASS()
+class SINGULARISVEHICLE_API USingularisVehiclePersistenceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// 开始 Subsystem 接口
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// 结束 Subsystem 接口
+
+	// 开始 TickableGameObject 接口
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// 结束 TickableGameObject 接口
+
+	/** 登记载具，由载具 BeginPlay 调用；单元自身的载具在此恢复卸载前记下的状态 */
+	void RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 注销载具，由载具 EndPlay 调用 */
+	void UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/**
+	 * 把水平位置位于区域内的登记载具写入单元的记录，并归还对象池或销毁
+	 * 单元卸载前自动调用，也可由自定义的流送逻辑调用；Returns 写入的数量
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Persistence")
+	int32 StoreVehiclesInRegion(FName CellName, const FBox& Region);
+
+	/** 开始按批放回单元记录中的载具，单元加载后自动调用；单元没有记录时不做任何事 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Persistence")
+	void RestoreCell(FName CellName);
+
+	/** 立即放回所有正在恢复的载具，不受每帧数量与时间预算限制，用于测试 */
+	void FlushRestores();
+
+	/** 丢弃所有记录，不放回载具 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Persistence")
+	void ClearRecords();
+
+	/** Returns 尚未放回的记录总数 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Persistence")
+	int32 GetNumStored() const;
+
+	/** Returns 单元中尚未放回的记录数量 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Persistence")
+	int32 GetNumStoredInCell(FName CellName) const;
+
+	/** Returns 登记的载具数量 */
+	FORCEINLINE int32 GetNumVehicles() const { return Vehicles.Num(); }
+
+	/** Returns 正在恢复的单元数量 */
+	FORCEINLINE int32 GetNumRestoringCells() const { return RestoringCells.Num(); }
+
+	/** Returns 最近一帧放回的载具数量 */
+	FORCEINLINE int32 GetLastNumRestored() const { return LastNumRestored; }
+
+	/** Returns 最近一帧放回载具的耗时（秒） */
+	FORCEINLINE double GetLastRestoreSeconds() const { return LastRestoreSeconds; }
+
+	/** Returns 最近一次写入单元记录的耗时（秒） */
+	FORCEINLINE double GetLastStoreSeconds() const { return LastStoreSeconds; }
+
+private:
+	/** 一个单元中的持久化载具 */
+	struct FPersistedCell
+	{
+		/** 连续存放的记录 */
+		TArray<FSingularisPersistedVehicle> Records;
+
+		/** 单元已重新加载，正在按批放回 */
+		bool bRestoring = false;
+
+		/** 已放回的记录数量，之前的记录不再有效 */
+		int32 NumRestored = 0;
+
+		/** 保存在单元自身包中的载具的状态，按 Actor 名称索引，由引擎重新创建的同名载具认领 */
+		TMap<FName, FSingularisPersistedVehicle> LevelVehicles;
+	};
+
+	/** 记下属于单元自身关卡的载具的状态，载具本身随关卡卸载；Returns 记下的数量 */
+	int32 StoreLevelVehicles(FName CellName, const ULevel* Level);
+
+	/** 为由引擎重新创建的单元载具恢复卸载前的状态 */
+	void RestoreLevelVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 从对象池取出一辆载具放回记录的位置并恢复状态 */
+	ABaseWheeledVehiclePawn* RestoreRecord(USingularisVehiclePoolSubsystem* Pool, const FSingularisPersistedVehicle& Record);
+
+	/** 放回正在恢复的单元中的记录，最多 MaxRestores 辆，超过 Deadline 后停止；Returns 放回的数量 */
+	int32 RestorePending(int32 MaxRestores, double Deadline);
+
+	/** Returns 载具类在类表中的序号，按需添加；类表已满时返回 INDEX_NONE */
+	int32 FindOrAddClassIndex(UClass* VehicleClass);
+
+	/** 单元即将卸载 */
+	void OnPreLevelRemoved(ULevel* Level, UWorld* World);
+
+	/** 单元已加载 */
+	void OnLevelAdded(ULevel* Level, UWorld* World);
+
+	TMap<FName, FPersistedCell> Cells;
+
+	/** 按加载顺序排列的正在恢复的单元 */
+	TArray<FName> RestoringCells;
+
+	/** 记录中 ClassIndex 对应的载具类 */
+	UPROPERTY(Transient)
+	TArray<TSubclassOf<ABaseWheeledVehiclePawn>> VehicleClasses;
+
+	TArray<TWeakObjectPtr<ABaseWheeledVehiclePawn>> Vehicles;
+
+	/** 写入记录的候选载具，复用以避免每次分配 */
+	TArray<ABaseWheeledVehiclePawn*> StoreCandidates;
+
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle PreLevelRemovedHandle;
+
+	int32 LastNumRestored = 0;
+	double LastRestoreSeconds = 0.0;
+	double LastStoreSeconds = 0.0;
+};
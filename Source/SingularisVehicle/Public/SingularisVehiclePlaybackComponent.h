@@ -0,0 +1,89 @@
+/* =====================================================================
+ * SingularisVehiclePlaybackComponent.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SingularisVehicleRecording.h"
+#include "SingularisVehiclePlaybackComponent.generated.h"
+
+class ABaseWheeledVehiclePawn;
+
+/**
+ *  载具回放组件
+ *  从映射的录制文件中按时间插值，以运动学方式驱动所在的载具（幽灵车/回放）
+ *  回放期间关闭载具的物理模拟、运动组件与碰撞；录制的车轮转角、转向角与悬挂偏移经由
+ *  USingularisVehicleWheelVisualSubsystem 写入车轮骨骼，使用动画蓝图的载具在回放期间由该子系统临时接管
+ *
+ *  只能挂在 ABaseWheeledVehiclePawn 上
+ */
+UCLASS(ClassGroup = (Vehicle), meta = (BlueprintSpawnableComponent))
+class SINGULARISVEHICLE_API USingularisVehiclePlaybackComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	USingularisVehiclePlaybackComponent();
+
+	/** 播放到结尾时是否从头开始 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Playback)
+	bool bLoop = false;
+
+	/** 播放速率 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Playback, meta = (ClampMin = "0.0"))
+	float PlaybackRate = 1.0f;
+
+	// 开始 ActorComponent 接口
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	// 结束 ActorComponent 接口
+
+	/** 打开录制文件，Returns 是否成功 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Recording")
+	bool OpenRecording(const FString& FilePath);
+
+	/** 从头开始回放，载具切换为运动学驱动 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Recording")
+	void StartPlayback();
+
+	/** 停止回放，恢复载具的物理模拟 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Recording")
+	void StopPlayback();
+
+	/** Returns 是否正在回放 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Recording")
+	bool IsPlaying() const { return bPlaying; }
+
+	/** Returns 当前回放时间（秒） */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Recording")
+	float GetPlaybackTime() const { return PlaybackTime; }
+
+	/** Returns 录制总时长（秒），未打开文件时为零 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Recording")
+	float GetRecordingDuration() const;
+
+	/** Returns 当前插值出的帧 */
+	FORCEINLINE const FSingularisVehicleRecordFrame& GetCurrentFrame() const { return CurrentFrame; }
+
+private:
+	/** 切换载具的物理模拟与运动组件 */
+	void SetVehicleSimulating(ABaseWheeledVehiclePawn* Pawn, bool bSimulate) const;
+
+	/** 将当前帧写入载具 */
+	void ApplyCurrentFrame() const;
+
+	TUniquePtr<FSingularisVehicleRecordingReader> Reader;
+
+	FSingularisVehicleRecordFrame CurrentFrame;
+
+	float PlaybackTime = 0.0f;
+
+	bool bPlaying = false;
+};
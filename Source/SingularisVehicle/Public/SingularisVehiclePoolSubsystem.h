@@ -0,0 +1,76 @@
+/* =====================================================================
+ * SingularisVehiclePoolSubsystem.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SingularisVehiclePoolSubsystem.generated.h"
+
+class ABaseWheeledVehiclePawn;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogSingularisVehiclePool, Log, All);
+
+/**
+ * 同一载具类的闲置实例
+ */
+USTRUCT()
+struct FSingularisVehiclePoolBucket
+{
+	GENERATED_BODY()
+
+	/** 闲置、可被取出的载具 */
+	UPROPERTY()
+	TArray<TObjectPtr<ABaseWheeledVehiclePawn>> Available;
+};
+
+/**
+ *  载具对象池子系统
+ *  预先生成载具实例，取出时原地传送并重置状态，归还时休眠并隐藏，
+ *  避免反复构造子对象、创建物理体与 Chaos 载具模拟带来的卡顿
+ */
+UCLASS()
+class SINGULARISVEHICLE_API USingularisVehiclePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// 开始 Subsystem 接口
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// 结束 Subsystem 接口
+
+	/** 预先生成指定数量的载具实例放入池中 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Pool")
+	void Prewarm(TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass, int32 Count);
+
+	/** 从池中取出一辆载具并放置到指定位置；池为空时直接生成新的实例 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Pool")
+	ABaseWheeledVehiclePawn* AcquireVehicle(TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass, const FTransform& SpawnTransform);
+
+	/** 将载具归还到池中 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Pool")
+	void ReleaseVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** Returns 池中指定类的闲置载具数量 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Pool")
+	int32 GetNumAvailable(TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass) const;
+
+	/** 闲置载具的停放位置 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle|Pool")
+	FVector ParkingLocation = FVector(0.0f, 0.0f, -50000.0f);
+
+private:
+	/** 生成一个新的载具实例 */
+	ABaseWheeledVehiclePawn* SpawnVehicle(TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass, const FTransform& SpawnTransform) const;
+
+	/** 按载具类分组的闲置实例 */
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, FSingularisVehiclePoolBucket> Buckets;
+};
@@ -0,0 +1,98 @@
+/* =====================================================================
+ * SingularisVehicleRecorderComponent.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SingularisVehicleRecording.h"
+#include "SingularisVehicleRecorderComponent.generated.h"
+
+class ABaseWheeledVehiclePawn;
+
+/**
+ *  载具录制组件
+ *  按固定采样率将输入、车身变换、车轮状态与刹车灯状态写入开始录制时预先分配的环形缓冲区，
+ *  录制期间不在游戏线程上分配内存；写满后覆盖最早的帧。保存时按时间顺序拷贝一次，在后台线程写出二进制文件
+ *
+ *  只能挂在 ABaseWheeledVehiclePawn 上
+ */
+UCLASS(ClassGroup = (Vehicle), meta = (BlueprintSpawnableComponent))
+class SINGULARISVEHICLE_API USingularisVehicleRecorderComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	USingularisVehicleRecorderComponent();
+
+	/** 采样率（帧/秒） */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Recording, meta = (ClampMin = "1.0"))
+	float SampleRate = 30.0f;
+
+	/** 环形缓冲区能容纳的最长时间（秒） */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Recording, meta = (ClampMin = "1.0"))
+	float MaxDuration = 600.0f;
+
+	/** 是否在 BeginPlay 时开始录制 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Recording)
+	bool bRecordOnBeginPlay = false;
+
+	// 开始 ActorComponent 接口
+	virtual void BeginPlay() override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	// 结束 ActorComponent 接口
+
+	/** 开始录制，清除之前的内容 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Recording")
+	void StartRecording();
+
+	/** 停止录制，已录制的内容保留到下次开始录制 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Recording")
+	void StopRecording();
+
+	/**
+	 * 在后台线程将录制内容写入文件
+	 * FilePath 为空时写入 Saved/VehicleRecordings/<Actor 名>.svrc
+	 * @return 是否有内容可写
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Recording")
+	bool SaveRecording(const FString& FilePath);
+
+	/** Returns 是否正在录制 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Recording")
+	bool IsRecording() const { return bRecording; }
+
+	/** Returns 缓冲区中的帧数 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Recording")
+	int32 GetNumRecordedFrames() const { return NumFrames; }
+
+private:
+	/** 采样当前状态 */
+	void CaptureFrame(FSingularisVehicleRecordFrame& OutFrame) const;
+
+	/** 录制的载具 */
+	TWeakObjectPtr<ABaseWheeledVehiclePawn> Vehicle;
+
+	/** 环形缓冲区，开始录制时一次性分配 */
+	TArray<FSingularisVehicleRecordFrame> Frames;
+
+	/** 下一帧写入的位置 */
+	int32 Head = 0;
+
+	/** 缓冲区中的有效帧数 */
+	int32 NumFrames = 0;
+
+	/** 自录制开始的时间 */
+	float RecordTime = 0.0f;
+
+	/** 距上次采样的时间 */
+	float TimeSinceSample = 0.0f;
+
+	bool bRecording = false;
+};
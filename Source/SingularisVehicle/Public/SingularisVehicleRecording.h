@@ -0,0 +1,141 @@
+/* =====================================================================
+ * SingularisVehicleRecording.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * 录制帧中单个车轮的状态
+ */
+struct FSingularisVehicleRecordWheel
+{
+	/** 车轮转动角度（度） */
+	float RotationAngle = 0.0f;
+
+	/** 车轮转向角度（度） */
+	float SteerAngle = 0.0f;
+
+	/** 悬挂偏移（厘米） */
+	float SuspensionOffset = 0.0f;
+};
+
+/**
+ * 录制帧
+ * 固定大小的 POD，文件中按原样连续存放，回放时可以直接从映射的内存中读取
+ */
+struct FSingularisVehicleRecordFrame
+{
+	/** 每帧最多记录的车轮数量 */
+	static constexpr int32 MaxWheels = 6;
+
+	/** 标志位 */
+	static constexpr uint8 FlagHandbrake = 1 << 0;
+	static constexpr uint8 FlagBrakeLights = 1 << 1;
+
+	/** 自录制开始的时间（秒） */
+	float Time = 0.0f;
+
+	/** 位置与朝向；朝向使用只需 4 字节对齐的 FRotator3f，帧可以紧接在文件头之后 */
+	FVector3f Location = FVector3f::ZeroVector;
+	FRotator3f Rotation = FRotator3f::ZeroRotator;
+	FVector3f LinearVelocity = FVector3f::ZeroVector;
+
+	float Steering = 0.0f;
+	float Throttle = 0.0f;
+	float Brake = 0.0f;
+	float EngineRPM = 0.0f;
+
+	int8 Gear = 0;
+	uint8 Flags = 0;
+	uint8 NumWheels = 0;
+	uint8 Reserved = 0;
+
+	FSingularisVehicleRecordWheel Wheels[MaxWheels];
+
+	FORCEINLINE bool IsHandbrakeOn() const { return (Flags & FlagHandbrake) != 0; }
+	FORCEINLINE bool AreBrakeLightsOn() const { return (Flags & FlagBrakeLights) != 0; }
+};
+
+static_assert(TIsTriviallyCopyable<FSingularisVehicleRecordFrame>::Value, "录制帧需要能按字节写入文件");
+
+/**
+ * 录制文件头
+ * 文件布局：文件头 + NumFrames 个按时间顺序排列的 FSingularisVehicleRecordFrame，小端序
+ */
+struct FSingularisVehicleRecordingHeader
+{
+	/** 'SVRC' */
+	static constexpr uint32 ExpectedMagic = 0x43525653;
+
+	/** 帧布局变化时递增 */
+	static constexpr uint32 CurrentVersion = 1;
+
+	uint32 Magic = ExpectedMagic;
+	uint32 Version = CurrentVersion;
+	uint32 FrameSize = sizeof(FSingularisVehicleRecordFrame);
+	uint32 NumFrames = 0;
+	float SampleRate = 0.0f;
+	uint32 Reserved = 0;
+
+	/** Returns 文件头是否能被当前版本读取 */
+	bool IsValid() const
+	{
+		return Magic == ExpectedMagic && Version == CurrentVersion && FrameSize == sizeof(FSingularisVehicleRecordFrame);
+	}
+};
+
+/**
+ * 录制文件读取器
+ * 优先内存映射整个文件，平台不支持时一次性读入内存；帧数据不做拷贝
+ */
+class SINGULARISVEHICLE_API FSingularisVehicleRecordingReader
+{
+public:
+	FSingularisVehicleRecordingReader();
+	~FSingularisVehicleRecordingReader();
+
+	/** 打开录制文件，Returns 是否成功 */
+	bool Open(const FString& FilePath);
+
+	/** 关闭文件并释放映射 */
+	void Close();
+
+	FORCEINLINE bool IsOpen() const { return Frames != nullptr; }
+	FORCEINLINE int32 GetNumFrames() const { return NumFrames; }
+	FORCEINLINE const FSingularisVehicleRecordFrame& GetFrame(const int32 Index) const { return Frames[Index]; }
+
+	/** Returns 录制的总时长（秒） */
+	float GetDuration() const;
+
+	/** 在指定时间插值出一帧，超出范围时取端点 */
+	void Sample(float Time, FSingularisVehicleRecordFrame& OutFrame) const;
+
+private:
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/** 无法映射时的文件内容 */
+	TArray64<uint8> FallbackData;
+
+	const FSingularisVehicleRecordFrame* Frames = nullptr;
+	int32 NumFrames = 0;
+
+	/** 上一次采样的帧号，顺序回放时从这里开始查找 */
+	mutable int32 LastFrameIndex = 0;
+};
+
+namespace SingularisVehicleRecording
+{
+	/** 在后台线程写出录制文件，Frames 需按时间顺序排列 */
+	SINGULARISVEHICLE_API void SaveAsync(const FString& FilePath, float SampleRate, TArray<FSingularisVehicleRecordFrame>&& Frames);
+}
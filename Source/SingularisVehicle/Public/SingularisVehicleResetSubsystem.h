@@ -0,0 +1,129 @@
+/* =====================================================================
+ * SingularisVehicleResetSubsystem.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "WorldCollision.h"
+#include "SingularisVehicleResetSubsystem.generated.h"
+
+class ABaseWheeledVehiclePawn;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogSingularisVehicleReset, Log, All);
+
+/**
+ *  载具安全重置子系统
+ *  定期记录每辆载具最近几个着地且姿态正常的位置；收到重置请求后，对这些位置从新到旧依次发起
+ *  异步的地面射线与重叠检测，下一帧结果返回时把载具传送到第一个安全的位置
+ *
+ *  所有请求在同一帧批量发起，每帧发起的检测数量有上限，大量载具同时重置时游戏线程开销保持平稳；
+ *  同一帧的检测彼此看不到对方的传送，与本帧已接受的位置重叠的候选按不安全处理
+ */
+UCLASS()
+class SINGULARISVEHICLE_API USingularisVehicleResetSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// 开始 Subsystem 接口
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// 结束 Subsystem 接口
+
+	// 开始 TickableGameObject 接口
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// 结束 TickableGameObject 接口
+
+	/** 注册载具并开始记录安全位置，由载具 BeginPlay 调用 */
+	void RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 注销载具并丢弃其历史与未完成的请求，由载具 EndPlay 调用 */
+	void UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 请求把载具重置到安全位置，同一载具重复请求会被合并 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Reset")
+	void RequestReset(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** Returns 尚未完成的重置请求数量 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Reset")
+	int32 GetNumPendingResets() const { return Requests.Num(); }
+
+	/** 地面射线使用的通道 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle|Reset")
+	TEnumAsByte<ECollisionChannel> GroundTraceChannel = ECC_Visibility;
+
+	/** 重叠检测使用的通道 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle|Reset")
+	TEnumAsByte<ECollisionChannel> OverlapChannel = ECC_Vehicle;
+
+private:
+	/** 每辆载具保留的安全位置数量 */
+	static constexpr int32 HistorySize = 8;
+
+	struct FVehicleHistory
+	{
+		TWeakObjectPtr<ABaseWheeledVehiclePawn> Vehicle;
+
+		/** 车身在本地空间的包围盒 */
+		FBox LocalBounds = FBox(ForceInit);
+
+		/** 安全位置的环形缓冲区 */
+		TStaticArray<FTransform, HistorySize> Poses;
+		int32 Head = 0;
+		int32 NumPoses = 0;
+
+		/** 下次采样的时间 */
+		double NextSampleTime = 0.0;
+
+		/** Returns 从新到旧第 Age 个安全位置 */
+		const FTransform& GetPose(int32 Age) const { return Poses[(Head - 1 - Age + HistorySize) % HistorySize]; }
+	};
+
+	struct FResetRequest
+	{
+		TWeakObjectPtr<ABaseWheeledVehiclePawn> Vehicle;
+
+		/** 正在检测的安全位置序号（从新到旧），等于历史数量时检测请求时的当前位置 */
+		int32 CandidateAge = 0;
+
+		/** 正在检测的姿态 */
+		FTransform Candidate;
+
+		/** 候选位置抬高后车身的世界空间包围盒 */
+		FBox CandidateBounds = FBox(ForceInit);
+
+		FTraceHandle GroundTrace;
+		FTraceHandle OverlapTrace;
+
+		bool bInFlight = false;
+	};
+
+	/** 记录着地载具的安全位置 */
+	void SampleHistories(double Now);
+
+	/** 处理已返回的检测结果，Returns 请求是否已完成 */
+	bool ResolveRequest(FResetRequest& Request);
+
+	/** 为请求的下一个候选位置发起检测，Returns 是否还有候选 */
+	bool IssueQueries(FResetRequest& Request);
+
+	/** 所有候选都不安全时，按旧逻辑在原地抬高 */
+	void ApplyFallback(ABaseWheeledVehiclePawn& Vehicle) const;
+
+	TMap<TObjectKey<ABaseWheeledVehiclePawn>, FVehicleHistory> Histories;
+
+	TArray<FResetRequest> Requests;
+
+	/** 本帧已接受的重置位置的包围盒，复用以避免每帧分配 */
+	TArray<FBox> AcceptedBounds;
+};
@@ -0,0 +1,83 @@
+/* =====================================================================
+ * SingularisVehicleSignificanceSubsystem.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SingularisVehicleTypes.h"
+#include "SingularisVehicleSignificanceSubsystem.generated.h"
+
+class ABaseWheeledVehiclePawn;
+
+/**
+ *  载具重要度子系统
+ *  每帧根据观察者距离、屏幕可见性和控制者为所有已注册载具打分，
+ *  并在一次批处理中统一切换载具的重要度层级（避免在每个 Pawn 的 Tick 中各自判断）
+ */
+UCLASS()
+class SINGULARISVEHICLE_API USingularisVehicleSignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// 开始 Subsystem 接口
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// 结束 Subsystem 接口
+
+	// 开始 TickableGameObject 接口
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// 结束 TickableGameObject 接口
+
+	/** 注册载具，由载具 BeginPlay 调用 */
+	void RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 注销载具，由载具 EndPlay 调用；注销时载具恢复到全速层级 */
+	void UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** Returns 当前处于指定层级的载具数量 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Significance")
+	int32 GetNumVehiclesInTier(EVehicleSignificanceTier Tier) const;
+
+private:
+	struct FVehicleEntry
+	{
+		TWeakObjectPtr<ABaseWheeledVehiclePawn> Vehicle;
+		EVehicleSignificanceTier Tier = EVehicleSignificanceTier::Full;
+	};
+
+	struct FPendingTierChange
+	{
+		int32 EntryIndex;
+		EVehicleSignificanceTier NewTier;
+
+		/** 新层级比当前层级更高（更新更频繁） */
+		bool bPromotion;
+	};
+
+	/** 收集所有玩家控制器的视点位置 */
+	void GatherViewerLocations();
+
+	/** 计算单个载具的期望层级（带滞后，避免在阈值附近来回切换） */
+	EVehicleSignificanceTier EvaluateTier(const ABaseWheeledVehiclePawn& Vehicle, EVehicleSignificanceTier CurrentTier) const;
+
+	/** 已注册载具 */
+	TArray<FVehicleEntry> Vehicles;
+
+	/** 本帧的观察者位置 */
+	TArray<FVector> ViewerLocations;
+
+	/** 本帧待应用的层级变更，复用以避免每帧分配 */
+	TArray<FPendingTierChange> PendingChanges;
+
+	/** 每个层级的载具数量 */
+	int32 TierCounts[static_cast<int32>(EVehicleSignificanceTier::Num)] = {};
+};
@@ -0,0 +1,157 @@
+/* =====================================================================
+ * SingularisVehicleSimulation.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChaosWheeledVehicleMovementComponent.h"
+#include "Containers/Queue.h"
+#include "SingularisBakedCurve.h"
+#include "SingularisSurfaceResponse.h"
+#include "SingularisVehicleGroundContact.h"
+#include "SingularisVehicleSnapshot.h"
+
+/**
+ * 带时间戳的控制输入采样，由游戏线程写入，物理线程读取
+ */
+struct FSingularisVehicleInputSample
+{
+	/** FPlatformTime::Seconds() 时间戳 */
+	double Timestamp = 0.0;
+
+	float Throttle = 0.0f;
+	float Brake = 0.0f;
+	float Steering = 0.0f;
+	float Handbrake = 0.0f;
+};
+
+/** 单生产者（游戏线程）单消费者（物理线程）的无锁输入队列 */
+using FSingularisVehicleInputQueue = TQueue<FSingularisVehicleInputSample, EQueueMode::Spsc>;
+
+/**
+ * 从持久化记录放回行驶中的载具时，由游戏线程一次性交给物理线程模拟的行驶状态
+ */
+struct FSingularisVehicleDriveRestore
+{
+	/** 沿车头方向的速度（厘米/秒），车轮转速按此匹配，挂挡时引擎转速随后由传动系统推出 */
+	float ForwardSpeed = 0.0f;
+};
+
+/** 单生产者（游戏线程）单消费者（物理线程）的行驶状态恢复队列 */
+using FSingularisVehicleDriveRestoreQueue = TQueue<FSingularisVehicleDriveRestore, EQueueMode::Spsc>;
+
+/**
+ * 创建物理载具时从运动组件复制给模拟的参数，之后只在物理线程上读取
+ */
+struct FSingularisVehicleSimulationConfig
+{
+	/** 为空时使用游戏线程经 Chaos 异步输入送来的控制输入 */
+	TSharedPtr<FSingularisVehicleInputQueue, ESPMode::ThreadSafe> InputQueue;
+
+	/** 游戏线程请求恢复的行驶状态，在下一个物理步开始时写入，为空时不恢复 */
+	TSharedPtr<FSingularisVehicleDriveRestoreQueue, ESPMode::ThreadSafe> DriveRestoreQueue;
+
+	/** 每个物理步结束时发布状态快照，为空时不发布 */
+	TSharedPtr<FSingularisVehicleSnapshotBuffer, ESPMode::ThreadSafe> SnapshotBuffer;
+
+	/** 路面响应表，为空时保持 Chaos 的默认行为 */
+	FSingularisSurfaceResponseTablePtr SurfaceResponses;
+
+	/** 高度场接触提供者，为空时悬挂检测全部使用场景查询 */
+	FSingularisGroundContactProviderPtr GroundContact;
+
+	/** 载具附近是否有动态物体，为 true 时本步的悬挂检测全部使用场景查询 */
+	FSingularisGroundObstructionPtr GroundObstruction;
+
+	/** 车速（英里/小时）到转向比例的查找表，未烘焙时使用 Chaos 按关键帧逐段查找的转向曲线 */
+	FSingularisBakedCurve SteeringCurve;
+
+	FVehicleInputRateConfig ThrottleInputRate;
+	FVehicleInputRateConfig BrakeInputRate;
+	FVehicleInputRateConfig SteeringInputRate;
+	FVehicleInputRateConfig HandbrakeInputRate;
+
+	/** 倒挡时油门与制动互换 */
+	bool bReverseAsBrake = true;
+
+	/** 空中角度阻尼，小于等于 0 时不在物理线程上施加 */
+	float AirborneAngularDamping = 0.0f;
+};
+
+/**
+ *  插件的 Chaos 轮式载具物理线程模拟
+ *  异步输入模式下每个物理步从队列中取出带时间戳的采样，按采样在两步之间的持续时间分段插值，
+ *  插值使用物理步长而不是游戏帧长，因此操控手感不随帧率变化；空中的角度阻尼也在物理步中施加
+ *
+ *  每个物理步结束时把速度、转速、挡位、输入与车轮滑移写入快照存储，供其他线程无锁读取
+ *
+ *  配置了路面响应表时，每个着地车轮按接触的物理材质表面类型查表，缩放摩擦力并判断打滑与侧滑
+ *
+ *  配置了高度场接触提供者且所有车轮都使用 Raycast 悬挂检测时，先由缓存的高度场求接触，无法解析或附近有动态物体时再执行场景查询
+ *
+ *  配置了转向查找表时，转向比例直接由查找表求值，不再经过 Chaos 转向曲线的关键帧查找
+ */
+class SINGULARISVEHICLE_API FSingularisVehicleSimulation : public UChaosWheeledVehicleSimulation
+{
+public:
+	typedef UChaosWheeledVehicleSimulation Super;
+
+	explicit FSingularisVehicleSimulation(const FSingularisVehicleSimulationConfig& InConfig);
+
+	// 开始 Chaos 载具模拟接口
+	virtual void ApplyInput(const FControlInputs& ControlInputs, float DeltaTime) override;
+	virtual void UpdateSimulation(float DeltaTime, const FChaosVehicleAsyncInput& InputData, Chaos::FRigidBodyHandle_Internal* Handle) override;
+	virtual void ProcessSteering(const FControlInputs& ControlInputs) override;
+	virtual void ApplyWheelFrictionForces(float DeltaTime) override;
+	virtual void PerformSuspensionTraces(const TArray<Chaos::FSuspensionTrace>& SuspensionTrace,
+	                                     FCollisionQueryParams& TraceParams,
+	                                     FCollisionResponseContainer& CollisionResponse,
+	                                     TArray<FWheelTraceParams>& WheelTraceParams) override;
+	// 结束 Chaos 载具模拟接口
+
+	/** 开始或停止统计每辆载具每个物理步的模拟耗时，所有载具共用一份统计，供基准测试使用 */
+	static void SetCollectStepStats(bool bCollect);
+
+	/** 取出并清零统计，Returns 是否统计到了物理步 */
+	static bool ConsumeStepStats(int64& OutNumSteps, double& OutSeconds);
+
+private:
+	/** 让平滑后的输入朝当前目标前进一段时间 */
+	void AdvanceInputs(float DeltaTime);
+
+	/** 按请求的车速设置各车轮的转速，使放回的载具不必从静止的车轮开始打滑 */
+	void ApplyDriveRestore(const FSingularisVehicleDriveRestore& Restore);
+
+	/** 按车轮接触的路面查表，缩放车轮的路面摩擦力 */
+	void ApplySurfaceResponses();
+
+	/** 发布本步结束时的状态快照 */
+	void PublishSnapshot(float DeltaTime);
+
+	FSingularisVehicleSimulationConfig Config;
+
+	/** 当前目标，即最近一次取出的采样 */
+	FSingularisVehicleInputSample TargetInputs;
+
+	/** 平滑后实际施加到载具上的输入 */
+	FSingularisVehicleInputSample SmoothedInputs;
+
+	/** 上一个物理步取队列的时间 */
+	double LastConsumeTime = 0.0;
+
+	/** 本步实际施加的输入，写入快照 */
+	FControlInputs AppliedInputs;
+
+	/** 下一次发布的快照序号与模拟时间 */
+	uint32 NextStepIndex = 1;
+	double SimulationTime = 0.0;
+
+	/** 各车轮最近接触的路面表面类型 */
+	uint8 WheelSurfaces[FSingularisVehicleSnapshot::MaxWheels] = {};
+};
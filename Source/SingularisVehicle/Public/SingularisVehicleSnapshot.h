@@ -0,0 +1,123 @@
+/* =====================================================================
+ * SingularisVehicleSnapshot.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/**
+ * 载具在一个物理步结束时的状态
+ * 由物理线程模拟每步发布一次，供仪表、引擎声音、小地图与统计等读取方使用，不必各自访问运动组件
+ */
+struct FSingularisVehicleSnapshot
+{
+	/** 快照最多记录的车轮数量，多出的车轮不记录 */
+	static constexpr int32 MaxWheels = 8;
+
+	/** 物理载具创建以来发布的序号，从 1 开始；为 0 表示尚未发布过 */
+	uint32 StepIndex = 0;
+
+	/** 物理载具创建以来的模拟时间（秒） */
+	float SimulationTime = 0.0f;
+
+	/** 沿车头方向的速度（厘米/秒） */
+	float ForwardSpeed = 0.0f;
+
+	float EngineRPM = 0.0f;
+
+	/** 当前挡位，负数为倒挡，0 为空挡 */
+	int8 CurrentGear = 0;
+
+	/** 实际记录的车轮数量 */
+	uint8 NumWheels = 0;
+
+	/** 着地车轮的位掩码，第 i 位对应第 i 个车轮 */
+	uint8 WheelContactMask = 0;
+
+	/** 所有车轮都离地 */
+	bool bInAir = false;
+
+	/** 物理步实际使用的输入，已经过平滑与倒挡互换 */
+	float Throttle = 0.0f;
+	float Brake = 0.0f;
+	float Steering = 0.0f;
+	float Handbrake = 0.0f;
+
+	/** 各车轮的滑移量（厘米/秒），即轮胎接地点相对地面的滑动速度 */
+	float WheelSlip[MaxWheels] = {};
+
+	/** 各车轮的侧偏角（弧度） */
+	float WheelSlipAngle[MaxWheels] = {};
+
+	/** 各车轮最近接触的路面表面类型（EPhysicalSurface），离地时保持离地前的值；没有路面响应表时为 0 */
+	uint8 WheelSurface[MaxWheels] = {};
+
+	/** 滑移量超过所在路面 SlipThreshold 的车轮的位掩码，没有路面响应表时为 0 */
+	uint8 WheelSlipMask = 0;
+
+	/** 侧滑量超过所在路面 SkidThreshold 的车轮的位掩码，没有路面响应表时为 0 */
+	uint8 WheelSkidMask = 0;
+
+	/** Returns 着地的车轮数量 */
+	FORCEINLINE int32 GetNumWheelsInContact() const { return FMath::CountBits(WheelContactMask); }
+
+	/** Returns 第 WheelIndex 个车轮是否着地 */
+	FORCEINLINE bool IsWheelInContact(const int32 WheelIndex) const { return (WheelContactMask & (1u << WheelIndex)) != 0; }
+};
+
+/**
+ *  单个载具的快照存储（顺序锁）
+ *  只有该载具的物理线程模拟写入，任意线程都可以无锁读取：写入前后各递增一次序号，读取方在序号为偶数且
+ *  读取前后不变时才接受结果，否则重试。写入只是一次小结构体的复制，重试几乎不会发生
+ */
+class SINGULARISVEHICLE_API FSingularisVehicleSnapshotBuffer
+{
+public:
+	/** 发布快照，只能由唯一的写入方调用 */
+	void Publish(const FSingularisVehicleSnapshot& Snapshot)
+	{
+		const uint32 Sequence = SequenceNumber.load(std::memory_order_relaxed);
+		SequenceNumber.store(Sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		Data = Snapshot;
+
+		SequenceNumber.store(Sequence + 2, std::memory_order_release);
+	}
+
+	/** 尝试读取一次，Returns 读到的快照是否完整；写入方正在写入时返回 false */
+	bool TryRead(FSingularisVehicleSnapshot& OutSnapshot) const
+	{
+		const uint32 Begin = SequenceNumber.load(std::memory_order_acquire);
+		if (Begin & 1u)
+		{
+			return false;
+		}
+
+		OutSnapshot = Data;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return SequenceNumber.load(std::memory_order_relaxed) == Begin;
+	}
+
+	/** 读取完整的快照，写入方正在写入时重试 */
+	FSingularisVehicleSnapshot Read() const;
+
+	/** 批量读取，可在任意线程调用；两个数组一一对应 */
+	static void ReadAll(TConstArrayView<TSharedRef<const FSingularisVehicleSnapshotBuffer, ESPMode::ThreadSafe>> Buffers,
+	                    TArray<FSingularisVehicleSnapshot>& OutSnapshots);
+
+private:
+	/** 奇数表示正在写入 */
+	std::atomic<uint32> SequenceNumber{0};
+
+	FSingularisVehicleSnapshot Data;
+};
+
+using FSingularisVehicleSnapshotBufferRef = TSharedRef<const FSingularisVehicleSnapshotBuffer, ESPMode::ThreadSafe>;
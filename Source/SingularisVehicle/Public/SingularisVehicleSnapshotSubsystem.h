@@ -0,0 +1,62 @@
+/* =====================================================================
+ * SingularisVehicleSnapshotSubsystem.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SingularisVehicleSnapshot.h"
+#include "SingularisVehicleSnapshotSubsystem.generated.h"
+
+class ABaseWheeledVehiclePawn;
+
+/**
+ *  载具状态快照子系统
+ *  登记所有载具的快照存储，提供批量读取：游戏线程可一次取得全部载具的快照与对应的载具，
+ *  其他线程先在游戏线程上取得存储的引用，之后随时用 FSingularisVehicleSnapshotBuffer::ReadAll 无锁读取
+ *
+ *  只登记使用 USingularisVehicleMovementComponent 的载具
+ */
+UCLASS()
+class SINGULARISVEHICLE_API USingularisVehicleSnapshotSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// 开始 Subsystem 接口
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// 结束 Subsystem 接口
+
+	/** 登记载具的快照存储，由载具 BeginPlay 调用 */
+	void RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 注销载具，由载具 EndPlay 调用 */
+	void UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/**
+	 * 在游戏线程上读取所有载具的快照
+	 * @param OutVehicles 不为空时填写与快照一一对应的载具
+	 */
+	void ReadSnapshots(TArray<FSingularisVehicleSnapshot>& OutSnapshots, TArray<ABaseWheeledVehiclePawn*>* OutVehicles = nullptr) const;
+
+	/**
+	 * 取得所有载具快照存储的引用，交给其他线程批量读取
+	 * 引用保证存储在载具销毁后仍然有效，只是不再更新；载具增减后需要重新取得
+	 */
+	void GetSnapshotBuffers(TArray<FSingularisVehicleSnapshotBufferRef>& OutBuffers) const;
+
+	/** Returns 已登记的载具数量 */
+	FORCEINLINE int32 GetNumVehicles() const { return Vehicles.Num(); }
+
+private:
+	/** 以下数组一一对应 */
+	TArray<TWeakObjectPtr<ABaseWheeledVehiclePawn>> Vehicles;
+	TArray<FSingularisVehicleSnapshotBufferRef> Buffers;
+};
@@ -0,0 +1,269 @@
+/* =====================================================================
+ * SingularisVehicleSpec.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChaosWheeledVehicleMovementComponent.h"
+#include "Engine/DataAsset.h"
+#include "SingularisBakedCurve.h"
+#include "SingularisSurfaceResponse.h"
+#include "SingularisVehicleSpec.generated.h"
+
+class UChaosVehicleWheel;
+class UCurveFloat;
+
+/**
+ * 底盘配置
+ */
+USTRUCT(BlueprintType)
+struct FSingularisVehicleChassisSpec
+{
+	GENERATED_BODY()
+
+	/** 车辆质量（千克） */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Chassis, meta = (ClampMin = "0.01", UIMin = "0.01"))
+	float Mass = 1500.0f;
+
+	/** 底盘宽度（厘米），用于空气阻力计算 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Chassis)
+	float ChassisWidth = 180.0f;
+
+	/** 底盘离地高度（厘米），影响车辆重心和稳定性 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Chassis)
+	float ChassisHeight = 144.0f;
+
+	/** 空气阻力系数，值越低车辆空气动力学性能越好 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Chassis)
+	float DragCoefficient = 0.31f;
+
+	/** 下压力系数 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Chassis)
+	float DownforceCoefficient = 0.3f;
+};
+
+/**
+ * 引擎配置
+ */
+USTRUCT(BlueprintType)
+struct FSingularisVehicleEngineSpec
+{
+	GENERATED_BODY()
+
+	/** 扭矩曲线（横轴转速，纵轴扭矩比例），以资产引用的方式在所有实例间共享 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Engine)
+	TObjectPtr<UCurveFloat> TorqueCurve;
+
+	/** 最大扭矩（牛米），决定加速能力 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Engine)
+	float MaxTorque = 750.0f;
+
+	/** 发动机最高转速（转/分钟），超限会断油 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Engine)
+	float MaxRPM = 7000.0f;
+
+	/** 怠速转速 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Engine)
+	float EngineIdleRPM = 900.0f;
+
+	/** 发动机制动强度（0.0-1.0），松油门时的减速效果 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Engine, meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float EngineBrakeEffect = 0.2f;
+
+	/** 发动机旋转惯量，值越大转速变化越慢 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Engine)
+	float EngineRevUpMOI = 5.0f;
+
+	/** 转速下降速率（RPM/秒） */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Engine)
+	float EngineRevDownRate = 600.0f;
+};
+
+/**
+ * 变速箱配置
+ */
+USTRUCT(BlueprintType)
+struct FSingularisVehicleTransmissionSpec
+{
+	GENERATED_BODY()
+
+	/** 启用自动换挡 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Transmission)
+	bool bUseAutomaticGears = true;
+
+	/** 启用自动倒车（低速时自动切倒挡） */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Transmission)
+	bool bUseAutoReverse = true;
+
+	/** 主减速器传动比 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Transmission)
+	float FinalRatio = 2.81f;
+
+	/** 前进挡传动比（数值越大扭矩越大，极速越低） */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Transmission)
+	TArray<float> ForwardGearRatios = {4.25f, 2.52f, 1.66f, 1.22f, 1.0f};
+
+	/** 倒挡传动比 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Transmission)
+	TArray<float> ReverseGearRatios = {4.04f};
+
+	/** 升挡转速阈值 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Transmission)
+	float ChangeUpRPM = 6000.0f;
+
+	/** 降挡转速阈值 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Transmission)
+	float ChangeDownRPM = 2000.0f;
+
+	/** 换挡耗时（秒） */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Transmission)
+	float GearChangeTime = 0.2f;
+
+	/** 传动效率（0.0-1.0） */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Transmission, meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float TransmissionEfficiency = 0.9f;
+};
+
+/**
+ * 转向配置
+ */
+USTRUCT(BlueprintType)
+struct FSingularisVehicleSteeringSpec
+{
+	GENERATED_BODY()
+
+	/** 转向几何 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Steering)
+	ESteeringType SteeringType = ESteeringType::Ackermann;
+
+	/** 转向角度比率（0.0-1.0），值越小转向越平缓 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Steering, meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float AngleRatio = 0.7f;
+
+	/** 转向随车速变化的曲线（横轴车速，纵轴转向比例），以资产引用的方式在所有实例间共享 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Steering)
+	TObjectPtr<UCurveFloat> SteeringCurve;
+};
+
+/**
+ * 一根车轴上左右两个车轮的配置
+ */
+USTRUCT(BlueprintType)
+struct FSingularisVehicleAxleSpec
+{
+	GENERATED_BODY()
+
+	/** 车轮物理类 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Wheels)
+	TSubclassOf<UChaosVehicleWheel> WheelClass;
+
+	/** 左轮骨骼名 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Wheels)
+	FName LeftBoneName;
+
+	/** 右轮骨骼名 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Wheels)
+	FName RightBoneName;
+
+	/** 车轮位置微调 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Wheels)
+	FVector AdditionalOffset = FVector::ZeroVector;
+};
+
+/**
+ *  载具规格数据资产
+ *  集中描述底盘、引擎、变速箱、转向与各车轴的车轮配置，多个载具蓝图与实例引用同一份资产，
+ *  在物理状态创建前一次性写入 Chaos 载具运动组件；曲线以资产引用共享，不在每个实例中复制关键帧
+ *
+ *  通过 Asset Manager 以 "SingularisVehicleSpec" 主资产类型异步加载；加载后扭矩曲线与转向曲线被烘焙为查找表，
+ *  创建物理载具时替换 Chaos 对曲线的稀疏采样，游戏线程上的查询（仪表、音效、AI 等）也使用查找表而不是逐帧求值富曲线；路面响应同样烘焙为按表面类型索引的定长表
+ */
+UCLASS(BlueprintType)
+class SINGULARISVEHICLE_API USingularisVehicleSpec : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** 主资产类型 */
+	static const FPrimaryAssetType PrimaryAssetType;
+
+	// 开始 UObject 接口
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+	// 结束 UObject 接口
+
+	/** 将规格写入运动组件；需要在物理状态创建前调用，否则调用方需要重建物理状态 */
+	void ApplyTo(UChaosWheeledVehicleMovementComponent& Movement) const;
+
+	/**
+	 * Returns 交给物理线程模拟求转向比例的查找表，由运动组件在创建物理载具时调用
+	 * Chaos 的转向曲线只取关键帧并逐段查找，查找表按等间距直接求值；运动组件的转向曲线在规格写入后被改掉时返回空
+	 * 扭矩曲线在 Chaos 中已是等间距采样、按下标直接求值的表，引擎模拟内部的查找无法替换，保留 Chaos 自己的采样
+	 */
+	const FSingularisBakedCurve* FindSimulationSteeringCurve(const UChaosWheeledVehicleMovementComponent& Movement) const;
+
+	/** 重新烘焙曲线查找表；在运行时修改曲线后需要手动调用，已创建的物理载具在重建物理状态后才使用新表 */
+	void BakeCurves();
+
+	/** 重新烘焙路面响应表；在运行时修改路面响应后需要手动调用，已创建的物理载具在重建物理状态后才使用新表 */
+	void BakeSurfaceResponses();
+
+	/** Returns 指定转速下扭矩曲线的原始值，Chaos 按曲线最大值归一化后乘以 MaxTorque；未配置扭矩曲线时为 0 */
+	FORCEINLINE float GetTorqueRatioAtRPM(const float RPM) const { return BakedTorqueCurve.Evaluate(RPM); }
+
+	/** Returns 指定车速下转向曲线的原始值，未配置转向曲线时为 0 */
+	FORCEINLINE float GetSteeringRatioAtSpeed(const float Speed) const { return BakedSteeringCurve.Evaluate(Speed); }
+
+	FORCEINLINE const FSingularisBakedCurve& GetBakedTorqueCurve() const { return BakedTorqueCurve; }
+	FORCEINLINE const FSingularisBakedCurve& GetBakedSteeringCurve() const { return BakedSteeringCurve; }
+
+	/** Returns 路面响应表，没有配置任何路面时为空 */
+	FORCEINLINE const FSingularisSurfaceResponseTablePtr& GetSurfaceResponseTable() const { return SurfaceResponseTable; }
+
+	/** 底盘 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Vehicle)
+	FSingularisVehicleChassisSpec Chassis;
+
+	/** 引擎 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Vehicle)
+	FSingularisVehicleEngineSpec Engine;
+
+	/** 变速箱 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Vehicle)
+	FSingularisVehicleTransmissionSpec Transmission;
+
+	/** 转向 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Vehicle)
+	FSingularisVehicleSteeringSpec Steering;
+
+	/** 由前到后的车轴；为空时保留载具蓝图中的车轮配置 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Vehicle)
+	TArray<FSingularisVehicleAxleSpec> Axles;
+
+	/** 各种路面上的车轮响应；为空时不调整摩擦力，也不产生路面事件 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Surface)
+	TArray<FSingularisSurfaceResponse> SurfaceResponses;
+
+	/** 未列在 SurfaceResponses 中的路面使用的响应，其 SurfaceType 不起作用 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Surface)
+	FSingularisSurfaceResponse DefaultSurfaceResponse;
+
+private:
+	/** 扭矩曲线查找表，范围 0 到 MaxRPM，与 Chaos 采样扭矩曲线的范围一致 */
+	FSingularisBakedCurve BakedTorqueCurve;
+
+	/** 转向曲线查找表，范围为曲线自身的时间范围 */
+	FSingularisBakedCurve BakedSteeringCurve;
+
+	/** 路面响应表，每次烘焙都换一份新表，已交给物理线程的旧表保持不变 */
+	FSingularisSurfaceResponseTablePtr SurfaceResponseTable;
+};
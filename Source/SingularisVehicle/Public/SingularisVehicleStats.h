@@ -0,0 +1,15 @@
+/* =====================================================================
+ * SingularisVehicleStats.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "Stats/Stats.h"
+
+// 控制台输入 "stat SingularisVehicle" 查看
+DECLARE_STATS_GROUP(TEXT("SingularisVehicle"), STATGROUP_SingularisVehicle, STATCAT_Advanced);
@@ -0,0 +1,67 @@
+/* =====================================================================
+ * SingularisVehicleTelemetry.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Trace/Trace.h"
+
+class ABaseWheeledVehiclePawn;
+
+// 遥测随 Trace 或 CSV Profiler 一起编译，Test 构建中同样可用
+#define SINGULARISVEHICLE_TELEMETRY (UE_TRACE_ENABLED || CSV_PROFILER)
+
+#if UE_TRACE_ENABLED
+/**
+ * Unreal Insights 通道，默认关闭
+ * 使用 -trace=SingularisVehicle 启动，或在运行时输入 "Trace.Enable SingularisVehicle"
+ */
+UE_TRACE_CHANNEL_EXTERN(SingularisVehicleChannel, SINGULARISVEHICLE_API);
+#endif
+
+#if CSV_PROFILER
+// 汇总数据，使用 -csvCategories=SingularisVehicle 采集
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(SINGULARISVEHICLE_API, SingularisVehicle);
+#endif
+
+/**
+ * 载具遥测
+ * Insights 通道逐车输出转速、挡位、速度、车轮滑移、悬挂压缩与接地状态，CSV 记录所有载具的逐帧汇总
+ */
+namespace SingularisVehicleTelemetry
+{
+	/**
+	 * Returns Insights 通道已打开，或 CSV 正在采集且打开了 SingularisVehicle 分类；都关闭时遥测只花费这一次判断
+	 * 分类默认关闭，仅采集其他分类的 CSV 不会触发逐车统计
+	 */
+	FORCEINLINE bool IsEnabled()
+	{
+#if UE_TRACE_ENABLED
+		if (UE_TRACE_CHANNELEXPR_IS_ENABLED(SingularisVehicleChannel))
+		{
+			return true;
+		}
+#endif
+#if CSV_PROFILER
+		const FCsvProfiler* CsvProfiler = FCsvProfiler::Get();
+		if (CsvProfiler->IsCapturing() && CsvProfiler->IsCategoryEnabled(CSV_CATEGORY_INDEX(SingularisVehicle)))
+		{
+			return true;
+		}
+#endif
+		return false;
+	}
+
+	/** 载具开始运行时输出名称，Insights 中用于识别载具 ID */
+	SINGULARISVEHICLE_API void TraceVehicleSpawn(const ABaseWheeledVehiclePawn& Vehicle);
+
+	/** 记录载具本帧的状态，调用前先检查 IsEnabled */
+	SINGULARISVEHICLE_API void RecordVehicleState(const ABaseWheeledVehiclePawn& Vehicle);
+}
@@ -0,0 +1,48 @@
+/* =====================================================================
+ * SingularisVehicleTrafficProcessors.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityQuery.h"
+#include "MassProcessor.h"
+#include "SingularisVehicleTrafficTypes.h"
+#include "SingularisVehicleTrafficProcessors.generated.h"
+
+/**
+ *  交通运动学处理器
+ *  沿烘焙车道并行推进所有未升级的交通实体，并写出与运动相符的控制输入
+ *
+ *  不注册到 Mass 处理阶段，由 USingularisVehicleTrafficSubsystem 在自己的 Tick 中执行，
+ *  因此只依赖 MassEntity 模块，无需 MassGameplay 的模拟子系统
+ */
+UCLASS()
+class SINGULARISVEHICLE_API USingularisVehicleTrafficMovementProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	USingularisVehicleTrafficMovementProcessor();
+
+	/** 设置本次执行使用的车道与驾驶参数，由子系统在执行前调用 */
+	void SetLanes(TConstArrayView<FSingularisTrafficLane> InLanes, const FSingularisTrafficDrivingParams& InParams);
+
+protected:
+	// 开始 MassProcessor 接口
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+	// 结束 MassProcessor 接口
+
+private:
+	FMassEntityQuery EntityQuery;
+
+	TConstArrayView<FSingularisTrafficLane> Lanes;
+
+	FSingularisTrafficDrivingParams DrivingParams;
+};
@@ -0,0 +1,144 @@
+/* =====================================================================
+ * SingularisVehicleTrafficSubsystem.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassArchetypeTypes.h"
+#include "MassEntityQuery.h"
+#include "MassEntityTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SingularisVehicleTrafficTypes.h"
+#include "SingularisVehicleTrafficSubsystem.generated.h"
+
+class ABaseWheeledVehiclePawn;
+class USingularisVehicleTrafficMovementProcessor;
+class USplineComponent;
+struct FMassEntityManager;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogSingularisVehicleTraffic, Log, All);
+
+/**
+ *  交通子系统
+ *  远处的交通车是 Mass 实体，由运动学处理器沿车道并行推进；观察者附近的实体升级为对象池中的物理载具，
+ *  离开后降级回实体。升级与降级时互相交接位置、速度、车道进度与控制输入，切换前后看不出差别
+ *
+ *  实体本身没有视觉表现，可通过 GetEntityTransforms 取得变换交给实例化网格等表现层
+ */
+UCLASS()
+class SINGULARISVEHICLE_API USingularisVehicleTrafficSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// 开始 Subsystem 接口
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// 结束 Subsystem 接口
+
+	// 开始 TickableGameObject 接口
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// 结束 TickableGameObject 接口
+
+	/** 驾驶参数，运动学实体与升级后的物理载具共用 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle|Traffic")
+	FSingularisTrafficDrivingParams DrivingParams;
+
+	/** 升级时从对象池取出的载具类，为空时不升级 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle|Traffic")
+	TSubclassOf<ABaseWheeledVehiclePawn> PromotedVehicleClass;
+
+	/**
+	 * 烘焙样条为车道，Returns 车道序号
+	 * 样条点应位于载具根组件的高度，升级时载具直接放在车道上
+	 * @param SpeedLimit 限速（厘米/秒）
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Traffic")
+	int32 RegisterLane(const USplineComponent* Spline, float SpeedLimit = 1400.0f);
+
+	/** 由折线注册车道，Returns 车道序号 */
+	int32 RegisterLanePoints(TConstArrayView<FVector> Points, bool bClosedLoop, float SpeedLimit);
+
+	/**
+	 * 在车道上等间距生成交通实体
+	 * @param SpeedVariance 期望速度相对限速的随机扰动比例
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Traffic")
+	void SpawnTraffic(int32 LaneIndex, int32 Count, float SpeedVariance = 0.15f);
+
+	/** 销毁所有交通实体，已升级的载具归还对象池 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Traffic")
+	void ClearTraffic();
+
+	/** Returns 交通实体总数（含已升级的） */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Traffic")
+	int32 GetNumEntities() const { return Entities.Num(); }
+
+	/** Returns 当前升级为物理载具的数量 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Traffic")
+	int32 GetNumPromoted() const { return Promoted.Num(); }
+
+	/** 取得所有未升级实体的变换 */
+	void GetEntityTransforms(TArray<FTransform>& OutTransforms);
+
+private:
+	struct FPromotedVehicle
+	{
+		FMassEntityHandle Entity;
+		TWeakObjectPtr<ABaseWheeledVehiclePawn> Vehicle;
+	};
+
+	struct FPromotionCandidate
+	{
+		FMassEntityHandle Entity;
+		double DistanceSquared;
+	};
+
+	/** 收集所有玩家控制器的视点位置 */
+	void GatherViewerLocations();
+
+	/** Returns 到最近观察者的距离平方 */
+	double GetMinViewerDistanceSquared(const FVector& Location) const;
+
+	/** 降级离开范围的载具，升级进入范围的实体 */
+	void UpdatePromotion();
+
+	/** 用实体状态生成物理载具 */
+	bool PromoteEntity(FMassEntityHandle Entity);
+
+	/** 将物理载具的状态写回实体并归还对象池 */
+	void DemoteEntity(int32 PromotedIndex);
+
+	/** 驾驶已升级的载具沿车道行驶，同时同步实体状态 */
+	void DrivePromotedVehicles();
+
+	FMassEntityManager* EntityManager = nullptr;
+
+	FMassArchetypeHandle TrafficArchetype;
+
+	UPROPERTY(Transient)
+	TObjectPtr<USingularisVehicleTrafficMovementProcessor> MovementProcessor;
+
+	/** 未升级实体的位置，用于挑选升级候选与导出变换 */
+	FMassEntityQuery KinematicQuery;
+
+	TArray<FSingularisTrafficLane> Lanes;
+
+	TArray<FMassEntityHandle> Entities;
+
+	TArray<FPromotedVehicle> Promoted;
+
+	/** 本帧的观察者位置 */
+	TArray<FVector> ViewerLocations;
+
+	/** 升级候选，复用以避免每帧分配 */
+	TArray<FPromotionCandidate> Candidates;
+};
@@ -0,0 +1,166 @@
+/* =====================================================================
+ * SingularisVehicleTrafficTypes.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "SingularisVehicleTrafficTypes.generated.h"
+
+class USplineComponent;
+
+/** 交通实体的位置与朝向 */
+USTRUCT()
+struct SINGULARISVEHICLE_API FSingularisTrafficTransformFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+};
+
+/** 交通实体的速度 */
+USTRUCT()
+struct SINGULARISVEHICLE_API FSingularisTrafficVelocityFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	/** 世界空间速度（厘米/秒） */
+	FVector Velocity = FVector::ZeroVector;
+
+	/** 沿车道的速度（厘米/秒） */
+	float Speed = 0.0f;
+};
+
+/** 交通实体在车道上的进度 */
+USTRUCT()
+struct SINGULARISVEHICLE_API FSingularisTrafficLaneFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	/** USingularisVehicleTrafficSubsystem 中的车道序号 */
+	int32 LaneIndex = INDEX_NONE;
+
+	/** 沿车道的距离（厘米） */
+	float Distance = 0.0f;
+
+	/** 期望速度（厘米/秒），生成时由车道限速加随机扰动得到 */
+	float TargetSpeed = 0.0f;
+};
+
+/** 交通实体当前的控制输入，升级为物理载具时原样交给运动组件 */
+USTRUCT()
+struct SINGULARISVEHICLE_API FSingularisTrafficControlFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	float Throttle = 0.0f;
+	float Brake = 0.0f;
+	float Steering = 0.0f;
+	bool bHandbrake = false;
+};
+
+/** 已升级为物理载具的实体，运动学处理器跳过这些实体 */
+USTRUCT()
+struct SINGULARISVEHICLE_API FSingularisTrafficPromotedTag : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+/**
+ * 运动学驾驶参数
+ */
+USTRUCT(BlueprintType)
+struct SINGULARISVEHICLE_API FSingularisTrafficDrivingParams
+{
+	GENERATED_BODY()
+
+	/** 最大加速度（厘米/秒²），对应满油门 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Traffic, meta = (ClampMin = "1.0"))
+	float MaxAcceleration = 300.0f;
+
+	/** 最大减速度（厘米/秒²），对应满刹车 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Traffic, meta = (ClampMin = "1.0"))
+	float MaxDeceleration = 800.0f;
+
+	/** 满转向时的前轮转角（度） */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Traffic, meta = (ClampMin = "1.0"))
+	float MaxSteerAngle = 35.0f;
+
+	/** 转向预瞄距离（厘米） */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Traffic, meta = (ClampMin = "1.0"))
+	float LookaheadDistance = 800.0f;
+};
+
+/**
+ * 烘焙后的车道
+ * 按固定间距重采样的折线，求值只做一次索引与插值，可在并行处理器中只读访问
+ */
+struct SINGULARISVEHICLE_API FSingularisTrafficLane
+{
+	/** 等间距的采样点；闭合车道的最后一个点与第一个点重合 */
+	TArray<FVector> Points;
+
+	/** 车道长度（厘米） */
+	float Length = 0.0f;
+
+	/** 采样间距的倒数 */
+	float InvSpacing = 0.0f;
+
+	/** 限速（厘米/秒） */
+	float SpeedLimit = 0.0f;
+
+	bool bClosedLoop = false;
+
+	/** 从折线按指定间距重采样 */
+	static FSingularisTrafficLane FromPolyline(TConstArrayView<FVector> Polyline, bool bClosedLoop, float SpeedLimit, float Spacing);
+
+	/** 从样条重采样 */
+	static FSingularisTrafficLane FromSpline(const USplineComponent& Spline, float SpeedLimit, float Spacing);
+
+	FORCEINLINE bool IsValid() const { return Points.Num() >= 2 && Length > 0.0f; }
+
+	/** 闭合车道取模，开放车道截断 */
+	float WrapDistance(float Distance) const;
+
+	/** 指定距离处的位置 */
+	FVector GetLocationAtDistance(float Distance) const;
+
+	/** 指定距离处的切线方向 */
+	FVector GetDirectionAtDistance(float Distance) const;
+
+	/** 在 HintDistance 前后 SearchRadius 范围内查找离 Location 最近的距离 */
+	float FindDistanceClosestTo(const FVector& Location, float HintDistance, float SearchRadius) const;
+};
+
+namespace SingularisVehicleTraffic
+{
+	/**
+	 * 按车道推进一个运动学实体，并反推出与这次运动相符的控制输入
+	 * 纯函数，只读车道数据，可在任意线程调用
+	 */
+	SINGULARISVEHICLE_API void AdvanceKinematic(const FSingularisTrafficLane& Lane,
+	                                            const FSingularisTrafficDrivingParams& Params,
+	                                            float DeltaTime,
+	                                            FSingularisTrafficLaneFragment& LaneState,
+	                                            FSingularisTrafficTransformFragment& Transform,
+	                                            FSingularisTrafficVelocityFragment& Velocity,
+	                                            FSingularisTrafficControlFragment& Control);
+
+	/**
+	 * 为沿车道行驶的物理载具计算控制输入（预瞄追踪加速度比例控制）
+	 * 与 AdvanceKinematic 使用相同的参数，升级前后的驾驶行为保持一致
+	 */
+	SINGULARISVEHICLE_API void ComputeFollowControl(const FSingularisTrafficLane& Lane,
+	                                                const FSingularisTrafficDrivingParams& Params,
+	                                                const FSingularisTrafficLaneFragment& LaneState,
+	                                                const FTransform& VehicleTransform,
+	                                                float ForwardSpeed,
+	                                                FSingularisTrafficControlFragment& OutControl);
+}
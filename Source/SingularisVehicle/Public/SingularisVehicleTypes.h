@@ -0,0 +1,117 @@
+/* =====================================================================
+ * SingularisVehicleTypes.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SingularisVehicleTypes.generated.h"
+
+/**
+ * 是否编译纯表现功能：载具自带的相机、共享相机组、BrakeLights 蓝图事件与骨骼动画更新
+ * 专用服务器构建中默认为 0，可在 Target.cs 的 GlobalDefinitions 中覆盖
+ */
+#ifndef SINGULARISVEHICLE_WITH_COSMETICS
+#define SINGULARISVEHICLE_WITH_COSMETICS (!UE_SERVER)
+#endif
+
+/**
+ * 载具重要度层级
+ * 由 USingularisVehicleSignificanceSubsystem 根据与观察者的距离、是否在屏幕上以及是否被玩家控制计算得出
+ */
+UENUM(BlueprintType)
+enum class EVehicleSignificanceTier : uint8
+{
+	/** 全速更新 */
+	Full,
+	/** 降低 Tick 频率 */
+	Reduced,
+	/** 降低 Tick 频率并简化车轮检测 */
+	LowDetail,
+	/** 冻结物理与 Tick */
+	Frozen,
+
+	Num UMETA(Hidden)
+};
+
+/** 控制帧的输入通道，用于只写入发生变化的通道 */
+enum class EVehicleControlChannels : uint8
+{
+	None = 0,
+	Throttle = 1 << 0,
+	Brake = 1 << 1,
+	Steering = 1 << 2,
+	Handbrake = 1 << 3,
+
+	All = Throttle | Brake | Steering | Handbrake
+};
+ENUM_CLASS_FLAGS(EVehicleControlChannels)
+
+/**
+ * 一帧的载具控制输入
+ * 玩家的 Enhanced Input 回调、AI 控制器与交通等驾驶者都只填写控制帧，
+ * 由 USingularisVehicleControlSubsystem 在每帧的同一次批处理中写入运动组件
+ */
+USTRUCT(BlueprintType)
+struct SINGULARISVEHICLE_API FVehicleControlFrame
+{
+	GENERATED_BODY()
+
+	/** 油门 [0, 1] */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Control)
+	float Throttle = 0.0f;
+
+	/** 制动 [0, 1] */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Control)
+	float Brake = 0.0f;
+
+	/** 转向 [-1, 1] */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Control)
+	float Steering = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Control)
+	bool bHandbrake = false;
+
+	/** Returns 按这一帧的输入刹车灯是否应点亮 */
+	FORCEINLINE bool WantsBrakeLights() const { return Brake > 0.0f || bHandbrake; }
+
+	/** Returns 与上一帧相比发生变化的通道；没有上一帧时为全部通道 */
+	FORCEINLINE EVehicleControlChannels GetChangedChannels(const FVehicleControlFrame* Previous) const
+	{
+		if (!Previous)
+		{
+			return EVehicleControlChannels::All;
+		}
+
+		EVehicleControlChannels Channels = EVehicleControlChannels::None;
+		if (Throttle != Previous->Throttle)
+		{
+			Channels |= EVehicleControlChannels::Throttle;
+		}
+		if (Brake != Previous->Brake)
+		{
+			Channels |= EVehicleControlChannels::Brake;
+		}
+		if (Steering != Previous->Steering)
+		{
+			Channels |= EVehicleControlChannels::Steering;
+		}
+		if (bHandbrake != Previous->bHandbrake)
+		{
+			Channels |= EVehicleControlChannels::Handbrake;
+		}
+		return Channels;
+	}
+
+	FORCEINLINE bool operator==(const FVehicleControlFrame& Other) const
+	{
+		return Throttle == Other.Throttle && Brake == Other.Brake && Steering == Other.Steering && bHandbrake == Other.bHandbrake;
+	}
+
+	FORCEINLINE bool operator!=(const FVehicleControlFrame& Other) const { return !(*this == Other); }
+};
@@ -0,0 +1,144 @@
+/* =====================================================================
+ * SingularisVehicleWheelVisualSubsystem.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SingularisVehicleRecording.h"
+#include "SingularisVehicleWheelVisualSubsystem.generated.h"
+
+class ABaseWheeledVehiclePawn;
+class UAnimInstance;
+class USkeletalMeshComponent;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogSingularisVehicleWheelVisual, Log, All);
+
+/**
+ *  车轮表现子系统
+ *  不使用动画蓝图，直接把 Chaos 车轮的转角、转向角与悬挂偏移写入骨骼网格的组件空间变换，
+ *  效果与动画蓝图中的 WheelController 节点相同，但没有动画图表的求值与骨骼刷新开销
+ *
+ *  接管的载具会清除网格上的动画实例并停止骨骼刷新，车轮骨骼由 WheelSetups 中的 BoneName 确定
+ *  （默认为 Phys_Wheel_FL/FR/BL/BR），其子骨骼随车轮一起移动
+ *
+ *  更新频率随重要度层级降低：Reduced 与 LowDetail 层级每隔若干帧更新一次并错开帧，Frozen 层级与不可见的载具不更新
+ *
+ *  回放等不经过 Chaos 车轮的场合通过 BeginExternalWheelPoses 改为写入外部给定的车轮状态，更新频率规则不变
+ */
+UCLASS()
+class SINGULARISVEHICLE_API USingularisVehicleWheelVisualSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// 开始 Subsystem 接口
+	virtual void Deinitialize() override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// 结束 Subsystem 接口
+
+	// 开始 TickableGameObject 接口
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// 结束 TickableGameObject 接口
+
+	/**
+	 * 接管载具的车轮表现，由载具 BeginPlay 调用
+	 * 只接管开启了 bUseNativeWheelVisuals（或 SingularisVehicle.WheelVisual.Mode 为 2）、执行表现工作且找到车轮骨骼的载具
+	 */
+	void RegisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 注销载具，由载具 EndPlay 调用；网格保持无动画实例的状态 */
+	void UnregisterVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 更新所有到期的载具，由 Tick 调用 */
+	void UpdateWheelVisuals();
+
+	/**
+	 * 之后改为写入 SetExternalWheelPoses 给定的车轮状态，由回放组件在开始回放时调用
+	 * 尚未接管的载具（使用动画蓝图）在此临时接管，EndExternalWheelPoses 时恢复原来的动画蓝图；Returns 是否接管
+	 */
+	bool BeginExternalWheelPoses(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 设置外部给定的车轮状态，按车轮序号排列；在下一次到期更新时写入骨骼 */
+	void SetExternalWheelPoses(const ABaseWheeledVehiclePawn* Vehicle, TConstArrayView<FSingularisVehicleRecordWheel> Wheels);
+
+	/** 恢复读取 Chaos 车轮，由回放组件在停止回放时调用 */
+	void EndExternalWheelPoses(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** Returns 接管的载具数量 */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Wheels")
+	int32 GetNumVehicles() const { return Vehicles.Num(); }
+
+	/** Returns 最近一次更新的载具数量 */
+	FORCEINLINE int32 GetLastNumUpdated() const { return LastNumUpdated; }
+
+	/** Returns 最近一次更新的耗时（秒） */
+	FORCEINLINE double GetLastUpdateSeconds() const { return LastUpdateSeconds; }
+
+private:
+	/** 随车轮移动的一根骨骼 */
+	struct FWheelBone
+	{
+		int32 BoneIndex = INDEX_NONE;
+		int32 ParentIndex = INDEX_NONE;
+
+		/** 对应的车轮序号；车轮骨骼的子骨骼为 INDEX_NONE，只跟随父骨骼 */
+		int32 WheelIndex = INDEX_NONE;
+
+		/** 参考姿势下相对父骨骼的变换 */
+		FTransform RefLocalTransform;
+	};
+
+	struct FVehicleEntry
+	{
+		TWeakObjectPtr<ABaseWheeledVehiclePawn> Vehicle;
+		TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+
+		/** 按骨骼序号排列，父骨骼总在子骨骼之前 */
+		TArray<FWheelBone> Bones;
+
+		/** 降频更新时的帧错位 */
+		uint32 UpdatePhase = 0;
+
+		/** 外部给定的车轮状态，bUseExternalWheels 时代替 Chaos 车轮 */
+		TArray<FSingularisVehicleRecordWheel, TInlineAllocator<FSingularisVehicleRecordFrame::MaxWheels>> ExternalWheels;
+		bool bUseExternalWheels = false;
+
+		/** 只为外部车轮状态临时接管，结束时恢复该动画蓝图并注销 */
+		bool bTemporary = false;
+		TSubclassOf<UAnimInstance> RestoreAnimClass;
+	};
+
+	/** 接管载具的网格并添加条目，Returns 新条目；找不到车轮骨骼时返回空 */
+	FVehicleEntry* AddVehicle(ABaseWheeledVehiclePawn* Vehicle);
+
+	/** Returns 载具的条目，未接管时为空 */
+	FVehicleEntry* FindEntry(const ABaseWheeledVehiclePawn* Vehicle);
+
+	/** 收集车轮骨骼及其子骨骼，Returns 是否找到任何车轮骨骼 */
+	static bool BuildWheelBones(const ABaseWheeledVehiclePawn& Vehicle, const USkeletalMeshComponent& Mesh, TArray<FWheelBone>& OutBones);
+
+	/** 把车轮状态写入一辆载具的骨骼；ExternalWheels 非空时代替 Chaos 车轮 */
+	static void UpdateVehicle(const ABaseWheeledVehiclePawn& Vehicle,
+	                          USkeletalMeshComponent& Mesh,
+	                          TConstArrayView<FWheelBone> Bones,
+	                          TConstArrayView<FSingularisVehicleRecordWheel> ExternalWheels);
+
+	TArray<FVehicleEntry> Vehicles;
+
+	/** 已更新的次数，与 UpdatePhase 一起决定降频载具在哪一帧更新 */
+	uint32 UpdateCounter = 0;
+
+	/** 下一辆载具的帧错位 */
+	uint32 NextUpdatePhase = 0;
+
+	int32 LastNumUpdated = 0;
+	double LastUpdateSeconds = 0.0;
+};
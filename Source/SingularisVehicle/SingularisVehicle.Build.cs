@@ -20,9 +20,12 @@ public class SingularisVehicle : ModuleRules
 		);
 
 
+		// 公共头文件中的交通片段继承 FMassFragment，依赖本模块的模块同样需要 MassEntity 的头文件
+		// MassEntity 自 UE 5.5 起为引擎模块，更早的引擎版本需要启用 MassEntity 插件
 		PublicDependencyModuleNames.AddRange(
 			[
-				"Core"
+				"Core",
+				"MassEntity"
 			]
 		);
 
@@ -35,7 +38,12 @@ public class SingularisVehicle : ModuleRules
 				"SlateCore",
 				"InputCore",
 				"EnhancedInput",
-				"ChaosVehicles"
+				"Chaos",
+				"ChaosVehicles",
+				"PhysicsCore",
+				"Landscape",
+				"NetCore",
+				"TraceLog"
 			]
 		);
 
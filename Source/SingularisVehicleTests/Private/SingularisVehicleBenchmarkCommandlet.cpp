@@ -0,0 +1,2828 @@
+/* =====================================================================
+ * SingularisVehicleBenchmarkCommandlet.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleBenchmarkCommandlet.h"
+
+#include "BaseVehicleWheelFront.h"
+#include "BaseVehicleWheelRear.h"
+#include "BaseWheeledVehiclePawn.h"
+#include "ChaosVehicleWheel.h"
+#include "ChaosWheeledVehicleMovementComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Curves/CurveFloat.h"
+#include "Async/Async.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/ReplicatedState.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "LandscapeProxy.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "SingularisBakedCurve.h"
+#include "SingularisSurfaceResponse.h"
+#include "SingularisVehicleAIDriverSubsystem.h"
+#include "SingularisVehicleContactSubsystem.h"
+#include "SingularisVehicleControlSubsystem.h"
+#include "SingularisVehicleGroundSubsystem.h"
+#include "SingularisVehicleHibernationSubsystem.h"
+#include "SingularisVehicleLightComponent.h"
+#include "SingularisVehicleMovementComponent.h"
+#include "SingularisVehicleNetTypes.h"
+#include "SingularisVehiclePersistenceSubsystem.h"
+#include "SingularisVehicleResetSubsystem.h"
+#include "SingularisVehicleSimulation.h"
+#include "SingularisVehicleSnapshotSubsystem.h"
+#include "SingularisVehicleTrafficSubsystem.h"
+#include "SingularisVehicleWheelVisualSubsystem.h"
+#include "UObject/CoreNet.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY(LogSingularisVehicleBenchmark);
+
+namespace SingularisVehicleBenchmark
+{
+	/** 插件自带的扭矩曲线 */
+	static const TCHAR* TorqueCurvePath = TEXT("/SingularisVehicle/Curves/SportsCar_TorqueCurve.SportsCar_TorqueCurve");
+
+	/** 生成平地使用的网格 */
+	static const TCHAR* FloorMeshPath = TEXT("/Engine/BasicShapes/Cube.Cube");
+
+	/** 载具之间的间距（厘米） */
+	static constexpr float VehicleSpacing = 800.0f;
+
+	/** 交通场景的环形车道数量、最内圈半径与车道间距（厘米） */
+	static constexpr int32 NumTrafficLanes = 8;
+	static constexpr float TrafficLaneRadius = 20000.0f;
+	static constexpr float TrafficLaneSpacing = 500.0f;
+
+	/** 高度场接触相对悬挂射线的精度要求：两者都命中时的平均高度误差（厘米）与是否命中的一致率 */
+	static constexpr double MaxGroundMeanHeightError = 1.0;
+	static constexpr double MinGroundHitAgreement = 0.99;
+
+	/** 报告中指标方向的写法 */
+	static const TCHAR* GateNames[] = {TEXT("LowerIsBetter"), TEXT("HigherIsBetter"), TEXT("None")};
+
+	static const TCHAR* GetGateName(const ESingularisVehicleBenchmarkGate Gate)
+	{
+		return GateNames[static_cast<uint8>(Gate)];
+	}
+
+	/** 没有方向字段的旧基线按开销处理 */
+	static ESingularisVehicleBenchmarkGate ParseGateName(const FString& Name)
+	{
+		for (uint8 Index = 0; Index < UE_ARRAY_COUNT(GateNames); ++Index)
+		{
+			if (Name == GateNames[Index])
+			{
+				return static_cast<ESingularisVehicleBenchmarkGate>(Index);
+			}
+		}
+
+		return ESingularisVehicleBenchmarkGate::LowerIsBetter;
+	}
+
+	/** 一个复制值最近一次写出的内容，复制系统只在内容变化时重新发送 */
+	struct FNetPayload
+	{
+		TArray<uint8> Bytes;
+		int64 NumBits = 0;
+
+		/** 以网络归档写出，Returns 内容是否与上次不同 */
+		template <typename FSerializeFunc>
+		bool Write(FSerializeFunc&& Serialize)
+		{
+			FNetBitWriter Writer(nullptr, 1024);
+			Serialize(Writer);
+			const bool bChanged = Writer.GetNumBits() != NumBits || *Writer.GetBuffer() != Bytes;
+			NumBits = Writer.GetNumBits();
+			Bytes = *Writer.GetBuffer();
+			return bChanged;
+		}
+	};
+}
+
+USingularisVehicleBenchmarkCommandlet::USingularisVehicleBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 USingularisVehicleBenchmarkCommandlet::Main(const FString& Params)
+{
+	FString Scenario = TEXT("Simulation");
+	FParse::Value(*Params, TEXT("Scenario="), Scenario);
+
+	TArray<FSingularisVehicleBenchmarkRow> Rows;
+	const bool bSucceeded = RunScenario(Scenario, Params, Rows);
+	if (!bSucceeded)
+	{
+		return 1;
+	}
+
+	FString OutputDirectory = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("SingularisVehicle");
+	FParse::Value(*Params, TEXT("Output="), OutputDirectory);
+	WriteReport(OutputDirectory, Rows);
+
+	FString BaselinePath;
+	if (FParse::Value(*Params, TEXT("Baseline="), BaselinePath))
+	{
+		double Tolerance = 0.15;
+		FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+		if (CompareWithBaseline(BaselinePath, Rows, Tolerance))
+		{
+			UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("性能相对基线 '%s' 出现退化"), *BaselinePath);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+bool USingularisVehicleBenchmarkCommandlet::RunScenario(const FString& Scenario, const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows)
+{
+	if (Scenario == TEXT("Simulation"))
+	{
+		return RunSimulationScenario(Params, OutRows);
+	}
+
+	if (Scenario == TEXT("CurveLUT"))
+	{
+		return RunCurveLUTScenario(Params, OutRows);
+	}
+
+	if (Scenario == TEXT("Traffic"))
+	{
+		return RunTrafficScenario(Params, OutRows);
+	}
+
+	if (Scenario == TEXT("Lights"))
+	{
+		return RunLightsScenario(Params, OutRows);
+	}
+
+	if (Scenario == TEXT("AIDriver"))
+	{
+		return RunAIDriverScenario(Params, OutRows);
+	}
+
+	if (Scenario == TEXT("Control"))
+	{
+		return RunControlScenario(Params, OutRows);
+	}
+
+	if (Scenario == TEXT("Reset"))
+	{
+		return RunResetScenario(Params, OutRows);
+	}
+
+	if (Scenario == TEXT("Hibernation"))
+	{
+		return RunHibernationScenario(Params, OutRows);
+	}
+
+	if (Scenario == TEXT("ServerSoak"))
+	{
+		return RunServerSoakScenario(Params, OutRows);
+	}
+
+	if (Scenario == TEXT("Snapshot"))
+	{
+		return RunSnapshotScenario(Params, OutRows);
+	}
+
+	if (Scenario == TEXT("WheelVisual"))
+	{
+		return RunWheelVisualScenario(Params, OutRows);
+	}
+
+	if (Scenario == TEXT("Surface"))
+	{
+		return RunSurfaceScenario(Params, OutRows);
+	}
+
+	if (Scenario == TEXT("Ground"))
+	{
+		return RunGroundScenario(Params, OutRows);
+	}
+
+	if (Scenario == TEXT("Contact"))
+	{
+		return RunContactScenario(Params, OutRows);
+	}
+
+	if (Scenario == TEXT("Persistence"))
+	{
+		return RunPersistenceScenario(Params, OutRows);
+	}
+
+	if (Scenario == TEXT("NetBandwidth"))
+	{
+		return RunNetBandwidthScenario(Params, OutRows);
+	}
+
+	UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("未知的场景 '%s'"), *Scenario);
+	return false;
+}
+
+bool USingularisVehicleBenchmarkCommandlet::RunSimulationScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const
+{
+	FString VehicleClassPath;
+	if (!FParse::Value(*Params, TEXT("VehicleClass="), VehicleClassPath))
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("缺少 -VehicleClass= 参数，需要一个带网格与车轮配置的 ABaseWheeledVehiclePawn 子类"));
+		return false;
+	}
+
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = LoadClass<ABaseWheeledVehiclePawn>(nullptr, *VehicleClassPath);
+	if (!VehicleClass)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法加载载具类 '%s'"), *VehicleClassPath);
+		return false;
+	}
+
+	// 确认测试的是本插件的车轮
+	for (const FChaosWheelSetup& WheelSetup : VehicleClass.GetDefaultObject()->GetChaosVehicleMovement()->WheelSetups)
+	{
+		if (!WheelSetup.WheelClass || !(WheelSetup.WheelClass->IsChildOf<UBaseVehicleWheelFront>() || WheelSetup.WheelClass->IsChildOf<UBaseVehicleWheelRear>()))
+		{
+			UE_LOG(LogSingularisVehicleBenchmark,
+			       Warning,
+			       TEXT("车轮 '%s' 不是 UBaseVehicleWheelFront/UBaseVehicleWheelRear 的子类，结果可能与插件默认配置不同"),
+			       *GetNameSafe(WheelSetup.WheelClass));
+		}
+	}
+
+	UCurveFloat* TorqueCurve = LoadObject<UCurveFloat>(nullptr, SingularisVehicleBenchmark::TorqueCurvePath);
+	if (!TorqueCurve)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Warning, TEXT("无法加载扭矩曲线 '%s'，使用载具类自身的配置"), SingularisVehicleBenchmark::TorqueCurvePath);
+	}
+
+	FString MapPath;
+	FParse::Value(*Params, TEXT("Map="), MapPath);
+
+	int32 NumFrames = 600;
+	int32 NumWarmupFrames = 60;
+	float DeltaTime = 1.0f / 60.0f;
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("WarmupFrames="), NumWarmupFrames);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+	const bool bAsyncInput = FParse::Param(*Params, TEXT("AsyncInput"));
+
+	UWorld* World = CreateBenchmarkWorld(MapPath);
+	if (!World)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法创建测试世界 '%s'"), *MapPath);
+		return false;
+	}
+
+	// 通过物理场景的前后回调测量物理耗时
+	double PhysicsStartTime = 0.0;
+	double PhysicsSeconds = 0.0;
+	FPhysScene* PhysScene = World->GetPhysicsScene();
+	const FDelegateHandle PreTickHandle = PhysScene->OnPhysScenePreTick.AddLambda([&PhysicsStartTime](auto*, float)
+	{
+		PhysicsStartTime = FPlatformTime::Seconds();
+	});
+	const FDelegateHandle PostTickHandle = PhysScene->OnPhysScenePostTick.AddLambda([&PhysicsStartTime, &PhysicsSeconds](auto*)
+	{
+		PhysicsSeconds += FPlatformTime::Seconds() - PhysicsStartTime;
+	});
+
+	TArray<ABaseWheeledVehiclePawn*> Vehicles;
+	for (const int32 NumVehicles : ParseCounts(Params, {1, 16, 64, 256}))
+	{
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		const uint64 MemoryBefore = FPlatformMemory::GetStats().UsedPhysical;
+
+		// 生成载具，按方阵排列
+		const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumVehicles)));
+		Vehicles.Reset(NumVehicles);
+		const double SpawnStartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumVehicles; ++Index)
+		{
+			const FVector Location((Index % GridSize) * SingularisVehicleBenchmark::VehicleSpacing,
+			                       (Index / GridSize) * SingularisVehicleBenchmark::VehicleSpacing,
+			                       100.0f);
+			const FTransform SpawnTransform(Location);
+
+			ABaseWheeledVehiclePawn* Vehicle = World->SpawnActorDeferred<ABaseWheeledVehiclePawn>(
+				VehicleClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+			if (!Vehicle)
+			{
+				continue;
+			}
+
+			if (TorqueCurve)
+			{
+				// 组件在 FinishSpawning 时才注册并创建物理载具，此时设置的曲线会被烘焙进模拟
+				Vehicle->GetChaosVehicleMovement()->EngineSetup.TorqueCurve.ExternalCurve = TorqueCurve;
+			}
+
+			if (bAsyncInput && Vehicle->GetSingularisVehicleMovement())
+			{
+				Vehicle->GetSingularisVehicleMovement()->bUseAsyncPhysicsInput = true;
+			}
+
+			Vehicle->FinishSpawning(SpawnTransform);
+			Vehicles.Add(Vehicle);
+		}
+		const double SpawnSeconds = FPlatformTime::Seconds() - SpawnStartTime;
+		const uint64 MemoryAfter = FPlatformMemory::GetStats().UsedPhysical;
+
+		// 预热，让载具落地并稳定
+		for (int32 Frame = 0; Frame < NumWarmupFrames; ++Frame)
+		{
+			World->Tick(LEVELTICK_All, DeltaTime);
+		}
+
+		// 正式测量，同时统计载具模拟自身每一步的耗时（转向查找、悬挂检测、路面响应与快照发布）
+		PhysicsSeconds = 0.0;
+		double FrameSeconds = 0.0;
+		int64 NumSteps = 0;
+		double StepSeconds = 0.0;
+		FSingularisVehicleSimulation::ConsumeStepStats(NumSteps, StepSeconds);
+		FSingularisVehicleSimulation::SetCollectStepStats(true);
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			ApplyScriptedInputs(Vehicles, Frame, DeltaTime);
+
+			const double FrameStartTime = FPlatformTime::Seconds();
+			World->Tick(LEVELTICK_All, DeltaTime);
+			FrameSeconds += FPlatformTime::Seconds() - FrameStartTime;
+			++GFrameCounter;
+		}
+		FSingularisVehicleSimulation::SetCollectStepStats(false);
+		FSingularisVehicleSimulation::ConsumeStepStats(NumSteps, StepSeconds);
+
+		const double PhysicsMs = PhysicsSeconds * 1000.0 / FMath::Max(NumFrames, 1);
+		const double GameThreadMs = FMath::Max(FrameSeconds * 1000.0 / FMath::Max(NumFrames, 1) - PhysicsMs, 0.0);
+		const double NumSpawned = FMath::Max(Vehicles.Num(), 1);
+
+		// 异步输入模式单独成行，避免与同步模式的基线混在一起比较
+		auto AddRow = [&OutRows, NumVehicles, bAsyncInput](const TCHAR* Metric, const double Value)
+		{
+			OutRows.Add({bAsyncInput ? TEXT("SimulationAsyncInput") : TEXT("Simulation"), NumVehicles, Metric, Value});
+		};
+		AddRow(TEXT("GameThreadMs"), GameThreadMs);
+		AddRow(TEXT("PhysicsMs"), PhysicsMs);
+		AddRow(TEXT("GameThreadMsPerVehicle"), GameThreadMs / NumSpawned);
+		AddRow(TEXT("PhysicsMsPerVehicle"), PhysicsMs / NumSpawned);
+		AddRow(TEXT("MemoryPerVehicleKB"), static_cast<double>(MemoryAfter > MemoryBefore ? MemoryAfter - MemoryBefore : 0) / 1024.0 / NumSpawned);
+		AddRow(TEXT("SpawnMsPerVehicle"), SpawnSeconds * 1000.0 / NumSpawned);
+		AddRow(TEXT("VehicleStepUs"), StepSeconds * 1.0e6 / FMath::Max<int64>(NumSteps, 1));
+
+		UE_LOG(LogSingularisVehicleBenchmark,
+		       Display,
+		       TEXT("%4d 辆：游戏线程 %.3f ms，物理 %.3f ms，单车单步模拟 %.2f us（%lld 步），生成 %.3f ms/辆"),
+		       NumVehicles,
+		       GameThreadMs,
+		       PhysicsMs,
+		       StepSeconds * 1.0e6 / FMath::Max<int64>(NumSteps, 1),
+		       NumSteps,
+		       SpawnSeconds * 1000.0 / NumSpawned);
+
+		for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+		{
+			Vehicle->Destroy();
+		}
+		World->Tick(LEVELTICK_All, DeltaTime);
+	}
+
+	PhysScene->OnPhysScenePreTick.Remove(PreTickHandle);
+	PhysScene->OnPhysScenePostTick.Remove(PostTickHandle);
+	DestroyBenchmarkWorld(World);
+	return true;
+}
+
+bool USingularisVehicleBenchmarkCommandlet::RunCurveLUTScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const
+{
+	const UCurveFloat* TorqueCurve = LoadObject<UCurveFloat>(nullptr, SingularisVehicleBenchmark::TorqueCurvePath);
+	if (!TorqueCurve)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法加载扭矩曲线 '%s'"), SingularisVehicleBenchmark::TorqueCurvePath);
+		return false;
+	}
+
+	int32 NumSamples = 4000000;
+	FParse::Value(*Params, TEXT("Samples="), NumSamples);
+	NumSamples = FMath::Max(NumSamples, 1);
+
+	FSingularisBakedCurve BakedCurve;
+	BakedCurve.Bake(TorqueCurve->FloatCurve);
+
+	// 在曲线范围内外各取一些随机转速，覆盖端点钳制
+	const float Range = BakedCurve.GetMaxTime() - BakedCurve.GetMinTime();
+	FRandomStream RandomStream(0x5EED);
+	TArray<float> Times;
+	Times.SetNumUninitialized(NumSamples);
+	for (float& Time : Times)
+	{
+		Time = BakedCurve.GetMinTime() + RandomStream.FRandRange(-0.05f, 1.05f) * Range;
+	}
+
+	TArray<float> Values;
+	Values.SetNumUninitialized(NumSamples);
+
+	// 三种求值方式的累加结果互相校验，同时防止编译器优化掉循环
+	double Checksum[3] = {};
+
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		Values[Index] = TorqueCurve->FloatCurve.Eval(Times[Index]);
+	}
+	const double RichSeconds = FPlatformTime::Seconds() - StartTime;
+	for (const float Value : Values)
+	{
+		Checksum[0] += Value;
+	}
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		Values[Index] = BakedCurve.Evaluate(Times[Index]);
+	}
+	const double BakedSeconds = FPlatformTime::Seconds() - StartTime;
+	for (const float Value : Values)
+	{
+		Checksum[1] += Value;
+	}
+
+	StartTime = FPlatformTime::Seconds();
+	BakedCurve.EvaluateBatch(Times.GetData(), Values.GetData(), NumSamples);
+	const double BatchSeconds = FPlatformTime::Seconds() - StartTime;
+	for (const float Value : Values)
+	{
+		Checksum[2] += Value;
+	}
+
+	const float MaxError = BakedCurve.ComputeMaxError(TorqueCurve->FloatCurve);
+
+	auto AddRow = [&OutRows, NumSamples](const TCHAR* Metric, const double Value)
+	{
+		OutRows.Add({TEXT("CurveLUT"), NumSamples, Metric, Value});
+	};
+	AddRow(TEXT("RichCurveNsPerSample"), RichSeconds * 1.0e9 / NumSamples);
+	AddRow(TEXT("BakedNsPerSample"), BakedSeconds * 1.0e9 / NumSamples);
+	AddRow(TEXT("BakedBatchNsPerSample"), BatchSeconds * 1.0e9 / NumSamples);
+	AddRow(TEXT("MaxError"), MaxError);
+
+	UE_LOG(LogSingularisVehicleBenchmark,
+	       Display,
+	       TEXT("%d 次求值：富曲线 %.2f ns，查找表 %.2f ns，批量 %.2f ns，最大误差 %.5f，校验和 %.3f/%.3f/%.3f"),
+	       NumSamples,
+	       RichSeconds * 1.0e9 / NumSamples,
+	       BakedSeconds * 1.0e9 / NumSamples,
+	       BatchSeconds * 1.0e9 / NumSamples,
+	       MaxError,
+	       Checksum[0],
+	       Checksum[1],
+	       Checksum[2]);
+
+	return true;
+}
+
+bool USingularisVehicleBenchmarkCommandlet::RunTrafficScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const
+{
+	FString MapPath;
+	FParse::Value(*Params, TEXT("Map="), MapPath);
+
+	int32 NumFrames = 600;
+	int32 NumWarmupFrames = 60;
+	float DeltaTime = 1.0f / 60.0f;
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("WarmupFrames="), NumWarmupFrames);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+
+	UWorld* World = CreateBenchmarkWorld(MapPath);
+	USingularisVehicleTrafficSubsystem* Traffic = World ? World->GetSubsystem<USingularisVehicleTrafficSubsystem>() : nullptr;
+	if (!Traffic)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法创建测试世界或交通子系统 '%s'"), *MapPath);
+		if (World)
+		{
+			DestroyBenchmarkWorld(World);
+		}
+		return false;
+	}
+
+	// 同心的环形车道，实体均匀分布在各条车道上
+	TArray<int32> LaneIndices;
+	for (int32 LaneIndex = 0; LaneIndex < SingularisVehicleBenchmark::NumTrafficLanes; ++LaneIndex)
+	{
+		const float Radius = SingularisVehicleBenchmark::TrafficLaneRadius + LaneIndex * SingularisVehicleBenchmark::TrafficLaneSpacing;
+		TArray<FVector> Points;
+		for (int32 PointIndex = 0; PointIndex < 64; ++PointIndex)
+		{
+			const float Angle = UE_TWO_PI * PointIndex / 64;
+			Points.Add(FVector(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 100.0f));
+		}
+		LaneIndices.Add(Traffic->RegisterLanePoints(Points, true, 1400.0f));
+	}
+
+	for (const int32 NumEntities : ParseCounts(Params, {5000}))
+	{
+		for (int32 Index = 0; Index < LaneIndices.Num(); ++Index)
+		{
+			const int32 NumOnLane = NumEntities / LaneIndices.Num() + (Index < NumEntities % LaneIndices.Num() ? 1 : 0);
+			Traffic->SpawnTraffic(LaneIndices[Index], NumOnLane);
+		}
+
+		for (int32 Frame = 0; Frame < NumWarmupFrames; ++Frame)
+		{
+			World->Tick(LEVELTICK_All, DeltaTime);
+		}
+
+		double FrameSeconds = 0.0;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const double FrameStartTime = FPlatformTime::Seconds();
+			World->Tick(LEVELTICK_All, DeltaTime);
+			FrameSeconds += FPlatformTime::Seconds() - FrameStartTime;
+			++GFrameCounter;
+		}
+
+		const double FrameMs = FrameSeconds * 1000.0 / FMath::Max(NumFrames, 1);
+		OutRows.Add({TEXT("Traffic"), NumEntities, TEXT("FrameMs"), FrameMs});
+		OutRows.Add({TEXT("Traffic"), NumEntities, TEXT("UsPerEntity"), FrameMs * 1000.0 / FMath::Max(Traffic->GetNumEntities(), 1)});
+
+		UE_LOG(LogSingularisVehicleBenchmark, Display, TEXT("%5d 个交通实体：每帧 %.3f ms"), Traffic->GetNumEntities(), FrameMs);
+
+		Traffic->ClearTraffic();
+	}
+
+	DestroyBenchmarkWorld(World);
+	return true;
+}
+
+bool USingularisVehicleBenchmarkCommandlet::RunLightsScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const
+{
+	FString VehicleClassPath;
+	FParse::Value(*Params, TEXT("VehicleClass="), VehicleClassPath);
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = LoadClass<ABaseWheeledVehiclePawn>(nullptr, *VehicleClassPath);
+	if (!VehicleClass)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法加载载具类 '%s'，灯光场景需要 -VehicleClass="), *VehicleClassPath);
+		return false;
+	}
+
+	FString MapPath;
+	FParse::Value(*Params, TEXT("Map="), MapPath);
+
+	int32 NumFrames = 600;
+	float DeltaTime = 1.0f / 60.0f;
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+
+	UWorld* World = CreateBenchmarkWorld(MapPath);
+	if (!World)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法创建测试世界 '%s'"), *MapPath);
+		return false;
+	}
+
+	for (const int32 NumVehicles : ParseCounts(Params, {500}))
+	{
+		TArray<ABaseWheeledVehiclePawn*> Vehicles;
+		TArray<USingularisVehicleLightComponent*> Lights;
+		SpawnVehicleGrid(World, VehicleClass, NumVehicles, Vehicles);
+		for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+		{
+			USingularisVehicleLightComponent* Light = Vehicle->FindComponentByClass<USingularisVehicleLightComponent>();
+			if (!Light)
+			{
+				Light = NewObject<USingularisVehicleLightComponent>(Vehicle);
+				Vehicle->AddInstanceComponent(Light);
+				Light->RegisterComponent();
+			}
+			Lights.Add(Light);
+		}
+
+		for (int32 Frame = 0; Frame < 60; ++Frame)
+		{
+			World->Tick(LEVELTICK_All, DeltaTime);
+			++GFrameCounter;
+		}
+
+		// 单帧开销：关闭组件 Tick，每帧在世界 Tick 之后统一更新并计时
+		for (USingularisVehicleLightComponent* Light : Lights)
+		{
+			Light->SetComponentTickEnabled(false);
+		}
+
+		double UpdateSeconds = 0.0;
+		int64 NumChanges = 0;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			ApplyScriptedInputs(Vehicles, Frame, DeltaTime);
+			World->Tick(LEVELTICK_All, DeltaTime);
+			++GFrameCounter;
+
+			const double StartTime = FPlatformTime::Seconds();
+			for (USingularisVehicleLightComponent* Light : Lights)
+			{
+				NumChanges += Light->UpdateFromMovement() ? 1 : 0;
+			}
+			UpdateSeconds += FPlatformTime::Seconds() - StartTime;
+		}
+
+		const double UpdateMs = UpdateSeconds * 1000.0 / FMath::Max(NumFrames, 1);
+		OutRows.Add({TEXT("Lights"), NumVehicles, TEXT("UpdateMs"), UpdateMs});
+		OutRows.Add({TEXT("Lights"), NumVehicles, TEXT("UpdateUsPerVehicle"), UpdateMs * 1000.0 / FMath::Max(Vehicles.Num(), 1)});
+		OutRows.Add({TEXT("Lights"), NumVehicles, TEXT("ChangesPerFrame"), static_cast<double>(NumChanges) / FMath::Max(NumFrames, 1), ESingularisVehicleBenchmarkGate::None});
+
+		UE_LOG(LogSingularisVehicleBenchmark,
+		       Display,
+		       TEXT("%4d 辆：灯光更新 %.3f ms/帧，%.2f 次变化/帧"),
+		       NumVehicles,
+		       UpdateMs,
+		       static_cast<double>(NumChanges) / FMath::Max(NumFrames, 1));
+
+		for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+		{
+			Vehicle->Destroy();
+		}
+		World->Tick(LEVELTICK_All, DeltaTime);
+	}
+
+	DestroyBenchmarkWorld(World);
+	return true;
+}
+
+bool USingularisVehicleBenchmarkCommandlet::RunAIDriverScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const
+{
+	FString VehicleClassPath;
+	FParse::Value(*Params, TEXT("VehicleClass="), VehicleClassPath);
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = LoadClass<ABaseWheeledVehiclePawn>(nullptr, *VehicleClassPath);
+	if (!VehicleClass)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法加载载具类 '%s'，AI 驾驶场景需要 -VehicleClass="), *VehicleClassPath);
+		return false;
+	}
+
+	FString MapPath;
+	FParse::Value(*Params, TEXT("Map="), MapPath);
+
+	int32 NumFrames = 300;
+	int32 NumWarmupFrames = 60;
+	float DeltaTime = 1.0f / 60.0f;
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("WarmupFrames="), NumWarmupFrames);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+
+	IConsoleVariable* ForceSingleThread = IConsoleManager::Get().FindConsoleVariable(TEXT("SingularisVehicle.AIDriver.ForceSingleThread"));
+	UWorld* World = CreateBenchmarkWorld(MapPath);
+	USingularisVehicleAIDriverSubsystem* Driver = World ? World->GetSubsystem<USingularisVehicleAIDriverSubsystem>() : nullptr;
+	if (!Driver || !ForceSingleThread)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法创建测试世界或 AI 驾驶子系统 '%s'"), *MapPath);
+		if (World)
+		{
+			DestroyBenchmarkWorld(World);
+		}
+		return false;
+	}
+
+	// 与交通场景相同的同心环形路径
+	constexpr int32 NumRingPoints = 64;
+	TArray<int32> PathIndices;
+	for (int32 LaneIndex = 0; LaneIndex < SingularisVehicleBenchmark::NumTrafficLanes; ++LaneIndex)
+	{
+		const float Radius = SingularisVehicleBenchmark::TrafficLaneRadius + LaneIndex * SingularisVehicleBenchmark::TrafficLaneSpacing;
+		TArray<FVector> Points;
+		for (int32 PointIndex = 0; PointIndex < NumRingPoints; ++PointIndex)
+		{
+			const float Angle = UE_TWO_PI * PointIndex / NumRingPoints;
+			Points.Add(FVector(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 100.0f));
+		}
+		PathIndices.Add(Driver->RegisterPathPoints(Points, true, 1400.0f));
+	}
+
+	const int32 NumThreads = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+
+	for (const int32 NumVehicles : ParseCounts(Params, {64, 256, 1024}))
+	{
+		// 载具沿各条环形路径均匀摆放，车头朝向路径切线
+		TArray<ABaseWheeledVehiclePawn*> Vehicles;
+		for (int32 Index = 0; Index < NumVehicles; ++Index)
+		{
+			const int32 LaneIndex = Index % PathIndices.Num();
+			const int32 NumOnLane = NumVehicles / PathIndices.Num() + (LaneIndex < NumVehicles % PathIndices.Num() ? 1 : 0);
+			const float Radius = SingularisVehicleBenchmark::TrafficLaneRadius + LaneIndex * SingularisVehicleBenchmark::TrafficLaneSpacing;
+			const float Angle = UE_TWO_PI * (Index / PathIndices.Num()) / FMath::Max(NumOnLane, 1);
+			const FVector Location(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 100.0f);
+			const FRotator Rotation(0.0f, FMath::RadiansToDegrees(Angle) + 90.0f, 0.0f);
+
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			if (ABaseWheeledVehiclePawn* Vehicle = World->SpawnActor<ABaseWheeledVehiclePawn>(VehicleClass, FTransform(Rotation, Location), SpawnParameters))
+			{
+				Driver->AssignVehicle(Vehicle, PathIndices[LaneIndex]);
+				Vehicles.Add(Vehicle);
+			}
+		}
+
+		for (int32 Frame = 0; Frame < NumWarmupFrames; ++Frame)
+		{
+			World->Tick(LEVELTICK_All, DeltaTime);
+			++GFrameCounter;
+		}
+
+		// 分别测量并行与强制单线程下的各阶段耗时
+		auto Measure = [World, Driver, NumFrames, DeltaTime](FSingularisAIDriverTimings& OutTotal)
+		{
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				World->Tick(LEVELTICK_All, DeltaTime);
+				++GFrameCounter;
+
+				const FSingularisAIDriverTimings& Timings = Driver->GetLastTimings();
+				OutTotal.GatherSeconds += Timings.GatherSeconds;
+				OutTotal.ComputeSeconds += Timings.ComputeSeconds;
+				OutTotal.WriteSeconds += Timings.WriteSeconds;
+				OutTotal.NumDriven = FMath::Max(OutTotal.NumDriven, Timings.NumDriven);
+			}
+		};
+
+		FSingularisAIDriverTimings Parallel;
+		FSingularisAIDriverTimings Serial;
+		Measure(Parallel);
+		ForceSingleThread->Set(true, ECVF_SetByCode);
+		Measure(Serial);
+		ForceSingleThread->Set(false, ECVF_SetByCode);
+
+		double SpeedSum = 0.0;
+		for (const ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+		{
+			SpeedSum += Vehicle->GetChaosVehicleMovement()->GetForwardSpeed();
+		}
+
+		const double FrameScale = 1.0e6 / FMath::Max(NumFrames, 1) / FMath::Max(Parallel.NumDriven, 1);
+		const double GatherUs = Parallel.GatherSeconds * FrameScale;
+		const double ComputeUs = Parallel.ComputeSeconds * FrameScale;
+		const double WriteUs = Parallel.WriteSeconds * FrameScale;
+		const double SerialComputeUs = Serial.ComputeSeconds * FrameScale;
+		const double Speedup = Serial.ComputeSeconds / FMath::Max(Parallel.ComputeSeconds, UE_DOUBLE_SMALL_NUMBER);
+		const double MeanSpeedKmh = SpeedSum / FMath::Max(Vehicles.Num(), 1) * 0.036;
+
+		OutRows.Add({TEXT("AIDriver"), NumVehicles, TEXT("GatherUsPerVehicle"), GatherUs});
+		OutRows.Add({TEXT("AIDriver"), NumVehicles, TEXT("ComputeUsPerVehicle"), ComputeUs});
+		OutRows.Add({TEXT("AIDriver"), NumVehicles, TEXT("WriteUsPerVehicle"), WriteUs});
+		OutRows.Add({TEXT("AIDriver"), NumVehicles, TEXT("TotalUsPerVehicle"), GatherUs + ComputeUs + WriteUs});
+		OutRows.Add({TEXT("AIDriver"), NumVehicles, TEXT("SingleThreadComputeUsPerVehicle"), SerialComputeUs});
+		OutRows.Add({TEXT("AIDriver"), NumVehicles, TEXT("ParallelSpeedup"), Speedup, ESingularisVehicleBenchmarkGate::HigherIsBetter});
+
+		// 线程数取决于机器，车速只说明载具确实在行驶，两者都只记录
+		OutRows.Add({TEXT("AIDriver"), NumVehicles, TEXT("Threads"), static_cast<double>(NumThreads), ESingularisVehicleBenchmarkGate::None});
+		OutRows.Add({TEXT("AIDriver"), NumVehicles, TEXT("MeanSpeedKmh"), MeanSpeedKmh, ESingularisVehicleBenchmarkGate::None});
+
+		UE_LOG(LogSingularisVehicleBenchmark,
+		       Display,
+		       TEXT("%4d 辆：收集 %.3f us/辆，计算 %.3f us/辆（单线程 %.3f，%d 线程加速 %.2fx），提交 %.3f us/辆，平均车速 %.1f km/h"),
+		       NumVehicles,
+		       GatherUs,
+		       ComputeUs,
+		       SerialComputeUs,
+		       NumThreads,
+		       Speedup,
+		       WriteUs,
+		       MeanSpeedKmh);
+
+		for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+		{
+			Vehicle->Destroy();
+		}
+		World->Tick(LEVELTICK_All, DeltaTime);
+	}
+
+	DestroyBenchmarkWorld(World);
+	return true;
+}
+
+bool USingularisVehicleBenchmarkCommandlet::RunControlScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const
+{
+	FString VehicleClassPath;
+	FParse::Value(*Params, TEXT("VehicleClass="), VehicleClassPath);
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = LoadClass<ABaseWheeledVehiclePawn>(nullptr, *VehicleClassPath);
+	if (!VehicleClass)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法加载载具类 '%s'，控制帧场景需要 -VehicleClass="), *VehicleClassPath);
+		return false;
+	}
+
+	FString MapPath;
+	FParse::Value(*Params, TEXT("Map="), MapPath);
+
+	int32 NumFrames = 600;
+	float DeltaTime = 1.0f / 60.0f;
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+
+	UWorld* World = CreateBenchmarkWorld(MapPath);
+	USingularisVehicleControlSubsystem* Control = World ? World->GetSubsystem<USingularisVehicleControlSubsystem>() : nullptr;
+	if (!Control)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法创建测试世界或控制子系统 '%s'"), *MapPath);
+		if (World)
+		{
+			DestroyBenchmarkWorld(World);
+		}
+		return false;
+	}
+
+	for (const int32 NumVehicles : ParseCounts(Params, {500}))
+	{
+		TArray<ABaseWheeledVehiclePawn*> Vehicles;
+		SpawnVehicleGrid(World, VehicleClass, NumVehicles, Vehicles);
+
+		// 逐车逐通道直接写入运动组件
+		double DirectSeconds = 0.0;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			ApplyScriptedInputs(Vehicles, Frame, DeltaTime);
+			DirectSeconds += FPlatformTime::Seconds() - StartTime;
+
+			World->Tick(LEVELTICK_All, DeltaTime);
+			++GFrameCounter;
+		}
+
+		// 提交控制帧并由子系统批量写入；世界 Tick 中的批处理随后没有变化可写
+		double BatchedSeconds = 0.0;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Index = 0; Index < Vehicles.Num(); ++Index)
+			{
+				Vehicles[Index]->SubmitControlFrame(MakeScriptedControlFrame(Index, Frame, DeltaTime));
+			}
+			Control->ApplyControlFrames(DeltaTime);
+			BatchedSeconds += FPlatformTime::Seconds() - StartTime;
+
+			World->Tick(LEVELTICK_All, DeltaTime);
+			++GFrameCounter;
+		}
+
+		const double DirectMs = DirectSeconds * 1000.0 / FMath::Max(NumFrames, 1);
+		const double BatchedMs = BatchedSeconds * 1000.0 / FMath::Max(NumFrames, 1);
+		OutRows.Add({TEXT("Control"), NumVehicles, TEXT("DirectMs"), DirectMs});
+		OutRows.Add({TEXT("Control"), NumVehicles, TEXT("BatchedMs"), BatchedMs});
+
+		UE_LOG(LogSingularisVehicleBenchmark,
+		       Display,
+		       TEXT("%4d 辆：逐通道写入 %.3f ms/帧，控制帧批处理 %.3f ms/帧"),
+		       NumVehicles,
+		       DirectMs,
+		       BatchedMs);
+
+		for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+		{
+			Vehicle->Destroy();
+		}
+		World->Tick(LEVELTICK_All, DeltaTime);
+	}
+
+	DestroyBenchmarkWorld(World);
+	return true;
+}
+
+bool USingularisVehicleBenchmarkCommandlet::RunResetScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const
+{
+	FString VehicleClassPath;
+	FParse::Value(*Params, TEXT("VehicleClass="), VehicleClassPath);
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = LoadClass<ABaseWheeledVehiclePawn>(nullptr, *VehicleClassPath);
+	if (!VehicleClass)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法加载载具类 '%s'，重置场景需要 -VehicleClass="), *VehicleClassPath);
+		return false;
+	}
+
+	FString MapPath;
+	FParse::Value(*Params, TEXT("Map="), MapPath);
+
+	int32 NumRounds = 10;
+	float DeltaTime = 1.0f / 60.0f;
+	FParse::Value(*Params, TEXT("Rounds="), NumRounds);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+
+	// 每轮之间驾驶的帧数，足够记录下几个安全位置
+	constexpr int32 DriveFrames = 180;
+
+	// 请求发出后最多等待的帧数
+	constexpr int32 MaxResolveFrames = 10;
+
+	UWorld* World = CreateBenchmarkWorld(MapPath);
+	USingularisVehicleResetSubsystem* ResetSubsystem = World ? World->GetSubsystem<USingularisVehicleResetSubsystem>() : nullptr;
+	if (!ResetSubsystem)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法创建测试世界或重置子系统 '%s'"), *MapPath);
+		if (World)
+		{
+			DestroyBenchmarkWorld(World);
+		}
+		return false;
+	}
+
+	bool bPassed = true;
+	int32 Frame = 0;
+	for (const int32 NumVehicles : ParseCounts(Params, {50}))
+	{
+		TArray<ABaseWheeledVehiclePawn*> Vehicles;
+		SpawnVehicleGrid(World, VehicleClass, NumVehicles, Vehicles);
+
+		double DriveSeconds = 0.0;
+		double RequestSeconds = 0.0;
+		double ResolveSeconds = 0.0;
+		int64 NumDriveFrames = 0;
+		int64 NumResolveFrames = 0;
+		for (int32 Round = 0; Round < NumRounds; ++Round)
+		{
+			for (int32 DriveFrame = 0; DriveFrame < DriveFrames; ++DriveFrame, ++Frame)
+			{
+				ApplyScriptedInputs(Vehicles, Frame, DeltaTime);
+
+				const double StartTime = FPlatformTime::Seconds();
+				World->Tick(LEVELTICK_All, DeltaTime);
+				DriveSeconds += FPlatformTime::Seconds() - StartTime;
+				++NumDriveFrames;
+				++GFrameCounter;
+			}
+
+			// 所有载具在同一帧请求重置
+			const double RequestStartTime = FPlatformTime::Seconds();
+			for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+			{
+				Vehicle->RequestSafeReset();
+			}
+			RequestSeconds += FPlatformTime::Seconds() - RequestStartTime;
+
+			int32 ResolveFrame = 0;
+			for (; ResolveFrame < MaxResolveFrames && ResetSubsystem->GetNumPendingResets() > 0; ++ResolveFrame, ++Frame)
+			{
+				const double StartTime = FPlatformTime::Seconds();
+				World->Tick(LEVELTICK_All, DeltaTime);
+				ResolveSeconds += FPlatformTime::Seconds() - StartTime;
+				++NumResolveFrames;
+				++GFrameCounter;
+			}
+
+			if (ResetSubsystem->GetNumPendingResets() > 0)
+			{
+				UE_LOG(LogSingularisVehicleBenchmark,
+				       Error,
+				       TEXT("第 %d 轮：%d 帧后仍有 %d 个重置请求未完成"),
+				       Round,
+				       MaxResolveFrames,
+				       ResetSubsystem->GetNumPendingResets());
+				bPassed = false;
+			}
+
+			for (const ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+			{
+				if (Vehicle->GetActorUpVector().Z < 0.95f)
+				{
+					UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("第 %d 轮：'%s' 重置后没有摆正"), Round, *Vehicle->GetName());
+					bPassed = false;
+				}
+			}
+		}
+
+		const double DriveFrameMs = DriveSeconds * 1000.0 / FMath::Max<int64>(NumDriveFrames, 1);
+		const double ResolveFrameMs = ResolveSeconds * 1000.0 / FMath::Max<int64>(NumResolveFrames, 1);
+		const double RequestMs = RequestSeconds * 1000.0 / FMath::Max(NumRounds, 1);
+		OutRows.Add({TEXT("Reset"), NumVehicles, TEXT("DriveFrameMs"), DriveFrameMs});
+		OutRows.Add({TEXT("Reset"), NumVehicles, TEXT("ResolveFrameMs"), ResolveFrameMs});
+		OutRows.Add({TEXT("Reset"), NumVehicles, TEXT("RequestMs"), RequestMs});
+		OutRows.Add({TEXT("Reset"), NumVehicles, TEXT("ResolveFrames"), static_cast<double>(NumResolveFrames) / FMath::Max(NumRounds, 1)});
+
+		UE_LOG(LogSingularisVehicleBenchmark,
+		       Display,
+		       TEXT("%4d 辆：驾驶 %.3f ms/帧，重置期间 %.3f ms/帧，发出请求 %.3f ms，平均 %.1f 帧完成"),
+		       NumVehicles,
+		       DriveFrameMs,
+		       ResolveFrameMs,
+		       RequestMs,
+		       static_cast<double>(NumResolveFrames) / FMath::Max(NumRounds, 1));
+
+		for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+		{
+			Vehicle->Destroy();
+		}
+		World->Tick(LEVELTICK_All, DeltaTime);
+	}
+
+	DestroyBenchmarkWorld(World);
+	return bPassed;
+}
+
+bool USingularisVehicleBenchmarkCommandlet::RunHibernationScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const
+{
+	FString VehicleClassPath;
+	FParse::Value(*Params, TEXT("VehicleClass="), VehicleClassPath);
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = LoadClass<ABaseWheeledVehiclePawn>(nullptr, *VehicleClassPath);
+	if (!VehicleClass || !VehicleClass->GetDefaultObject<ABaseWheeledVehiclePawn>()->GetHibernationMesh())
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法加载载具类 '%s' 或其没有设置 HibernationMesh，休眠场景需要 -VehicleClass="), *VehicleClassPath);
+		return false;
+	}
+
+	FString MapPath;
+	FParse::Value(*Params, TEXT("Map="), MapPath);
+
+	int32 NumFrames = 600;
+	int32 NumWakes = 32;
+	float DeltaTime = 1.0f / 60.0f;
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("Wakes="), NumWakes);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+
+	UWorld* World = CreateBenchmarkWorld(MapPath);
+	USingularisVehicleHibernationSubsystem* Hibernation = World ? World->GetSubsystem<USingularisVehicleHibernationSubsystem>() : nullptr;
+	IConsoleVariable* RestDelay = IConsoleManager::Get().FindConsoleVariable(TEXT("SingularisVehicle.Hibernation.RestDelay"));
+	if (!Hibernation || !RestDelay)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法创建测试世界或休眠子系统 '%s'"), *MapPath);
+		if (World)
+		{
+			DestroyBenchmarkWorld(World);
+		}
+		return false;
+	}
+
+	bool bPassed = true;
+
+	// 先检查自动休眠：静止的载具在缩短的等待时间后应全部变为实例
+	{
+		const float PreviousRestDelay = RestDelay->GetFloat();
+		RestDelay->Set(1.0f, ECVF_SetByCode);
+
+		TArray<ABaseWheeledVehiclePawn*> Vehicles;
+		SpawnVehicleGrid(World, VehicleClass, 16, Vehicles);
+		for (int32 Frame = 0; Frame < FMath::CeilToInt(5.0f / DeltaTime); ++Frame)
+		{
+			World->Tick(LEVELTICK_All, DeltaTime);
+			++GFrameCounter;
+		}
+
+		if (Hibernation->GetNumHibernated() != Vehicles.Num() || Hibernation->GetNumAwake() != 0)
+		{
+			UE_LOG(LogSingularisVehicleBenchmark,
+			       Error,
+			       TEXT("自动休眠：%d 辆中只有 %d 辆休眠，仍有 %d 辆醒着"),
+			       Vehicles.Num(),
+			       Hibernation->GetNumHibernated(),
+			       Hibernation->GetNumAwake());
+			bPassed = false;
+		}
+
+		RestDelay->Set(PreviousRestDelay, ECVF_SetByCode);
+		Hibernation->ClearHibernatedVehicles();
+	}
+
+	for (const int32 NumParked : ParseCounts(Params, {1000, 5000}))
+	{
+		const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumParked)));
+		TArray<FTransform> Transforms;
+		for (int32 Index = 0; Index < NumParked; ++Index)
+		{
+			Transforms.Emplace(FVector((Index % GridSize) * SingularisVehicleBenchmark::VehicleSpacing,
+			                           (Index / GridSize) * SingularisVehicleBenchmark::VehicleSpacing,
+			                           100.0f));
+		}
+
+		TArray<int32> Handles;
+		const double PlaceStartTime = FPlatformTime::Seconds();
+		Hibernation->AddParkedVehicles(VehicleClass, Transforms, Handles);
+		const double PlaceMs = (FPlatformTime::Seconds() - PlaceStartTime) * 1000.0;
+
+		// 大量休眠载具的稳态帧耗时，应与空世界相当
+		const double TickStartTime = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			World->Tick(LEVELTICK_All, DeltaTime);
+			++GFrameCounter;
+		}
+		const double FrameMs = (FPlatformTime::Seconds() - TickStartTime) * 1000.0 / FMath::Max(NumFrames, 1);
+
+		// 唤醒一部分，检查载具回到原处，再让它们重新休眠
+		const int32 NumToWake = FMath::Min(NumWakes, Handles.Num());
+		TArray<ABaseWheeledVehiclePawn*> Woken;
+		const double WakeStartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumToWake; ++Index)
+		{
+			if (ABaseWheeledVehiclePawn* Vehicle = Hibernation->WakeVehicle(Handles[Index]))
+			{
+				Woken.Add(Vehicle);
+			}
+		}
+		const double WakeUs = (FPlatformTime::Seconds() - WakeStartTime) * 1.0e6 / FMath::Max(NumToWake, 1);
+
+		for (int32 Index = 0; Index < Woken.Num(); ++Index)
+		{
+			if (!Woken[Index]->GetActorLocation().Equals(Transforms[Index].GetLocation(), 1.0f))
+			{
+				UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("'%s' 唤醒后没有回到休眠的位置"), *Woken[Index]->GetName());
+				bPassed = false;
+			}
+		}
+
+		if (Woken.Num() != NumToWake || Hibernation->GetNumHibernated() != NumParked - NumToWake)
+		{
+			UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("%d 辆中只唤醒了 %d 辆"), NumToWake, Woken.Num());
+			bPassed = false;
+		}
+
+		World->Tick(LEVELTICK_All, DeltaTime);
+		++GFrameCounter;
+
+		const double HibernateStartTime = FPlatformTime::Seconds();
+		for (ABaseWheeledVehiclePawn* Vehicle : Woken)
+		{
+			Hibernation->HibernateVehicle(Vehicle);
+		}
+		const double HibernateUs = (FPlatformTime::Seconds() - HibernateStartTime) * 1.0e6 / FMath::Max(Woken.Num(), 1);
+
+		if (Hibernation->GetNumHibernated() != NumParked)
+		{
+			UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("重新休眠后应有 %d 辆，实际 %d 辆"), NumParked, Hibernation->GetNumHibernated());
+			bPassed = false;
+		}
+
+		OutRows.Add({TEXT("Hibernation"), NumParked, TEXT("PlaceMs"), PlaceMs});
+		OutRows.Add({TEXT("Hibernation"), NumParked, TEXT("FrameMs"), FrameMs});
+		OutRows.Add({TEXT("Hibernation"), NumParked, TEXT("WakeUsPerVehicle"), WakeUs});
+		OutRows.Add({TEXT("Hibernation"), NumParked, TEXT("HibernateUsPerVehicle"), HibernateUs});
+		OutRows.Add({TEXT("Hibernation"), NumParked, TEXT("Models"), static_cast<double>(Hibernation->GetNumModels()), ESingularisVehicleBenchmarkGate::None});
+
+		UE_LOG(LogSingularisVehicleBenchmark,
+		       Display,
+		       TEXT("%5d 辆：放置 %.3f ms，稳态 %.3f ms/帧，唤醒 %.1f us/辆，休眠 %.1f us/辆，%d 个实例化网格"),
+		       NumParked,
+		       PlaceMs,
+		       FrameMs,
+		       WakeUs,
+		       HibernateUs,
+		       Hibernation->GetNumModels());
+
+		Hibernation->ClearHibernatedVehicles();
+		World->Tick(LEVELTICK_All, DeltaTime);
+	}
+
+	DestroyBenchmarkWorld(World);
+	return bPassed;
+}
+
+bool USingularisVehicleBenchmarkCommandlet::RunServerSoakScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const
+{
+	FString VehicleClassPath;
+	FParse::Value(*Params, TEXT("VehicleClass="), VehicleClassPath);
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = LoadClass<ABaseWheeledVehiclePawn>(nullptr, *VehicleClassPath);
+	if (!VehicleClass)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法加载载具类 '%s'，服务器长稳场景需要 -VehicleClass="), *VehicleClassPath);
+		return false;
+	}
+
+	FString MapPath;
+	FParse::Value(*Params, TEXT("Map="), MapPath);
+
+	int32 NumFrames = 3600;
+	int32 NumWarmupFrames = 60;
+	float DeltaTime = 1.0f / 60.0f;
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("WarmupFrames="), NumWarmupFrames);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+
+	IConsoleVariable* ForceServerLean = IConsoleManager::Get().FindConsoleVariable(TEXT("SingularisVehicle.ForceServerLean"));
+	UWorld* World = CreateBenchmarkWorld(MapPath);
+	if (!World || !ForceServerLean)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法创建测试世界 '%s'"), *MapPath);
+		if (World)
+		{
+			DestroyBenchmarkWorld(World);
+		}
+		return false;
+	}
+
+	// 客户端构建依次测量完整配置与精简配置；服务器构建只有精简配置
+	TArray<bool, TInlineAllocator<2>> LeanPasses;
+#if SINGULARISVEHICLE_WITH_COSMETICS
+	LeanPasses.Add(false);
+#endif
+	LeanPasses.Add(true);
+
+	const bool bPreviousForceServerLean = ForceServerLean->GetBool();
+	bool bPassed = true;
+	int32 Frame = 0;
+	for (const int32 NumVehicles : ParseCounts(Params, {64, 256}))
+	{
+		for (const bool bLean : LeanPasses)
+		{
+			ForceServerLean->Set(bLean, ECVF_SetByCode);
+#if SINGULARISVEHICLE_WITH_COSMETICS
+			const TCHAR* ScenarioName = bLean ? TEXT("ServerSoakLean") : TEXT("ServerSoakClient");
+#else
+			const TCHAR* ScenarioName = TEXT("ServerSoakServerBuild");
+#endif
+
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			const uint64 MemoryBefore = FPlatformMemory::GetStats().UsedPhysical;
+
+			TArray<ABaseWheeledVehiclePawn*> Vehicles;
+			SpawnVehicleGrid(World, VehicleClass, NumVehicles, Vehicles);
+
+			for (int32 WarmupFrame = 0; WarmupFrame < NumWarmupFrames; ++WarmupFrame, ++Frame)
+			{
+				World->Tick(LEVELTICK_All, DeltaTime);
+				++GFrameCounter;
+			}
+
+			// 精简配置销毁的组件要回收后才能体现在内存中
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			const uint64 MemorySpawned = FPlatformMemory::GetStats().UsedPhysical;
+
+			int32 NumComponents = 0;
+			int32 NumTickingComponents = 0;
+			for (const ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+			{
+				for (const UActorComponent* Component : Vehicle->GetComponents())
+				{
+					++NumComponents;
+					NumTickingComponents += Component->IsComponentTickEnabled() ? 1 : 0;
+				}
+			}
+
+			double FrameSeconds = 0.0;
+			for (int32 SoakFrame = 0; SoakFrame < NumFrames; ++SoakFrame, ++Frame)
+			{
+				ApplyScriptedInputs(Vehicles, Frame, DeltaTime);
+
+				const double FrameStartTime = FPlatformTime::Seconds();
+				World->Tick(LEVELTICK_All, DeltaTime);
+				FrameSeconds += FPlatformTime::Seconds() - FrameStartTime;
+				++GFrameCounter;
+			}
+
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			const uint64 MemorySoaked = FPlatformMemory::GetStats().UsedPhysical;
+
+			const double NumSpawned = FMath::Max(Vehicles.Num(), 1);
+			const double MemoryPerVehicleKB = static_cast<double>(MemorySpawned > MemoryBefore ? MemorySpawned - MemoryBefore : 0) / 1024.0 / NumSpawned;
+			const double GrowthPerVehicleKB = static_cast<double>(MemorySoaked > MemorySpawned ? MemorySoaked - MemorySpawned : 0) / 1024.0 / NumSpawned;
+			const double FrameMsPerVehicle = FrameSeconds * 1000.0 / FMath::Max(NumFrames, 1) / NumSpawned;
+
+			OutRows.Add({ScenarioName, NumVehicles, TEXT("MemoryPerVehicleKB"), MemoryPerVehicleKB});
+			OutRows.Add({ScenarioName, NumVehicles, TEXT("SoakGrowthPerVehicleKB"), GrowthPerVehicleKB});
+			OutRows.Add({ScenarioName, NumVehicles, TEXT("FrameMsPerVehicle"), FrameMsPerVehicle});
+			OutRows.Add({ScenarioName, NumVehicles, TEXT("ComponentsPerVehicle"), NumComponents / NumSpawned});
+			OutRows.Add({ScenarioName, NumVehicles, TEXT("TickingComponentsPerVehicle"), NumTickingComponents / NumSpawned});
+
+			UE_LOG(LogSingularisVehicleBenchmark,
+			       Display,
+			       TEXT("%s %4d 辆：%.1f KB/辆，长稳增长 %.2f KB/辆，%.4f ms/辆，组件 %.1f 个/辆（Tick %.1f 个）"),
+			       ScenarioName,
+			       NumVehicles,
+			       MemoryPerVehicleKB,
+			       GrowthPerVehicleKB,
+			       FrameMsPerVehicle,
+			       NumComponents / NumSpawned,
+			       NumTickingComponents / NumSpawned);
+
+			// 精简配置下不应留有任何相机
+			if (bLean)
+			{
+				for (const ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+				{
+					if (Vehicle->HasCameraRig() || Vehicle->GetFollowCamera())
+					{
+						UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("'%s' 在服务器精简配置下仍带有相机"), *Vehicle->GetName());
+						bPassed = false;
+						break;
+					}
+				}
+			}
+
+			for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+			{
+				Vehicle->Destroy();
+			}
+			World->Tick(LEVELTICK_All, DeltaTime);
+		}
+	}
+
+	ForceServerLean->Set(bPreviousForceServerLean, ECVF_SetByCode);
+	DestroyBenchmarkWorld(World);
+	return bPassed;
+}
+
+bool USingularisVehicleBenchmarkCommandlet::RunSnapshotScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const
+{
+	FString VehicleClassPath;
+	FParse::Value(*Params, TEXT("VehicleClass="), VehicleClassPath);
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = LoadClass<ABaseWheeledVehiclePawn>(nullptr, *VehicleClassPath);
+	if (!VehicleClass)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法加载载具类 '%s'，快照场景需要 -VehicleClass="), *VehicleClassPath);
+		return false;
+	}
+
+	FString MapPath;
+	FParse::Value(*Params, TEXT("Map="), MapPath);
+
+	int32 NumFrames = 600;
+	int32 NumWarmupFrames = 60;
+	float DeltaTime = 1.0f / 60.0f;
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("WarmupFrames="), NumWarmupFrames);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+
+	UWorld* World = CreateBenchmarkWorld(MapPath);
+	USingularisVehicleSnapshotSubsystem* Snapshots = World ? World->GetSubsystem<USingularisVehicleSnapshotSubsystem>() : nullptr;
+	if (!Snapshots)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法创建测试世界或快照子系统 '%s'"), *MapPath);
+		if (World)
+		{
+			DestroyBenchmarkWorld(World);
+		}
+		return false;
+	}
+
+	bool bPassed = true;
+	int32 Frame = 0;
+	for (const int32 NumVehicles : ParseCounts(Params, {256}))
+	{
+		TArray<ABaseWheeledVehiclePawn*> Vehicles;
+		SpawnVehicleGrid(World, VehicleClass, NumVehicles, Vehicles);
+
+		for (int32 WarmupFrame = 0; WarmupFrame < NumWarmupFrames; ++WarmupFrame, ++Frame)
+		{
+			World->Tick(LEVELTICK_All, DeltaTime);
+			++GFrameCounter;
+		}
+
+		// 后台线程在模拟进行的同时不停批量读取，检查读到的快照完整且序号不倒退
+		TArray<FSingularisVehicleSnapshotBufferRef> Buffers;
+		Snapshots->GetSnapshotBuffers(Buffers);
+
+		std::atomic<bool> bStopReader{false};
+		TFuture<TTuple<int64, int32>> Reader = Async(EAsyncExecution::Thread, [&bStopReader, Buffers]()
+		{
+			TArray<FSingularisVehicleSnapshot> ReadSnapshots;
+			TArray<uint32> LastStepIndices;
+			LastStepIndices.SetNumZeroed(Buffers.Num());
+
+			int64 NumReads = 0;
+			int32 NumErrors = 0;
+			while (!bStopReader.load(std::memory_order_relaxed))
+			{
+				FSingularisVehicleSnapshotBuffer::ReadAll(Buffers, ReadSnapshots);
+				for (int32 Index = 0; Index < ReadSnapshots.Num(); ++Index)
+				{
+					const FSingularisVehicleSnapshot& Snapshot = ReadSnapshots[Index];
+					const bool bConsistent = Snapshot.StepIndex >= LastStepIndices[Index]
+						&& Snapshot.NumWheels <= FSingularisVehicleSnapshot::MaxWheels
+						&& (Snapshot.WheelContactMask >> Snapshot.NumWheels) == 0;
+					NumErrors += bConsistent ? 0 : 1;
+					LastStepIndices[Index] = Snapshot.StepIndex;
+				}
+				NumReads += ReadSnapshots.Num();
+			}
+			return MakeTuple(NumReads, NumErrors);
+		});
+
+		// 游戏线程上对比逐车读取运动组件与一次批量读取快照
+		TArray<FSingularisVehicleSnapshot> FrameSnapshots;
+		double PollSeconds = 0.0;
+		double SnapshotSeconds = 0.0;
+		double Checksum = 0.0;
+		const double SoakStartTime = FPlatformTime::Seconds();
+		for (int32 MeasureFrame = 0; MeasureFrame < NumFrames; ++MeasureFrame, ++Frame)
+		{
+			ApplyScriptedInputs(Vehicles, Frame, DeltaTime);
+			World->Tick(LEVELTICK_All, DeltaTime);
+			++GFrameCounter;
+
+			const double PollStartTime = FPlatformTime::Seconds();
+			for (const ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+			{
+				const UChaosWheeledVehicleMovementComponent* Movement = Vehicle->GetChaosVehicleMovement();
+				Checksum += Movement->GetForwardSpeed() + Movement->GetEngineRotationSpeed() + Movement->GetCurrentGear();
+				Checksum += Movement->GetThrottleInput() + Movement->GetBrakeInput() + (Movement->IsMovingOnGround() ? 1.0 : 0.0);
+				for (const UChaosVehicleWheel* Wheel : Movement->Wheels)
+				{
+					Checksum += Wheel ? Wheel->GetSlipMagnitude() + Wheel->GetSlipAngle() : 0.0;
+				}
+			}
+			PollSeconds += FPlatformTime::Seconds() - PollStartTime;
+
+			const double SnapshotStartTime = FPlatformTime::Seconds();
+			Snapshots->ReadSnapshots(FrameSnapshots);
+			SnapshotSeconds += FPlatformTime::Seconds() - SnapshotStartTime;
+
+			for (const FSingularisVehicleSnapshot& Snapshot : FrameSnapshots)
+			{
+				Checksum -= Snapshot.ForwardSpeed;
+			}
+		}
+		const double SoakSeconds = FPlatformTime::Seconds() - SoakStartTime;
+
+		bStopReader.store(true, std::memory_order_relaxed);
+		const TTuple<int64, int32> ReaderResult = Reader.Get();
+
+		if (ReaderResult.Get<1>() > 0)
+		{
+			UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("后台线程读到 %d 个不完整或序号倒退的快照"), ReaderResult.Get<1>());
+			bPassed = false;
+		}
+
+		int32 NumUnpublished = 0;
+		for (const FSingularisVehicleSnapshot& Snapshot : FrameSnapshots)
+		{
+			NumUnpublished += Snapshot.StepIndex == 0 ? 1 : 0;
+		}
+		if (NumUnpublished > 0)
+		{
+			UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("%d 辆载具从未发布快照"), NumUnpublished);
+			bPassed = false;
+		}
+
+		const double NumRead = FMath::Max(FrameSnapshots.Num(), 1) * static_cast<double>(FMath::Max(NumFrames, 1));
+		const double PollUs = PollSeconds * 1.0e6 / NumRead;
+		const double SnapshotUs = SnapshotSeconds * 1.0e6 / NumRead;
+		const double BackgroundReadsPerSecond = ReaderResult.Get<0>() / FMath::Max(SoakSeconds, UE_DOUBLE_SMALL_NUMBER);
+
+		OutRows.Add({TEXT("Snapshot"), NumVehicles, TEXT("DirectPollUsPerVehicle"), PollUs});
+		OutRows.Add({TEXT("Snapshot"), NumVehicles, TEXT("SnapshotReadUsPerVehicle"), SnapshotUs});
+		OutRows.Add({TEXT("Snapshot"), NumVehicles, TEXT("BackgroundReadsPerSecond"), BackgroundReadsPerSecond, ESingularisVehicleBenchmarkGate::HigherIsBetter});
+
+		UE_LOG(LogSingularisVehicleBenchmark,
+		       Display,
+		       TEXT("%4d 辆：逐车读取运动组件 %.3f us/辆，批量读取快照 %.3f us/辆，后台线程 %.0f 次/秒（校验 %.1f）"),
+		       NumVehicles,
+		       PollUs,
+		       SnapshotUs,
+		       BackgroundReadsPerSecond,
+		       Checksum);
+
+		for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+		{
+			Vehicle->Destroy();
+		}
+		World->Tick(LEVELTICK_All, DeltaTime);
+	}
+
+	DestroyBenchmarkWorld(World);
+	return bPassed;
+}
+
+bool USingularisVehicleBenchmarkCommandlet::RunWheelVisualScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const
+{
+#if SINGULARISVEHICLE_WITH_COSMETICS
+	FString VehicleClassPath;
+	FParse::Value(*Params, TEXT("VehicleClass="), VehicleClassPath);
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = LoadClass<ABaseWheeledVehiclePawn>(nullptr, *VehicleClassPath);
+	if (!VehicleClass)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法加载载具类 '%s'，车轮表现场景需要 -VehicleClass="), *VehicleClassPath);
+		return false;
+	}
+
+	FString MapPath;
+	FParse::Value(*Params, TEXT("Map="), MapPath);
+
+	int32 NumFrames = 600;
+	int32 NumWarmupFrames = 60;
+	float DeltaTime = 1.0f / 60.0f;
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("WarmupFrames="), NumWarmupFrames);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+
+	IConsoleVariable* WheelVisualMode = IConsoleManager::Get().FindConsoleVariable(TEXT("SingularisVehicle.WheelVisual.Mode"));
+	IConsoleVariable* UpdateOffscreen = IConsoleManager::Get().FindConsoleVariable(TEXT("SingularisVehicle.WheelVisual.UpdateOffscreen"));
+	UWorld* World = CreateBenchmarkWorld(MapPath);
+	USingularisVehicleWheelVisualSubsystem* WheelVisuals = World ? World->GetSubsystem<USingularisVehicleWheelVisualSubsystem>() : nullptr;
+	if (!WheelVisuals || !WheelVisualMode || !UpdateOffscreen)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法创建测试世界或车轮表现子系统 '%s'"), *MapPath);
+		if (World)
+		{
+			DestroyBenchmarkWorld(World);
+		}
+		return false;
+	}
+
+	// 没有渲染时网格从不可见，两种方式都强制每帧更新：动画蓝图由全速层级的 AlwaysTickPoseAndRefreshBones 保证
+	const int32 PreviousMode = WheelVisualMode->GetInt();
+	const bool bPreviousUpdateOffscreen = UpdateOffscreen->GetBool();
+	UpdateOffscreen->Set(true, ECVF_SetByCode);
+
+	bool bPassed = true;
+	int32 Frame = 0;
+	for (const int32 NumVehicles : ParseCounts(Params, {200}))
+	{
+		// 依次测量动画蓝图与直接写入骨骼，每次重新生成载具，由注册时的模式决定使用哪种方式
+		double FrameMs[2] = {};
+		double NativeUpdateSeconds = 0.0;
+		for (int32 Pass = 0; Pass < 2; ++Pass)
+		{
+			const bool bNative = Pass == 1;
+			WheelVisualMode->Set(bNative ? 2 : 0, ECVF_SetByCode);
+
+			TArray<ABaseWheeledVehiclePawn*> Vehicles;
+			SpawnVehicleGrid(World, VehicleClass, NumVehicles, Vehicles);
+
+			int32 NumAnimInstances = 0;
+			for (const ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+			{
+				NumAnimInstances += Vehicle->GetMesh()->GetAnimInstance() ? 1 : 0;
+			}
+
+			if (!bNative && NumAnimInstances == 0)
+			{
+				UE_LOG(LogSingularisVehicleBenchmark, Warning, TEXT("'%s' 没有动画蓝图，对比没有意义"), *VehicleClassPath);
+			}
+			if (bNative && (NumAnimInstances > 0 || WheelVisuals->GetNumVehicles() != Vehicles.Num()))
+			{
+				UE_LOG(LogSingularisVehicleBenchmark,
+				       Error,
+				       TEXT("只有 %d/%d 辆载具改为直接写入车轮骨骼（仍有 %d 个动画实例），检查 WheelSetups 的 BoneName"),
+				       WheelVisuals->GetNumVehicles(),
+				       Vehicles.Num(),
+				       NumAnimInstances);
+				bPassed = false;
+			}
+
+			for (int32 WarmupFrame = 0; WarmupFrame < NumWarmupFrames; ++WarmupFrame, ++Frame)
+			{
+				World->Tick(LEVELTICK_All, DeltaTime);
+				++GFrameCounter;
+			}
+
+			double FrameSeconds = 0.0;
+			for (int32 MeasureFrame = 0; MeasureFrame < NumFrames; ++MeasureFrame, ++Frame)
+			{
+				ApplyScriptedInputs(Vehicles, Frame, DeltaTime);
+
+				const double FrameStartTime = FPlatformTime::Seconds();
+				World->Tick(LEVELTICK_All, DeltaTime);
+				FrameSeconds += FPlatformTime::Seconds() - FrameStartTime;
+				++GFrameCounter;
+
+				NativeUpdateSeconds += bNative ? WheelVisuals->GetLastUpdateSeconds() : 0.0;
+			}
+			FrameMs[Pass] = FrameSeconds * 1000.0 / FMath::Max(NumFrames, 1) / FMath::Max(Vehicles.Num(), 1);
+
+			for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+			{
+				Vehicle->Destroy();
+			}
+			World->Tick(LEVELTICK_All, DeltaTime);
+		}
+
+		// 两种方式其余工作相同，帧时间之差即动画蓝图的求值与骨骼刷新开销减去直接写入的开销
+		const double NativeUpdateUs = NativeUpdateSeconds * 1.0e6 / FMath::Max(NumFrames, 1) / FMath::Max(NumVehicles, 1);
+		const double SavedUs = (FrameMs[0] - FrameMs[1]) * 1000.0;
+
+		OutRows.Add({TEXT("WheelVisual"), NumVehicles, TEXT("AnimBlueprintFrameMsPerVehicle"), FrameMs[0]});
+		OutRows.Add({TEXT("WheelVisual"), NumVehicles, TEXT("NativeFrameMsPerVehicle"), FrameMs[1]});
+		OutRows.Add({TEXT("WheelVisual"), NumVehicles, TEXT("NativeUpdateUsPerVehicle"), NativeUpdateUs});
+		OutRows.Add({TEXT("WheelVisual"), NumVehicles, TEXT("AnimationSavedUsPerVehicle"), SavedUs, ESingularisVehicleBenchmarkGate::HigherIsBetter});
+
+		UE_LOG(LogSingularisVehicleBenchmark,
+		       Display,
+		       TEXT("%4d 辆：动画蓝图 %.4f ms/辆，直接写入 %.4f ms/辆（车轮更新 %.3f us/辆），每辆节省 %.3f us"),
+		       NumVehicles,
+		       FrameMs[0],
+		       FrameMs[1],
+		       NativeUpdateUs,
+		       SavedUs);
+	}
+
+	WheelVisualMode->Set(PreviousMode, ECVF_SetByCode);
+	UpdateOffscreen->Set(bPreviousUpdateOffscreen, ECVF_SetByCode);
+	DestroyBenchmarkWorld(World);
+	return bPassed;
+#else
+	UE_LOG(LogSingularisVehicleBenchmark, Display, TEXT("服务器构建没有车轮表现，跳过车轮表现场景"));
+	return true;
+#endif
+}
+
+bool USingularisVehicleBenchmarkCommandlet::RunSurfaceScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const
+{
+	// 对比按表面类型下标访问烘焙表、TMap 查找与逐项比较表格
+	int32 NumLookups = 1 << 22;
+	FParse::Value(*Params, TEXT("Lookups="), NumLookups);
+
+	TArray<FSingularisSurfaceResponse> Responses;
+	for (int32 SurfaceType = 1; SurfaceType <= 16; ++SurfaceType)
+	{
+		FSingularisSurfaceResponse& Response = Responses.AddDefaulted_GetRef();
+		Response.SurfaceType = static_cast<EPhysicalSurface>(SurfaceType);
+		Response.FrictionScale = 1.0f / SurfaceType;
+	}
+	const FSingularisSurfaceResponseTableRef Table = FSingularisSurfaceResponseTable::Bake(Responses, FSingularisSurfaceResponse());
+
+	TMap<uint8, FSingularisSurfaceResponse> ResponseMap;
+	for (const FSingularisSurfaceResponse& Response : Responses)
+	{
+		ResponseMap.Add(Response.SurfaceType.GetValue(), Response);
+	}
+
+	// 接触的表面类型预先随机生成，其中约一半不在表格中
+	FRandomStream Random(7);
+	TArray<uint8> Contacts;
+	Contacts.SetNumUninitialized(4096);
+	for (uint8& Contact : Contacts)
+	{
+		Contact = static_cast<uint8>(Random.RandRange(0, 31));
+	}
+
+	auto Measure = [NumLookups, &Contacts](auto&& Lookup)
+	{
+		float Sum = 0.0f;
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumLookups; ++Index)
+		{
+			Sum += Lookup(Contacts[Index & (Contacts.Num() - 1)]);
+		}
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+		return MakeTuple(Seconds * 1.0e9 / FMath::Max(NumLookups, 1), Sum);
+	};
+
+	const auto TableResult = Measure([&Table](const uint8 SurfaceType)
+	{
+		return Table->Get(SurfaceType).FrictionScale;
+	});
+	const auto MapResult = Measure([&ResponseMap](const uint8 SurfaceType)
+	{
+		const FSingularisSurfaceResponse* Response = ResponseMap.Find(SurfaceType);
+		return Response ? Response->FrictionScale : 1.0f;
+	});
+	const auto LinearResult = Measure([&Responses](const uint8 SurfaceType)
+	{
+		const FSingularisSurfaceResponse* Response = Responses.FindByPredicate([SurfaceType](const FSingularisSurfaceResponse& Candidate)
+		{
+			return Candidate.SurfaceType == SurfaceType;
+		});
+		return Response ? Response->FrictionScale : 1.0f;
+	});
+
+	OutRows.Add({TEXT("SurfaceLookup"), Responses.Num(), TEXT("TableLookupNs"), TableResult.Get<0>()});
+	OutRows.Add({TEXT("SurfaceLookup"), Responses.Num(), TEXT("MapLookupNs"), MapResult.Get<0>()});
+	OutRows.Add({TEXT("SurfaceLookup"), Responses.Num(), TEXT("LinearSearchNs"), LinearResult.Get<0>()});
+
+	UE_LOG(LogSingularisVehicleBenchmark,
+	       Display,
+	       TEXT("%d 种路面：烘焙表 %.2f ns/次，TMap %.2f ns/次，逐项比较 %.2f ns/次（校验 %.1f/%.1f/%.1f）"),
+	       Responses.Num(),
+	       TableResult.Get<0>(),
+	       MapResult.Get<0>(),
+	       LinearResult.Get<0>(),
+	       TableResult.Get<1>(),
+	       MapResult.Get<1>(),
+	       LinearResult.Get<1>());
+
+	return true;
+}
+
+bool USingularisVehicleBenchmarkCommandlet::RunGroundScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const
+{
+	FString VehicleClassPath;
+	FParse::Value(*Params, TEXT("VehicleClass="), VehicleClassPath);
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = LoadClass<ABaseWheeledVehiclePawn>(nullptr, *VehicleClassPath);
+	if (!VehicleClass)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法加载载具类 '%s'，地面接触场景需要 -VehicleClass="), *VehicleClassPath);
+		return false;
+	}
+
+	FString MapPath;
+	FParse::Value(*Params, TEXT("Map="), MapPath);
+
+	int32 NumFrames = 600;
+	int32 NumWarmupFrames = 60;
+	float DeltaTime = 1.0f / 60.0f;
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("WarmupFrames="), NumWarmupFrames);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+
+	IConsoleVariable* GroundEnable = IConsoleManager::Get().FindConsoleVariable(TEXT("SingularisVehicle.Ground.Enable"));
+	IConsoleVariable* GroundValidate = IConsoleManager::Get().FindConsoleVariable(TEXT("SingularisVehicle.Ground.Validate"));
+	UWorld* World = CreateBenchmarkWorld(MapPath);
+	USingularisVehicleGroundSubsystem* Ground = World ? World->GetSubsystem<USingularisVehicleGroundSubsystem>() : nullptr;
+	if (!Ground || !GroundEnable || !GroundValidate)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法创建测试世界或地面接触子系统 '%s'"), *MapPath);
+		if (World)
+		{
+			DestroyBenchmarkWorld(World);
+		}
+		return false;
+	}
+
+	// 载具放在地形中央，需要 -Map= 指定带地形的地图
+	FBox LandscapeBounds(ForceInit);
+	for (TActorIterator<ALandscapeProxy> It(World); It; ++It)
+	{
+		LandscapeBounds += It->GetComponentsBoundingBox();
+	}
+	if (!LandscapeBounds.IsValid)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("地图 '%s' 中没有地形，地面接触场景需要 -Map= 指定带地形的地图"), *MapPath);
+		DestroyBenchmarkWorld(World);
+		return false;
+	}
+
+	const int32 PreviousEnable = GroundEnable->GetInt();
+	const int32 PreviousValidate = GroundValidate->GetInt();
+	const FSingularisGroundContactProviderPtr& Provider = Ground->GetContactProvider();
+	Provider->bCollectStats.store(true);
+
+	bool bSpawned = true;
+	bool bAccurate = true;
+	int32 Frame = 0;
+	for (const int32 NumVehicles : ParseCounts(Params, {64, 256}))
+	{
+		// 按方阵放在地面以上，开启高度场接触后重建物理载具
+		TArray<ABaseWheeledVehiclePawn*> Vehicles;
+		const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumVehicles)));
+		const FVector GridOrigin = LandscapeBounds.GetCenter() - FVector(GridSize - 1, GridSize - 1, 0.0f) * (SingularisVehicleBenchmark::VehicleSpacing * 0.5f);
+		for (int32 Index = 0; Index < NumVehicles; ++Index)
+		{
+			const FVector Column = GridOrigin + FVector(Index % GridSize, Index / GridSize, 0.0f) * SingularisVehicleBenchmark::VehicleSpacing;
+
+			FHitResult GroundHit;
+			if (!World->LineTraceSingleByChannel(GroundHit,
+			                                     FVector(Column.X, Column.Y, LandscapeBounds.Max.Z + 100.0),
+			                                     FVector(Column.X, Column.Y, LandscapeBounds.Min.Z - 100.0),
+			                                     ECC_WorldStatic))
+			{
+				continue;
+			}
+
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			ABaseWheeledVehiclePawn* Vehicle = World->SpawnActor<ABaseWheeledVehiclePawn>(VehicleClass, FTransform(GroundHit.ImpactPoint + FVector(0.0f, 0.0f, 100.0f)), SpawnParameters);
+			if (Vehicle && Vehicle->GetSingularisVehicleMovement())
+			{
+				Vehicle->GetSingularisVehicleMovement()->bUseHeightfieldContact = true;
+				Vehicle->GetSingularisVehicleMovement()->RecreatePhysicsState();
+				Ground->RegisterVehicle(Vehicle);
+				Vehicles.Add(Vehicle);
+			}
+			else if (Vehicle)
+			{
+				Vehicle->Destroy();
+			}
+		}
+
+		if (Vehicles.IsEmpty())
+		{
+			UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("'%s' 没有使用 USingularisVehicleMovementComponent 或无法放在地形上"), *VehicleClassPath);
+			bSpawned = false;
+			break;
+		}
+		Ground->BuildPendingTiles();
+
+		// 依次测量全部场景查询与高度场接触，最后在校验模式下由场景查询驱动悬挂，统计高度场结果与之的偏差
+		FSingularisGroundContactStats PassStats[3];
+		for (int32 Pass = 0; Pass < 3; ++Pass)
+		{
+			GroundEnable->Set(Pass >= 1, ECVF_SetByCode);
+			GroundValidate->Set(Pass == 2, ECVF_SetByCode);
+
+			for (int32 WarmupFrame = 0; WarmupFrame < NumWarmupFrames; ++WarmupFrame, ++Frame)
+			{
+				ApplyScriptedInputs(Vehicles, Frame, DeltaTime);
+				World->Tick(LEVELTICK_All, DeltaTime);
+				++GFrameCounter;
+			}
+
+			Provider->ResetStats();
+			for (int32 MeasureFrame = 0; MeasureFrame < NumFrames; ++MeasureFrame, ++Frame)
+			{
+				ApplyScriptedInputs(Vehicles, Frame, DeltaTime);
+				World->Tick(LEVELTICK_All, DeltaTime);
+				++GFrameCounter;
+			}
+			PassStats[Pass] = Provider->GetStats();
+		}
+
+		// 单个车轮的悬挂检测耗时，高度场接触一项包含回退到场景查询的车轮
+		const FSingularisGroundContactStats& Raycast = PassStats[0];
+		const FSingularisGroundContactStats& Analytic = PassStats[1];
+		const int64 NumAnalyticPassWheels = Analytic.NumAnalyticWheels + Analytic.NumFallbackWheels;
+		const double RaycastUs = Raycast.FallbackSeconds * 1.0e6 / FMath::Max<int64>(Raycast.NumFallbackWheels, 1);
+		const double AnalyticUs = (Analytic.AnalyticSeconds + Analytic.FallbackSeconds) * 1.0e6 / FMath::Max<int64>(NumAnalyticPassWheels, 1);
+		const double Coverage = static_cast<double>(Analytic.NumAnalyticWheels) / FMath::Max<int64>(NumAnalyticPassWheels, 1);
+
+		OutRows.Add({TEXT("GroundRaycast"), Vehicles.Num(), TEXT("SuspensionTraceUsPerWheel"), RaycastUs});
+		OutRows.Add({TEXT("GroundAnalytic"), Vehicles.Num(), TEXT("SuspensionTraceUsPerWheel"), AnalyticUs});
+		OutRows.Add({TEXT("GroundAnalytic"), Vehicles.Num(), TEXT("AnalyticCoverage"), Coverage, ESingularisVehicleBenchmarkGate::HigherIsBetter});
+
+		// 两者都命中时的高度偏差，以及是否命中的一致率
+		const FSingularisGroundContactStats& Validate = PassStats[2];
+		const double MeanHeightError = Validate.SumHeightError / FMath::Max<int64>(Validate.NumBothHit, 1);
+		const double HitAgreement = 1.0 - static_cast<double>(Validate.NumHitMismatches) / FMath::Max<int64>(Validate.NumCompared, 1);
+
+		OutRows.Add({TEXT("GroundAccuracy"), Vehicles.Num(), TEXT("MeanHeightErrorCm"), MeanHeightError});
+		OutRows.Add({TEXT("GroundAccuracy"), Vehicles.Num(), TEXT("MaxHeightErrorCm"), Validate.MaxHeightError, ESingularisVehicleBenchmarkGate::None});
+		OutRows.Add({TEXT("GroundAccuracy"), Vehicles.Num(), TEXT("HitAgreement"), HitAgreement, ESingularisVehicleBenchmarkGate::HigherIsBetter});
+
+		UE_LOG(LogSingularisVehicleBenchmark,
+		       Display,
+		       TEXT("%4d 辆：场景查询 %.3f us/轮，高度场 %.3f us/轮（覆盖 %.1f%%），%lld 次对比：高度误差平均 %.3f cm、最大 %.3f cm，命中一致 %.2f%%"),
+		       Vehicles.Num(),
+		       RaycastUs,
+		       AnalyticUs,
+		       Coverage * 100.0,
+		       Validate.NumCompared,
+		       MeanHeightError,
+		       Validate.MaxHeightError,
+		       HitAgreement * 100.0);
+
+		if (Validate.NumCompared == 0)
+		{
+			UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("%d 辆：没有车轮落在可直接采样的高度场上，检查车轮是否使用 Raycast 悬挂检测"), Vehicles.Num());
+			bAccurate = false;
+		}
+		else if (MeanHeightError > SingularisVehicleBenchmark::MaxGroundMeanHeightError || HitAgreement < SingularisVehicleBenchmark::MinGroundHitAgreement)
+		{
+			UE_LOG(LogSingularisVehicleBenchmark,
+			       Error,
+			       TEXT("%d 辆：高度场接触偏差超出要求（平均高度误差不超过 %.1f cm，命中一致率不低于 %.2f）"),
+			       Vehicles.Num(),
+			       SingularisVehicleBenchmark::MaxGroundMeanHeightError,
+			       SingularisVehicleBenchmark::MinGroundHitAgreement);
+			bAccurate = false;
+		}
+
+		for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+		{
+			Vehicle->Destroy();
+		}
+		World->Tick(LEVELTICK_All, DeltaTime);
+	}
+
+	Provider->bCollectStats.store(false);
+	GroundEnable->Set(PreviousEnable, ECVF_SetByCode);
+	GroundValidate->Set(PreviousValidate, ECVF_SetByCode);
+	DestroyBenchmarkWorld(World);
+	return bSpawned && bAccurate;
+}
+
+bool USingularisVehicleBenchmarkCommandlet::RunContactScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows)
+{
+	FString VehicleClassPath;
+	FParse::Value(*Params, TEXT("VehicleClass="), VehicleClassPath);
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = LoadClass<ABaseWheeledVehiclePawn>(nullptr, *VehicleClassPath);
+	if (!VehicleClass)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法加载载具类 '%s'，车身接触场景需要 -VehicleClass="), *VehicleClassPath);
+		return false;
+	}
+
+	int32 NumFrames = 600;
+	int32 NumSettleFrames = 30;
+	float DeltaTime = 1.0f / 60.0f;
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("SettleFrames="), NumSettleFrames);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+
+	// 需要自建的平地与侧墙，不使用 -Map=
+	IConsoleVariable* ContactEnable = IConsoleManager::Get().FindConsoleVariable(TEXT("SingularisVehicle.Contact.Enable"));
+	UWorld* World = CreateBenchmarkWorld(FString());
+	USingularisVehicleContactSubsystem* Contacts = World ? World->GetSubsystem<USingularisVehicleContactSubsystem>() : nullptr;
+	UStaticMesh* WallMesh = LoadObject<UStaticMesh>(nullptr, SingularisVehicleBenchmark::FloorMeshPath);
+	if (!Contacts || !ContactEnable || !WallMesh)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法创建测试世界、接触聚合子系统或墙体网格"));
+		if (World)
+		{
+			DestroyBenchmarkWorld(World);
+		}
+		return false;
+	}
+
+	// 两排载具相距 RowGap 迎面行驶，并略微转向同一侧的长墙
+	constexpr float RowGap = 3000.0f;
+	constexpr float LaneSpacing = 450.0f;
+	constexpr float SteerTowardWall = -0.15f;
+
+	const int32 PreviousEnable = ContactEnable->GetInt();
+	const FDelegateHandle BatchHandle = Contacts->OnContactBatch.AddLambda([this](const TConstArrayView<FSingularisVehicleContact> Batch)
+	{
+		for (const FSingularisVehicleContact& Contact : Batch)
+		{
+			++NumContactCallbacks;
+			ContactWorkAccumulator += Contact.PeakImpulse * 1.0e-6 + Contact.Location.Size() * 1.0e-9;
+		}
+	});
+
+	bool bPassed = true;
+	for (const int32 NumVehicles : ParseCounts(Params, {100}))
+	{
+		const int32 NumLanes = FMath::Max((NumVehicles + 1) / 2, 1);
+		AStaticMeshActor* Wall = World->SpawnActor<AStaticMeshActor>(FVector(0.0f, -LaneSpacing, 100.0f), FRotator::ZeroRotator);
+		Wall->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+		Wall->GetStaticMeshComponent()->SetStaticMesh(WallMesh);
+		Wall->SetActorScale3D(FVector(RowGap * 2.0f / 100.0f, 0.5f, 2.0f));
+
+		// 依次测量：车身开启逐次命中事件并绑定 OnComponentHit、接触聚合子系统
+		int64 NumCallbacks[2] = {};
+		double FrameMs[2] = {};
+		double AggregatorSeconds = 0.0;
+		int64 NumRawContacts = 0;
+		for (int32 Pass = 0; Pass < 2; ++Pass)
+		{
+			const bool bAggregated = Pass == 1;
+			ContactEnable->Set(bAggregated, ECVF_SetByCode);
+
+			TArray<ABaseWheeledVehiclePawn*> Vehicles;
+			for (int32 Index = 0; Index < NumVehicles; ++Index)
+			{
+				const bool bSecondRow = Index % 2 == 1;
+				const FVector Location(bSecondRow ? RowGap * 0.5f : -RowGap * 0.5f, (Index / 2) * LaneSpacing, 100.0f);
+				const FRotator Rotation(0.0f, bSecondRow ? 180.0f : 0.0f, 0.0f);
+
+				FActorSpawnParameters SpawnParameters;
+				SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+				ABaseWheeledVehiclePawn* Vehicle = World->SpawnActor<ABaseWheeledVehiclePawn>(VehicleClass, FTransform(Rotation, Location), SpawnParameters);
+				if (!Vehicle)
+				{
+					continue;
+				}
+
+				if (!bAggregated)
+				{
+					Vehicle->GetMesh()->SetNotifyRigidBodyCollision(true);
+					Vehicle->GetMesh()->OnComponentHit.AddDynamic(this, &USingularisVehicleBenchmarkCommandlet::HandleBenchmarkHit);
+				}
+				Vehicles.Add(Vehicle);
+			}
+
+			for (int32 Frame = 0; Frame < NumSettleFrames; ++Frame)
+			{
+				World->Tick(LEVELTICK_All, DeltaTime);
+				++GFrameCounter;
+			}
+
+			NumContactCallbacks = 0;
+			double FrameSeconds = 0.0;
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				for (int32 Index = 0; Index < Vehicles.Num(); ++Index)
+				{
+					// 两排的前进方向相反，转向取反后都偏向同一侧的墙
+					const float Steering = Index % 2 == 1 ? -SteerTowardWall : SteerTowardWall;
+					if (USingularisVehicleMovementComponent* Movement = Vehicles[Index]->GetSingularisVehicleMovement())
+					{
+						Movement->QueueControlInputs(1.0f, 0.0f, Steering, false);
+					}
+					else
+					{
+						Vehicles[Index]->GetVehicleMovementComponent()->SetThrottleInput(1.0f);
+						Vehicles[Index]->GetVehicleMovementComponent()->SetSteeringInput(Steering);
+					}
+				}
+
+				const double FrameStartTime = FPlatformTime::Seconds();
+				World->Tick(LEVELTICK_All, DeltaTime);
+				FrameSeconds += FPlatformTime::Seconds() - FrameStartTime;
+				++GFrameCounter;
+
+				if (bAggregated)
+				{
+					AggregatorSeconds += Contacts->GetLastProcessSeconds();
+					NumRawContacts += Contacts->GetLastNumRawContacts();
+				}
+			}
+
+			NumCallbacks[Pass] = NumContactCallbacks;
+			FrameMs[Pass] = FrameSeconds * 1000.0 / FMath::Max(NumFrames, 1);
+
+			for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+			{
+				Vehicle->Destroy();
+			}
+			World->Tick(LEVELTICK_All, DeltaTime);
+		}
+		Wall->Destroy();
+
+		const double VehicleSeconds = FMath::Max(NumVehicles * NumFrames * DeltaTime, UE_SMALL_NUMBER);
+		const double RawPerVehicleSecond = NumCallbacks[0] / VehicleSeconds;
+		const double AggregatedPerVehicleSecond = NumCallbacks[1] / VehicleSeconds;
+		const double AggregatorUs = AggregatorSeconds * 1.0e6 / FMath::Max(NumFrames, 1);
+
+		OutRows.Add({TEXT("ContactRaw"), NumVehicles, TEXT("CallbacksPerVehicleSecond"), RawPerVehicleSecond, ESingularisVehicleBenchmarkGate::None});
+		OutRows.Add({TEXT("ContactRaw"), NumVehicles, TEXT("FrameMs"), FrameMs[0]});
+		OutRows.Add({TEXT("ContactAggregated"), NumVehicles, TEXT("CallbacksPerVehicleSecond"), AggregatedPerVehicleSecond});
+		OutRows.Add({TEXT("ContactAggregated"), NumVehicles, TEXT("FrameMs"), FrameMs[1]});
+		OutRows.Add({TEXT("ContactAggregated"), NumVehicles, TEXT("AggregatorUsPerFrame"), AggregatorUs});
+		OutRows.Add({TEXT("ContactAggregated"), NumVehicles, TEXT("RawContactsPerFrame"), static_cast<double>(NumRawContacts) / FMath::Max(NumFrames, 1), ESingularisVehicleBenchmarkGate::None});
+
+		UE_LOG(LogSingularisVehicleBenchmark,
+		       Display,
+		       TEXT("%4d 辆：逐次命中 %lld 次回调（%.1f 次/辆/秒，%.3f ms/帧），聚合 %lld 次（%.1f 次/辆/秒，%.3f ms/帧，聚合开销 %.1f us/帧）"),
+		       NumVehicles,
+		       NumCallbacks[0],
+		       RawPerVehicleSecond,
+		       FrameMs[0],
+		       NumCallbacks[1],
+		       AggregatedPerVehicleSecond,
+		       FrameMs[1],
+		       AggregatorUs);
+
+		if (NumCallbacks[0] > 0 && NumCallbacks[1] == 0)
+		{
+			UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("逐次命中有 %lld 次回调，但聚合后没有任何接触；检查 SingularisVehicle.Contact.MinImpulse"), NumCallbacks[0]);
+			bPassed = false;
+		}
+	}
+
+	Contacts->OnContactBatch.Remove(BatchHandle);
+	ContactEnable->Set(PreviousEnable, ECVF_SetByCode);
+	DestroyBenchmarkWorld(World);
+	return bPassed;
+}
+
+void USingularisVehicleBenchmarkCommandlet::HandleBenchmarkHit(UPrimitiveComponent* HitComponent,
+                                                            AActor* OtherActor,
+                                                            UPrimitiveComponent* OtherComp,
+                                                            const FVector NormalImpulse,
+                                                            const FHitResult& Hit)
+{
+	++NumContactCallbacks;
+	ContactWorkAccumulator += NormalImpulse.Size() * 1.0e-6 + Hit.ImpactPoint.Size() * 1.0e-9;
+}
+
+bool USingularisVehicleBenchmarkCommandlet::RunPersistenceScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const
+{
+	FString VehicleClassPath;
+	FParse::Value(*Params, TEXT("VehicleClass="), VehicleClassPath);
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = LoadClass<ABaseWheeledVehiclePawn>(nullptr, *VehicleClassPath);
+	if (!VehicleClass)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法加载载具类 '%s'，持久化场景需要 -VehicleClass="), *VehicleClassPath);
+		return false;
+	}
+
+	int32 NumFrames = 600;
+	int32 NumSettleFrames = 30;
+	int32 CycleFrames = 30;
+	int32 NumCells = 8;
+	float CellSize = 6400.0f;
+	float DeltaTime = 1.0f / 60.0f;
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("SettleFrames="), NumSettleFrames);
+	FParse::Value(*Params, TEXT("CycleFrames="), CycleFrames);
+	FParse::Value(*Params, TEXT("Cells="), NumCells);
+	FParse::Value(*Params, TEXT("CellSize="), CellSize);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+	CycleFrames = FMath::Max(CycleFrames, 1);
+	NumCells = FMath::Max(NumCells, 1);
+
+	// 需要足够大的平地让载具持续驶过单元边界，不使用 -Map=
+	UWorld* World = CreateBenchmarkWorld(FString());
+	USingularisVehiclePersistenceSubsystem* Persistence = World ? World->GetSubsystem<USingularisVehiclePersistenceSubsystem>() : nullptr;
+	if (!Persistence)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法创建测试世界或持久化子系统"));
+		if (World)
+		{
+			DestroyBenchmarkWorld(World);
+		}
+		return false;
+	}
+
+	// 沿 X 方向排成一排的模拟单元，Y 与 Z 方向不限；载具从第一个单元出发沿 X 方向驶过后面的单元
+	auto GetCellName = [](const int32 CellIndex)
+	{
+		return FName(TEXT("BenchmarkCell"), CellIndex + 1);
+	};
+	auto GetCellBounds = [CellSize](const int32 CellIndex)
+	{
+		return FBox(FVector(CellIndex * CellSize, -1.0e6, -1.0e6), FVector((CellIndex + 1) * CellSize, 1.0e6, 1.0e6));
+	};
+
+	auto GatherVehicles = [World](TArray<ABaseWheeledVehiclePawn*>& OutVehicles)
+	{
+		OutVehicles.Reset();
+		for (TActorIterator<ABaseWheeledVehiclePawn> It(World); It; ++It)
+		{
+			if (IsValid(*It) && !It->IsPooled())
+			{
+				OutVehicles.Add(*It);
+			}
+		}
+	};
+
+	/** 基线：单元卸载时销毁载具，只保留位置与速度，重新加载时在同一帧全部重新生成 */
+	struct FRespawnRecord
+	{
+		FTransform Transform;
+		FVector Velocity = FVector::ZeroVector;
+	};
+
+	bool bPassed = true;
+	TArray<ABaseWheeledVehiclePawn*> Vehicles;
+	for (const int32 NumVehicles : ParseCounts(Params, {200}))
+	{
+		// 依次测量：销毁后重新生成、持久化子系统
+		double AvgFrameMs[2] = {};
+		double MaxFrameMs[2] = {};
+		double P99FrameMs[2] = {};
+		double MaxStoreMs = 0.0;
+		double MaxVelocityError = 0.0;
+		int32 NumGearMismatches = 0;
+		for (int32 Pass = 0; Pass < 2; ++Pass)
+		{
+			const bool bPersistence = Pass == 1;
+
+			SpawnVehicleGrid(World, VehicleClass, NumVehicles, Vehicles);
+			for (int32 Frame = 0; Frame < NumSettleFrames; ++Frame)
+			{
+				World->Tick(LEVELTICK_All, DeltaTime);
+				++GFrameCounter;
+			}
+
+			TArray<TArray<FRespawnRecord>> RespawnCells;
+			RespawnCells.SetNum(NumCells);
+			int32 UnloadedCell = INDEX_NONE;
+
+			TArray<double> FrameTimes;
+			FrameTimes.Reserve(NumFrames);
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				GatherVehicles(Vehicles);
+				for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+				{
+					if (USingularisVehicleMovementComponent* Movement = Vehicle->GetSingularisVehicleMovement())
+					{
+						Movement->QueueControlInputs(1.0f, 0.0f, 0.0f, false);
+					}
+					else
+					{
+						Vehicle->GetChaosVehicleMovement()->SetThrottleInput(1.0f);
+					}
+				}
+
+				// 流送开销计入所在帧
+				const double FrameStartTime = FPlatformTime::Seconds();
+				if (Frame % CycleFrames == 0)
+				{
+					// 重新加载上一轮卸载的单元，再卸载下一个单元
+					const int32 NextCell = (Frame / CycleFrames) % NumCells;
+					if (bPersistence)
+					{
+						if (UnloadedCell != INDEX_NONE)
+						{
+							Persistence->RestoreCell(GetCellName(UnloadedCell));
+						}
+
+						const double StoreStartTime = FPlatformTime::Seconds();
+						Persistence->StoreVehiclesInRegion(GetCellName(NextCell), GetCellBounds(NextCell));
+						MaxStoreMs = FMath::Max(MaxStoreMs, (FPlatformTime::Seconds() - StoreStartTime) * 1000.0);
+					}
+					else
+					{
+						if (UnloadedCell != INDEX_NONE)
+						{
+							for (const FRespawnRecord& Record : RespawnCells[UnloadedCell])
+							{
+								FActorSpawnParameters SpawnParameters;
+								SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+								if (ABaseWheeledVehiclePawn* Vehicle = World->SpawnActor<ABaseWheeledVehiclePawn>(VehicleClass, Record.Transform, SpawnParameters))
+								{
+									Vehicle->GetMesh()->SetPhysicsLinearVelocity(Record.Velocity);
+								}
+							}
+							RespawnCells[UnloadedCell].Reset();
+						}
+
+						const FBox Bounds = GetCellBounds(NextCell);
+						for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+						{
+							if (Bounds.IsInsideXY(Vehicle->GetActorLocation()))
+							{
+								RespawnCells[NextCell].Add({Vehicle->GetActorTransform(), Vehicle->GetMesh()->GetPhysicsLinearVelocity()});
+								Vehicle->Destroy();
+							}
+						}
+					}
+					UnloadedCell = NextCell;
+				}
+
+				World->Tick(LEVELTICK_All, DeltaTime);
+				FrameTimes.Add((FPlatformTime::Seconds() - FrameStartTime) * 1000.0);
+				++GFrameCounter;
+			}
+
+			// 最后一个卸载的单元也重新加载，所有载具都应回到世界中
+			if (UnloadedCell != INDEX_NONE)
+			{
+				if (bPersistence)
+				{
+					Persistence->RestoreCell(GetCellName(UnloadedCell));
+				}
+				else
+				{
+					for (const FRespawnRecord& Record : RespawnCells[UnloadedCell])
+					{
+						FActorSpawnParameters SpawnParameters;
+						SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+						World->SpawnActor<ABaseWheeledVehiclePawn>(VehicleClass, Record.Transform, SpawnParameters);
+					}
+				}
+			}
+
+			// 卸载期间开始的恢复可能尚未完成
+			if (bPersistence)
+			{
+				Persistence->FlushRestores();
+			}
+			World->Tick(LEVELTICK_All, DeltaTime);
+			++GFrameCounter;
+
+			GatherVehicles(Vehicles);
+			if (Vehicles.Num() != NumVehicles || (bPersistence && Persistence->GetNumStored() != 0))
+			{
+				UE_LOG(LogSingularisVehicleBenchmark,
+				       Error,
+				       TEXT("%s：所有单元重新加载后应有 %d 辆载具，实际 %d 辆，仍有 %d 条记录"),
+				       bPersistence ? TEXT("持久化") : TEXT("重新生成"),
+				       NumVehicles,
+				       Vehicles.Num(),
+				       Persistence->GetNumStored());
+				bPassed = false;
+			}
+
+			// 状态恢复检查：把全部载具写入一个单元后立即放回，按位置对应比较速度与挡位
+			if (bPersistence)
+			{
+				struct FExpectedState
+				{
+					FVector Location;
+					FVector Velocity;
+					int32 Gear = 0;
+				};
+
+				TArray<FExpectedState> Expected;
+				for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+				{
+					Expected.Add({Vehicle->GetActorLocation(), Vehicle->GetMesh()->GetPhysicsLinearVelocity(), Vehicle->GetChaosVehicleMovement()->GetCurrentGear()});
+				}
+
+				const FName CheckCell(TEXT("BenchmarkCheck"));
+				Persistence->StoreVehiclesInRegion(CheckCell, FBox(FVector(-1.0e6), FVector(1.0e6)));
+				Persistence->RestoreCell(CheckCell);
+				Persistence->FlushRestores();
+
+				GatherVehicles(Vehicles);
+				for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+				{
+					const FExpectedState* Closest = nullptr;
+					double ClosestDistanceSquared = TNumericLimits<double>::Max();
+					for (const FExpectedState& State : Expected)
+					{
+						const double DistanceSquared = FVector::DistSquared(State.Location, Vehicle->GetActorLocation());
+						if (DistanceSquared < ClosestDistanceSquared)
+						{
+							ClosestDistanceSquared = DistanceSquared;
+							Closest = &State;
+						}
+					}
+
+					if (Closest)
+					{
+						MaxVelocityError = FMath::Max(MaxVelocityError, (Vehicle->GetMesh()->GetPhysicsLinearVelocity() - Closest->Velocity).Size());
+						NumGearMismatches += Vehicle->GetChaosVehicleMovement()->GetTargetGear() != Closest->Gear ? 1 : 0;
+					}
+				}
+
+				if (Vehicles.Num() != Expected.Num() || MaxVelocityError > 1.0 || NumGearMismatches > 0)
+				{
+					UE_LOG(LogSingularisVehicleBenchmark,
+					       Error,
+					       TEXT("状态恢复：%d 辆中放回 %d 辆，最大速度偏差 %.2f cm/s，%d 辆挡位不符"),
+					       Expected.Num(),
+					       Vehicles.Num(),
+					       MaxVelocityError,
+					       NumGearMismatches);
+					bPassed = false;
+				}
+			}
+
+			FrameTimes.Sort();
+			double TotalMs = 0.0;
+			for (const double FrameMs : FrameTimes)
+			{
+				TotalMs += FrameMs;
+			}
+			AvgFrameMs[Pass] = TotalMs / FMath::Max(FrameTimes.Num(), 1);
+			MaxFrameMs[Pass] = FrameTimes.IsEmpty() ? 0.0 : FrameTimes.Last();
+			P99FrameMs[Pass] = FrameTimes.IsEmpty() ? 0.0 : FrameTimes[FMath::FloorToInt32((FrameTimes.Num() - 1) * 0.99)];
+
+			// 持久化一轮归还对象池的载具留在池中，只销毁世界中的载具
+			for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+			{
+				Vehicle->Destroy();
+			}
+			Persistence->ClearRecords();
+			World->Tick(LEVELTICK_All, DeltaTime);
+		}
+
+		OutRows.Add({TEXT("PersistenceRespawn"), NumVehicles, TEXT("AvgFrameMs"), AvgFrameMs[0]});
+		OutRows.Add({TEXT("PersistenceRespawn"), NumVehicles, TEXT("P99FrameMs"), P99FrameMs[0]});
+		OutRows.Add({TEXT("PersistenceRespawn"), NumVehicles, TEXT("MaxFrameMs"), MaxFrameMs[0]});
+		OutRows.Add({TEXT("PersistencePooled"), NumVehicles, TEXT("AvgFrameMs"), AvgFrameMs[1]});
+		OutRows.Add({TEXT("PersistencePooled"), NumVehicles, TEXT("P99FrameMs"), P99FrameMs[1]});
+		OutRows.Add({TEXT("PersistencePooled"), NumVehicles, TEXT("MaxFrameMs"), MaxFrameMs[1]});
+		OutRows.Add({TEXT("PersistencePooled"), NumVehicles, TEXT("MaxStoreMs"), MaxStoreMs});
+		OutRows.Add({TEXT("PersistencePooled"), NumVehicles, TEXT("MaxVelocityError"), MaxVelocityError});
+
+		UE_LOG(LogSingularisVehicleBenchmark,
+		       Display,
+		       TEXT("%4d 辆：重新生成 %.3f / %.3f / %.3f ms（平均 / P99 / 最大），持久化 %.3f / %.3f / %.3f ms，单元写入最多 %.3f ms，速度偏差 %.2f cm/s"),
+		       NumVehicles,
+		       AvgFrameMs[0],
+		       P99FrameMs[0],
+		       MaxFrameMs[0],
+		       AvgFrameMs[1],
+		       P99FrameMs[1],
+		       MaxFrameMs[1],
+		       MaxStoreMs,
+		       MaxVelocityError);
+	}
+
+	DestroyBenchmarkWorld(World);
+	return bPassed;
+}
+
+bool USingularisVehicleBenchmarkCommandlet::RunNetBandwidthScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const
+{
+	FString VehicleClassPath;
+	FParse::Value(*Params, TEXT("VehicleClass="), VehicleClassPath);
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = LoadClass<ABaseWheeledVehiclePawn>(nullptr, *VehicleClassPath);
+	if (!VehicleClass)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法加载载具类 '%s'，带宽场景需要 -VehicleClass="), *VehicleClassPath);
+		return false;
+	}
+
+	FString MapPath;
+	FParse::Value(*Params, TEXT("Map="), MapPath);
+
+	int32 NumFrames = 600;
+	int32 NumWarmupFrames = 60;
+	float DeltaTime = 1.0f / 60.0f;
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("WarmupFrames="), NumWarmupFrames);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+	NumFrames = FMath::Max(NumFrames, 1);
+
+	UWorld* World = CreateBenchmarkWorld(MapPath);
+	if (!World)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法创建测试世界 '%s'"), *MapPath);
+		return false;
+	}
+
+	// 每辆车在两条路径上最近一次发送的内容
+	struct FVehicleNetState
+	{
+		SingularisVehicleBenchmark::FNetPayload Movement;
+		SingularisVehicleBenchmark::FNetPayload ReplicatedState;
+		SingularisVehicleBenchmark::FNetPayload Motion;
+		SingularisVehicleBenchmark::FNetPayload Drive;
+		FSingularisVehicleNetControl LastControl;
+		float TimeSinceControlSent = 0.0f;
+		float TimeSinceNetUpdate = 0.0f;
+	};
+
+	const USingularisVehicleMovementComponent* DefaultMovement = GetDefault<USingularisVehicleMovementComponent>();
+
+	for (const int32 NumVehicles : ParseCounts(Params, {16, 64}))
+	{
+		TArray<ABaseWheeledVehiclePawn*> Vehicles;
+		SpawnVehicleGrid(World, VehicleClass, NumVehicles, Vehicles);
+		for (int32 Frame = 0; Frame < NumWarmupFrames; ++Frame)
+		{
+			World->Tick(LEVELTICK_All, DeltaTime);
+			++GFrameCounter;
+		}
+
+		TArray<FVehicleNetState> States;
+		States.SetNum(Vehicles.Num());
+		int64 DefaultControlBits = 0;
+		int64 DefaultStateBits = 0;
+		int64 CompactControlBits = 0;
+		int64 CompactStateBits = 0;
+
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			ApplyScriptedInputs(Vehicles, Frame, DeltaTime);
+			World->Tick(LEVELTICK_All, DeltaTime);
+			++GFrameCounter;
+
+			for (int32 Index = 0; Index < Vehicles.Num(); ++Index)
+			{
+				ABaseWheeledVehiclePawn* Vehicle = Vehicles[Index];
+				const UChaosWheeledVehicleMovementComponent* Movement = Vehicle->GetChaosVehicleMovement();
+				const USingularisVehicleMovementComponent* SingularisMovement = Vehicle->GetSingularisVehicleMovement();
+				const USingularisVehicleMovementComponent* SendSettings = SingularisMovement ? SingularisMovement : DefaultMovement;
+				const FVehicleControlFrame ControlFrame = MakeScriptedControlFrame(Index, Frame, DeltaTime);
+				FVehicleNetState& State = States[Index];
+
+				// 默认路径：拥有者每帧调用一次 ServerUpdateState，参数与 ReplicatedState 的字段相同
+				FVehicleReplicatedState ReplicatedState;
+				ReplicatedState.SteeringInput = ControlFrame.Steering;
+				ReplicatedState.ThrottleInput = ControlFrame.Throttle;
+				ReplicatedState.BrakeInput = ControlFrame.Brake;
+				ReplicatedState.HandbrakeInput = ControlFrame.bHandbrake ? 1.0f : 0.0f;
+				ReplicatedState.TargetGear = Movement->GetTargetGear();
+				auto SerializeReplicatedState = [&ReplicatedState](FArchive& Ar)
+				{
+					FVehicleReplicatedState::StaticStruct()->SerializeBin(Ar, &ReplicatedState);
+				};
+				SingularisVehicleBenchmark::FNetPayload ServerUpdateState;
+				ServerUpdateState.Write(SerializeReplicatedState);
+				DefaultControlBits += ServerUpdateState.NumBits;
+
+				// 紧凑路径：控制帧变化且未超过发送频率时发送，不变时按保活间隔补发
+				FSingularisVehicleNetControl Control;
+				Control.SetInputs(ControlFrame.Steering, ControlFrame.Throttle, ControlFrame.Brake, ControlFrame.bHandbrake, Movement->GetTargetGear());
+				State.TimeSinceControlSent += DeltaTime;
+				const bool bControlChanged = !(Control == State.LastControl);
+				if ((bControlChanged && State.TimeSinceControlSent >= 1.0f / SendSettings->ControlSendRate)
+					|| State.TimeSinceControlSent >= SendSettings->ControlKeepAliveInterval)
+				{
+					SingularisVehicleBenchmark::FNetPayload ControlPayload;
+					ControlPayload.Write([&Control](FArchive& Ar)
+					{
+						bool bSuccess = true;
+						Control.NetSerialize(Ar, nullptr, bSuccess);
+					});
+					CompactControlBits += ControlPayload.NumBits;
+					State.LastControl = Control;
+					State.TimeSinceControlSent = 0.0f;
+				}
+
+				// 服务器按 Actor 的网络更新频率复制属性，内容不变的属性不发送
+				State.TimeSinceNetUpdate += DeltaTime;
+				if (State.TimeSinceNetUpdate < 1.0f / FMath::Max(Vehicle->GetNetUpdateFrequency(), 1.0f))
+				{
+					continue;
+				}
+				State.TimeSinceNetUpdate = 0.0f;
+
+				Vehicle->GatherCurrentMovement();
+				FRepMovement RepMovement = Vehicle->GetReplicatedMovement();
+				if (State.Movement.Write([&RepMovement](FArchive& Ar)
+				{
+					bool bSuccess = true;
+					RepMovement.NetSerialize(Ar, nullptr, bSuccess);
+				}))
+				{
+					DefaultStateBits += State.Movement.NumBits;
+				}
+				if (State.ReplicatedState.Write(SerializeReplicatedState))
+				{
+					DefaultStateBits += State.ReplicatedState.NumBits;
+				}
+
+				const UPrimitiveComponent* Body = Vehicle->GetMesh();
+				FSingularisVehicleNetMotion Motion;
+				Motion.SetFromBody(Body->GetComponentTransform(), Body->GetPhysicsLinearVelocity(), Body->GetPhysicsAngularVelocityInDegrees());
+				if (State.Motion.Write([&Motion](FArchive& Ar)
+				{
+					bool bSuccess = true;
+					Motion.NetSerialize(Ar, nullptr, bSuccess);
+				}))
+				{
+					CompactStateBits += State.Motion.NumBits;
+				}
+
+				FSingularisVehicleNetDrive Drive;
+				Drive.Set(Movement->GetEngineRotationSpeed(),
+				          Movement->GetCurrentGear(),
+				          ControlFrame.Steering,
+				          ControlFrame.Throttle,
+				          ControlFrame.Brake,
+				          ControlFrame.bHandbrake);
+				if (State.Drive.Write([&Drive](FArchive& Ar)
+				{
+					bool bSuccess = true;
+					Drive.NetSerialize(Ar, nullptr, bSuccess);
+				}))
+				{
+					CompactStateBits += State.Drive.NumBits;
+				}
+			}
+		}
+
+		// 只计属性与 RPC 参数本身，不含数据包与 Bunch 头；状态按一个接收端计
+		const double BytesScale = 1.0 / (8.0 * NumFrames * DeltaTime * FMath::Max(Vehicles.Num(), 1));
+		auto AddRows = [&OutRows, NumVehicles, BytesScale](const TCHAR* Scenario, const int64 ControlBits, const int64 StateBits)
+		{
+			OutRows.Add({Scenario, NumVehicles, TEXT("ControlBytesPerVehiclePerSecond"), ControlBits * BytesScale});
+			OutRows.Add({Scenario, NumVehicles, TEXT("StateBytesPerVehiclePerSecond"), StateBits * BytesScale});
+			OutRows.Add({Scenario, NumVehicles, TEXT("BytesPerVehiclePerSecond"), (ControlBits + StateBits) * BytesScale});
+		};
+		AddRows(TEXT("NetDefault"), DefaultControlBits, DefaultStateBits);
+		AddRows(TEXT("NetCompact"), CompactControlBits, CompactStateBits);
+
+		UE_LOG(LogSingularisVehicleBenchmark,
+		       Display,
+		       TEXT("%4d 辆：默认路径 控制 %.1f + 状态 %.1f 字节/秒/辆，紧凑复制 控制 %.1f + 状态 %.1f 字节/秒/辆"),
+		       NumVehicles,
+		       DefaultControlBits * BytesScale,
+		       DefaultStateBits * BytesScale,
+		       CompactControlBits * BytesScale,
+		       CompactStateBits * BytesScale);
+
+		for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+		{
+			Vehicle->Destroy();
+		}
+		World->Tick(LEVELTICK_All, DeltaTime);
+	}
+
+	DestroyBenchmarkWorld(World);
+	return true;
+}
+
+UWorld* USingularisVehicleBenchmarkCommandlet::CreateBenchmarkWorld(const FString& MapPath)
+{
+	UWorld* World = nullptr;
+	if (MapPath.IsEmpty())
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("SingularisVehicleBenchmark"));
+	}
+	else
+	{
+		const UPackage* Package = LoadPackage(nullptr, *MapPath, LOAD_None);
+		World = Package ? UWorld::FindWorldInPackage(const_cast<UPackage*>(Package)) : nullptr;
+		if (!World)
+		{
+			return nullptr;
+		}
+
+		World->WorldType = EWorldType::Game;
+		World->AddToRoot();
+		if (!World->bIsWorldInitialized)
+		{
+			World->InitWorld();
+		}
+	}
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->bShouldSimulatePhysics = true;
+	World->UpdateWorldComponents(true, false);
+	World->SetGameMode(FURL());
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	// 没有指定地图时用一个压扁的立方体作为地面
+	if (MapPath.IsEmpty())
+	{
+		if (UStaticMesh* FloorMesh = LoadObject<UStaticMesh>(nullptr, SingularisVehicleBenchmark::FloorMeshPath))
+		{
+			AStaticMeshActor* Floor = World->SpawnActor<AStaticMeshActor>(FVector(0.0f, 0.0f, -50.0f), FRotator::ZeroRotator);
+			Floor->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+			Floor->GetStaticMeshComponent()->SetStaticMesh(FloorMesh);
+			Floor->SetActorScale3D(FVector(2000.0f, 2000.0f, 1.0f));
+		}
+	}
+
+	return World;
+}
+
+void USingularisVehicleBenchmarkCommandlet::SpawnVehicleGrid(UWorld* World,
+                                                          const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass,
+                                                          const int32 NumVehicles,
+                                                          TArray<ABaseWheeledVehiclePawn*>& OutVehicles)
+{
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumVehicles)));
+	OutVehicles.Reset(NumVehicles);
+	for (int32 Index = 0; Index < NumVehicles; ++Index)
+	{
+		const FVector Location((Index % GridSize) * SingularisVehicleBenchmark::VehicleSpacing,
+		                       (Index / GridSize) * SingularisVehicleBenchmark::VehicleSpacing,
+		                       100.0f);
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		if (ABaseWheeledVehiclePawn* Vehicle = World->SpawnActor<ABaseWheeledVehiclePawn>(VehicleClass, FTransform(Location), SpawnParameters))
+		{
+			OutVehicles.Add(Vehicle);
+		}
+	}
+}
+
+void USingularisVehicleBenchmarkCommandlet::DestroyBenchmarkWorld(UWorld* World)
+{
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+FVehicleControlFrame USingularisVehicleBenchmarkCommandlet::MakeScriptedControlFrame(const int32 VehicleIndex, const int32 Frame, const float DeltaTime)
+{
+	const float Time = Frame * DeltaTime;
+
+	// 每辆车错开相位：加速 4 秒、制动 1 秒，期间持续蛇行
+	const float Phase = VehicleIndex * 0.37f;
+	const float Cycle = FMath::Fmod(Time + Phase, 5.0f);
+	const bool bBraking = Cycle > 4.0f;
+
+	FVehicleControlFrame ControlFrame;
+	ControlFrame.Throttle = bBraking ? 0.0f : 1.0f;
+	ControlFrame.Brake = bBraking ? 1.0f : 0.0f;
+	ControlFrame.Steering = FMath::Sin((Time + Phase) * 0.8f) * 0.6f;
+	return ControlFrame;
+}
+
+void USingularisVehicleBenchmarkCommandlet::ApplyScriptedInputs(const TArray<ABaseWheeledVehiclePawn*>& Vehicles, const int32 Frame, const float DeltaTime)
+{
+	for (int32 Index = 0; Index < Vehicles.Num(); ++Index)
+	{
+		const FVehicleControlFrame ControlFrame = MakeScriptedControlFrame(Index, Frame, DeltaTime);
+
+		if (USingularisVehicleMovementComponent* Movement = Vehicles[Index]->GetSingularisVehicleMovement())
+		{
+			Movement->QueueThrottleInput(ControlFrame.Throttle);
+			Movement->QueueBrakeInput(ControlFrame.Brake);
+			Movement->QueueSteeringInput(ControlFrame.Steering);
+			Movement->QueueHandbrakeInput(ControlFrame.bHandbrake);
+		}
+		else
+		{
+			UChaosWheeledVehicleMovementComponent* ChaosMovement = Vehicles[Index]->GetChaosVehicleMovement();
+			ChaosMovement->SetThrottleInput(ControlFrame.Throttle);
+			ChaosMovement->SetBrakeInput(ControlFrame.Brake);
+			ChaosMovement->SetSteeringInput(ControlFrame.Steering);
+			ChaosMovement->SetHandbrakeInput(ControlFrame.bHandbrake);
+		}
+	}
+}
+
+void USingularisVehicleBenchmarkCommandlet::WriteReport(const FString& OutputDirectory, const TArray<FSingularisVehicleBenchmarkRow>& Rows)
+{
+	// CSV
+	FString Csv = TEXT("Scenario,Count,Metric,Value,Gate\n");
+	for (const FSingularisVehicleBenchmarkRow& Row : Rows)
+	{
+		Csv += FString::Printf(TEXT("%s,%d,%s,%.6f,%s\n"), *Row.Scenario, Row.Count, *Row.Metric, Row.Value, SingularisVehicleBenchmark::GetGateName(Row.Gate));
+	}
+
+	// JSON
+	TArray<TSharedPtr<FJsonValue>> JsonRows;
+	for (const FSingularisVehicleBenchmarkRow& Row : Rows)
+	{
+		const TSharedRef<FJsonObject> JsonRow = MakeShared<FJsonObject>();
+		JsonRow->SetStringField(TEXT("Scenario"), Row.Scenario);
+		JsonRow->SetNumberField(TEXT("Count"), Row.Count);
+		JsonRow->SetStringField(TEXT("Metric"), Row.Metric);
+		JsonRow->SetNumberField(TEXT("Value"), Row.Value);
+		JsonRow->SetStringField(TEXT("Gate"), SingularisVehicleBenchmark::GetGateName(Row.Gate));
+		JsonRows.Add(MakeShared<FJsonValueObject>(JsonRow));
+	}
+
+	const TSharedRef<FJsonObject> JsonRoot = MakeShared<FJsonObject>();
+	JsonRoot->SetArrayField(TEXT("Rows"), JsonRows);
+
+	FString Json;
+	FJsonSerializer::Serialize(JsonRoot, TJsonWriterFactory<>::Create(&Json));
+
+	const FString CsvPath = OutputDirectory / TEXT("SingularisVehicleBenchmark.csv");
+	const FString JsonPath = OutputDirectory / TEXT("SingularisVehicleBenchmark.json");
+	FFileHelper::SaveStringToFile(Csv, *CsvPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+	FFileHelper::SaveStringToFile(Json, *JsonPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+
+	UE_LOG(LogSingularisVehicleBenchmark, Display, TEXT("报告已写入 '%s' 与 '%s'"), *CsvPath, *JsonPath);
+}
+
+bool USingularisVehicleBenchmarkCommandlet::CompareWithBaseline(const FString& BaselinePath,
+                                                                const TArray<FSingularisVehicleBenchmarkRow>& Rows,
+                                                                const double Tolerance)
+{
+	FString Json;
+	TSharedPtr<FJsonObject> JsonRoot;
+	if (!FFileHelper::LoadFileToString(Json, *BaselinePath) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), JsonRoot) || !JsonRoot)
+	{
+		UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("无法读取基线 '%s'"), *BaselinePath);
+		return true;
+	}
+
+	bool bRegressed = false;
+	for (const TSharedPtr<FJsonValue>& JsonValue : JsonRoot->GetArrayField(TEXT("Rows")))
+	{
+		const TSharedPtr<FJsonObject>& BaselineRow = JsonValue->AsObject();
+		const FString Scenario = BaselineRow->GetStringField(TEXT("Scenario"));
+		const int32 Count = static_cast<int32>(BaselineRow->GetNumberField(TEXT("Count")));
+		const FString Metric = BaselineRow->GetStringField(TEXT("Metric"));
+		const double BaselineValue = BaselineRow->GetNumberField(TEXT("Value"));
+
+		FString BaselineGateName;
+		BaselineRow->TryGetStringField(TEXT("Gate"), BaselineGateName);
+		const ESingularisVehicleBenchmarkGate BaselineGate = SingularisVehicleBenchmark::ParseGateName(BaselineGateName);
+
+		const FSingularisVehicleBenchmarkRow* Row = Rows.FindByPredicate([&](const FSingularisVehicleBenchmarkRow& Candidate)
+		{
+			return Candidate.Scenario == Scenario && Candidate.Count == Count && Candidate.Metric == Metric;
+		});
+
+		// 参与比较的指标缺失说明场景没有跑完或改了规模，不能当作通过
+		if (!Row)
+		{
+			if (BaselineGate != ESingularisVehicleBenchmarkGate::None)
+			{
+				UE_LOG(LogSingularisVehicleBenchmark, Error, TEXT("%s/%d/%s：基线中有此指标，本次结果中缺失"), *Scenario, Count, *Metric);
+				bRegressed = true;
+			}
+			continue;
+		}
+
+		// 方向以本次结果为准，指标含义改变后旧基线中的方向不再适用
+		bool bRowRegressed = false;
+		switch (Row->Gate)
+		{
+		case ESingularisVehicleBenchmarkGate::LowerIsBetter:
+			bRowRegressed = Row->Value > BaselineValue * (1.0 + Tolerance);
+			break;
+		case ESingularisVehicleBenchmarkGate::HigherIsBetter:
+			bRowRegressed = Row->Value < BaselineValue * (1.0 - Tolerance);
+			break;
+		case ESingularisVehicleBenchmarkGate::None:
+			break;
+		}
+
+		if (bRowRegressed)
+		{
+			UE_LOG(LogSingularisVehicleBenchmark,
+			       Error,
+			       TEXT("%s/%d/%s：%.4f %s基线 %.4f（容差 %.0f%%）"),
+			       *Scenario,
+			       Count,
+			       *Metric,
+			       Row->Value,
+			       Row->Gate == ESingularisVehicleBenchmarkGate::HigherIsBetter ? TEXT("低于") : TEXT("超过"),
+			       BaselineValue,
+			       Tolerance * 100.0);
+			bRegressed = true;
+		}
+	}
+
+	return bRegressed;
+}
+
+TArray<int32> USingularisVehicleBenchmarkCommandlet::ParseCounts(const FString& Params, const TArray<int32>& DefaultCounts)
+{
+	FString CountsString;
+	if (!FParse::Value(*Params, TEXT("Counts="), CountsString, false))
+	{
+		return DefaultCounts;
+	}
+
+	TArray<FString> Tokens;
+	CountsString.ParseIntoArray(Tokens, TEXT(","));
+
+	TArray<int32> Counts;
+	for (const FString& Token : Tokens)
+	{
+		if (const int32 Count = FCString::Atoi(*Token); Count > 0)
+		{
+			Counts.Add(Count);
+		}
+	}
+
+	return Counts.IsEmpty() ? DefaultCounts : Counts;
+}
@@ -0,0 +1,13 @@
+/* =====================================================================
+ * SingularisVehicleTests.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "Modules/ModuleManager.h"
+
+// 基准测试 Commandlet 与自动化测试，没有需要在加载时初始化的内容
+IMPLEMENT_MODULE(FDefaultModuleImpl, SingularisVehicleTests)
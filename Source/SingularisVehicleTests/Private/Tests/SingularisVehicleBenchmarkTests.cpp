@@ -0,0 +1,143 @@
+/* =====================================================================
+ * SingularisVehicleBenchmarkTests.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleBenchmarkCommandlet.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "BaseWheeledVehiclePawn.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "Tests/SingularisVehicleTestHelpers.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSingularisVehicleBenchmarkParseCountsTest,
+                                 "SingularisVehicle.Benchmark.ParseCounts",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSingularisVehicleBenchmarkParseCountsTest::RunTest(const FString& Parameters)
+{
+	const TArray<int32> DefaultCounts = {1, 16, 64, 256};
+
+	TestEqual(TEXT("未指定规模时使用默认列表"), USingularisVehicleBenchmarkCommandlet::ParseCounts(TEXT("-Frames=60"), DefaultCounts), DefaultCounts);
+	TestEqual(TEXT("按给定顺序扫描"), USingularisVehicleBenchmarkCommandlet::ParseCounts(TEXT("-Counts=64,1,16"), DefaultCounts), TArray<int32>({64, 1, 16}));
+	TestEqual(TEXT("忽略零、负数与非数字"), USingularisVehicleBenchmarkCommandlet::ParseCounts(TEXT("-Counts=4,0,-2,abc,8"), DefaultCounts), TArray<int32>({4, 8}));
+	TestEqual(TEXT("没有有效规模时使用默认列表"), USingularisVehicleBenchmarkCommandlet::ParseCounts(TEXT("-Counts=0"), DefaultCounts), DefaultCounts);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSingularisVehicleBenchmarkBaselineTest,
+                                 "SingularisVehicle.Benchmark.Baseline",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSingularisVehicleBenchmarkBaselineTest::RunTest(const FString& Parameters)
+{
+	// 基线由 WriteReport 写出，与 Commandlet 的 -Baseline= 使用同一格式
+	const FString Directory = FPaths::AutomationTransientDir() / TEXT("SingularisVehicleBenchmark");
+	const FString BaselinePath = Directory / TEXT("SingularisVehicleBenchmark.json");
+	const TArray<FSingularisVehicleBenchmarkRow> BaselineRows = {
+		{TEXT("Simulation"), 16, TEXT("GameThreadMs"), 2.0},
+		{TEXT("Simulation"), 64, TEXT("GameThreadMs"), 8.0},
+		{TEXT("CurveLUT"), 1000, TEXT("BakedNsPerSample"), 1.0},
+		{TEXT("AIDriver"), 256, TEXT("ParallelSpeedup"), 4.0, ESingularisVehicleBenchmarkGate::HigherIsBetter},
+		{TEXT("AIDriver"), 256, TEXT("Threads"), 8.0, ESingularisVehicleBenchmarkGate::None},
+	};
+	USingularisVehicleBenchmarkCommandlet::WriteReport(Directory, BaselineRows);
+
+	auto Scaled = [&BaselineRows](const int32 RowIndex, const double Scale)
+	{
+		TArray<FSingularisVehicleBenchmarkRow> Rows = BaselineRows;
+		Rows[RowIndex].Value *= Scale;
+		return Rows;
+	};
+
+	TestFalse(TEXT("与基线相同"), USingularisVehicleBenchmarkCommandlet::CompareWithBaseline(BaselinePath, BaselineRows, 0.15));
+	TestFalse(TEXT("容差以内的变慢"), USingularisVehicleBenchmarkCommandlet::CompareWithBaseline(BaselinePath, Scaled(1, 1.1), 0.15));
+	TestFalse(TEXT("变快不算退化"), USingularisVehicleBenchmarkCommandlet::CompareWithBaseline(BaselinePath, Scaled(2, 0.5), 0.15));
+	TestFalse(TEXT("越大越好的指标变大不算退化"), USingularisVehicleBenchmarkCommandlet::CompareWithBaseline(BaselinePath, Scaled(3, 2.0), 0.15));
+	TestFalse(TEXT("不参与比较的指标任意变化"), USingularisVehicleBenchmarkCommandlet::CompareWithBaseline(BaselinePath, Scaled(4, 0.25), 0.15));
+
+	TArray<FSingularisVehicleBenchmarkRow> WithoutInformational = BaselineRows;
+	WithoutInformational.RemoveAt(4);
+	TestFalse(TEXT("缺少不参与比较的指标"), USingularisVehicleBenchmarkCommandlet::CompareWithBaseline(BaselinePath, WithoutInformational, 0.15));
+
+	AddExpectedError(TEXT("超过基线"), EAutomationExpectedErrorFlags::Contains, 1);
+	TestTrue(TEXT("超出容差的变慢"), USingularisVehicleBenchmarkCommandlet::CompareWithBaseline(BaselinePath, Scaled(1, 1.2), 0.15));
+
+	AddExpectedError(TEXT("低于基线"), EAutomationExpectedErrorFlags::Contains, 1);
+	TestTrue(TEXT("越大越好的指标超出容差的变小"), USingularisVehicleBenchmarkCommandlet::CompareWithBaseline(BaselinePath, Scaled(3, 0.8), 0.15));
+
+	AddExpectedError(TEXT("本次结果中缺失"), EAutomationExpectedErrorFlags::Contains, 3);
+	TestTrue(TEXT("本次缺少基线中参与比较的指标"),
+	         USingularisVehicleBenchmarkCommandlet::CompareWithBaseline(BaselinePath, {BaselineRows[0]}, 0.15));
+
+	AddExpectedError(TEXT("无法读取基线"), EAutomationExpectedErrorFlags::Contains, 1);
+	TestTrue(TEXT("基线缺失视为失败"), USingularisVehicleBenchmarkCommandlet::CompareWithBaseline(Directory / TEXT("Missing.json"), BaselineRows, 0.15));
+
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSingularisVehicleBenchmarkCountSweepTest,
+                                 "SingularisVehicle.Benchmark.CountSweep",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSingularisVehicleBenchmarkCountSweepTest::RunTest(const FString& Parameters)
+{
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = SingularisVehicleTests::LoadTestVehicleClass(*this);
+	if (!VehicleClass)
+	{
+		return true;
+	}
+
+	// 每个规模都应输出完整的一组指标，且按 -Counts= 的顺序
+	const TArray<int32> Counts = {1, 4};
+	const TCHAR* Metrics[] = {
+		TEXT("GameThreadMs"),
+		TEXT("PhysicsMs"),
+		TEXT("GameThreadMsPerVehicle"),
+		TEXT("PhysicsMsPerVehicle"),
+		TEXT("MemoryPerVehicleKB"),
+		TEXT("SpawnMsPerVehicle"),
+		TEXT("VehicleStepUs"),
+	};
+	constexpr int32 NumMetrics = UE_ARRAY_COUNT(Metrics);
+
+	USingularisVehicleBenchmarkCommandlet* Commandlet = NewObject<USingularisVehicleBenchmarkCommandlet>();
+	TArray<FSingularisVehicleBenchmarkRow> Rows;
+	const FString Params = FString::Printf(TEXT("-VehicleClass=%s -Counts=1,4 -Frames=30 -WarmupFrames=10"), *VehicleClass->GetPathName());
+	if (!TestTrue(TEXT("模拟场景运行成功"), Commandlet->RunScenario(TEXT("Simulation"), Params, Rows)))
+	{
+		return true;
+	}
+
+	TestEqual(TEXT("结果行数"), Rows.Num(), Counts.Num() * NumMetrics);
+	for (int32 CountIndex = 0; CountIndex < Counts.Num(); ++CountIndex)
+	{
+		for (int32 MetricIndex = 0; MetricIndex < NumMetrics; ++MetricIndex)
+		{
+			const int32 RowIndex = CountIndex * NumMetrics + MetricIndex;
+			if (!Rows.IsValidIndex(RowIndex))
+			{
+				break;
+			}
+
+			const FSingularisVehicleBenchmarkRow& Row = Rows[RowIndex];
+			const FString What = FString::Printf(TEXT("%d/%s"), Counts[CountIndex], Metrics[MetricIndex]);
+			TestEqual(What + TEXT(" 场景"), Row.Scenario, FString(TEXT("Simulation")));
+			TestEqual(What + TEXT(" 规模"), Row.Count, Counts[CountIndex]);
+			TestEqual(What + TEXT(" 指标"), Row.Metric, FString(Metrics[MetricIndex]));
+			TestTrue(What + TEXT(" 为非负有限值"), FMath::IsFinite(Row.Value) && Row.Value >= 0.0);
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,232 @@
+/* =====================================================================
+ * SingularisVehicleGroundTests.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleGroundSubsystem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "BaseWheeledVehiclePawn.h"
+#include "EngineUtils.h"
+#include "LandscapeProxy.h"
+#include "SingularisVehicleBenchmarkCommandlet.h"
+#include "SingularisVehicleGroundContact.h"
+#include "SingularisVehicleMovementComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/SingularisVehicleTestHelpers.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSingularisVehicleGroundAccuracyTest,
+                                 "SingularisVehicle.Ground.Accuracy",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSingularisVehicleGroundAccuracyTest::RunTest(const FString& Parameters)
+{
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = SingularisVehicleTests::LoadTestVehicleClass(*this);
+	const FString MapPath = SingularisVehicleTests::GetTestLandscapeMap(*this);
+	if (!VehicleClass || MapPath.IsEmpty())
+	{
+		return true;
+	}
+
+	IConsoleVariable* GroundEnable = IConsoleManager::Get().FindConsoleVariable(TEXT("SingularisVehicle.Ground.Enable"));
+	IConsoleVariable* GroundValidate = IConsoleManager::Get().FindConsoleVariable(TEXT("SingularisVehicle.Ground.Validate"));
+	if (!TestNotNull(TEXT("SingularisVehicle.Ground.Enable"), GroundEnable) || !TestNotNull(TEXT("SingularisVehicle.Ground.Validate"), GroundValidate))
+	{
+		return true;
+	}
+
+	UWorld* World = USingularisVehicleBenchmarkCommandlet::CreateBenchmarkWorld(MapPath);
+	USingularisVehicleGroundSubsystem* Ground = World ? World->GetSubsystem<USingularisVehicleGroundSubsystem>() : nullptr;
+	if (!TestNotNull(TEXT("地面接触子系统"), Ground))
+	{
+		if (World)
+		{
+			USingularisVehicleBenchmarkCommandlet::DestroyBenchmarkWorld(World);
+		}
+		return true;
+	}
+
+	FBox LandscapeBounds(ForceInit);
+	for (TActorIterator<ALandscapeProxy> It(World); It; ++It)
+	{
+		LandscapeBounds += It->GetComponentsBoundingBox();
+	}
+	if (!TestTrue(FString::Printf(TEXT("地图 '%s' 带有地形"), *MapPath), LandscapeBounds.IsValid != 0))
+	{
+		USingularisVehicleBenchmarkCommandlet::DestroyBenchmarkWorld(World);
+		return true;
+	}
+
+	const int32 PreviousEnable = GroundEnable->GetInt();
+	const int32 PreviousValidate = GroundValidate->GetInt();
+	const FSingularisGroundContactProviderPtr& Provider = Ground->GetContactProvider();
+	Provider->bCollectStats.store(true);
+
+	// 与基准测试的默认规模相同：64 辆与 256 辆
+	constexpr int32 GridSizes[] = {8, 16};
+	constexpr float Spacing = 800.0f;
+	for (const int32 GridSize : GridSizes)
+	{
+		// 方阵放在地形中央的地面以上，开启高度场接触后重建物理载具
+		const FVector GridOrigin = LandscapeBounds.GetCenter() - FVector(GridSize - 1, GridSize - 1, 0.0f) * (Spacing * 0.5f);
+		TArray<ABaseWheeledVehiclePawn*> Vehicles;
+		for (int32 Index = 0; Index < GridSize * GridSize; ++Index)
+		{
+			const FVector Column = GridOrigin + FVector(Index % GridSize, Index / GridSize, 0.0f) * Spacing;
+
+			FHitResult GroundHit;
+			if (!World->LineTraceSingleByChannel(GroundHit,
+			                                     FVector(Column.X, Column.Y, LandscapeBounds.Max.Z + 100.0),
+			                                     FVector(Column.X, Column.Y, LandscapeBounds.Min.Z - 100.0),
+			                                     ECC_WorldStatic))
+			{
+				continue;
+			}
+
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			ABaseWheeledVehiclePawn* Vehicle = World->SpawnActor<ABaseWheeledVehiclePawn>(VehicleClass, FTransform(GroundHit.ImpactPoint + FVector(0.0f, 0.0f, 100.0f)), SpawnParameters);
+			if (Vehicle && Vehicle->GetSingularisVehicleMovement())
+			{
+				Vehicle->GetSingularisVehicleMovement()->bUseHeightfieldContact = true;
+				Vehicle->GetSingularisVehicleMovement()->RecreatePhysicsState();
+				Ground->RegisterVehicle(Vehicle);
+				Vehicles.Add(Vehicle);
+			}
+			else if (Vehicle)
+			{
+				Vehicle->Destroy();
+			}
+		}
+
+		const int32 NumVehicles = GridSize * GridSize;
+		if (!TestFalse(FString::Printf(TEXT("%d 辆：有使用 USingularisVehicleMovementComponent 且放在地形上的载具"), NumVehicles), Vehicles.IsEmpty()))
+		{
+			break;
+		}
+		Ground->BuildPendingTiles();
+
+		// 校验模式：悬挂仍由场景查询驱动，同时对比高度场解析的结果
+		GroundEnable->Set(1, ECVF_SetByCode);
+		GroundValidate->Set(1, ECVF_SetByCode);
+		SingularisVehicleTests::TickWorld(World, 60);
+		Provider->ResetStats();
+
+		// 半油门绕圈，让车轮经过不同坡度的地形
+		for (int32 Index = 0; Index < Vehicles.Num(); ++Index)
+		{
+			Vehicles[Index]->SetControlInputs(0.5f, 0.0f, (Index & 1) ? 0.4f : -0.4f, false);
+		}
+		SingularisVehicleTests::TickWorld(World, 300);
+		const FSingularisGroundContactStats Stats = Provider->GetStats();
+
+		for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+		{
+			Vehicle->Destroy();
+		}
+		SingularisVehicleTests::TickWorld(World, 1);
+
+		// 两者都命中时的高度偏差，以及是否命中的一致率
+		if (!TestTrue(FString::Printf(TEXT("%d 辆：有车轮落在可直接采样的高度场上（检查车轮是否使用 Raycast 悬挂检测）"), NumVehicles), Stats.NumCompared > 0))
+		{
+			continue;
+		}
+
+		const double MeanHeightError = Stats.SumHeightError / FMath::Max<int64>(Stats.NumBothHit, 1);
+		const double HitAgreement = 1.0 - static_cast<double>(Stats.NumHitMismatches) / Stats.NumCompared;
+		AddInfo(FString::Printf(TEXT("%d 辆，%lld 次对比：高度误差平均 %.3f cm、最大 %.3f cm，法线最大 %.2f 度，命中一致 %.2f%%"),
+		                        NumVehicles,
+		                        Stats.NumCompared,
+		                        MeanHeightError,
+		                        Stats.MaxHeightError,
+		                        Stats.MaxNormalErrorDegrees,
+		                        HitAgreement * 100.0));
+
+		TestTrue(FString::Printf(TEXT("%d 辆：平均高度误差 %.3f cm 不超过 1 cm"), NumVehicles, MeanHeightError), MeanHeightError <= 1.0);
+		TestTrue(FString::Printf(TEXT("%d 辆：命中一致率 %.4f 不低于 0.99"), NumVehicles, HitAgreement), HitAgreement >= 0.99);
+	}
+
+	Provider->bCollectStats.store(false);
+	GroundEnable->Set(PreviousEnable, ECVF_SetByCode);
+	GroundValidate->Set(PreviousValidate, ECVF_SetByCode);
+	USingularisVehicleBenchmarkCommandlet::DestroyBenchmarkWorld(World);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSingularisVehicleGroundObstructionTest,
+                                 "SingularisVehicle.Ground.DynamicObstruction",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSingularisVehicleGroundObstructionTest::RunTest(const FString& Parameters)
+{
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = SingularisVehicleTests::LoadTestVehicleClass(*this);
+	if (!VehicleClass)
+	{
+		return true;
+	}
+
+	UWorld* World = USingularisVehicleBenchmarkCommandlet::CreateBenchmarkWorld(FString());
+	USingularisVehicleGroundSubsystem* Ground = World ? World->GetSubsystem<USingularisVehicleGroundSubsystem>() : nullptr;
+	if (!TestNotNull(TEXT("地面接触子系统"), Ground))
+	{
+		if (World)
+		{
+			USingularisVehicleBenchmarkCommandlet::DestroyBenchmarkWorld(World);
+		}
+		return true;
+	}
+
+	// 两辆车相距很远，之后把第二辆移到第一辆旁边
+	TArray<ABaseWheeledVehiclePawn*> Vehicles;
+	for (const FVector& Location : {FVector(0.0f, 0.0f, 100.0f), FVector(5000.0f, 0.0f, 100.0f)})
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		ABaseWheeledVehiclePawn* Vehicle = World->SpawnActor<ABaseWheeledVehiclePawn>(VehicleClass, FTransform(Location), SpawnParameters);
+		if (Vehicle && Vehicle->GetSingularisVehicleMovement())
+		{
+			Vehicle->GetSingularisVehicleMovement()->bUseHeightfieldContact = true;
+			Vehicle->GetSingularisVehicleMovement()->RecreatePhysicsState();
+			Ground->RegisterVehicle(Vehicle);
+			Vehicles.Add(Vehicle);
+		}
+	}
+
+	if (!TestEqual(TEXT("使用 USingularisVehicleMovementComponent 的载具数量"), Vehicles.Num(), 2))
+	{
+		USingularisVehicleBenchmarkCommandlet::DestroyBenchmarkWorld(World);
+		return true;
+	}
+	SingularisVehicleTests::TickWorld(World, 30);
+
+	auto IsObstructed = [](const ABaseWheeledVehiclePawn* Vehicle)
+	{
+		return Vehicle->GetSingularisVehicleMovement()->GetGroundObstruction()->load();
+	};
+
+	Ground->BuildPendingTiles();
+	TestFalse(TEXT("附近没有其他物体时使用高度场"), IsObstructed(Vehicles[0]));
+
+	Vehicles[1]->SetActorLocation(Vehicles[0]->GetActorLocation() + FVector(0.0f, 300.0f, 0.0f), false, nullptr, ETeleportType::TeleportPhysics);
+	Ground->BuildPendingTiles();
+	TestTrue(TEXT("旁边有其他载具时回退到场景查询"), IsObstructed(Vehicles[0]));
+	TestTrue(TEXT("两辆车都回退到场景查询"), IsObstructed(Vehicles[1]));
+
+	Ground->UnregisterVehicle(Vehicles[1]);
+	Vehicles[1]->Destroy();
+	SingularisVehicleTests::TickWorld(World, 2);
+	Ground->BuildPendingTiles();
+	TestFalse(TEXT("其他载具离开后恢复使用高度场"), IsObstructed(Vehicles[0]));
+
+	USingularisVehicleBenchmarkCommandlet::DestroyBenchmarkWorld(World);
+	return true;
+}
+
+#endif
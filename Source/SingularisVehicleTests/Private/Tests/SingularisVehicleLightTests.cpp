@@ -0,0 +1,98 @@
+/* =====================================================================
+ * SingularisVehicleLightTests.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisVehicleLightComponent.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "BaseWheeledVehiclePawn.h"
+#include "SingularisVehicleBenchmarkCommandlet.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/SingularisVehicleTestHelpers.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSingularisVehicleLightTransitionTest,
+                                 "SingularisVehicle.Lights.Transitions",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSingularisVehicleLightTransitionTest::RunTest(const FString& Parameters)
+{
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = SingularisVehicleTests::LoadTestVehicleClass(*this);
+	if (!VehicleClass)
+	{
+		return true;
+	}
+
+	UWorld* World = USingularisVehicleBenchmarkCommandlet::CreateBenchmarkWorld(FString());
+	if (!TestNotNull(TEXT("测试世界"), World))
+	{
+		return true;
+	}
+
+	TArray<ABaseWheeledVehiclePawn*> Vehicles;
+	USingularisVehicleBenchmarkCommandlet::SpawnVehicleGrid(World, VehicleClass, 1, Vehicles);
+	if (!TestEqual(TEXT("生成的载具数量"), Vehicles.Num(), 1))
+	{
+		USingularisVehicleBenchmarkCommandlet::DestroyBenchmarkWorld(World);
+		return true;
+	}
+
+	ABaseWheeledVehiclePawn* Vehicle = Vehicles[0];
+	USingularisVehicleLightComponent* Light = Vehicle->FindComponentByClass<USingularisVehicleLightComponent>();
+	if (!Light)
+	{
+		Light = NewObject<USingularisVehicleLightComponent>(Vehicle);
+		Vehicle->AddInstanceComponent(Light);
+		Light->RegisterComponent();
+	}
+	SingularisVehicleTests::TickWorld(World, 60);
+
+	// 组件状态与写入网格的自定义图元数据须一致
+	auto Expect = [this, Vehicle, Light](const TCHAR* Step, const bool bBrake, const bool bReverse)
+	{
+		const TArray<float>& CustomData = Vehicle->GetMesh()->GetCustomPrimitiveData().Data;
+		const float BrakeValue = CustomData.IsValidIndex(Light->BrakeLightDataIndex) ? CustomData[Light->BrakeLightDataIndex] : 0.0f;
+		const float ReverseValue = CustomData.IsValidIndex(Light->ReverseLightDataIndex) ? CustomData[Light->ReverseLightDataIndex] : 0.0f;
+		TestEqual(FString::Printf(TEXT("%s：刹车灯"), Step), Light->AreBrakeLightsOn(), bBrake);
+		TestEqual(FString::Printf(TEXT("%s：倒车灯"), Step), Light->AreReverseLightsOn(), bReverse);
+		TestEqual(FString::Printf(TEXT("%s：刹车灯图元数据"), Step), BrakeValue > 0.5f, bBrake);
+		TestEqual(FString::Printf(TEXT("%s：倒车灯图元数据"), Step), ReverseValue > 0.5f, bReverse);
+	};
+
+	// 加速、制动、松开、手刹、停车后倒车
+	Vehicle->SetControlInputs(1.0f, 0.0f, 0.0f, false);
+	SingularisVehicleTests::TickWorld(World, 90);
+	Expect(TEXT("加速"), false, false);
+
+	Vehicle->SetControlInputs(0.0f, 1.0f, 0.0f, false);
+	SingularisVehicleTests::TickWorld(World, 3);
+	Expect(TEXT("制动"), true, false);
+
+	Vehicle->SetControlInputs(0.0f, 0.0f, 0.0f, false);
+	SingularisVehicleTests::TickWorld(World, 3);
+	Expect(TEXT("松开制动"), false, false);
+
+	Vehicle->SetControlInputs(0.0f, 0.0f, 0.0f, true);
+	SingularisVehicleTests::TickWorld(World, 3);
+	Expect(TEXT("手刹"), true, false);
+
+	// 停稳后继续踩制动，Chaos 挂入倒挡
+	Vehicle->SetControlInputs(0.0f, 1.0f, 0.0f, false);
+	SingularisVehicleTests::TickWorld(World, 300);
+	Expect(TEXT("倒车"), false, true);
+
+	Vehicle->ResetVehicleState();
+	Expect(TEXT("重置"), false, false);
+
+	USingularisVehicleBenchmarkCommandlet::DestroyBenchmarkWorld(World);
+	return true;
+}
+
+#endif
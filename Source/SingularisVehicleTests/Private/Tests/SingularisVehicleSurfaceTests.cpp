@@ -0,0 +1,167 @@
+/* =====================================================================
+ * SingularisVehicleSurfaceTests.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "SingularisSurfaceResponse.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "BaseWheeledVehiclePawn.h"
+#include "SingularisVehicleBenchmarkCommandlet.h"
+#include "SingularisVehicleMovementComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "Tests/SingularisVehicleTestHelpers.h"
+#include "UObject/Package.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSingularisVehicleSurfaceDriveTest,
+                                 "SingularisVehicle.Surface.Drive",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSingularisVehicleSurfaceDriveTest::RunTest(const FString& Parameters)
+{
+	const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = SingularisVehicleTests::LoadTestVehicleClass(*this);
+	if (!VehicleClass)
+	{
+		return true;
+	}
+
+	UWorld* World = USingularisVehicleBenchmarkCommandlet::CreateBenchmarkWorld(FString());
+	UStaticMesh* StripMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!TestNotNull(TEXT("测试世界"), World) || !TestNotNull(TEXT("路面网格"), StripMesh))
+	{
+		if (World)
+		{
+			USingularisVehicleBenchmarkCommandlet::DestroyBenchmarkWorld(World);
+		}
+		return true;
+	}
+
+	// 沿 X 轴依次铺设沥青、砂石与冰面三条路面带，略高于地面
+	struct FSurfaceStrip
+	{
+		EPhysicalSurface SurfaceType;
+		const TCHAR* Name;
+		float Friction;
+		float FrictionScale;
+	};
+	const FSurfaceStrip Strips[] = {
+		{SurfaceType1, TEXT("Tarmac"), 1.0f, 1.0f},
+		{SurfaceType2, TEXT("Gravel"), 0.8f, 0.7f},
+		{SurfaceType3, TEXT("Ice"), 0.5f, 0.15f},
+	};
+	constexpr int32 NumStrips = UE_ARRAY_COUNT(Strips);
+	constexpr float StripLength = 4000.0f;
+
+	TArray<FSingularisSurfaceResponse> Responses;
+	for (int32 StripIndex = 0; StripIndex < NumStrips; ++StripIndex)
+	{
+		const FSurfaceStrip& Strip = Strips[StripIndex];
+
+		UPhysicalMaterial* Material = NewObject<UPhysicalMaterial>(GetTransientPackage(), *FString::Printf(TEXT("TestSurface_%s"), Strip.Name));
+		Material->SurfaceType = Strip.SurfaceType;
+		Material->Friction = Strip.Friction;
+
+		AStaticMeshActor* StripActor = World->SpawnActor<AStaticMeshActor>(FVector((StripIndex + 0.5f) * StripLength - 1000.0f, 0.0f, -4.0f), FRotator::ZeroRotator);
+		StripActor->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+		StripActor->GetStaticMeshComponent()->SetStaticMesh(StripMesh);
+		StripActor->GetStaticMeshComponent()->SetPhysMaterialOverride(Material);
+		StripActor->SetActorScale3D(FVector(StripLength / 100.0f, 60.0f, 0.1f));
+
+		FSingularisSurfaceResponse& Response = Responses.AddDefaulted_GetRef();
+		Response.SurfaceType = Strip.SurfaceType;
+		Response.FrictionScale = Strip.FrictionScale;
+	}
+	const FSingularisSurfaceResponseTableRef Table = FSingularisSurfaceResponseTable::Bake(Responses, FSingularisSurfaceResponse());
+
+	// 载具并排停在第一条路面带起点，全油门直行
+	constexpr int32 NumVehicles = 4;
+	TArray<ABaseWheeledVehiclePawn*> Vehicles;
+	for (int32 Index = 0; Index < NumVehicles; ++Index)
+	{
+		const FVector Location(0.0f, (Index - (NumVehicles - 1) * 0.5f) * 500.0f, 100.0f);
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		ABaseWheeledVehiclePawn* Vehicle = World->SpawnActor<ABaseWheeledVehiclePawn>(VehicleClass, FTransform(Location), SpawnParameters);
+		if (Vehicle && Vehicle->GetSingularisVehicleMovement())
+		{
+			Vehicle->GetSingularisVehicleMovement()->SetSurfaceResponseTable(Table);
+			Vehicle->GetSingularisVehicleMovement()->RecreatePhysicsState();
+			Vehicles.Add(Vehicle);
+		}
+		else if (Vehicle)
+		{
+			Vehicle->Destroy();
+		}
+	}
+
+	if (!TestEqual(TEXT("使用 USingularisVehicleMovementComponent 的载具数量"), Vehicles.Num(), NumVehicles))
+	{
+		USingularisVehicleBenchmarkCommandlet::DestroyBenchmarkWorld(World);
+		return true;
+	}
+
+	// 按路面统计着地车轮的平均滑移量，并记录每辆车经过的路面
+	double SlipSums[NumStrips] = {};
+	int32 SlipCounts[NumStrips] = {};
+	uint8 VisitedMasks[NumVehicles] = {};
+
+	constexpr int32 NumFrames = 900;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		for (ABaseWheeledVehiclePawn* Vehicle : Vehicles)
+		{
+			Vehicle->GetSingularisVehicleMovement()->QueueControlInputs(1.0f, 0.0f, 0.0f, false);
+		}
+
+		SingularisVehicleTests::TickWorld(World, 1);
+
+		for (int32 Index = 0; Index < Vehicles.Num(); ++Index)
+		{
+			const FSingularisVehicleSnapshot Snapshot = Vehicles[Index]->GetSingularisVehicleMovement()->ReadSnapshot();
+			for (int32 WheelIndex = 0; WheelIndex < Snapshot.NumWheels; ++WheelIndex)
+			{
+				if (!Snapshot.IsWheelInContact(WheelIndex))
+				{
+					continue;
+				}
+
+				for (int32 StripIndex = 0; StripIndex < NumStrips; ++StripIndex)
+				{
+					if (Snapshot.WheelSurface[WheelIndex] == Strips[StripIndex].SurfaceType)
+					{
+						SlipSums[StripIndex] += Snapshot.WheelSlip[WheelIndex];
+						++SlipCounts[StripIndex];
+						VisitedMasks[Index] |= static_cast<uint8>(1u << StripIndex);
+					}
+				}
+			}
+		}
+	}
+
+	// 每辆车都应依次经过三种路面
+	constexpr int32 AllStripsMask = (1 << NumStrips) - 1;
+	for (int32 Index = 0; Index < Vehicles.Num(); ++Index)
+	{
+		TestEqual(FString::Printf(TEXT("'%s' 经过的路面掩码"), *Vehicles[Index]->GetName()), static_cast<int32>(VisitedMasks[Index]), AllStripsMask);
+	}
+
+	// 冰面的摩擦缩放最低，全油门时车轮滑移应明显大于沥青
+	const double TarmacSlip = SlipSums[0] / FMath::Max(SlipCounts[0], 1);
+	const double IceSlip = SlipSums[NumStrips - 1] / FMath::Max(SlipCounts[NumStrips - 1], 1);
+	TestTrue(FString::Printf(TEXT("冰面平均滑移 %.1f 大于沥青 %.1f"), IceSlip, TarmacSlip), IceSlip > TarmacSlip);
+
+	USingularisVehicleBenchmarkCommandlet::DestroyBenchmarkWorld(World);
+	return true;
+}
+
+#endif
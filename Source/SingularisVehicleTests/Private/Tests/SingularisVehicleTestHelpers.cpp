@@ -0,0 +1,68 @@
+/* =====================================================================
+ * SingularisVehicleTestHelpers.cpp
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#include "Tests/SingularisVehicleTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "BaseWheeledVehiclePawn.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+
+namespace SingularisVehicleTests
+{
+	static FString VehicleClassPath;
+	static FAutoConsoleVariableRef CVarVehicleClass(
+		TEXT("SingularisVehicle.Tests.VehicleClass"),
+		VehicleClassPath,
+		TEXT("需要驾驶载具的自动化测试使用的 ABaseWheeledVehiclePawn 子类路径，如 /Game/Vehicles/BP_SportsCar.BP_SportsCar_C。"));
+
+	static FString LandscapeMapPath;
+	static FAutoConsoleVariableRef CVarLandscapeMap(
+		TEXT("SingularisVehicle.Tests.LandscapeMap"),
+		LandscapeMapPath,
+		TEXT("地面接触测试使用的带地形地图，如 /Game/Maps/Landscape。"));
+
+	TSubclassOf<ABaseWheeledVehiclePawn> LoadTestVehicleClass(FAutomationTestBase& Test)
+	{
+		if (VehicleClassPath.IsEmpty())
+		{
+			Test.AddWarning(TEXT("未设置 SingularisVehicle.Tests.VehicleClass，跳过需要驾驶载具的检查"));
+			return nullptr;
+		}
+
+		const TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass = LoadClass<ABaseWheeledVehiclePawn>(nullptr, *VehicleClassPath);
+		if (!VehicleClass)
+		{
+			Test.AddError(FString::Printf(TEXT("无法加载载具类 '%s'"), *VehicleClassPath));
+		}
+		return VehicleClass;
+	}
+
+	FString GetTestLandscapeMap(FAutomationTestBase& Test)
+	{
+		if (LandscapeMapPath.IsEmpty())
+		{
+			Test.AddWarning(TEXT("未设置 SingularisVehicle.Tests.LandscapeMap，跳过需要地形的检查"));
+		}
+		return LandscapeMapPath;
+	}
+
+	void TickWorld(UWorld* World, const int32 NumFrames, const float DeltaTime)
+	{
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			World->Tick(LEVELTICK_All, DeltaTime);
+			++GFrameCounter;
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,32 @@
+/* =====================================================================
+ * SingularisVehicleTestHelpers.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SubclassOf.h"
+
+class ABaseWheeledVehiclePawn;
+class FAutomationTestBase;
+class UWorld;
+
+namespace SingularisVehicleTests
+{
+	/**
+	 * Returns SingularisVehicle.Tests.VehicleClass 指定的载具类
+	 * 插件不带可驾驶的载具资源，未指定时添加警告并返回空，调用方应直接结束测试
+	 */
+	TSubclassOf<ABaseWheeledVehiclePawn> LoadTestVehicleClass(FAutomationTestBase& Test);
+
+	/** Returns SingularisVehicle.Tests.LandscapeMap 指定的带地形地图；未指定时添加警告并返回空字符串 */
+	FString GetTestLandscapeMap(FAutomationTestBase& Test);
+
+	/** 以固定步长推进世界 */
+	void TickWorld(UWorld* World, int32 NumFrames, float DeltaTime = 1.0f / 60.0f);
+}
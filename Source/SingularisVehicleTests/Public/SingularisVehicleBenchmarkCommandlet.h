@@ -0,0 +1,210 @@
+/* =====================================================================
+ * SingularisVehicleBenchmarkCommandlet.h
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: 2024 TrifingZW <TrifingZW@gmail.com>
+ * 
+ * Copyright (c) 2024 TrifingZW
+ * Licensed under MIT License
+ * ===================================================================== */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Engine/HitResult.h"
+#include "SingularisVehicleTypes.h"
+#include "SingularisVehicleBenchmarkCommandlet.generated.h"
+
+class ABaseWheeledVehiclePawn;
+class UPrimitiveComponent;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogSingularisVehicleBenchmark, Log, All);
+
+/**
+ * 与基线比较时指标的方向
+ */
+enum class ESingularisVehicleBenchmarkGate : uint8
+{
+	/** 耗时、内存等开销，超过基线乘以 (1 + 容差) 时视为退化 */
+	LowerIsBetter,
+
+	/** 吞吐量、加速比、覆盖率等，低于基线乘以 (1 - 容差) 时视为退化 */
+	HigherIsBetter,
+
+	/** 只记录，不参与比较，例如实际使用的线程数 */
+	None,
+};
+
+/**
+ * 单条基准测试结果：某个场景在某个规模下的一项指标
+ */
+struct FSingularisVehicleBenchmarkRow
+{
+	FString Scenario;
+	int32 Count = 0;
+	FString Metric;
+	double Value = 0.0;
+	ESingularisVehicleBenchmarkGate Gate = ESingularisVehicleBenchmarkGate::LowerIsBetter;
+};
+
+/**
+ *  载具性能基准测试 Commandlet
+ *  在无 GPU 的环境下创建平坦的测试场景，按不同规模生成载具并以脚本输入驾驶固定帧数，
+ *  输出游戏线程耗时、物理耗时、单车每个物理步的模拟耗时、单车内存与生成耗时，并与基线比较，超出容差时返回非零
+ *
+ *  位于 DeveloperTool 模块 SingularisVehicleTests，Shipping 构建不包含；功能正确性由同模块的自动化测试检查，
+ *  这里只做计时
+ *
+ *  用法：
+ *  UnrealEditor-Cmd <Project>.uproject -run=SingularisVehicleBenchmark -nullrhi -unattended
+ *      -VehicleClass=/Game/Vehicles/BP_SportsCar.BP_SportsCar_C
+ *      [-Scenario=Simulation] [-Map=/Game/Maps/Flat] [-Counts=1,16,64,256] [-Frames=600] [-WarmupFrames=60] [-AsyncInput]
+ *      [-Output=<目录>] [-Baseline=<基线 json>] [-Tolerance=0.15]
+ *
+ *  曲线查找表与富曲线求值的对比：
+ *  UnrealEditor-Cmd <Project>.uproject -run=SingularisVehicleBenchmark -nullrhi -unattended -Scenario=CurveLUT [-Samples=4000000]
+ *
+ *  Mass 交通实体的运动学更新：
+ *  UnrealEditor-Cmd <Project>.uproject -run=SingularisVehicleBenchmark -nullrhi -unattended -Scenario=Traffic [-Counts=5000] [-Frames=600]
+ *
+ *  灯光组件的单帧更新开销，状态转换由自动化测试 SingularisVehicle.Lights.Transitions 检查：
+ *  UnrealEditor-Cmd <Project>.uproject -run=SingularisVehicleBenchmark -nullrhi -unattended -Scenario=Lights -VehicleClass=... [-Counts=500]
+ *
+ *  AI 驾驶子系统在环形路径上驾驶载具，输出单车的收集、计算与提交耗时，以及并行相对单线程的加速比：
+ *  UnrealEditor-Cmd <Project>.uproject -run=SingularisVehicleBenchmark -nullrhi -unattended -Scenario=AIDriver -VehicleClass=... [-Counts=64,256,1024]
+ *
+ *  逐车逐通道写入输入与提交控制帧批量写入的开销对比：
+ *  UnrealEditor-Cmd <Project>.uproject -run=SingularisVehicleBenchmark -nullrhi -unattended -Scenario=Control -VehicleClass=... [-Counts=500]
+ *
+ *  同一帧大量载具请求安全重置时的游戏线程开销，请求未在限定帧数内完成或载具未摆正时返回非零：
+ *  UnrealEditor-Cmd <Project>.uproject -run=SingularisVehicleBenchmark -nullrhi -unattended -Scenario=Reset -VehicleClass=... [-Counts=50] [-Rounds=10]
+ *
+ *  大量停放车辆休眠时的帧耗时与单车唤醒、休眠开销，自动休眠或唤醒结果不符合预期时返回非零：
+ *  UnrealEditor-Cmd <Project>.uproject -run=SingularisVehicleBenchmark -nullrhi -unattended -Scenario=Hibernation -VehicleClass=... [-Counts=1000,5000] [-Wakes=32]
+ *
+ *  服务器长稳测试：长时间驾驶后报告单车内存、内存增长、单车帧耗时与组件数；客户端构建同时测量完整配置与服务器精简配置，
+ *  在专用服务器构建（如 LinuxServer）中运行即得到服务器构建的数据，精简配置下仍带有相机时返回非零：
+ *  <Project>Server -run=SingularisVehicleBenchmark -nullrhi -unattended -Scenario=ServerSoak -VehicleClass=... [-Counts=64,256] [-Frames=3600]
+ *
+ *  逐车读取运动组件与批量读取状态快照的开销对比，同时由后台线程持续读取，读到不完整的快照时返回非零：
+ *  UnrealEditor-Cmd <Project>.uproject -run=SingularisVehicleBenchmark -nullrhi -unattended -Scenario=Snapshot -VehicleClass=... [-Counts=256]
+ *
+ *  动画蓝图与直接写入车轮骨骼的帧时间对比，载具类需带有动画蓝图；有载具未能改为直接写入时返回非零：
+ *  UnrealEditor-Cmd <Project>.uproject -run=SingularisVehicleBenchmark -nullrhi -unattended -Scenario=WheelVisual -VehicleClass=... [-Counts=200]
+ *
+ *  路面响应表的查表开销，驶过多种路面的识别与滑移由自动化测试 SingularisVehicle.Surface.Drive 检查：
+ *  UnrealEditor-Cmd <Project>.uproject -run=SingularisVehicleBenchmark -nullrhi -unattended -Scenario=Surface [-Lookups=4194304]
+ *
+ *  高度场接触与悬挂射线场景查询的单轮耗时对比，并在校验模式下统计两者的高度误差与命中一致率，地图需带有地形；
+ *  平均高度误差超过 1 cm 或命中一致率低于 0.99 时返回非零：
+ *  UnrealEditor-Cmd <Project>.uproject -run=SingularisVehicleBenchmark -nullrhi -unattended -Scenario=Ground -VehicleClass=... -Map=/Game/Maps/Landscape
+ *      [-Counts=64,256] [-Frames=600]
+ *
+ *  两排载具迎面相撞并贴墙刮擦，对比绑定车身 OnComponentHit 与接触聚合子系统的回调次数与帧时间；聚合后没有任何接触时返回非零：
+ *  UnrealEditor-Cmd <Project>.uproject -run=SingularisVehicleBenchmark -nullrhi -unattended -Scenario=Contact -VehicleClass=... [-Counts=100] [-Frames=600]
+ *
+ *  载具驶过一排轮流卸载与重新加载的模拟单元，对比销毁后同帧重新生成与持久化子系统分批放回的帧耗时峰值；
+ *  有载具未能回到世界、或放回后的速度与挡位和写入时不一致时返回非零：
+ *  UnrealEditor-Cmd <Project>.uproject -run=SingularisVehicleBenchmark -nullrhi -unattended -Scenario=Persistence -VehicleClass=...
+ *      [-Counts=200] [-Frames=600] [-CycleFrames=30] [-Cells=8] [-CellSize=6400]
+ *
+ *  默认复制路径（Actor 移动复制、Chaos 的 ServerUpdateState 与 ReplicatedState）与紧凑复制的每车每秒字节数对比，
+ *  按相同的脚本输入与网络更新频率写出两条路径实际复制的内容，只计负载，不含数据包头：
+ *  UnrealEditor-Cmd <Project>.uproject -run=SingularisVehicleBenchmark -nullrhi -unattended -Scenario=NetBandwidth -VehicleClass=... [-Counts=16,64] [-Frames=600]
+ */
+UCLASS()
+class SINGULARISVEHICLETESTS_API USingularisVehicleBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	USingularisVehicleBenchmarkCommandlet();
+
+	// 开始 Commandlet 接口
+	virtual int32 Main(const FString& Params) override;
+	// 结束 Commandlet 接口
+
+	/** 运行一个场景并追加结果，不写报告也不比较基线；Returns 场景是否成功 */
+	bool RunScenario(const FString& Scenario, const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows);
+
+	/** 按方阵生成载具 */
+	static void SpawnVehicleGrid(UWorld* World, TSubclassOf<ABaseWheeledVehiclePawn> VehicleClass, int32 NumVehicles, TArray<ABaseWheeledVehiclePawn*>& OutVehicles);
+
+	/** 创建基准测试使用的世界；未指定地图时生成一块平地 */
+	static UWorld* CreateBenchmarkWorld(const FString& MapPath);
+
+	/** 销毁基准测试世界 */
+	static void DestroyBenchmarkWorld(UWorld* World);
+
+	/** 写出 CSV 与 JSON 报告 */
+	static void WriteReport(const FString& OutputDirectory, const TArray<FSingularisVehicleBenchmarkRow>& Rows);
+
+	/** 按各行的方向与基线比较，基线中参与比较的行在本次结果中缺失也视为失败；Returns 是否存在超出容差的退化 */
+	static bool CompareWithBaseline(const FString& BaselinePath, const TArray<FSingularisVehicleBenchmarkRow>& Rows, double Tolerance);
+
+	/** 解析逗号分隔的规模列表 */
+	static TArray<int32> ParseCounts(const FString& Params, const TArray<int32>& DefaultCounts);
+
+private:
+	/** 完整载具模拟：生成、驾驶并测量 */
+	bool RunSimulationScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const;
+
+	/** 扭矩曲线求值：富曲线与烘焙查找表的逐个及批量求值 */
+	bool RunCurveLUTScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const;
+
+	/** 交通实体：在环形车道上推进大量 Mass 实体 */
+	bool RunTrafficScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const;
+
+	/** 灯光组件：测量单帧更新开销 */
+	bool RunLightsScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const;
+
+	/** AI 驾驶：测量各阶段的单车开销与线程扩展 */
+	bool RunAIDriverScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const;
+
+	/** 控制帧：对比逐通道直接写入与控制子系统批量写入的游戏线程开销 */
+	bool RunControlScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const;
+
+	/** 安全重置：所有载具同一帧请求重置，测量请求与结果返回期间的帧耗时 */
+	bool RunResetScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const;
+
+	/** 休眠：放置大量停放车辆，测量稳态帧耗时以及唤醒与休眠的单车开销 */
+	bool RunHibernationScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const;
+
+	/** 服务器长稳：对比完整配置与服务器精简配置的单车内存与 Tick 开销 */
+	bool RunServerSoakScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const;
+
+	/** 状态快照：对比逐车读取运动组件与批量读取快照，并在后台线程并发读取 */
+	bool RunSnapshotScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const;
+
+	/** 车轮表现：对比动画蓝图与直接写入车轮骨骼的帧时间 */
+	bool RunWheelVisualScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const;
+
+	/** 路面响应：对比查表方式的开销 */
+	bool RunSurfaceScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const;
+
+	/** 地面接触：在地形上对比高度场接触与场景查询的悬挂检测耗时，并校验两者的偏差 */
+	bool RunGroundScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const;
+
+	/** 车身接触：对比逐次命中回调与聚合后的接触批次；需要绑定回调，因此不是 const */
+	bool RunContactScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows);
+
+	/** 持久化：单元轮流卸载与重新加载时，对比重新生成与分批放回的帧耗时峰值，并校验状态恢复 */
+	bool RunPersistenceScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const;
+
+	/** 复制带宽：对比默认复制路径与紧凑复制的每车每秒字节数 */
+	bool RunNetBandwidthScenario(const FString& Params, TArray<FSingularisVehicleBenchmarkRow>& OutRows) const;
+
+	/** 车身接触场景中逐次命中的回调，统计次数并模拟订阅者的处理 */
+	UFUNCTION()
+	void HandleBenchmarkHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
+
+	/** 按帧号与载具序号生成脚本化的控制帧 */
+	static FVehicleControlFrame MakeScriptedControlFrame(int32 VehicleIndex, int32 Frame, float DeltaTime);
+
+	/** 按帧号与载具序号生成脚本化的油门、转向与制动输入 */
+	static void ApplyScriptedInputs(const TArray<ABaseWheeledVehiclePawn*>& Vehicles, int32 Frame, float DeltaTime);
+
+	/** 车身接触场景的回调次数与模拟处理的累计结果 */
+	int64 NumContactCallbacks = 0;
+	double ContactWorkAccumulator = 0.0;
+};
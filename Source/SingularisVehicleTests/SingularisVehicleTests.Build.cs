@@ -0,0 +1,50 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class SingularisVehicleTests : ModuleRules
+{
+	public SingularisVehicleTests(ReadOnlyTargetRules target) : base(target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicIncludePaths.AddRange(
+			[
+			]
+		);
+
+
+		PrivateIncludePaths.AddRange(
+			[
+			]
+		);
+
+
+		PublicDependencyModuleNames.AddRange(
+			[
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"SingularisVehicle"
+			]
+		);
+
+
+		PrivateDependencyModuleNames.AddRange(
+			[
+				"Chaos",
+				"ChaosVehicles",
+				"PhysicsCore",
+				"Landscape",
+				"Json",
+				"MassEntity"
+			]
+		);
+
+
+		DynamicallyLoadedModuleNames.AddRange(
+			[
+			]
+		);
+	}
+}